@@ -9,17 +9,63 @@ PRJ_DIR=$$BASE_DIR/tnct/async
 
 HEADERS += \
         $$PRJ_DIR/bus/sleeping_loop.h \
+        $$PRJ_DIR/bus/timer_wheel.h \
         $$PRJ_DIR/bus/exec_sync.h \
         $$PRJ_DIR/bus/dispatcher.h \
+        $$PRJ_DIR/bus/handle.h \
+        $$PRJ_DIR/bus/work_stealing_pool.h \
+        $$PRJ_DIR/bus/static_dispatcher.h \
+        $$PRJ_DIR/bus/sleep_for.h \
+        $$PRJ_DIR/bus/sync_wait.h \
+        $$PRJ_DIR/bus/affinity.h \
+        $$PRJ_DIR/bus/pipeline.h \
+        $$PRJ_DIR/bus/recorder.h \
+        $$PRJ_DIR/bus/replayer.h \
+        $$PRJ_DIR/bus/shm_sender.h \
+        $$PRJ_DIR/bus/shm_receiver.h \
+        $$PRJ_DIR/bus/parallel.h \
         $$PRJ_DIR/dat/handling_priority.h \
+        $$PRJ_DIR/dat/overflow_policy.h \
+        $$PRJ_DIR/dat/histogram.h \
+        $$PRJ_DIR/dat/affinity.h \
+        $$PRJ_DIR/dat/stage_config.h \
+        $$PRJ_DIR/dat/stage_metrics.h \
+        $$PRJ_DIR/dat/autoscaling.h \
+        $$PRJ_DIR/dat/batch_size.h \
+        $$PRJ_DIR/dat/event_pool.h \
+        $$PRJ_DIR/dat/handling_metrics.h \
+        $$PRJ_DIR/dat/handling_definition.h \
         $$PRJ_DIR/dat/handling_name.h \
+        $$PRJ_DIR/dat/reply.h \
+        $$PRJ_DIR/dat/request.h \
         $$PRJ_DIR/dat/result.h \
+        $$PRJ_DIR/dat/task.h \
         $$PRJ_DIR/internal/bus/handling.h \
+        $$PRJ_DIR/internal/bus/metrics_recorder.h \
+        $$PRJ_DIR/internal/bus/inline_handling.h \
+        $$PRJ_DIR/internal/bus/exec_pool.h \
+        $$PRJ_DIR/internal/bus/sharded_handling.h \
+        $$PRJ_DIR/internal/bus/filtered_handling.h \
+        $$PRJ_DIR/internal/bus/pipeline_stage.h \
+        $$PRJ_DIR/internal/bus/coroutine_runner.h \
+        $$PRJ_DIR/internal/bus/detached.h \
+        $$PRJ_DIR/internal/bus/shm_ring.h \
+        $$PRJ_DIR/internal/bus/publish_serialized.h \
+        $$PRJ_DIR/internal/bus/event_taps.h \
         $$PRJ_DIR/internal/dat/handler_id.h \
         $$PRJ_DIR/internal/dat/handling_id.h \
+        $$PRJ_DIR/internal/dat/reply_slot.h \
+        $$PRJ_DIR/internal/dat/record_format.h \
         $$PRJ_DIR/cpt/is_dispatcher.h  \
         $$PRJ_DIR/cpt/is_event.h  \
+        $$PRJ_DIR/cpt/is_pmr_event.h  \
         $$PRJ_DIR/cpt/is_handler.h  \
+        $$PRJ_DIR/cpt/is_batch_handler.h  \
+        $$PRJ_DIR/cpt/is_coroutine_handler.h  \
+        $$PRJ_DIR/cpt/is_any_handler.h  \
+        $$PRJ_DIR/cpt/is_key_extractor.h  \
+        $$PRJ_DIR/cpt/is_event_filter.h  \
+        $$PRJ_DIR/cpt/is_event_serializer.h  \
         $$PRJ_DIR/cpt/has_add_handling_method.h  \
         $$PRJ_DIR/cpt/has_events_handled.h  \
         $$PRJ_DIR/cpt/has_events_published.h  \
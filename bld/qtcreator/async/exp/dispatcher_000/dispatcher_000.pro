@@ -15,6 +15,13 @@ HEADERS+=$$PRJ_DIR/dispatcher_000/publisher.h \
          $$PRJ_DIR/dispatcher_000/handler_type_id.h \
          $$PRJ_DIR/dispatcher_000/results.h \
          $$PRJ_DIR/dispatcher_000/configuration.h \
+         $$PRJ_DIR/dispatcher_000/queue_throughput.h \
+         $$PRJ_DIR/dispatcher_000/batch_throughput.h \
+         $$PRJ_DIR/dispatcher_000/wake_latency.h \
+         $$PRJ_DIR/dispatcher_000/publish_cost.h \
+         $$PRJ_DIR/dispatcher_000/affinity_cost.h \
+         $$PRJ_DIR/dispatcher_000/replay_load.h \
+         $$PRJ_DIR/dispatcher_000/shm_latency.h \
          $$PRJ_DIR/dispatcher_000/handler_id.h
 
 
@@ -27,4 +34,12 @@ DISTFILES += \
     $$prj_dir/dispatcher_000/cfg-c.ini \
     $$prj_dir/dispatcher_000/cfg-d.ini \
     $$prj_dir/dispatcher_000/cfg-e.ini \
-    $$prj_dir/dispatcher_000/cfg-f.ini
+    $$prj_dir/dispatcher_000/cfg-f.ini \
+    $$prj_dir/dispatcher_000/cfg-g.ini \
+    $$prj_dir/dispatcher_000/cfg-h.ini \
+    $$prj_dir/dispatcher_000/cfg-i.ini \
+    $$prj_dir/dispatcher_000/cfg-j.ini \
+    $$prj_dir/dispatcher_000/cfg-k.ini \
+    $$prj_dir/dispatcher_000/cfg-l.ini \
+    $$prj_dir/dispatcher_000/cfg-m.ini \
+    $$prj_dir/dispatcher_000/cfg-n.ini
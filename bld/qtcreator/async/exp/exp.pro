@@ -2,6 +2,7 @@ TEMPLATE=subdirs
 QMAKE_CXXFLAGS += -DTENACITAS_LOG
 SUBDIRS = \
         sleeping_loop_000 \
+        sleeping_loop_001 \
         executer_000 \
         dispatcher_000 \
         temperature_sensors_simulator \
@@ -0,0 +1,7 @@
+QT -= core
+TEMPLATE = app
+TARGET = tnct.async.exp.sleeping_loop_001
+CONFIG += example
+include (../../../common.pri)
+
+SOURCES = $$BASE_DIR/tnct/async/exp/sleeping_loop_001/main.cpp
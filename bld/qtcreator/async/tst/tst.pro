@@ -12,9 +12,25 @@ SOURCES = $$PRJ_DIR/main.cpp
 
 HEADERS = \
          $$PRJ_DIR/dispatcher_test.h \
+         $$PRJ_DIR/exec_sync_test.h \
+         $$PRJ_DIR/filter_test.h \
+         $$PRJ_DIR/autoscaling_test.h \
+         $$PRJ_DIR/affinity_test.h \
+         $$PRJ_DIR/event_pool_test.h \
+         $$PRJ_DIR/pipeline_test.h \
+         $$PRJ_DIR/record_test.h \
+         $$PRJ_DIR/shm_test.h \
+         $$PRJ_DIR/parallel_test.h \
+         $$PRJ_DIR/coroutine_test.h \
          $$PRJ_DIR/cpt_test.h \
          $$PRJ_DIR/sleeping_loop_test.h \
-         $$PRJ_DIR/handling_test.h
+         $$PRJ_DIR/static_dispatcher_test.h \
+         $$PRJ_DIR/handle_test.h \
+         $$PRJ_DIR/handling_test.h \
+         $$PRJ_DIR/metrics_test.h \
+         $$PRJ_DIR/request_test.h \
+         $$PRJ_DIR/sharded_handling_test.h \
+         $$PRJ_DIR/work_stealing_pool_test.h
 
 
 DISTFILES += $$PRJ_DIR/cfg_000.ini
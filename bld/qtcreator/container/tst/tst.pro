@@ -11,8 +11,11 @@ SOURCES = $$PRJ_DIR/main.cpp
 
 HEADERS = \
           $$PRJ_DIR/circular_queue_test.h \
+          $$PRJ_DIR/coalescing_queue_test.h \
           $$PRJ_DIR/cpt_test.h \
           $$PRJ_DIR/matrix_test.h \
+          $$PRJ_DIR/mpmc_queue_test.h \
+          $$PRJ_DIR/multi_level_queue_test.h \
           $$PRJ_DIR/multiply_matrix_test.h \
           $$PRJ_DIR/multiply_matrix_row_test.h \
           $$PRJ_DIR/multi_index_test.h \
@@ -35,7 +35,7 @@ concept has_add_handling_method =
                p_handling_name, std::move(p_queue),
                std::move(p_handler), p_handling_priority,
                p_num_handlers)
-         } -> std::same_as<async::dat::result>;
+         } -> std::convertible_to<async::dat::result>;
        };
 
 } // namespace tnct::async::cpt
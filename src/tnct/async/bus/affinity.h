@@ -0,0 +1,176 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_AFFINITY_H
+#define TNCT_ASYNC_BUS_AFFINITY_H
+
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "tnct/async/dat/affinity.h"
+#include "tnct/async/dat/result.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief Makes the calling thread run only in \p p_cpus
+///
+/// It is implemented only in Linux, with \p pthread_setaffinity_np, and in
+/// other systems it returns \p dat::result::ERROR_SETTING_AFFINITY.
+/// An empty \p p_cpus does not change the affinity of the thread.
+inline dat::result pin_current_thread(const dat::cpu_set &p_cpus)
+{
+  if (p_cpus.empty())
+  {
+    return dat::result::OK;
+  }
+#ifdef __linux__
+  cpu_set_t _set;
+  CPU_ZERO(&_set);
+  for (std::size_t _cpu : p_cpus)
+  {
+    if (_cpu >= CPU_SETSIZE)
+    {
+      return dat::result::ERROR_SETTING_AFFINITY;
+    }
+    CPU_SET(_cpu, &_set);
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(_set), &_set) != 0)
+  {
+    return dat::result::ERROR_SETTING_AFFINITY;
+  }
+  return dat::result::OK;
+#else
+  return dat::result::ERROR_SETTING_AFFINITY;
+#endif
+}
+
+/// \brief CPUs of the NUMA node \p p_node, as listed by Linux in
+/// \p /sys/devices/system/node/node<p_node>/cpulist
+///
+/// \return \p std::nullopt if the node does not exist, or if it is not Linux
+inline std::optional<dat::cpu_set> cpus_of_numa_node(std::size_t p_node)
+{
+  std::ifstream _file("/sys/devices/system/node/node" + std::to_string(p_node)
+                      + "/cpulist");
+  std::string   _list;
+  if (!_file || !std::getline(_file, _list))
+  {
+    return std::nullopt;
+  }
+
+  // like "0-3,8-11"
+  dat::cpu_set _cpus;
+  try
+  {
+    std::size_t _pos{0};
+    while (_pos < _list.size())
+    {
+      std::size_t       _end{_list.find(',', _pos)};
+      const std::string _range{_list.substr(
+          _pos, (_end == std::string::npos ? _list.size() : _end) - _pos)};
+
+      const std::size_t _dash{_range.find('-')};
+      const std::size_t _first{std::stoul(_range.substr(0, _dash))};
+      const std::size_t _last{_dash == std::string::npos
+                                  ? _first
+                                  : std::stoul(_range.substr(_dash + 1))};
+      for (std::size_t _cpu = _first; _cpu <= _last; ++_cpu)
+      {
+        _cpus.push_back(_cpu);
+      }
+
+      if (_end == std::string::npos)
+      {
+        break;
+      }
+      _pos = _end + 1;
+    }
+  }
+  catch (...)
+  {
+    return std::nullopt;
+  }
+  return _cpus;
+}
+
+/// \brief Calls \p p_function in a new thread that runs only in \p p_cpus,
+/// waits for it, and returns what it returns
+///
+/// Linux places a memory page in the NUMA node of the thread that touches it
+/// first, so a queue created by \p p_function, like a
+/// \p container::dat::circular_queue, has its storage in the node of
+/// \p p_cpus, which can be the CPUs of the handlers of the handling that
+/// will use it.
+///
+/// If the thread can not be pinned, \p p_function is called anyway.
+template <std::invocable t_function>
+std::invoke_result_t<t_function> call_pinned(const dat::cpu_set &p_cpus,
+                                             t_function        &&p_function)
+{
+  using result = std::invoke_result_t<t_function>;
+
+  std::exception_ptr _exception;
+  if constexpr (std::is_void_v<result>)
+  {
+    std::thread _thread(
+        [&]()
+        {
+          try
+          {
+            static_cast<void>(pin_current_thread(p_cpus));
+            p_function();
+          }
+          catch (...)
+          {
+            _exception = std::current_exception();
+          }
+        });
+    _thread.join();
+    if (_exception)
+    {
+      std::rethrow_exception(_exception);
+    }
+  }
+  else
+  {
+    std::optional<result> _result;
+    std::thread           _thread(
+        [&]()
+        {
+          try
+          {
+            static_cast<void>(pin_current_thread(p_cpus));
+            _result.emplace(p_function());
+          }
+          catch (...)
+          {
+            _exception = std::current_exception();
+          }
+        });
+    _thread.join();
+    if (_exception)
+    {
+      std::rethrow_exception(_exception);
+    }
+    return std::move(*_result);
+  }
+}
+
+} // namespace tnct::async::bus
+
+#endif
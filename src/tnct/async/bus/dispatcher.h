@@ -6,19 +6,42 @@
 #ifndef TNCT_ASYNC_DISPATCHER_H
 #define TNCT_ASYNC_DISPATCHER_H
 
+#include <coroutine>
 #include <cstring>
 #include <ctime>
 #include <functional>
+#include <iterator>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <tuple>
+#include <vector>
 
 #include "tnct/async/cpt/is_event.h"
-#include "tnct/async/cpt/is_handler.h"
+#include "tnct/async/cpt/is_any_handler.h"
+#include "tnct/async/cpt/is_event_filter.h"
+#include "tnct/async/cpt/is_key_extractor.h"
+#include "tnct/async/cpt/is_pmr_event.h"
+#include "tnct/async/dat/affinity.h"
+#include "tnct/async/dat/autoscaling.h"
+#include "tnct/async/dat/batch_size.h"
+#include "tnct/async/dat/event_pool.h"
+#include "tnct/async/dat/handling_metrics.h"
 #include "tnct/async/dat/handling_name.h"
+#include "tnct/async/bus/handle.h"
+#include "tnct/async/bus/work_stealing_pool.h"
 #include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/reply.h"
+#include "tnct/async/dat/request.h"
 #include "tnct/async/dat/result.h"
+#include "tnct/async/dat/task.h"
+#include "tnct/async/internal/bus/filtered_handling.h"
 #include "tnct/async/internal/bus/handling.h"
+#include "tnct/async/internal/bus/inline_handling.h"
+#include "tnct/async/internal/bus/sharded_handling.h"
 #include "tnct/async/internal/dat/handler_id.h"
 #include "tnct/container/cpt/queue.h"
 #include "tnct/format/bus/fmt.h"
@@ -80,10 +103,91 @@ satisfies the requirements defined by \p container::cpt::queue.
 A \p handling can have multiples instances of the \p hander type, in case each
 \p event instance can be handled independently from any other \p event.
 
+A \p handler can also be a \p async::cpt::is_batch_handler, receiving a
+\p std::span with up to a certain amount of events from the \p queue at once,
+and \p publish_batch adds many events to the queues, and only then wakes up the
+handlers, at most one per \p event, and none if they are all busy, which
+reduces the cost of synchronization per \p event.
+
 It is possible to define a \p dat::handling_priority for a \p handling, so that
 handlings that have higher priority will have the event copied to its queue
 before a handling with lower priority.
 
+By default, each \p handler runs in its own thread. If a \p work_stealing_pool
+is passed to the constructor, the \p handler objects of all the \p handling
+objects are called by tasks in the threads of the pool, and the number of
+handlers of a \p handling is the maximum number of tasks calling them at the
+same time. The \p dat::handling_priority of the \p handling is the priority of
+its tasks in the pool.
+
+A \p handling can have a maximum capacity, and a \p dat::overflow_policy, set
+by \p set_overflow_policy, that defines if publishing to a full \p handling
+blocks the publisher, drops the new event, drops the oldest event in the queue,
+or is rejected, in which case \p publish returns
+\p dat::result::ERROR_QUEUE_FULL. When publishing to many handlings, the event
+is added to all of them that accept it, and the first error is returned.
+
+A \p handling added by \p add_inline_handling has no \p queue and no thread,
+and its \p handler is called by \p publish, in the thread of the publisher.
+
+A \p handler can be a coroutine, as defined in
+\p async::cpt::is_coroutine_handler, which \p co_await a \p dat::reply, or
+\p sleep_for, and meanwhile the thread that called it handles other events.
+Likewise, a coroutine can \p co_await \p async_publish, which suspends it,
+instead of blocking the thread, while a handling with
+\p dat::overflow_policy::block is full.
+
+A \p request publishes an \p event wrapped in a \p dat::request, which carries
+a slot where the \p handler puts the reply, and returns a \p dat::reply that
+waits for it, with or without a timeout, so the publisher does not need its own
+mutex and condition variable to wait for the result of the handling.
+
+If the \p queue of a \p handling is a \p container::cpt::coalescing_queue, like
+\p container::dat::coalescing_queue, an \p event replaces the one with the same
+key that was not handled yet, so events where only the latest value matters,
+like progress reports, do not pile up in the \p queue.
+
+A \p handling can have a filter, passed to \p add_handling, that \p publish
+calls before copying the event to the \p handling, so a \p handling interested
+in a few of the events of a type does not pay for a copy, a place in its
+\p queue and a wake up of its handlers for each event it would throw away.
+
+A \p handling added by \p add_sharded_handling spreads the events over many
+queues, each with one \p handler, by a key taken from the \p event, like the id
+of a sensor, so events with the same key are handled in the order they were
+published, while events with different keys are handled in parallel.
+
+A \p handling added with a \p dat::autoscaling policy starts and retires
+handler threads, one at a time, between a minimum and a maximum: it grows when
+events pile up in its \p queue, and shrinks when its handlers are mostly idle,
+after a few evaluations in a row agree, so a short burst does not make it
+oscillate.
+
+The handler threads of a \p handling added with a \p dat::affinity run only in
+the CPUs it defines, for all of them or for each one, so, on a machine with
+many NUMA nodes, they can stay in the node where their \p queue was created
+by \p bus::call_pinned, with no traffic between the nodes.
+
+A \p handling added with a \p dat::event_pool keeps its events, and the strings
+and vectors inside them, in its own memory, reused as events are handled, if
+the event is an \p async::cpt::is_pmr_event, so publishing does not allocate
+from the global heap, shared by all the threads. An event built with the
+memory returned by \p get_event_pool is moved to the \p handling with no copy.
+
+The \p add_handling, \p add_inline_handling and \p add_sharded_handling
+methods return a \p handle, which converts to the \p dat::result of adding
+the \p handling, and which \p get_num_events, \p get_events_capacity,
+\p get_amount_handlers, \p clear, \p increment_handlers, \p stop and
+\p remove_handling accept instead of its name, so they reach the \p handling
+directly, with no search, and can be called often, like by a loop that
+monitors the queues. A \p handle is no longer valid after its \p handling is
+removed, or after the dispatcher is destroyed.
+
+Each \p handling records, without locks, how many events were published,
+handled, dropped and rejected, the high water mark of its queue, histograms of
+the time events wait in the queue and of the time the handlers take, and how
+long each handler was busy, which \p get_metrics returns.
+
 Please, take a look at the tests and examples for more information on how to use
 the dispatcher class.
 */
@@ -96,12 +200,27 @@ public:
   using events = std::tuple<t_events...>;
   using logger = t_logger;
 
+  /// \brief Maximum amount of events passed at once to a batch handler, if
+  /// not informed in \p add_handling
+  static constexpr std::size_t default_batch_size{dat::default_batch_size};
+
+  /// \brief Refers to a handling of \p t_event added to this dispatcher
+  template <async::cpt::is_event t_event>
+  using handle = bus::handle<t_event>;
+
   dispatcher() = delete;
 
   dispatcher(logger &p_logger) : m_logger(p_logger)
   {
   }
 
+  /// \brief The handlers will be called in the threads of \p p_pool, which
+  /// must live longer than the dispatcher
+  dispatcher(logger &p_logger, work_stealing_pool<logger> &p_pool)
+      : m_logger(p_logger), m_pool(&p_pool)
+  {
+  }
+
   dispatcher(const dispatcher &) = delete;
   dispatcher(dispatcher &&)      = delete;
 
@@ -109,6 +228,9 @@ public:
   {
     TNCT_LOG_TRA(m_logger, "dispatcher destructor");
     stop();
+    // coroutine handlers waiting for replies to requests still in the queues
+    // are resumed, so the handlings do not wait for them forever
+    clear();
   }
 
   dispatcher &operator=(const dispatcher &) = delete;
@@ -120,7 +242,9 @@ public:
   void operator delete(void *)   = delete;
   void operator delete[](void *) = delete;
 
+  /// \brief Publishes a copy of \p p_event to each handling of \p t_event
   template <async::cpt::is_event t_event>
+  requires std::copy_constructible<t_event>
   [[nodiscard]] dat::result publish(const t_event &p_event) noexcept
   {
 
@@ -130,17 +254,81 @@ public:
     {
       handlings<t_event> &_handlings{get_handlings<t_event>()};
 
+      dat::result _result{dat::result::OK};
       for (auto &_value : _handlings)
       {
-        _value.second->add_event(p_event);
+        if (!_value.second->is_stopped() && _value.second->accepts(p_event))
+        {
+          merge(_result,
+                _value.second->add_event(_value.second->copy_event(p_event)));
+        }
       }
+      return _result;
     }
     catch (std::exception &_ex)
     {
       TNCT_LOG_ERR(m_logger, _ex.what());
-      return dat::result::ERROR_PUBLISHNG;
     }
-    return dat::result::OK;
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  /// \brief Publishes a copy of each event in \p p_events to each handling of
+  /// \p t_event, waking up the handlers of a handling, at most one per event,
+  /// only after all the events are in its queue
+  template <async::cpt::is_event t_event>
+  requires std::copy_constructible<t_event>
+  [[nodiscard]] dat::result
+  publish_batch(std::span<const t_event> p_events) noexcept
+  {
+
+    check_if_event_is_in_events_tupĺe<t_event>();
+
+    if (p_events.empty())
+    {
+      return dat::result::OK;
+    }
+
+    try
+    {
+      handlings<t_event> &_handlings{get_handlings<t_event>()};
+
+      dat::result _result{dat::result::OK};
+      for (auto &_value : _handlings)
+      {
+        if (!_value.second->is_stopped())
+        {
+          merge(_result, _value.second->add_events(p_events));
+        }
+      }
+      return _result;
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  /// \brief Publishes \p p_event, which is moved to the last handling of
+  /// \p t_event, and copied only to the others
+  ///
+  /// A move-only \p t_event can only be published if there is at most one
+  /// handling for it
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] dat::result publish(t_event &&p_event) noexcept
+  {
+
+    check_if_event_is_in_events_tupĺe<t_event>();
+
+    try
+    {
+      return fan_out(std::move(p_event));
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
   }
 
   template <async::cpt::is_event t_event, typename... t_event_params>
@@ -151,35 +339,336 @@ public:
 
     try
     {
-      handlings<t_event> &_handlings{get_handlings<t_event>()};
+      return fan_out(t_event{std::forward<t_event_params>(p_params)...});
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  /// \brief Publishes \p p_event, like \p publish, but when a handling with
+  /// \p dat::overflow_policy::block is full, the coroutine that awaits the
+  /// returned \p dat::task is suspended, instead of the thread
+  ///
+  /// The coroutine is resumed by the thread that takes an event from the
+  /// handling, or that stops or clears it
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] dat::task<dat::result> async_publish(t_event p_event)
+  {
+    check_if_event_is_in_events_tupĺe<t_event>();
 
-      const t_event _event{std::forward<t_event_params>(p_params)...};
+    dat::result _result{dat::result::OK};
+    try
+    {
+      handlings<t_event> &_handlings{get_handlings<t_event>()};
+      if (_handlings.empty())
+      {
+        co_return _result;
+      }
 
+      std::vector<handling<t_event> *> _accepting;
       for (auto &_value : _handlings)
       {
-        _value.second->add_event(_event);
+        if (!_value.second->is_stopped() && _value.second->accepts(p_event))
+        {
+          _accepting.push_back(_value.second.get());
+        }
+      }
+
+      if constexpr (!std::copy_constructible<t_event>)
+      {
+        if (_accepting.size() > 1)
+        {
+          TNCT_LOG_ERR(m_logger,
+                       format::bus::fmt("event '", typeid(t_event).name(),
+                                        "' can not be copied to more than one "
+                                        "handling"));
+          co_return dat::result::ERROR_PUBLISHNG;
+        }
+      }
+
+      for (std::size_t _i = 0; _i < _accepting.size(); ++_i)
+      {
+        handling<t_event> &_handling{*_accepting[_i]};
+
+        std::optional<t_event> _event;
+        if constexpr (std::copy_constructible<t_event>)
+        {
+          if (_i == (_accepting.size() - 1))
+          {
+            _event.emplace(std::move(p_event));
+          }
+          else
+          {
+            _event.emplace(p_event);
+          }
+        }
+        else
+        {
+          _event.emplace(std::move(p_event));
+        }
+
+        while (true)
+        {
+          if (const std::optional<dat::result> _added{
+                  _handling.try_add_event(std::move(*_event))})
+          {
+            merge(_result, *_added);
+            break;
+          }
+          co_await space_awaiter<t_event>{_handling, *_event};
+        }
       }
     }
     catch (std::exception &_ex)
     {
       TNCT_LOG_ERR(m_logger, _ex.what());
-      return dat::result::ERROR_PUBLISHNG;
+      co_return dat::result::ERROR_PUBLISHNG;
     }
-    return dat::result::OK;
+    co_return _result;
+  }
+
+  /// \brief Publishes \p p_event in a \p dat::request<t_event, t_reply>, and
+  /// returns the \p dat::reply that the handler of the request fulfils
+  ///
+  /// The reply is empty, and does not block, if there is no handling for the
+  /// request, or if no handler replied to it
+  template <std::movable t_reply, async::cpt::is_event t_event>
+  [[nodiscard]] dat::reply<t_reply> request(t_event p_event) noexcept
+  {
+    using request_event = dat::request<t_event, t_reply>;
+
+    check_if_event_is_in_events_tupĺe<request_event>();
+
+    std::shared_ptr<typename request_event::slot> _slot;
+    try
+    {
+      _slot = std::make_shared<typename request_event::slot>();
+
+      if (const dat::result _result{
+              fan_out(request_event{std::move(p_event), _slot})};
+          _result != dat::result::OK)
+      {
+        TNCT_LOG_ERR(m_logger,
+                     format::bus::fmt("error publishing request '",
+                                      typeid(t_event).name(), "': ", _result));
+      }
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::reply<t_reply>{std::move(_slot)};
   }
 
-  template <async::cpt::is_event            t_event,
-            container::cpt::queue<t_event>  t_handling_queue,
-            async::cpt::is_handler<t_event> t_handler>
-  dat::result add_handling(
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler, if it is a \p async::cpt::is_batch_handler
+  template <async::cpt::is_event                t_event,
+            container::cpt::queue<t_event>      t_handling_queue,
+            async::cpt::is_any_handler<t_event> t_handler>
+  handle<t_event> add_handling(
       const dat::handling_name &p_id, t_handling_queue &&p_queue,
       t_handler            &&p_handler,
       dat::handling_priority p_priority    = dat::handling_priority::medium,
-      std::size_t            p_num_handler = 1)
+      std::size_t            p_num_handler = 1,
+      std::size_t            p_batch_size  = default_batch_size)
   {
     return add_handling<t_event, t_handler, t_handling_queue>(
         p_id, std::move(p_handler), std::move(p_queue), p_num_handler,
-        p_priority);
+        p_priority, p_batch_size);
+  }
+
+  /// \brief Adds a handling that only receives the events \p p_filter accepts
+  ///
+  /// \p p_filter is called by \p publish, in the thread of the publisher,
+  /// before the event is copied to the handling, so it should be fast, and if
+  /// events are published by many threads, it is called by all of them at the
+  /// same time
+  ///
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler, if it is a \p async::cpt::is_batch_handler
+  template <async::cpt::is_event                 t_event,
+            container::cpt::queue<t_event>       t_handling_queue,
+            async::cpt::is_any_handler<t_event>  t_handler,
+            async::cpt::is_event_filter<t_event> t_filter>
+  handle<t_event> add_handling(
+      const dat::handling_name &p_id, t_handling_queue &&p_queue,
+      t_handler &&p_handler, t_filter &&p_filter,
+      dat::handling_priority p_priority    = dat::handling_priority::medium,
+      std::size_t            p_num_handler = 1,
+      std::size_t            p_batch_size  = default_batch_size)
+  {
+    using handling_concrete =
+        internal::bus::handling_concrete<t_logger, t_event, t_handling_queue,
+                                         t_handler>;
+
+    using filtered_handling =
+        internal::bus::filtered_handling<t_event, handling_concrete, t_filter>;
+
+    return emplace_handling<t_event, t_handler, filtered_handling>(
+        p_priority, std::move(p_filter), p_id, m_logger, std::move(p_handler),
+        std::move(p_queue), p_num_handler, m_pool, p_priority, p_batch_size);
+  }
+
+  /// \brief Adds a handling whose handler threads run only in the CPUs
+  /// defined in \p p_affinity
+  ///
+  /// It is not possible if the handlers are called in the threads of a pool.
+  /// To have the storage of \p p_queue in the same NUMA node of the handlers,
+  /// create it with \p bus::call_pinned, using the same CPUs.
+  ///
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler, if it is a \p async::cpt::is_batch_handler
+  template <async::cpt::is_event                t_event,
+            container::cpt::queue<t_event>      t_handling_queue,
+            async::cpt::is_any_handler<t_event> t_handler>
+  handle<t_event> add_handling(
+      const dat::handling_name &p_id, t_handling_queue &&p_queue,
+      t_handler &&p_handler, const dat::affinity &p_affinity,
+      dat::handling_priority p_priority    = dat::handling_priority::medium,
+      std::size_t            p_num_handler = 1,
+      std::size_t            p_batch_size  = default_batch_size)
+  {
+    if (m_pool != nullptr)
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("handling ", p_id,
+                                    " can not have an affinity, as the "
+                                    "handlers are called in the threads of a "
+                                    "pool"));
+      return handle<t_event>{dat::result::ERROR_ADDING_HANDLER};
+    }
+
+    using handling_concrete =
+        internal::bus::handling_concrete<t_logger, t_event, t_handling_queue,
+                                         t_handler>;
+
+    return emplace_handling<t_event, t_handler, handling_concrete>(
+        p_priority, p_id, m_logger, std::move(p_handler), std::move(p_queue),
+        p_num_handler, m_pool, p_priority, p_batch_size,
+        std::optional<dat::autoscaling>{}, p_affinity);
+  }
+
+  /// \brief Adds a handling whose events are kept in the memory defined in
+  /// \p p_event_pool, including what they allocate, which is reused when an
+  /// event is destroyed after it is handled
+  ///
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler, if it is a \p async::cpt::is_batch_handler
+  template <async::cpt::is_pmr_event            t_event,
+            container::cpt::queue<t_event>      t_handling_queue,
+            async::cpt::is_any_handler<t_event> t_handler>
+  handle<t_event> add_handling(
+      const dat::handling_name &p_id, t_handling_queue &&p_queue,
+      t_handler &&p_handler, const dat::event_pool &p_event_pool,
+      dat::handling_priority p_priority    = dat::handling_priority::medium,
+      std::size_t            p_num_handler = 1,
+      std::size_t            p_batch_size  = default_batch_size)
+  {
+    using handling_concrete =
+        internal::bus::handling_concrete<t_logger, t_event, t_handling_queue,
+                                         t_handler>;
+
+    return emplace_handling<t_event, t_handler, handling_concrete>(
+        p_priority, p_id, m_logger, std::move(p_handler), std::move(p_queue),
+        p_num_handler, m_pool, p_priority, p_batch_size,
+        std::optional<dat::autoscaling>{}, dat::affinity{},
+        std::optional<dat::event_pool>{p_event_pool});
+  }
+
+  /// \brief Adds a handling whose amount of handler threads changes between
+  /// \p p_autoscaling.min_handlers and \p p_autoscaling.max_handlers, as the
+  /// amount of events in its queue, and how busy the handlers are, change
+  ///
+  /// It starts with \p p_autoscaling.min_handlers handlers, and it is not
+  /// possible if the handlers are called in the threads of a pool
+  ///
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler, if it is a \p async::cpt::is_batch_handler
+  template <async::cpt::is_event                t_event,
+            container::cpt::queue<t_event>      t_handling_queue,
+            async::cpt::is_any_handler<t_event> t_handler>
+  handle<t_event> add_handling(
+      const dat::handling_name &p_id, t_handling_queue &&p_queue,
+      t_handler &&p_handler, const dat::autoscaling &p_autoscaling,
+      dat::handling_priority p_priority   = dat::handling_priority::medium,
+      std::size_t            p_batch_size = default_batch_size)
+  {
+    if (m_pool != nullptr)
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("handling ", p_id,
+                                    " can not autoscale, as the handlers are "
+                                    "called in the threads of a pool"));
+      return handle<t_event>{dat::result::ERROR_ADDING_HANDLER};
+    }
+
+    using handling_concrete =
+        internal::bus::handling_concrete<t_logger, t_event, t_handling_queue,
+                                         t_handler>;
+
+    return emplace_handling<t_event, t_handler, handling_concrete>(
+        p_priority, p_id, m_logger, std::move(p_handler), std::move(p_queue),
+        p_autoscaling.min_handlers, m_pool, p_priority, p_batch_size,
+        std::optional<dat::autoscaling>{p_autoscaling});
+  }
+
+  /// \brief Adds a handling whose \p p_handler is called in the thread that
+  /// publishes the event, during \p publish, with no queue and no thread
+  ///
+  /// It is meant for handlers that take less time than adding the event to a
+  /// queue and waking up a handler thread. If events are published by many
+  /// threads, \p p_handler is called by all of them at the same time.
+  ///
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler by \p publish_batch, if it is a
+  /// \p async::cpt::is_batch_handler
+  template <async::cpt::is_event                t_event,
+            async::cpt::is_any_handler<t_event> t_handler>
+  handle<t_event> add_inline_handling(
+      const dat::handling_name &p_id, t_handler &&p_handler,
+      dat::handling_priority p_priority   = dat::handling_priority::medium,
+      std::size_t            p_batch_size = default_batch_size)
+  {
+    using inline_handling =
+        internal::bus::inline_handling<t_logger, t_event, t_handler>;
+
+    return emplace_handling<t_event, t_handler, inline_handling>(
+        p_priority, p_id, m_logger, std::move(p_handler), p_batch_size);
+  }
+
+  /// \brief Adds a handling whose events are spread over \p p_num_shards
+  /// queues, each with one handler, by the key \p p_key_extractor returns
+  ///
+  /// Events with the same key are always handled by the same handler, in the
+  /// order they were published, while events with different keys can be
+  /// handled at the same time
+  ///
+  /// \p p_queue and \p p_handler are copied to each shard, and the maximum
+  /// capacity defined in \p set_overflow_policy is the one of each shard
+  template <async::cpt::is_event                  t_event,
+            container::cpt::queue<t_event>        t_handling_queue,
+            async::cpt::is_any_handler<t_event>   t_handler,
+            async::cpt::is_key_extractor<t_event> t_key_extractor>
+  requires(std::copy_constructible<t_handling_queue>
+           && std::copy_constructible<t_handler>)
+  handle<t_event> add_sharded_handling(
+      const dat::handling_name &p_id, t_handling_queue &&p_queue,
+      t_handler &&p_handler, t_key_extractor &&p_key_extractor,
+      std::size_t            p_num_shards,
+      dat::handling_priority p_priority   = dat::handling_priority::medium,
+      std::size_t            p_batch_size = default_batch_size)
+  {
+    using sharded_handling =
+        internal::bus::sharded_handling<t_logger, t_event, t_handling_queue,
+                                        t_handler, t_key_extractor>;
+
+    return emplace_handling<t_event, t_handler, sharded_handling>(
+        p_priority, p_id, m_logger, std::move(p_handler), std::move(p_queue),
+        std::move(p_key_extractor), p_num_shards, m_pool, p_priority,
+        p_batch_size);
   }
 
   /// \brief Clears the events queue of all handlings of an is_event
@@ -229,6 +718,45 @@ public:
     return dat::result::OK;
   }
 
+  /// \brief Defines what happens when an event is published to a handling
+  /// that already has \p p_max_capacity events
+  ///
+  /// By default, a handling has no maximum capacity, and its queue grows as
+  /// needed, like \p dat::overflow_policy::grow. If \p p_max_capacity is 0, the
+  /// handling has no maximum capacity, whatever \p p_policy is.
+  ///
+  /// \attention A handling with \p dat::overflow_policy::block may block the
+  /// thread that publishes the event until a handler takes an event from the
+  /// queue, so if that thread is a worker of the \p work_stealing_pool used by
+  /// the handling, and all the workers are blocked, there will be a deadlock
+  template <async::cpt::is_event t_event>
+  dat::result set_overflow_policy(const dat::handling_name &p_handling_name,
+                                  dat::overflow_policy      p_policy,
+                                  std::size_t               p_max_capacity)
+  {
+    check_if_event_is_in_events_tupĺe<t_event>();
+    try
+    {
+      auto _set{[&](handling<t_event> &p_handling)
+                { p_handling.set_overflow_policy(p_policy, p_max_capacity); }};
+
+      if (!find_handling<t_event>(p_handling_name, _set))
+      {
+        TNCT_LOG_ERR(m_logger,
+                     format::bus::fmt("Could not find handling ",
+                                      p_handling_name, " in event ",
+                                      typeid(t_event).name()));
+        return dat::result::HANDLING_NOT_FOUND;
+      }
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+      return dat::result::ERROR_UNKNOWN;
+    }
+    return dat::result::OK;
+  }
+
   /// \brief Clears the events queue of all handlings of all events
   dat::result clear()
   {
@@ -280,6 +808,84 @@ public:
     return std::nullopt;
   }
 
+  /// \brief Evaluates now the \p dat::autoscaling policy of a handling of
+  /// \p t_event, besides the evaluations at each \p dat::autoscaling::interval
+  ///
+  /// \return \p std::nullopt if the handling does not exist, or has no
+  /// autoscaling policy
+  template <async::cpt::is_event t_event>
+  std::optional<dat::autoscaling_decision>
+  autoscale(const dat::handling_name &p_handling_name) noexcept
+  {
+    check_if_event_is_in_events_tupĺe<t_event>();
+    try
+    {
+      std::optional<dat::autoscaling_decision> _decision;
+      if (find_handling<t_event>(p_handling_name,
+                                 [&](handling<t_event> &p_handling)
+                                 { _decision = p_handling.autoscale(); }))
+      {
+        return _decision;
+      }
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return std::nullopt;
+  }
+
+  /// \brief Memory where a handling of \p t_event keeps its events, so an
+  /// event can be built with it, and published with no copy
+  ///
+  /// \return \p nullptr if the handling does not exist, or has no
+  /// \p dat::event_pool
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] std::pmr::memory_resource *
+  get_event_pool(const dat::handling_name &p_handling_name) const noexcept
+  {
+    check_if_event_is_in_events_tupĺe<t_event>();
+    try
+    {
+      std::pmr::memory_resource *_pool{nullptr};
+      find_handling<t_event>(p_handling_name,
+                             [&](const handling<t_event> &p_handling)
+                             { _pool = p_handling.get_event_pool(); });
+      return _pool;
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return nullptr;
+  }
+
+  /// \brief Snapshot of the metrics of a handling of \p t_event
+  ///
+  /// The metrics are recorded without locks, and reading them does not stop
+  /// the publishing or the handling of events
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] std::optional<dat::handling_metrics>
+  get_metrics(const dat::handling_name &p_handling_name) const noexcept
+  {
+    check_if_event_is_in_events_tupĺe<t_event>();
+    try
+    {
+      std::optional<dat::handling_metrics> _metrics;
+      if (find_handling<t_event>(p_handling_name,
+                                 [&](const handling<t_event> &p_handling)
+                                 { _metrics = p_handling.get_metrics(); }))
+      {
+        return _metrics;
+      }
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return std::nullopt;
+  }
+
   template <async::cpt::is_event t_event>
   [[nodiscard]] std::optional<size_t>
   get_num_events(const dat::handling_name &p_handling_name) const noexcept
@@ -324,15 +930,170 @@ public:
     return std::nullopt;
   }
 
+  /// \brief Amount of events in the queue of the handling of \p p_handle,
+  /// with no search and no lock of the dispatcher, so it can be polled while
+  /// events are published
+  ///
+  /// \return \p std::nullopt if \p p_handle is not valid, which includes a
+  /// handling that was removed, or if it is of another dispatcher
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] std::optional<size_t>
+  get_num_events(const handle<t_event> &p_handle) const noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return std::nullopt;
+    }
+    return {_handling->get_num_events()};
+  }
+
+  /// \return \p std::nullopt if \p p_handle is not valid, or if it is of
+  /// another dispatcher
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] std::optional<size_t>
+  get_events_capacity(const handle<t_event> &p_handle) const noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return std::nullopt;
+    }
+    return {_handling->get_events_capacity()};
+  }
+
+  /// \return \p std::nullopt if \p p_handle is not valid, or if it is of
+  /// another dispatcher
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] std::optional<size_t>
+  get_amount_handlers(const handle<t_event> &p_handle) const noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return std::nullopt;
+    }
+    return {_handling->get_amount_handlers()};
+  }
+
+  /// \brief Clears the events queue of the handling of \p p_handle
+  template <async::cpt::is_event t_event>
+  dat::result clear(const handle<t_event> &p_handle) noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return dat::result::HANDLING_NOT_FOUND;
+    }
+    try
+    {
+      _handling->clear();
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+      return dat::result::ERROR_CLEARING;
+    }
+    return dat::result::OK;
+  }
+
+  /// \brief Starts \p p_num_handlers more handlers in the handling of
+  /// \p p_handle, which must have been added with a \p dat::autoscaling
+  /// policy, up to its maximum
+  ///
+  /// The handlers may be retired later by the policy, if they are mostly
+  /// idle
+  template <async::cpt::is_event t_event>
+  dat::result increment_handlers(const handle<t_event> &p_handle,
+                                 std::size_t            p_num_handlers) noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return dat::result::HANDLING_NOT_FOUND;
+    }
+    try
+    {
+      return _handling->increment_handlers(p_num_handlers);
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_ADDING_HANDLER;
+  }
+
+  /// \brief Stops the handlers of the handling of \p p_handle, which does not
+  /// receive events published after that
+  ///
+  /// The events still in its queue are not handled
+  template <async::cpt::is_event t_event>
+  dat::result stop(const handle<t_event> &p_handle) noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return dat::result::HANDLING_NOT_FOUND;
+    }
+    try
+    {
+      _handling->stop();
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+      return dat::result::ERROR_STOPPING;
+    }
+    return dat::result::OK;
+  }
+
+  /// \brief Stops the handling of \p p_handle, and removes it from the
+  /// dispatcher, after which \p p_handle, and any copy of it, is no longer
+  /// valid
+  ///
+  /// \attention Like adding a handling, removing it must not happen while
+  /// other threads publish events of \p t_event, as the handlings are
+  /// traversed by \p publish with no lock
+  template <async::cpt::is_event t_event>
+  dat::result remove_handling(const handle<t_event> &p_handle) noexcept
+  {
+    const handling_ptr<t_event> _handling{find_handling(p_handle)};
+    if (!_handling)
+    {
+      return dat::result::HANDLING_NOT_FOUND;
+    }
+    try
+    {
+      _handling->stop();
+
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      handlings<t_event>         &_handlings{get_handlings<t_event>()};
+      for (auto _ite = _handlings.begin(); _ite != _handlings.end(); ++_ite)
+      {
+        if (_ite->second == _handling)
+        {
+          _handlings.erase(_ite);
+          return dat::result::OK;
+        }
+      }
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+      return dat::result::ERROR_STOPPING;
+    }
+    return dat::result::HANDLING_NOT_FOUND;
+  }
+
 private:
   template <async::cpt::is_event t_event>
   using handling = internal::bus::handling<t_event>;
 
   template <async::cpt::is_event t_event>
-  using handling_ptr = std::unique_ptr<handling<t_event>>;
+  using handling_ptr = std::shared_ptr<handling<t_event>>;
 
   template <async::cpt::is_event t_event>
-  using handling_const_ptr = std::unique_ptr<const handling<t_event>>;
+  using handling_const_ptr = std::shared_ptr<const handling<t_event>>;
 
   template <async::cpt::is_event t_event>
   using handlings =
@@ -390,31 +1151,8 @@ private:
     return dat::result::OK;
   }
 
-  // template <async::cpt::event t_event>
-  // dat::result stop(handling_id p_handling_id) noexcept {
-  //   event_is_in_events_tupĺe<t_event>();
-  //   try {
-  //     TNCT_LOG_TRA(m_logger, format::bus::fmt("t_event = ",
-  //     typeid(t_event).name())); auto _stopper{[](handling<t_event>
-  //     &p_handling) { p_handling.stop(); }};
-
-  //     if (!find_handling<t_event>(p_handling_id, _stopper)) {
-  //       TNCT_LOG_ERR(m_logger,
-  //                    format::bus::fmt("Could not find handling ",
-  //                    p_handling_id,
-  //                                " in event ", typeid(t_event).name()));
-  //       return dat::result::HANDLING_NOT_FOUND;
-  //     }
-
-  //   } catch (std::exception &_ex) {
-  //     TNCT_LOG_ERR(m_logger, _ex.what());
-  //     return dat::result::ERROR_STOPPING;
-  //   }
-  //   return dat::result::OK;
-  // }
-
-  template <async::cpt::is_event            t_event,
-            async::cpt::is_handler<t_event> t_handler>
+  template <async::cpt::is_event                t_event,
+            async::cpt::is_any_handler<t_event> t_handler>
   [[nodiscard]] bool is_handler_already_being_used() const
   {
 
@@ -444,6 +1182,85 @@ private:
     return false;
   }
 
+  // Copies \p p_event to all the handlings that accept it but the last, to
+  // which it is moved, skipping the stopped ones
+  template <async::cpt::is_event t_event>
+  dat::result fan_out(t_event &&p_event)
+  {
+    handlings<t_event> &_handlings{get_handlings<t_event>()};
+
+    dat::result _result{dat::result::OK};
+
+    // the event is copied to a handling that accepts it only when another one
+    // that also accepts it is found, so the filter of each handling is called
+    // once, and the event is moved to the last one
+    handling<t_event> *_pending{nullptr};
+    for (auto &_value : _handlings)
+    {
+      if (_value.second->is_stopped() || !_value.second->accepts(p_event))
+      {
+        continue;
+      }
+
+      if (_pending != nullptr)
+      {
+        if constexpr (std::copy_constructible<t_event>)
+        {
+          merge(_result, _pending->add_event(_pending->copy_event(p_event)));
+        }
+        else
+        {
+          TNCT_LOG_ERR(m_logger,
+                       format::bus::fmt("event '", typeid(t_event).name(),
+                                        "' can not be copied to more than one "
+                                        "handling"));
+          return dat::result::ERROR_PUBLISHNG;
+        }
+      }
+      _pending = _value.second.get();
+    }
+
+    if (_pending != nullptr)
+    {
+      merge(_result, _pending->add_event(std::move(p_event)));
+    }
+
+    return _result;
+  }
+
+  // Suspends the coroutine of 'async_publish' until there may be space in
+  // 'handling' for 'event'
+  template <async::cpt::is_event t_event>
+  struct space_awaiter
+  {
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> p_awaiting)
+    {
+      return m_handling.resume_on_space(m_event, p_awaiting);
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+
+    handling<t_event> &m_handling;
+    const t_event     &m_event;
+  };
+
+  // Keeps in \p p_result the first error of the handlings of an event, as the
+  // event is still added to the other handlings
+  static void merge(dat::result &p_result, dat::result p_handling_result)
+  {
+    if (p_result == dat::result::OK)
+    {
+      p_result = p_handling_result;
+    }
+  }
+
   template <async::cpt::is_event t_event>
   [[nodiscard]] static constexpr std::size_t get_handlings_index()
   {
@@ -534,6 +1351,23 @@ private:
     return false;
   }
 
+  // The handling \p p_handle refers to, or \p nullptr if it was removed, or
+  // if \p p_handle is not of this dispatcher
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] handling_ptr<t_event>
+  find_handling(const handle<t_event> &p_handle) const
+  {
+    handling_ptr<t_event> _handling{p_handle.lock(this)};
+    if (!_handling)
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("handle of a handling of '",
+                                    typeid(t_event).name(),
+                                    "' is not valid in this dispatcher"));
+    }
+    return _handling;
+  }
+
   template <async::cpt::is_event t_event>
   static constexpr void check_if_event_is_in_events_tupĺe()
   {
@@ -541,45 +1375,57 @@ private:
                   "event is not in the 't_events...' of the dispatcher");
   }
 
-  template <async::cpt::is_event            t_event,
-            async::cpt::is_handler<t_event> t_handler,
-            container::cpt::queue<t_event>  t_queue>
-  dat::result add_handling(const dat::handling_name &p_handling_id,
-                           t_handler &&p_handler, t_queue &&p_queue,
-                           size_t                 p_num_handlers,
-                           dat::handling_priority p_handling_priority =
-                               dat::handling_priority::medium)
+  template <async::cpt::is_event                t_event,
+            async::cpt::is_any_handler<t_event> t_handler,
+            container::cpt::queue<t_event>      t_queue>
+  handle<t_event> add_handling(const dat::handling_name &p_handling_id,
+                               t_handler &&p_handler, t_queue &&p_queue,
+                               size_t                 p_num_handlers,
+                               dat::handling_priority p_handling_priority =
+                                   dat::handling_priority::medium,
+                               std::size_t p_batch_size = default_batch_size)
+  {
+    using handling_concrete =
+        internal::bus::handling_concrete<t_logger, t_event, t_queue, t_handler>;
+
+    return emplace_handling<t_event, t_handler, handling_concrete>(
+        p_handling_priority, p_handling_id, m_logger, std::move(p_handler),
+        std::move(p_queue), p_num_handlers, m_pool, p_handling_priority,
+        p_batch_size);
+  }
+
+  // Creates a \p t_handling with \p p_params, and inserts it in the handlings
+  // of \p t_event, if \p t_handler is not used by other handling
+  template <async::cpt::is_event t_event, typename t_handler,
+            typename t_handling, typename... t_params>
+  handle<t_event> emplace_handling(dat::handling_priority p_handling_priority,
+                                   t_params &&...p_params)
   {
 
     check_if_event_is_in_events_tupĺe<t_event>();
 
     if (is_handler_already_being_used<t_event, t_handler>())
     {
-      return dat::result::ERROR_HANDLER_ALREADY_IN_USE;
+      return handle<t_event>{dat::result::ERROR_HANDLER_ALREADY_IN_USE};
     }
 
-    using handling_concrete =
-        internal::bus::handling_concrete<t_logger, t_event, t_queue, t_handler>;
-
     try
     {
       std::lock_guard<std::mutex> _lock(m_mutex);
 
-      handling_ptr<t_event> _handling_ptr{std::make_unique<handling_concrete>(
-          p_handling_id, m_logger, std::move(p_handler), std::move(p_queue),
-          p_num_handlers)};
+      handling_ptr<t_event> _handling_ptr{
+          std::make_shared<t_handling>(std::forward<t_params>(p_params)...)};
 
-      get_handlings<t_event>().insert(
-          {p_handling_priority, std::move(_handling_ptr)});
+      get_handlings<t_event>().insert({p_handling_priority, _handling_ptr});
 
-      return dat::result::OK;
+      return handle<t_event>{this, _handling_ptr};
     }
     catch (std::exception &_ex)
     {
       TNCT_LOG_ERR(m_logger, _ex.what());
     }
 
-    return dat::result::ERROR_UNKNOWN;
+    return handle<t_event>{dat::result::ERROR_UNKNOWN};
   }
 
 private:
@@ -587,6 +1433,9 @@ private:
 
   events_handlings m_events_handlings;
 
+  // if not null, where the handlers are called
+  work_stealing_pool<logger> *m_pool{nullptr};
+
   std::mutex m_mutex;
 };
 
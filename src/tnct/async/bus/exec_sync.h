@@ -6,31 +6,74 @@
 #ifndef TNCT_ASYNC_EXEC_SYNC_H
 #define TNCT_ASYNC_EXEC_SYNC_H
 
+#include <chrono>
 #include <condition_variable>
+#include <exception>
 #include <functional>
+#include <mutex>
 #include <optional>
+#include <stop_token>
+#include <type_traits>
 
+#include "tnct/async/internal/bus/exec_pool.h"
 #include "tnct/time/cpt/chrono_convertible.h"
 
 namespace tnct::async
 {
 
+namespace internal::bus
+{
+
+// If \p t_function receives a \p std::stop_token, or a
+// \p std::function<bool()>, as its first parameter
+template <typename t_function, typename... t_params>
+inline constexpr bool receives_stop_token{
+    std::is_invocable_v<t_function &, std::stop_token, t_params...>};
+
+template <typename t_function, typename... t_params>
+using exec_sync_function_result = std::conditional_t<
+    receives_stop_token<t_function, t_params...>,
+    std::invoke_result<t_function &, std::stop_token, t_params...>,
+    std::invoke_result<t_function &, std::function<bool()>, t_params...>>::type;
+
+template <typename t_function, typename... t_params>
+using exec_sync_result = std::conditional_t<
+    // if 't_function' return type is 'void'
+    std::is_void_v<exec_sync_function_result<t_function, t_params...>>,
+    // the 'execute' wrapper will return 'bool', which will be 'true' if the
+    // 'p_function' executes in less 'p_max_time', or 'false' otherwise
+    bool,
+    // else it will return a 'std::optional' with the return type of
+    // 't_function', which will contain a value of that type, if the
+    // 'p_function' executes in less 'p_max_time', or empty otherwise
+    std::optional<exec_sync_function_result<t_function, t_params...>>>;
+
+} // namespace internal::bus
+
 /// \brief Executes a function synchronoulsy with timeout control
 /// The function may or may not return, and may or may not receive parameters
 ///
 /// \tparam t_function the function to be executed. It may not return, as
 ///
-/// <tt>void t_function(std::function<bool()> p_timeout, t_params...
-/// p_params)</tt> or it may return, as in
+/// <tt>void t_function(std::stop_token p_stop, t_params... p_params)</tt> or
+/// it may return, as in
 ///
-/// <tt>some-ret t_function(std::function<bool()> p_timeout, t_params...
-/// p_params)</tt>
+/// <tt>some-ret t_function(std::stop_token p_stop, t_params... p_params)</tt>
 ///
-/// where <tt>p_timeout</tt> informs that the function has exceeded the maximum
-/// time of execution, and can stop executing
+/// where a stop is requested in <tt>p_stop</tt> when the function has exceeded
+/// the maximum time of execution, so it can stop executing
 ///
-/// So, \p t_function should eventually call for <tt>p_timeout()</tt> to decide
-/// if it must continue to exec_sync
+/// So, \p t_function should eventually check
+/// <tt>p_stop.stop_requested()</tt>, or register a \p std::stop_callback, to
+/// decide if it must continue to execute
+///
+/// The first parameter can also be a <tt>std::function<bool()> p_timeout</tt>,
+/// which returns \p true when the function has exceeded the maximum time
+///
+/// The function is executed in a thread of a pool, which is reused by the next
+/// calls, and if it exceeds \p p_max_time, \p exec_sync requests it to stop,
+/// and waits for it to return, as it may use \p p_params. If the function
+/// throws, the exception is rethrown by \p exec_sync.
 ///
 /// \tparam t_params possible parameters of t_function
 ///
@@ -44,76 +87,101 @@ namespace tnct::async
 /// \attention Please, take a look at
 /// <tt>tnct/async/exp/executer_000/main.cpp</tt> for examples
 template <typename t_function, typename... t_params>
-inline std::conditional_t<
-    // if 't_function' return type is 'void'
-    std::is_void_v<
-        std::invoke_result_t<t_function, std::function<bool()>, t_params...>>,
-    // the 'execute' wrapper will return 'bool', which will be 'true' if the
-    // 'p_function' executes in less 'p_max_time', or 'false' otherwise
-    bool,
-    // else it will dat::result a 'std::optional' with the return type of
-    // 't_function', which will contain a value of that type, if the
-    // 'p_function' executes in less 'p_max_time', or empty otherwise
-    std::optional<
-        std::invoke_result_t<t_function, std::function<bool()>, t_params...>>>
+requires(
+    std::is_invocable_v<t_function &, std::stop_token, t_params...>
+    || std::is_invocable_v<t_function &, std::function<bool()>, t_params...>)
+inline internal::bus::exec_sync_result<t_function, t_params...>
 exec_sync(time::cpt::convertible_to_nano auto p_max_time,
           t_function &p_function, t_params &&...p_params)
 {
+  using t_ret =
+      internal::bus::exec_sync_function_result<t_function, t_params...>;
+
   std::mutex              _mutex;
   std::condition_variable _cond;
-  bool                    _timeout{false};
+  bool                    _done{false};
+  std::stop_source        _stop_source;
+  std::exception_ptr      _exception;
 
-  auto _is_timeout = [&_timeout]() { return _timeout; };
+  std::conditional_t<std::is_void_v<t_ret>, bool, std::optional<t_ret>> _ret{};
 
-  using t_ret = typename std::invoke_result_t<t_function, std::function<bool()>,
-                                              t_params...>;
+  auto _call = [&]()
+  {
+    if constexpr (internal::bus::receives_stop_token<t_function, t_params...>)
+    {
+      return p_function(_stop_source.get_token(),
+                        std::forward<t_params>(p_params)...);
+    }
+    else
+    {
+      return p_function(std::function<bool()>{[&_stop_source]()
+                                              {
+                                                return _stop_source
+                                                    .stop_requested();
+                                              }},
+                        std::forward<t_params>(p_params)...);
+    }
+  };
 
-  auto _ns{std::chrono::duration_cast<std::chrono::nanoseconds>(p_max_time)};
+  internal::bus::exec_pool::shared().run(
+      [&]() -> void
+      {
+        try
+        {
+          if constexpr (std::is_void_v<t_ret>)
+          {
+            _call();
+          }
+          else
+          {
+            _ret.emplace(_call());
+          }
+        }
+        catch (...)
+        {
+          _exception = std::current_exception();
+        }
+      },
+      [&]() -> void
+      {
+        // notified while locked, so 'exec_sync' does not return, destroying
+        // '_cond', before 'notify_one' returns
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _done = true;
+        _cond.notify_one();
+      });
 
-  if constexpr (std::is_void_v<t_ret>)
+  std::unique_lock<std::mutex> _lock{_mutex};
+  const bool                   _in_time{_cond.wait_for(
+      _lock, std::chrono::duration_cast<std::chrono::nanoseconds>(p_max_time),
+      [&_done]() { return _done; })};
+
+  if (!_in_time)
   {
-    std::thread _th(
-        [&]() -> void
-        {
-          p_function(_is_timeout, std::forward<t_params>(p_params)...);
-          _cond.notify_one();
-        });
+    _lock.unlock();
+    _stop_source.request_stop();
+    _lock.lock();
+    _cond.wait(_lock, [&_done]() { return _done; });
+  }
 
-    std::unique_lock<std::mutex> _lock{_mutex};
-    if (_cond.wait_for(_lock, _ns) != std::cv_status::timeout)
-    {
-      //      _th.join();
-      _th.detach();
-      return true;
-    }
-    _timeout = true;
-    _th.join();
-    return false;
+  if (_exception)
+  {
+    std::rethrow_exception(_exception);
+  }
+
+  if constexpr (std::is_void_v<t_ret>)
+  {
+    return _in_time;
   }
   else
   {
-    t_ret _ret;
-
-    std::thread _th(
-        [&]() -> void
-        {
-          _ret = p_function(_is_timeout, std::forward<t_params>(p_params)...);
-          _cond.notify_one();
-        });
-
-    std::unique_lock<std::mutex> _lock{_mutex};
-    if (_cond.wait_for(_lock, _ns) != std::cv_status::timeout)
+    if (!_in_time)
     {
-      //      _th.join();
-      _th.detach();
-      return {std::move(_ret)};
+      return std::nullopt;
     }
-    _timeout = true;
-    _th.join();
-    std::optional<t_ret> _aux{};
-    return _aux;
+    return _ret;
   }
-};
+}
 
 } // namespace tnct::async
 
@@ -0,0 +1,111 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_HANDLE_H
+#define TNCT_ASYNC_BUS_HANDLE_H
+
+#include <iostream>
+#include <memory>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/handling.h"
+#include "tnct/log/cpt/logger.h"
+
+namespace tnct::async::bus
+{
+
+template <log::cpt::logger t_logger, async::cpt::is_event... t_events>
+struct dispatcher;
+
+/// \brief Refers to a handling of \p t_event added to a \p bus::dispatcher,
+/// so the dispatcher can use it with no search for its name
+///
+/// It converts to, and compares with, the \p dat::result of adding the
+/// handling, so it can be used where that result was used.
+///
+/// A handle does not keep the handling alive. It is valid while the handling
+/// exists, which ends when \p dispatcher::remove_handling is called with it, or
+/// when the dispatcher is destroyed. After that, the methods of the dispatcher
+/// that take the handle return \p dat::result::HANDLING_NOT_FOUND or
+/// \p std::nullopt.
+template <async::cpt::is_event t_event> class handle
+{
+public:
+  handle() = default;
+
+  operator dat::result() const noexcept
+  {
+    return m_result;
+  }
+
+  /// \brief Keeps only \p p_result, and no longer refers to the handling, so
+  /// a variable that received a handle can receive other results
+  handle &operator=(dat::result p_result) noexcept
+  {
+    m_result = p_result;
+    m_owner  = nullptr;
+    m_handling.reset();
+    return *this;
+  }
+
+  [[nodiscard]] dat::result get_result() const noexcept
+  {
+    return m_result;
+  }
+
+  /// \return \p true if the handling was added, and it still exists
+  [[nodiscard]] bool is_valid() const noexcept
+  {
+    return !m_handling.expired();
+  }
+
+  friend bool operator==(const handle &p_handle, dat::result p_result) noexcept
+  {
+    return p_handle.m_result == p_result;
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out, const handle &p_handle)
+  {
+    return p_out << p_handle.m_result;
+  }
+
+private:
+  template <log::cpt::logger t_logger, async::cpt::is_event... t_events>
+  friend struct dispatcher;
+
+  using handling = internal::bus::handling<t_event>;
+
+  explicit handle(dat::result p_result) : m_result(p_result)
+  {
+  }
+
+  handle(const void *p_owner, const std::shared_ptr<handling> &p_handling)
+      : m_result(dat::result::OK), m_owner(p_owner), m_handling(p_handling)
+  {
+  }
+
+  // The handling, if it still exists, and if \p p_owner added it
+  [[nodiscard]] std::shared_ptr<handling> lock(const void *p_owner) const
+  {
+    if (p_owner != m_owner)
+    {
+      return {};
+    }
+    return m_handling.lock();
+  }
+
+private:
+  dat::result m_result{dat::result::HANDLING_NOT_FOUND};
+
+  // The dispatcher that added the handling, only compared, and never used
+  const void *m_owner{nullptr};
+
+  std::weak_ptr<handling> m_handling;
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -0,0 +1,298 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_PARALLEL_H
+#define TNCT_ASYNC_BUS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/log/cpt/logger.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief The pool used by \p parallel_for and \p parallel_reduce when no pool
+/// is passed, created the first time it is used, with one worker for each
+/// hardware thread, and destroyed when the program ends
+///
+/// Its logger is created with it, as the pool outlives any other logger
+template <log::cpt::logger t_logger>
+requires std::default_initializable<t_logger>
+work_stealing_pool<t_logger> &parallel_pool()
+{
+  static t_logger                     _logger;
+  static work_stealing_pool<t_logger> _pool{_logger};
+  return _pool;
+}
+
+} // namespace tnct::async::bus
+
+namespace tnct::async::internal::bus
+{
+
+// Calls 'p_chunk' with each index in [0, 'p_num_chunks'), in the current
+// thread and in the workers of 'p_pool', and returns when all of them
+// returned
+//
+// The current thread takes chunks like the workers, so it is never idle, and
+// a call made from a task of 'p_pool' finishes even if all the other workers
+// are busy. The first exception raised by 'p_chunk' is rethrown, after the
+// chunks already started finish, and the others are not executed.
+template <log::cpt::logger t_logger>
+void run_chunks(async::bus::work_stealing_pool<t_logger> &p_pool,
+                std::size_t                               p_num_chunks,
+                const std::function<void(std::size_t)>   &p_chunk)
+{
+  if (p_num_chunks == 0)
+  {
+    return;
+  }
+  if (p_num_chunks == 1)
+  {
+    p_chunk(0);
+    return;
+  }
+
+  // Shared with the tasks, because a task may start after all the chunks were
+  // executed, and after this function returned, when it only finds out there
+  // is nothing left to do
+  struct state
+  {
+    // Returns false when there are no more chunks
+    bool execute_next()
+    {
+      const std::size_t _idx{next.fetch_add(1)};
+      if (_idx >= amount)
+      {
+        return false;
+      }
+
+      if (!cancelled)
+      {
+        try
+        {
+          (*chunk)(_idx);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> _lock(mutex);
+          if (!exception)
+          {
+            exception = std::current_exception();
+          }
+          cancelled = true;
+        }
+      }
+
+      if (finished.fetch_add(1) + 1 == amount)
+      {
+        std::lock_guard<std::mutex> _lock(mutex);
+        cond.notify_all();
+      }
+      return true;
+    }
+
+    std::size_t amount;
+
+    // Only called for chunks taken before 'finished' reaches 'amount', while
+    // 'run_chunks' is waiting
+    const std::function<void(std::size_t)> *chunk;
+
+    std::atomic_size_t next{0};
+    std::atomic_size_t finished{0};
+    std::atomic_bool   cancelled{false};
+
+    std::exception_ptr      exception;
+    std::mutex              mutex;
+    std::condition_variable cond;
+  };
+
+  std::shared_ptr<state> _state{std::make_shared<state>()};
+  _state->amount = p_num_chunks;
+  _state->chunk  = &p_chunk;
+
+  const std::size_t _helpers{
+      std::min(p_pool.get_num_workers(), p_num_chunks - 1)};
+  for (std::size_t _i = 0; _i < _helpers; ++_i)
+  {
+    if (!p_pool.submit(
+            [_state]()
+            {
+              while (_state->execute_next())
+              {
+              }
+            }))
+    {
+      // the pool is stopped, and the current thread executes the chunks
+      break;
+    }
+  }
+
+  while (_state->execute_next())
+  {
+  }
+
+  {
+    std::unique_lock<std::mutex> _lock(_state->mutex);
+    _state->cond.wait(_lock, [&]()
+                      { return _state->finished == _state->amount; });
+  }
+
+  if (_state->exception)
+  {
+    std::rethrow_exception(_state->exception);
+  }
+}
+
+// Amount of indexes in each chunk, where 'p_grain' equal to 0 means about 4
+// chunks for each worker, so the ones that finish first can take more
+inline std::size_t chunk_size(std::size_t p_amount, std::size_t p_grain,
+                              std::size_t p_num_workers)
+{
+  if (p_grain != 0)
+  {
+    return p_grain;
+  }
+  const std::size_t _chunks{std::max<std::size_t>(p_num_workers, 1) * 4};
+  return std::max<std::size_t>((p_amount + _chunks - 1) / _chunks, 1);
+}
+
+} // namespace tnct::async::internal::bus
+
+namespace tnct::async::bus
+{
+
+/// \brief Calls \p p_function with each index in [\p p_begin, \p p_end), in
+/// parallel, in the threads of \p p_pool and in the current thread, and
+/// returns when all the calls returned
+///
+/// The indexes are divided in chunks of \p p_grain consecutive indexes, or,
+/// if \p p_grain is 0, in about 4 chunks for each worker, and each chunk is
+/// executed by one thread, in order. No event is published, and no thread is
+/// created, so it is cheap to call in a loop.
+///
+/// It can be called from a task of \p p_pool. If \p p_function throws, the
+/// chunks not started are not executed, and the exception is rethrown.
+template <log::cpt::logger t_logger, std::integral t_index,
+          typename t_function>
+requires std::invocable<t_function &, t_index>
+void parallel_for(work_stealing_pool<t_logger> &p_pool, t_index p_begin,
+                  t_index p_end, std::size_t p_grain, t_function &&p_function)
+{
+  if (p_end <= p_begin)
+  {
+    return;
+  }
+
+  const std::size_t _amount{static_cast<std::size_t>(p_end - p_begin)};
+  const std::size_t _chunk_size{internal::bus::chunk_size(
+      _amount, p_grain, p_pool.get_num_workers())};
+
+  internal::bus::run_chunks(
+      p_pool, (_amount + _chunk_size - 1) / _chunk_size,
+      [&](std::size_t p_chunk)
+      {
+        const std::size_t _first{p_chunk * _chunk_size};
+        const std::size_t _last{std::min(_first + _chunk_size, _amount)};
+        for (std::size_t _i = _first; _i < _last; ++_i)
+        {
+          p_function(static_cast<t_index>(p_begin + _i));
+        }
+      });
+}
+
+/// \brief Like the other \p parallel_for, using \p parallel_pool<t_logger>
+template <log::cpt::logger t_logger, std::integral t_index,
+          typename t_function>
+requires std::invocable<t_function &, t_index>
+void parallel_for(t_index p_begin, t_index p_end, std::size_t p_grain,
+                  t_function &&p_function)
+{
+  parallel_for(parallel_pool<t_logger>(), p_begin, p_end, p_grain,
+               std::forward<t_function>(p_function));
+}
+
+/// \brief Combines with \p p_reduce the values \p p_transform returns for each
+/// index in [\p p_begin, \p p_end), in parallel, like \p parallel_for
+///
+/// Each chunk combines its values, starting from \p p_identity, and then the
+/// current thread combines the results of the chunks, in the order of the
+/// indexes, so \p p_reduce must be associative, but need not be commutative,
+/// and the result is the same for any \p p_grain, if \p p_reduce is exact.
+///
+/// \return \p p_identity if the range is empty
+template <log::cpt::logger t_logger, std::integral t_index,
+          std::copyable t_value, typename t_transform, typename t_reduce>
+requires(std::is_invocable_r_v<t_value, t_transform &, t_index>
+         && std::is_invocable_r_v<t_value, t_reduce &, t_value, t_value>)
+t_value parallel_reduce(work_stealing_pool<t_logger> &p_pool, t_index p_begin,
+                        t_index p_end, std::size_t p_grain, t_value p_identity,
+                        t_transform &&p_transform, t_reduce &&p_reduce)
+{
+  if (p_end <= p_begin)
+  {
+    return p_identity;
+  }
+
+  const std::size_t _amount{static_cast<std::size_t>(p_end - p_begin)};
+  const std::size_t _chunk_size{internal::bus::chunk_size(
+      _amount, p_grain, p_pool.get_num_workers())};
+  const std::size_t _num_chunks{(_amount + _chunk_size - 1) / _chunk_size};
+
+  std::vector<t_value> _partials(_num_chunks, p_identity);
+
+  internal::bus::run_chunks(
+      p_pool, _num_chunks,
+      [&](std::size_t p_chunk)
+      {
+        const std::size_t _first{p_chunk * _chunk_size};
+        const std::size_t _last{std::min(_first + _chunk_size, _amount)};
+        t_value           _partial{p_identity};
+        for (std::size_t _i = _first; _i < _last; ++_i)
+        {
+          _partial = p_reduce(std::move(_partial),
+                              p_transform(static_cast<t_index>(p_begin + _i)));
+        }
+        _partials[p_chunk] = std::move(_partial);
+      });
+
+  t_value _result{std::move(p_identity)};
+  for (t_value &_partial : _partials)
+  {
+    _result = p_reduce(std::move(_result), std::move(_partial));
+  }
+  return _result;
+}
+
+/// \brief Like the other \p parallel_reduce, using \p parallel_pool<t_logger>
+template <log::cpt::logger t_logger, std::integral t_index,
+          std::copyable t_value, typename t_transform, typename t_reduce>
+requires(std::is_invocable_r_v<t_value, t_transform &, t_index>
+         && std::is_invocable_r_v<t_value, t_reduce &, t_value, t_value>)
+t_value parallel_reduce(t_index p_begin, t_index p_end, std::size_t p_grain,
+                        t_value p_identity, t_transform &&p_transform,
+                        t_reduce &&p_reduce)
+{
+  return parallel_reduce(parallel_pool<t_logger>(), p_begin, p_end, p_grain,
+                         std::move(p_identity),
+                         std::forward<t_transform>(p_transform),
+                         std::forward<t_reduce>(p_reduce));
+}
+
+} // namespace tnct::async::bus
+
+#endif
@@ -0,0 +1,290 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_PIPELINE_H
+#define TNCT_ASYNC_BUS_PIPELINE_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/dat/stage_config.h"
+#include "tnct/async/dat/stage_metrics.h"
+#include "tnct/async/internal/bus/pipeline_stage.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+template <log::cpt::logger t_logger, async::cpt::is_event t_source,
+          async::cpt::is_event t_current>
+class pipeline_builder;
+
+/** \brief A chain of stages, from the values of type \p t_source published to
+it, to a sink, built by a \p pipeline_builder
+
+Each stage is a function that receives the value produced by the stage before
+it, and returns the value passed to the stage after it, or a
+\p std::optional of it, where \p std::nullopt drops the value. The sink returns
+nothing.
+
+A stage is fused, or has its own queue and threads, as defined in its
+\p dat::stage_config, so a chain of cheap stages runs in one thread, with no
+copy, lock or wake up between them, while an expensive stage can have many
+threads. A function of a stage with more than one thread, or fused to one, is
+called by all of them at the same time.
+
+\p get_metrics reports the throughput and the utilisation of each stage, and
+\p get_bottleneck the stage whose threads spend most of their time in it.
+*/
+template <log::cpt::logger t_logger, async::cpt::is_event t_source>
+class pipeline final
+{
+public:
+  using logger = t_logger;
+  using source = t_source;
+
+  pipeline()                            = delete;
+  pipeline(const pipeline &)            = delete;
+  pipeline(pipeline &&)                 = default;
+  pipeline &operator=(const pipeline &) = delete;
+  pipeline &operator=(pipeline &&)      = default;
+
+  ~pipeline()
+  {
+    stop();
+  }
+
+  /// \brief Passes \p p_value to the first stage, calling it now, if it is
+  /// fused, or waiting for space in its queue, if it is full
+  dat::result publish(t_source &&p_value)
+  {
+    return m_entry(std::move(p_value));
+  }
+
+  template <typename... t_source_params>
+  dat::result publish(t_source_params &&...p_params)
+  {
+    return publish(t_source{std::forward<t_source_params>(p_params)...});
+  }
+
+  /// \brief Stops the stages, from the first to the sink, discarding the
+  /// values in their queues
+  void stop()
+  {
+    for (std::unique_ptr<internal::bus::pipeline_stage> &_stage : m_stages)
+    {
+      _stage->stop();
+    }
+  }
+
+  /// \return The metrics of each stage, from the first to the sink
+  [[nodiscard]] std::vector<dat::stage_metrics> get_metrics() const
+  {
+    std::vector<dat::stage_metrics> _metrics;
+    for (const std::unique_ptr<internal::bus::pipeline_stage> &_stage :
+         m_stages)
+    {
+      _metrics.push_back(_stage->get_metrics());
+    }
+    return _metrics;
+  }
+
+  /// \return The metrics of the stage with the greatest utilisation
+  [[nodiscard]] std::optional<dat::stage_metrics> get_bottleneck() const
+  {
+    std::vector<dat::stage_metrics> _metrics{get_metrics()};
+    auto _ite{std::max_element(
+        _metrics.begin(), _metrics.end(),
+        [](const dat::stage_metrics &p_left, const dat::stage_metrics &p_right)
+        { return p_left.utilisation() < p_right.utilisation(); })};
+    if (_ite == _metrics.end())
+    {
+      return std::nullopt;
+    }
+    return *_ite;
+  }
+
+private:
+  template <log::cpt::logger, async::cpt::is_event, async::cpt::is_event>
+  friend class pipeline_builder;
+
+  using stages = std::vector<std::unique_ptr<internal::bus::pipeline_stage>>;
+
+private:
+  pipeline(internal::bus::downstream<t_source> &&p_entry, stages &&p_stages)
+      : m_entry(std::move(p_entry)), m_stages(std::move(p_stages))
+  {
+  }
+
+private:
+  internal::bus::downstream<t_source> m_entry;
+
+  // From the first stage to the sink
+  stages m_stages;
+};
+
+/// \brief Declares the stages of a \p pipeline, from the one that receives the
+/// values of type \p t_source to the sink
+///
+/// \p stage adds a stage that receives \p t_current, and returns a builder
+/// whose \p t_current is what the stage produces, and \p sink adds the last
+/// stage, and creates the \p pipeline, like:
+///
+/// \code
+/// auto _pipeline{async::bus::pipeline_builder<logger, line>(_logger)
+///                    .stage("parse", parse, async::dat::fused)
+///                    .stage("score", score, {.handlers = 4})
+///                    .sink("store", store)};
+/// \endcode
+template <log::cpt::logger t_logger, async::cpt::is_event t_source,
+          async::cpt::is_event t_current = t_source>
+class pipeline_builder final
+{
+public:
+  explicit pipeline_builder(t_logger &p_logger)
+  requires std::same_as<t_source, t_current>
+      : m_logger(p_logger),
+        m_compose([](internal::bus::downstream<t_source> &&p_next, stages &)
+                  { return std::move(p_next); })
+  {
+  }
+
+  /// \brief Adds a stage that calls \p p_function with each value of type
+  /// \p t_current
+  template <std::move_constructible t_function>
+  requires std::invocable<t_function &, t_current &&>
+           && async::cpt::is_event<
+               internal::bus::stage_output_t<t_function, t_current>>
+  auto stage(std::string p_name, t_function p_function,
+             dat::stage_config p_config = {}) &&
+  {
+    using output = internal::bus::stage_output_t<t_function, t_current>;
+
+    return pipeline_builder<t_logger, t_source, output>(
+        m_logger,
+        add<t_function, output>(std::move(p_name), std::move(p_function),
+                                p_config),
+        threads_after(p_config));
+  }
+
+  /// \brief Adds the last stage, that calls \p p_function with each value of
+  /// type \p t_current, and creates the \p pipeline
+  ///
+  /// \return \p std::nullopt if a stage could not be created
+  template <std::move_constructible t_function>
+  requires std::invocable<t_function &, t_current &&>
+           && std::is_void_v<std::invoke_result_t<t_function &, t_current &&>>
+  std::optional<pipeline<t_logger, t_source>>
+  sink(std::string p_name, t_function p_function,
+       dat::stage_config p_config = {}) &&
+  {
+    compose_to<void> _compose{add<t_function, void>(
+        std::move(p_name), std::move(p_function), p_config)};
+
+    try
+    {
+      stages                              _stages;
+      internal::bus::downstream<t_source> _entry{_compose(nullptr, _stages)};
+
+      // the stages were created from the sink to the first one
+      std::reverse(_stages.begin(), _stages.end());
+
+      return pipeline<t_logger, t_source>(std::move(_entry),
+                                          std::move(_stages));
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("error creating pipeline: ", _ex.what()));
+    }
+    return std::nullopt;
+  }
+
+private:
+  template <log::cpt::logger, async::cpt::is_event, async::cpt::is_event>
+  friend class pipeline_builder;
+
+  using stages = std::vector<std::unique_ptr<internal::bus::pipeline_stage>>;
+
+  // Creates the stages from the one after 't_current' back to the first one,
+  // given where the values of type 't_current' go, and returns where the
+  // values of type 't_source' go
+  template <typename t_next>
+  using compose_to = std::function<internal::bus::downstream<t_source>(
+      internal::bus::downstream<t_next> &&, stages &)>;
+
+  using compose = compose_to<t_current>;
+
+private:
+  pipeline_builder(t_logger &p_logger, compose &&p_compose,
+                   std::size_t p_threads)
+      : m_logger(p_logger), m_compose(std::move(p_compose)),
+        m_threads(p_threads)
+  {
+  }
+
+  // Threads that run the stage after one added with 'p_config', if it is fused
+  [[nodiscard]] std::size_t
+  threads_after(const dat::stage_config &p_config) const
+  {
+    return p_config.fuse ? m_threads : std::max<std::size_t>(
+                                           p_config.handlers, 1);
+  }
+
+  template <typename t_function, typename t_output>
+  compose_to<t_output> add(std::string p_name, t_function &&p_function,
+                           const dat::stage_config &p_config)
+  {
+    using stage =
+        internal::bus::pipeline_stage_concrete<t_logger, t_current,
+                                               t_function>;
+
+    // 'std::function' must be copyable, and the function is moved only once
+    std::shared_ptr<t_function> _function{
+        std::make_shared<t_function>(std::move(p_function))};
+
+    return [&p_logger = m_logger, _previous = std::move(m_compose), _function,
+            _name = std::move(p_name), p_config, _threads = m_threads](
+               internal::bus::downstream<t_output> &&p_next,
+               stages &p_stages) -> internal::bus::downstream<t_source>
+    {
+      std::unique_ptr<stage> _stage{
+          std::make_unique<stage>(p_logger, _name, std::move(*_function),
+                                  p_config, _threads, std::move(p_next))};
+      stage *_stage_ptr{_stage.get()};
+      p_stages.push_back(std::move(_stage));
+
+      return _previous([_stage_ptr](t_current &&p_value)
+                       { return _stage_ptr->add(std::move(p_value)); },
+                       p_stages);
+    };
+  }
+
+private:
+  t_logger &m_logger;
+
+  compose m_compose;
+
+  // Threads that run the stage after 't_current', if it is fused, where 1 is
+  // the publisher
+  std::size_t m_threads{1};
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -0,0 +1,242 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_RECORDER_H
+#define TNCT_ASYNC_BUS_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/cpt/is_event_serializer.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/event_taps.h"
+#include "tnct/async/internal/dat/record_format.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief Writes the events of types \p t_events published to a dispatcher to
+/// a binary file, with the time each one was published, so a
+/// \p bus::replayer can publish them again, with the same timing
+///
+/// \p attach adds to the dispatcher, for each type in \p t_events, a handling
+/// called by \p publish, in the thread of the publisher, that serializes the
+/// event with \p t_serializer, and appends it to the file. The events
+/// published by many threads are written one at a time, in the order they
+/// were published.
+///
+/// So, while recording, the publishers of a type in \p t_events wait for each
+/// other, and, if the dispatcher has other handlings for the type, each event
+/// is copied for the recorder, which requires the type to be copyable. \p stop
+/// and the destructor remove the handlings, so the publishers stop paying for
+/// them.
+///
+/// The file is only readable by a \p bus::replayer with the same
+/// \p t_events, in the same order, and a \p t_serializer that reads what
+/// this one writes.
+template <log::cpt::logger t_logger, typename t_serializer,
+          async::cpt::is_event... t_events>
+requires(async::cpt::is_event_serializer<t_serializer, t_events> && ...)
+class recorder final
+{
+public:
+  using logger     = t_logger;
+  using serializer = t_serializer;
+  using events     = std::tuple<t_events...>;
+
+  /// \brief Creates the file \p p_path, replacing it if it exists
+  ///
+  /// \return \p std::nullopt if the file could not be created
+  static std::optional<recorder> create(t_logger                    &p_logger,
+                                        const std::filesystem::path &p_path,
+                                        t_serializer p_serializer = {})
+  {
+    try
+    {
+      std::shared_ptr<state> _state{std::make_shared<state>(
+          p_logger, std::ofstream{p_path, std::ios::binary | std::ios::trunc},
+          std::move(p_serializer))};
+      if (!_state->file)
+      {
+        TNCT_LOG_ERR(p_logger, format::bus::fmt("could not create '",
+                                                p_path.string(), '\''));
+        return std::nullopt;
+      }
+
+      const std::uint32_t _amount{sizeof...(t_events)};
+      _state->file.write(internal::dat::record_magic.data(),
+                         internal::dat::record_magic.size());
+      _state->file.write(reinterpret_cast<const char *>(&_amount),
+                         sizeof(_amount));
+
+      return recorder{std::move(_state)};
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(p_logger, format::bus::fmt("error creating recorder for '",
+                                              p_path.string(), "': ",
+                                              _ex.what()));
+    }
+    return std::nullopt;
+  }
+
+  recorder()                            = delete;
+  recorder(const recorder &)            = delete;
+  recorder(recorder &&)                 = default;
+  recorder &operator=(const recorder &) = delete;
+  recorder &operator=(recorder &&)      = default;
+
+  ~recorder()
+  {
+    stop();
+  }
+
+  /// \brief Starts recording the events of \p t_events published to
+  /// \p p_dispatcher, which must have all of them
+  ///
+  /// The handlings are called "recorder", and a dispatcher can have only one
+  /// recorder of the same types. Like adding a handling, it must not be
+  /// called while other threads publish the events.
+  template <typename t_dispatcher>
+  dat::result attach(t_dispatcher &p_dispatcher)
+  {
+    if (!m_state)
+    {
+      return dat::result::ERROR_RECORDING;
+    }
+
+    const dat::result _result{
+        m_taps.attach(p_dispatcher, "recorder", m_state)};
+    if (_result != dat::result::OK)
+    {
+      TNCT_LOG_ERR(m_state->logger,
+                   format::bus::fmt("error attaching recorder: ", _result));
+    }
+    return _result;
+  }
+
+  /// \brief Stops recording, closes the file, and removes the handlings from
+  /// the dispatcher
+  ///
+  /// Like removing a handling, it must not be called while other threads
+  /// publish the events
+  void stop()
+  {
+    if (!m_state)
+    {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> _lock(m_state->mutex);
+      if (m_state->file.is_open())
+      {
+        m_state->file.close();
+      }
+    }
+    m_taps.detach();
+  }
+
+  [[nodiscard]] std::size_t get_amount_recorded() const
+  {
+    if (!m_state)
+    {
+      return 0;
+    }
+    std::lock_guard<std::mutex> _lock(m_state->mutex);
+    return m_state->amount;
+  }
+
+private:
+  // The file is closed by 'stop', but the object lives while the handlings
+  // can call 'write'
+  struct state
+  {
+    state(t_logger &p_logger, std::ofstream &&p_file,
+          t_serializer &&p_serializer)
+        : logger(p_logger), file(std::move(p_file)),
+          serializer(std::move(p_serializer))
+    {
+    }
+
+    template <async::cpt::is_event t_event> void write(const t_event &p_event)
+    {
+      std::lock_guard<std::mutex> _lock(mutex);
+      if (!file.is_open())
+      {
+        return;
+      }
+
+      // taken under the lock, so the moments in the file never decrease
+      const auto _now{std::chrono::steady_clock::now()};
+
+      buffer.clear();
+      serializer.serialize(p_event, buffer);
+
+      const internal::dat::record_header _header{
+          static_cast<std::uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(_now
+                                                                   - start)
+                  .count()),
+          internal::bus::event_index<events, t_event>,
+          static_cast<std::uint32_t>(buffer.size())};
+
+      file.write(reinterpret_cast<const char *>(&_header), sizeof(_header));
+      file.write(reinterpret_cast<const char *>(buffer.data()),
+                 static_cast<std::streamsize>(buffer.size()));
+      if (!file)
+      {
+        TNCT_LOG_ERR(logger, format::bus::fmt("error recording ", p_event));
+        file.close();
+        return;
+      }
+      ++amount;
+    }
+
+    t_logger &logger;
+
+    std::ofstream file;
+
+    t_serializer serializer;
+
+    // Holds the serialized event until it is appended to the file
+    std::vector<std::byte> buffer;
+
+    const std::chrono::steady_clock::time_point start{
+        std::chrono::steady_clock::now()};
+
+    std::size_t amount{0};
+
+    std::mutex mutex;
+  };
+
+private:
+  explicit recorder(std::shared_ptr<state> &&p_state)
+      : m_state(std::move(p_state))
+  {
+  }
+
+private:
+  std::shared_ptr<state> m_state;
+
+  internal::bus::event_taps<state, t_events...> m_taps;
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -0,0 +1,240 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_REPLAYER_H
+#define TNCT_ASYNC_BUS_REPLAYER_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/cpt/is_event_serializer.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/publish_serialized.h"
+#include "tnct/async/internal/dat/record_format.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief Publishes to a dispatcher the events of a file written by a
+/// \p bus::recorder with the same \p t_events, in the same order, at the
+/// speed they were recorded, faster, or as fast as possible
+///
+/// Each event is read, deserialized with \p t_serializer, and published, one
+/// at a time, so the file may be larger than the memory.
+template <log::cpt::logger t_logger, typename t_serializer,
+          async::cpt::is_event... t_events>
+requires(async::cpt::is_event_serializer<t_serializer, t_events> && ...)
+class replayer final
+{
+public:
+  using logger     = t_logger;
+  using serializer = t_serializer;
+  using events     = std::tuple<t_events...>;
+
+  /// \return \p std::nullopt if the file could not be opened, or was not
+  /// written by a \p bus::recorder of as many types of events
+  static std::optional<replayer> create(t_logger                    &p_logger,
+                                        const std::filesystem::path &p_path,
+                                        t_serializer p_serializer = {})
+  {
+    try
+    {
+      std::ifstream _file{p_path, std::ios::binary};
+      if (!_file)
+      {
+        TNCT_LOG_ERR(p_logger, format::bus::fmt("could not open '",
+                                                p_path.string(), '\''));
+        return std::nullopt;
+      }
+
+      std::array<char, internal::dat::record_magic.size()> _magic{};
+      std::uint32_t                                        _amount{0};
+      _file.read(_magic.data(), _magic.size());
+      _file.read(reinterpret_cast<char *>(&_amount), sizeof(_amount));
+      if (!_file || (_magic != internal::dat::record_magic))
+      {
+        TNCT_LOG_ERR(p_logger, format::bus::fmt("'", p_path.string(),
+                                                "' is not a recording"));
+        return std::nullopt;
+      }
+      if (_amount != sizeof...(t_events))
+      {
+        TNCT_LOG_ERR(p_logger,
+                     format::bus::fmt("'", p_path.string(), "' has ", _amount,
+                                      " types of events, but ",
+                                      sizeof...(t_events), " were expected"));
+        return std::nullopt;
+      }
+
+      return replayer{p_logger, std::move(_file), std::move(p_serializer)};
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(p_logger, format::bus::fmt("error creating replayer for '",
+                                              p_path.string(), "': ",
+                                              _ex.what()));
+    }
+    return std::nullopt;
+  }
+
+  replayer()                            = delete;
+  replayer(const replayer &)            = delete;
+  replayer(replayer &&)                 = default;
+  replayer &operator=(const replayer &) = delete;
+  replayer &operator=(replayer &&)      = default;
+
+  ~replayer() = default;
+
+  /// \brief Publishes all the events of the file to \p p_dispatcher, from
+  /// the first one, in the thread that calls it
+  ///
+  /// \param p_speed is how many times faster than recorded the events are
+  /// published, where 1 is the speed they were recorded, and 0 means as fast
+  /// as possible
+  ///
+  /// An event that \p p_dispatcher does not accept, like when a queue is full
+  /// with \p dat::overflow_policy::reject, is counted by
+  /// \p get_amount_not_replayed, and the next events are still published
+  ///
+  /// \return \p dat::result::ERROR_REPLAYING if the file is corrupted, after
+  /// the events before the corruption were published
+  template <typename t_dispatcher>
+  dat::result replay(t_dispatcher &p_dispatcher, double p_speed = 1.0)
+  {
+    m_replayed     = 0;
+    m_not_replayed = 0;
+
+    try
+    {
+      m_file.clear();
+      m_file.seekg(first_record);
+
+      const auto _start{std::chrono::steady_clock::now()};
+
+      internal::dat::record_header _header;
+      while (m_file.read(reinterpret_cast<char *>(&_header), sizeof(_header)))
+      {
+        m_buffer.resize(_header.size);
+        if (!m_file.read(reinterpret_cast<char *>(m_buffer.data()),
+                         static_cast<std::streamsize>(_header.size)))
+        {
+          TNCT_LOG_ERR(m_logger, format::bus::fmt("event ", get_position(),
+                                                  " is truncated"));
+          return dat::result::ERROR_REPLAYING;
+        }
+
+        if (p_speed > 0)
+        {
+          std::this_thread::sleep_until(
+              _start
+              + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double, std::nano>(
+                      static_cast<double>(_header.nanoseconds) / p_speed)));
+        }
+
+        const std::optional<dat::result> _result{
+            internal::bus::publish_serialized<events>(
+                m_serializer, p_dispatcher, _header.event_index,
+                std::span<const std::byte>{m_buffer})};
+        if (!_result)
+        {
+          TNCT_LOG_ERR(m_logger,
+                       format::bus::fmt("event ", get_position(), " of type ",
+                                        _header.event_index,
+                                        " could not be deserialized"));
+          return dat::result::ERROR_REPLAYING;
+        }
+        if (*_result != dat::result::OK)
+        {
+          TNCT_LOG_TRA(m_logger, format::bus::fmt("event ", get_position(),
+                                                  " not published: ",
+                                                  *_result));
+          ++m_not_replayed;
+          continue;
+        }
+        ++m_replayed;
+      }
+
+      if (m_file.gcount() != 0)
+      {
+        TNCT_LOG_ERR(m_logger, format::bus::fmt("header of event ",
+                                                get_position(),
+                                                " is truncated"));
+        return dat::result::ERROR_REPLAYING;
+      }
+      return dat::result::OK;
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("error replaying event ", get_position(),
+                                    ": ", _ex.what()));
+    }
+    return dat::result::ERROR_REPLAYING;
+  }
+
+  /// \brief Amount of events published by the last \p replay
+  [[nodiscard]] std::size_t get_amount_replayed() const
+  {
+    return m_replayed;
+  }
+
+  /// \brief Amount of events of the last \p replay that the dispatcher did not
+  /// accept
+  [[nodiscard]] std::size_t get_amount_not_replayed() const
+  {
+    return m_not_replayed;
+  }
+
+private:
+  replayer(t_logger &p_logger, std::ifstream &&p_file,
+           t_serializer &&p_serializer)
+      : m_logger(p_logger), m_file(std::move(p_file)),
+        m_serializer(std::move(p_serializer))
+  {
+  }
+
+  // Position in the file of the event being replayed
+  [[nodiscard]] std::size_t get_position() const
+  {
+    return m_replayed + m_not_replayed;
+  }
+
+private:
+  static constexpr std::streamoff first_record{
+      internal::dat::record_magic.size() + sizeof(std::uint32_t)};
+
+  t_logger &m_logger;
+
+  std::ifstream m_file;
+
+  t_serializer m_serializer;
+
+  // Bytes of the event being replayed
+  std::vector<std::byte> m_buffer;
+
+  std::size_t m_replayed{0};
+
+  std::size_t m_not_replayed{0};
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -0,0 +1,229 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_SHM_RECEIVER_H
+#define TNCT_ASYNC_BUS_SHM_RECEIVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/cpt/is_event_serializer.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/publish_serialized.h"
+#include "tnct/async/internal/bus/shm_ring.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief Publishes to a dispatcher the events sent by a \p bus::shm_sender
+/// with the same \p t_events, in the same order, in another process of the
+/// same machine
+///
+/// \p start creates a thread that waits for the events in the shared memory
+/// segment, deserializes them with \p t_serializer, and publishes them, one
+/// at a time, in the order they were sent.
+template <log::cpt::logger t_logger, typename t_serializer,
+          async::cpt::is_event... t_events>
+requires(async::cpt::is_event_serializer<t_serializer, t_events> && ...)
+class shm_receiver final
+{
+public:
+  using logger     = t_logger;
+  using serializer = t_serializer;
+  using events     = std::tuple<t_events...>;
+
+  /// \param p_name is the name of the segment created by the sender
+  ///
+  /// \return \p std::nullopt if the segment does not exist, or was not
+  /// created by a \p bus::shm_sender of as many types of events
+  static std::optional<shm_receiver> create(t_logger          &p_logger,
+                                            const std::string &p_name,
+                                            t_serializer p_serializer = {})
+  {
+    try
+    {
+      return shm_receiver{std::make_unique<state>(
+          p_logger,
+          internal::bus::shm_ring::open(p_name, sizeof...(t_events)),
+          std::move(p_serializer))};
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(p_logger, format::bus::fmt("error creating receiver '",
+                                              p_name, "': ", _ex.what()));
+    }
+    return std::nullopt;
+  }
+
+  shm_receiver()                                = delete;
+  shm_receiver(const shm_receiver &)            = delete;
+  shm_receiver(shm_receiver &&)                 = default;
+  shm_receiver &operator=(const shm_receiver &) = delete;
+
+  shm_receiver &operator=(shm_receiver &&p_receiver)
+  {
+    if (this != &p_receiver)
+    {
+      stop();
+      m_state = std::move(p_receiver.m_state);
+    }
+    return *this;
+  }
+
+  ~shm_receiver()
+  {
+    stop();
+  }
+
+  /// \brief Starts publishing the events received to \p p_dispatcher, which
+  /// must have all of \p t_events, and must live until \p stop is called
+  ///
+  /// \return \p dat::result::ERROR_ADDING_HANDLER if it was already started
+  template <typename t_dispatcher>
+  dat::result start(t_dispatcher &p_dispatcher)
+  {
+    if (!m_state || m_state->thread.joinable())
+    {
+      return dat::result::ERROR_ADDING_HANDLER;
+    }
+
+    m_state->stopped = false;
+    m_state->thread =
+        std::thread{[_state = m_state.get(), &p_dispatcher]()
+                    { _state->receive(p_dispatcher); }};
+    return dat::result::OK;
+  }
+
+  /// \brief Stops receiving, after the event being published, if any, and
+  /// waits for the thread to finish
+  ///
+  /// The events not received stay in the segment, and a new \p start
+  /// receives them
+  void stop()
+  {
+    if (!m_state || !m_state->thread.joinable())
+    {
+      return;
+    }
+    m_state->stopped = true;
+    m_state->ring.wake_up_receiver();
+    m_state->thread.join();
+  }
+
+  [[nodiscard]] std::size_t get_amount_received() const
+  {
+    return m_state ? m_state->received.load() : 0;
+  }
+
+private:
+  // In a 'std::unique_ptr', so the thread refers to the same object after the
+  // receiver is moved
+  struct state
+  {
+    state(t_logger &p_logger, internal::bus::shm_ring &&p_ring,
+          t_serializer &&p_serializer)
+        : logger(p_logger), ring(std::move(p_ring)),
+          serializer(std::move(p_serializer))
+    {
+    }
+
+    template <typename t_dispatcher> void receive(t_dispatcher &p_dispatcher)
+    {
+      std::uint32_t _index{0};
+
+      // The event is copied from the ring, so the sender can reuse its space
+      // while it is published
+      auto _consume{
+          [&](std::uint32_t p_index, std::span<const std::byte> p_bytes)
+          {
+            _index = p_index;
+            buffer.assign(p_bytes.begin(), p_bytes.end());
+          }};
+
+      while (!stopped)
+      {
+        try
+        {
+          if (!ring.read(_consume, wait))
+          {
+            continue;
+          }
+
+          const std::optional<dat::result> _result{
+              internal::bus::publish_serialized<events>(
+                  serializer, p_dispatcher, _index,
+                  std::span<const std::byte>{buffer})};
+          if (!_result)
+          {
+            TNCT_LOG_ERR(logger,
+                         format::bus::fmt("event ", received.load(),
+                                          " of type ", _index,
+                                          " could not be deserialized"));
+            continue;
+          }
+          if (*_result != dat::result::OK)
+          {
+            TNCT_LOG_ERR(logger, format::bus::fmt("error publishing event ",
+                                                  received.load(), ": ",
+                                                  *_result));
+          }
+          ++received;
+        }
+        catch (std::exception &_ex)
+        {
+          TNCT_LOG_ERR(logger, format::bus::fmt("error receiving event ",
+                                                received.load(), ": ",
+                                                _ex.what()));
+        }
+      }
+    }
+
+    // How long the thread waits for an event before checking 'stopped'
+    static constexpr std::chrono::milliseconds wait{100};
+
+    t_logger &logger;
+
+    internal::bus::shm_ring ring;
+
+    t_serializer serializer;
+
+    // Bytes of the event being published
+    std::vector<std::byte> buffer;
+
+    std::atomic_bool stopped{false};
+
+    std::atomic_size_t received{0};
+
+    std::thread thread;
+  };
+
+private:
+  explicit shm_receiver(std::unique_ptr<state> &&p_state)
+      : m_state(std::move(p_state))
+  {
+  }
+
+private:
+  std::unique_ptr<state> m_state;
+};
+
+} // namespace tnct::async::bus
+
+#endif
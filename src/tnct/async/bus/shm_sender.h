@@ -0,0 +1,258 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_SHM_SENDER_H
+#define TNCT_ASYNC_BUS_SHM_SENDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/cpt/is_event_serializer.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/event_taps.h"
+#include "tnct/async/internal/bus/shm_ring.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief Carries the events of types \p t_events published to a dispatcher
+/// to a \p bus::shm_receiver in another process of the same machine, which
+/// publishes them to its own dispatcher
+///
+/// The events are serialized with \p t_serializer into a ring buffer in a
+/// POSIX shared memory segment, and the receiver sleeps on a futex while the
+/// ring is empty, so an event crosses the processes with no socket, no
+/// system call if the receiver is busy, and one to wake it up if it is not.
+///
+/// \p attach adds to the dispatcher, for each type in \p t_events, a handling
+/// called by \p publish, in the thread of the publisher, that writes the
+/// event to the ring. The publishers of \p t_events write one at a time, and
+/// each event is copied if the dispatcher has other handlings for it.
+///
+/// While the ring is full, the publisher waits up to the \p p_max_wait
+/// informed in \p create, so a slow receiver slows down the publishers. If
+/// there is still no space, the event is dropped, and counted by
+/// \p get_amount_not_sent, and the next events are dropped with no wait until
+/// the receiver frees space, so a receiver that stopped, or died, does not
+/// block the publishers.
+///
+/// The sender creates the segment, replacing one with the same name, and
+/// removes it when it is destroyed, after removing the handlings from the
+/// dispatcher, which \p stop also does. A segment has one sender and one
+/// receiver, which must have the same \p t_events, in the same order. Only
+/// Linux is supported.
+template <log::cpt::logger t_logger, typename t_serializer,
+          async::cpt::is_event... t_events>
+requires(async::cpt::is_event_serializer<t_serializer, t_events> && ...)
+class shm_sender final
+{
+public:
+  using logger     = t_logger;
+  using serializer = t_serializer;
+  using events     = std::tuple<t_events...>;
+
+  /// \brief Longest time a publisher waits for space in the ring, if not
+  /// informed in \p create
+  static constexpr std::chrono::milliseconds default_max_wait{100};
+
+  /// \param p_name is the name of the segment, like "/my-bridge"
+  ///
+  /// \param p_capacity is the minimum amount of bytes of the ring, rounded up
+  /// to a power of 2, and an event can take at most half of it
+  ///
+  /// \param p_max_wait is the longest time a publisher waits for space in the
+  /// ring, before the event is dropped
+  ///
+  /// \return \p std::nullopt if the segment could not be created
+  static std::optional<shm_sender>
+  create(t_logger &p_logger, const std::string &p_name, std::size_t p_capacity,
+         std::chrono::milliseconds p_max_wait   = default_max_wait,
+         t_serializer              p_serializer = {})
+  {
+    try
+    {
+      return shm_sender{std::make_shared<state>(
+          p_logger,
+          internal::bus::shm_ring::create(p_name, p_capacity,
+                                          sizeof...(t_events)),
+          p_max_wait, std::move(p_serializer))};
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(p_logger, format::bus::fmt("error creating sender '",
+                                              p_name, "': ", _ex.what()));
+    }
+    return std::nullopt;
+  }
+
+  shm_sender()                              = delete;
+  shm_sender(const shm_sender &)            = delete;
+  shm_sender(shm_sender &&)                 = default;
+  shm_sender &operator=(const shm_sender &) = delete;
+  shm_sender &operator=(shm_sender &&)      = default;
+
+  ~shm_sender()
+  {
+    stop();
+  }
+
+  /// \brief Starts sending the events of \p t_events published to
+  /// \p p_dispatcher, which must have all of them
+  ///
+  /// The handlings are called "shm-sender", and a dispatcher can have only
+  /// one sender of the same types. Like adding a handling, it must not be
+  /// called while other threads publish the events.
+  template <typename t_dispatcher>
+  dat::result attach(t_dispatcher &p_dispatcher)
+  {
+    if (!m_state)
+    {
+      return dat::result::ERROR_ADDING_HANDLER;
+    }
+
+    const dat::result _result{
+        m_taps.attach(p_dispatcher, "shm-sender", m_state)};
+    if (_result != dat::result::OK)
+    {
+      TNCT_LOG_ERR(m_state->logger,
+                   format::bus::fmt("error attaching sender: ", _result));
+    }
+    return _result;
+  }
+
+  /// \brief Stops sending, and removes the handlings from the dispatcher
+  ///
+  /// Like removing a handling, it must not be called while other threads
+  /// publish the events
+  void stop()
+  {
+    if (m_state)
+    {
+      m_state->stopped = true;
+    }
+    m_taps.detach();
+  }
+
+  [[nodiscard]] std::size_t get_amount_sent() const
+  {
+    return m_state ? m_state->sent.load() : 0;
+  }
+
+  /// \brief Amount of events not sent, because they were larger than half of
+  /// the ring, because there was no space in the ring after the longest wait,
+  /// or because the sender was stopped
+  [[nodiscard]] std::size_t get_amount_not_sent() const
+  {
+    return m_state ? m_state->not_sent.load() : 0;
+  }
+
+private:
+  // The segment is unmapped, and removed, when the sender and the handlings
+  // that write to it are gone
+  struct state
+  {
+    state(t_logger &p_logger, internal::bus::shm_ring &&p_ring,
+          std::chrono::milliseconds p_max_wait, t_serializer &&p_serializer)
+        : logger(p_logger), ring(std::move(p_ring)), max_wait(p_max_wait),
+          serializer(std::move(p_serializer))
+    {
+    }
+
+    template <async::cpt::is_event t_event> void write(const t_event &p_event)
+    {
+      std::lock_guard<std::mutex> _lock(mutex);
+      if (stopped)
+      {
+        ++not_sent;
+        return;
+      }
+
+      buffer.clear();
+      serializer.serialize(p_event, buffer);
+
+      if (!ring.write(
+              internal::bus::event_index<events, t_event>,
+              std::span<const std::byte>{buffer}, stopped,
+              stalled ? std::chrono::milliseconds::zero() : max_wait))
+      {
+        if (buffer.size() > ring.get_max_event_size())
+        {
+          TNCT_LOG_ERR(logger, format::bus::fmt(p_event, " has ",
+                                                buffer.size(),
+                                                " bytes, more than the ",
+                                                ring.get_max_event_size(),
+                                                " allowed"));
+        }
+        else if (!stopped && !stalled)
+        {
+          TNCT_LOG_ERR(logger,
+                       format::bus::fmt("no space in the ring after ",
+                                        max_wait.count(),
+                                        " ms, dropping events until the "
+                                        "receiver frees space"));
+          stalled = true;
+        }
+        ++not_sent;
+        return;
+      }
+      stalled = false;
+      ++sent;
+    }
+
+    t_logger &logger;
+
+    internal::bus::shm_ring ring;
+
+    const std::chrono::milliseconds max_wait;
+
+    t_serializer serializer;
+
+    // Holds the serialized event until it is written to the ring
+    std::vector<std::byte> buffer;
+
+    std::atomic_bool stopped{false};
+
+    // The last event was dropped for lack of space, so the next ones do not
+    // wait for it
+    bool stalled{false};
+
+    std::atomic_size_t sent{0};
+
+    std::atomic_size_t not_sent{0};
+
+    // The ring has only one writer
+    std::mutex mutex;
+  };
+
+private:
+  explicit shm_sender(std::shared_ptr<state> &&p_state)
+      : m_state(std::move(p_state))
+  {
+  }
+
+private:
+  std::shared_ptr<state> m_state;
+
+  internal::bus::event_taps<state, t_events...> m_taps;
+};
+
+} // namespace tnct::async::bus
+
+#endif
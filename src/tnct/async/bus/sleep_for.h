@@ -0,0 +1,58 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_SLEEP_FOR_H
+#define TNCT_ASYNC_BUS_SLEEP_FOR_H
+
+#include <chrono>
+#include <coroutine>
+
+#include "tnct/async/bus/timer_wheel.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief What a coroutine awaits to be suspended for a while, without keeping
+/// the thread busy
+///
+/// The coroutine is resumed by a worker thread of the \p timer_wheel, so it
+/// should not do much work before it suspends again, or finishes, as the other
+/// timers of the wheel wait for the worker
+class sleep_for
+{
+public:
+  template <typename t_rep, typename t_period>
+  explicit sleep_for(std::chrono::duration<t_rep, t_period> p_duration,
+                     timer_wheel &p_timer_wheel = timer_wheel::shared())
+      : m_duration(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(p_duration)),
+        m_timer_wheel(p_timer_wheel)
+  {
+  }
+
+  bool await_ready() const noexcept
+  {
+    return m_duration <= std::chrono::nanoseconds{0};
+  }
+
+  void await_suspend(std::coroutine_handle<> p_awaiting)
+  {
+    m_timer_wheel.start_once([p_awaiting]() { p_awaiting.resume(); },
+                             m_duration);
+  }
+
+  void await_resume() const noexcept
+  {
+  }
+
+private:
+  std::chrono::nanoseconds m_duration;
+
+  timer_wheel &m_timer_wheel;
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -6,12 +6,15 @@
 #ifndef TNCT_ASYNC_SLEEPING_LOOP_H
 #define TNCT_ASYNC_SLEEPING_LOOP_H
 
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <functional>
 #include <mutex>
 #include <string>
 #include <string_view>
 
+#include "tnct/async/bus/timer_wheel.h"
 #include "tnct/format/bus/fmt.h"
 
 #include "tnct/time/cpt/chrono_convertible.h"
@@ -22,6 +25,18 @@ namespace tnct::async
 {
 
 /// \brief Periodically executes a function
+///
+/// The function is called by the threads of a \p bus::timer_wheel, shared by
+/// all the loops that are not given one, so there is no thread per loop. It is
+/// called as soon as the loop starts, and then at each interval from that
+/// moment, not from the end of the previous call, so the calls do not drift.
+///
+/// \attention The shared \p bus::timer_wheel has as many worker threads as
+/// the hardware threads, but at most 4, for all the loops, and for
+/// \p sleep_for. So a function that blocks, like a publisher waiting for
+/// space in a queue with \p dat::overflow_policy::block, holds one of them,
+/// and if all of them are held, every other loop is called late. A loop whose
+/// function may block should be given its own \p bus::timer_wheel.
 template <log::cpt::logger t_logger>
 struct sleeping_loop
 {
@@ -42,14 +57,28 @@ struct sleeping_loop
   template <time::cpt::convertible_to_nano t_interval>
   sleeping_loop(logger &p_logger, function p_function, t_interval p_interval,
                 std::string_view p_id = "no-id")
-      : m_logger(p_logger), m_id(p_id), m_function(p_function),
+      : sleeping_loop(p_logger, bus::timer_wheel::shared(),
+                      std::move(p_function), p_interval, p_id)
+  {
+  }
+
+  /// \brief Constructor
+  ///
+  /// \param p_timer_wheel where \p p_function will be called, which must live
+  /// longer than the loop
+  template <time::cpt::convertible_to_nano t_interval>
+  sleeping_loop(logger &p_logger, bus::timer_wheel &p_timer_wheel,
+                function p_function, t_interval p_interval,
+                std::string_view p_id = "no-id")
+      : m_logger(p_logger), m_timer_wheel(p_timer_wheel), m_id(p_id),
+        m_function(std::move(p_function)),
         m_interval(std::chrono::duration_cast<decltype(m_interval)>(p_interval))
   {
 
     TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
-                                       " - creating with function ",
-                                       &m_function, " and interval of ",
-                                       m_interval.count(), " nanosecs"));
+                                            " - creating with function ",
+                                            &m_function, " and interval of ",
+                                            m_interval.count(), " nanosecs"));
   }
 
   sleeping_loop()                                 = delete;
@@ -57,61 +86,34 @@ struct sleeping_loop
   sleeping_loop &operator=(const sleeping_loop &) = delete;
 
   /// \brief Destructor
-  /// The loops stops calling the function
+  /// The loops stops calling the function, and waits for a call that may be
+  /// running, unless it is destroyed inside the function
   ~sleeping_loop()
   {
     TNCT_LOG_TRA(m_logger,
                  format::bus::fmt("sleeping loop ", m_id, " - destructor"));
 
     stop();
-    if (m_thread.get_id() == std::thread::id())
-    {
-      TNCT_LOG_TRA(m_logger,
-                   format::bus::fmt("sleeping loop ", m_id,
-                               " - not joining because m_thread.get_id() == "
-                               "std::thread::id()"));
-
-      return;
-    }
-    TNCT_LOG_TRA(m_logger,
-                 format::bus::fmt("sleeping loop ", m_id,
-                             " - m_thread.get_id() != std::thread::id()"));
-
-    if (!m_thread.joinable())
-    {
-      TNCT_LOG_TRA(
-          m_logger,
-          format::bus::fmt("sleeping loop ", m_id,
-                      " - not joining because m_thread is not joinable"));
-
-      return;
-    }
-    TNCT_LOG_TRA(m_logger,
-                 format::bus::fmt("sleeping loop ", m_id, " - m_thread.joinable()"));
-
-    {
-      std::lock_guard<std::mutex> _lock(m_mutex_join);
-      m_thread.join();
-    }
+    wait();
   }
 
   /// \brief Move constructor
   sleeping_loop(sleeping_loop &&p_loop)
-      : m_logger(p_loop.m_logger), m_id(std::move(p_loop.m_id)),
-        m_function(std::move(p_loop.m_function)), m_interval(p_loop.m_interval)
+      : m_logger(p_loop.m_logger), m_timer_wheel(p_loop.m_timer_wheel),
+        m_id(std::move(p_loop.m_id)), m_function(std::move(p_loop.m_function)),
+        m_interval(p_loop.m_interval)
   {
     TNCT_LOG_TRA(m_logger,
-                 format::bus::fmt("sleeping loop ", m_id, " move constructor from ",
-                             &p_loop, " to ", &(*this)));
-    bool _stopped(p_loop.is_stopped());
+                 format::bus::fmt("sleeping loop ", m_id,
+                                  " move constructor from ", &p_loop, " to ",
+                                  &(*this)));
+    const bool _stopped(p_loop.is_stopped());
 
     p_loop.stop();
-    m_stopped = _stopped;
+    p_loop.wait();
 
-    //    m_thread = std::move(p_loop.m_thread);
-    if (!m_stopped)
+    if (!_stopped)
     {
-      m_stopped = true;
       start();
     }
   }
@@ -122,41 +124,42 @@ struct sleeping_loop
   /// \brief Starts calling the function periodically
   void start()
   {
+    std::lock_guard<std::mutex> _lock(m_mutex);
     if (!m_stopped)
     {
       TNCT_LOG_TRA(m_logger,
                    format::bus::fmt("sleeping loop ", m_id,
-                               " - not starting because it is not stopped"));
+                                    " - not starting because it is not "
+                                    "stopped"));
       return;
     }
     m_stopped = false;
 
-    TNCT_LOG_TRA(m_logger,
-                 format::bus::fmt("sleeping loop ", m_id,
-                             " - starting loop thread in ", &(*this)));
+    TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
+                                            " - starting in ", &(*this)));
 
-    m_thread = std::thread([this]() { loop(); });
+    m_timer = m_timer_wheel.start([this]() { call(); }, m_interval);
   }
 
   /// \brief Stops the loop, if it was started
+  ///
+  /// A call of the function that is running is not interrupted
   void stop()
   {
+    std::lock_guard<std::mutex> _lock(m_mutex);
     if (m_stopped)
     {
       TNCT_LOG_TRA(m_logger,
                    format::bus::fmt("sleeping loop ", m_id,
-                               " - not stopping because it is stopped"));
+                                    " - not stopping because it is stopped"));
 
       return;
     }
     TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
-                                       " - stopping in ", &(*this)));
+                                            " - stopping in ", &(*this)));
 
     m_stopped = true;
-    m_cond.notify_one();
-
-    TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
-                                       " - leaving stop in ", &(*this)));
+    bus::timer_wheel::cancel(m_timer);
   }
 
   /// \brief Retrieves if the loop was stopped
@@ -171,91 +174,47 @@ struct sleeping_loop
   }
 
 private:
-  /// \brief Helper move function
-  // void move(sleeping_loop &&p_loop) {
-  //   bool _stopped = p_loop.is_stopped();
-
-  //   TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id, " - moving ",
-  //                                       p_loop.m_id, " which was",
-  //                                       (_stopped ? " " : " not "),
-  //                                       "stopped"));
-
-  //   p_loop.stop();
-
-  //   m_function = p_loop.m_function;
-  //   m_interval = std::move(p_loop.m_interval);
-  //   m_stopped = true;
-
-  //   if (!_stopped) {
-  //     TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
-  //                                         " - starting it because ",
-  //                                         p_loop.m_id, " was running"));
-
-  //     start();
-  //   }
-
-  //   else {
-  //     TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
-  //                                         " - NOT starting it because ",
-  //                                         p_loop.m_id, " was NOT running"));
-  //   }
-  // }
-
-  /// \brief Loop where the function will be called
-  void loop()
+  /// \brief Waits for a call of the function that may be running, which may
+  /// call \p stop, so \p m_mutex is not locked while waiting
+  void wait()
   {
-    while (true)
+    bus::timer_wheel::timer_ptr _timer;
     {
-      if (m_stopped)
-      {
-        TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id, " - stop"));
-
-        break;
-      }
-
-      TNCT_LOG_TRA(m_logger,
-                   format::bus::fmt("sleeping loop ", m_id, " - calling function ",
-                               &m_function, " in ", &(*this)));
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      _timer = m_timer;
+    }
+    if (_timer)
+    {
+      bus::timer_wheel::wait(_timer);
+    }
+  }
 
+  /// \brief Called by the timer wheel in each round of the loop
+  void call()
+  {
+    TNCT_LOG_TRA(m_logger,
+                 format::bus::fmt("sleeping loop ", m_id, " - calling function ",
+                                  &m_function, " in ", &(*this)));
+    try
+    {
       m_function();
-
-      TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id, " - ",
-                                         &m_function, " called"));
-
-      if (m_stopped)
-      {
-        TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id, " - stop"));
-
-        break;
-      }
-      TNCT_LOG_TRA(m_logger,
-                   format::bus::fmt("sleeping loop ", m_id, " - waiting for ",
-                               m_interval.count(),
-                               " microsecs to elaps, or a stop order"));
-
-      {
-        std::unique_lock<std::mutex> _lock(m_mutex_interval);
-        if ((m_cond.wait_for(_lock, m_interval) == std::cv_status::no_timeout)
-            || (m_stopped))
-        {
-
-          TNCT_LOG_TRA(m_logger,
-                       format::bus::fmt("sleeping loop ", m_id,
-                                   " - ordered to stop in ", &(*this)));
-
-          break;
-        }
-      }
-      TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id, " - ",
-                                         m_interval.count(), " ms elapsed"));
     }
-    TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id,
-                                       " - leaving loop in ", &(*this)));
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, format::bus::fmt("sleeping loop ", m_id, " - ",
+                                              _ex.what()));
+    }
+
+    TNCT_LOG_TRA(m_logger, format::bus::fmt("sleeping loop ", m_id, " - ",
+                                            &m_function, " called"));
   }
 
 private:
   logger &m_logger;
 
+  /// \brief Where \p m_function is called
+  bus::timer_wheel &m_timer_wheel;
+
   /// \brief Identifier of the slepping_loop, to help debugging
   std::string m_id;
 
@@ -266,20 +225,13 @@ private:
   std::chrono::nanoseconds m_interval;
 
   /// \brief Indicates that the loop must stop
-  // std::atomic<bool> m_stopped{true};
-  bool m_stopped{true};
-
-  /// \brief Thread where the \p loop method will run
-  std::thread m_thread;
-
-  /// \brief Protects joining the thread
-  std::mutex m_mutex_join;
+  std::atomic_bool m_stopped{true};
 
-  /// \brief Controls the interval execution
-  std::mutex m_mutex_interval;
+  /// \brief Timer of the current start, if it was started
+  bus::timer_wheel::timer_ptr m_timer;
 
-  /// \brief Controls the interval execution
-  std::condition_variable m_cond;
+  /// \brief Protects \p m_timer
+  std::mutex m_mutex;
 };
 
 } // namespace tnct::async
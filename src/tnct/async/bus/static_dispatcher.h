@@ -0,0 +1,359 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_STATIC_DISPATCHER_H
+#define TNCT_ASYNC_BUS_STATIC_DISPATCHER_H
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/handling_definition.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/handling.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief A dispatcher whose handlings are all defined at compile time
+///
+/// Each \p t_definitions is a \p dat::handling_definition, and the handlings
+/// are created in the constructor, and live as long as the dispatcher. As the
+/// handlings can not be added or removed, they are kept in a \p std::tuple,
+/// and \p publish adds the event to each handling of the event, from the
+/// highest to the lowest \p dat::handling_priority, with direct calls, which
+/// the compiler can inline, instead of walking a map and calling virtual
+/// methods, as \p dispatcher does.
+///
+/// A handling is identified by its position in \p t_definitions, so there is
+/// no search by name.
+///
+/// A move-only event can only be published if there is exactly one handling
+/// for it, which is checked at compile time.
+template <log::cpt::logger t_logger, typename... t_definitions>
+class static_dispatcher final
+{
+public:
+  using logger = t_logger;
+
+  static constexpr std::size_t num_handlings{sizeof...(t_definitions)};
+
+  /// \brief The handlers will be called in their own threads
+  static_dispatcher(logger &p_logger, t_definitions &&...p_definitions)
+      : m_logger(p_logger),
+        m_handlings(creator<t_definitions>{m_logger, nullptr, p_definitions}...)
+  {
+  }
+
+  /// \brief The handlers will be called in the threads of \p p_pool, which
+  /// must live longer than the dispatcher
+  static_dispatcher(logger &p_logger, work_stealing_pool<logger> &p_pool,
+                    t_definitions &&...p_definitions)
+      : m_logger(p_logger),
+        m_handlings(creator<t_definitions>{m_logger, &p_pool, p_definitions}...)
+  {
+  }
+
+  static_dispatcher()                                     = delete;
+  static_dispatcher(const static_dispatcher &)            = delete;
+  static_dispatcher(static_dispatcher &&)                 = delete;
+  static_dispatcher &operator=(const static_dispatcher &) = delete;
+  static_dispatcher &operator=(static_dispatcher &&)      = delete;
+
+  ~static_dispatcher() = default;
+
+  /// \brief Publishes a copy of \p p_event to each handling of \p t_event
+  template <async::cpt::is_event t_event>
+  requires std::copy_constructible<t_event>
+  [[nodiscard]] dat::result publish(const t_event &p_event) noexcept
+  {
+    static_assert(get_amount_handlings<t_event>() > 0,
+                  "there is no handling for the event");
+    try
+    {
+      dat::result _result{dat::result::OK};
+      for_each_by_priority<t_event>(
+          [&](auto &p_handling)
+          { merge(_result, p_handling.add_event(t_event{p_event})); });
+      return _result;
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  /// \brief Publishes \p p_event, which is moved to the last handling of
+  /// \p t_event, and copied only to the others
+  template <async::cpt::is_event t_event>
+  requires(!std::is_lvalue_reference_v<t_event>)
+  [[nodiscard]] dat::result publish(t_event &&p_event) noexcept
+  {
+    static_assert(get_amount_handlings<t_event>() > 0,
+                  "there is no handling for the event");
+    static_assert(std::copy_constructible<t_event>
+                      || (get_amount_handlings<t_event>() == 1),
+                  "an event that can not be copied can have only one handling");
+    try
+    {
+      return fan_out(std::move(p_event));
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  template <async::cpt::is_event t_event, typename... t_event_params>
+  [[nodiscard]] dat::result publish(t_event_params &&...p_params) noexcept
+  {
+    try
+    {
+      return publish<t_event>(
+          t_event{std::forward<t_event_params>(p_params)...});
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  /// \brief Publishes a copy of each event in \p p_events to each handling of
+  /// \p t_event, notifying the handlers of a handling only once
+  template <async::cpt::is_event t_event>
+  requires std::copy_constructible<t_event>
+  [[nodiscard]] dat::result
+  publish_batch(std::span<const t_event> p_events) noexcept
+  {
+    static_assert(get_amount_handlings<t_event>() > 0,
+                  "there is no handling for the event");
+    if (p_events.empty())
+    {
+      return dat::result::OK;
+    }
+    try
+    {
+      dat::result _result{dat::result::OK};
+      for_each_by_priority<t_event>(
+          [&](auto &p_handling)
+          { merge(_result, p_handling.add_events(p_events)); });
+      return _result;
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, _ex.what());
+    }
+    return dat::result::ERROR_PUBLISHNG;
+  }
+
+  /// \return Amount of handlings of \p t_event
+  template <async::cpt::is_event t_event>
+  [[nodiscard]] static constexpr std::size_t get_amount_handlings()
+  {
+    return (std::size_t{0} + ...
+            + (std::same_as<typename t_definitions::event, t_event> ? 1 : 0));
+  }
+
+  /// \brief Defines what happens when an event is published to the handling
+  /// at \p t_idx, and it already has \p p_max_capacity events
+  ///
+  /// \sa dispatcher::set_overflow_policy
+  template <std::size_t t_idx>
+  void set_overflow_policy(dat::overflow_policy p_policy,
+                           std::size_t          p_max_capacity)
+  {
+    std::get<t_idx>(m_handlings).set_overflow_policy(p_policy, p_max_capacity);
+  }
+
+  /// \brief Clears the events queue of the handling at \p t_idx
+  template <std::size_t t_idx>
+  void clear()
+  {
+    std::get<t_idx>(m_handlings).clear();
+  }
+
+  template <std::size_t t_idx>
+  [[nodiscard]] dat::handling_metrics get_metrics() const
+  {
+    return std::get<t_idx>(m_handlings).get_metrics();
+  }
+
+  template <std::size_t t_idx>
+  [[nodiscard]] std::size_t get_num_events() const
+  {
+    return std::get<t_idx>(m_handlings).get_num_events();
+  }
+
+  template <std::size_t t_idx>
+  [[nodiscard]] std::size_t get_amount_handlers() const
+  {
+    return std::get<t_idx>(m_handlings).get_amount_handlers();
+  }
+
+private:
+  using pool = work_stealing_pool<logger>;
+
+  template <typename t_definition>
+  using handling =
+      internal::bus::handling_concrete<logger, typename t_definition::event,
+                                       typename t_definition::queue,
+                                       typename t_definition::handler>;
+
+  using handlings = std::tuple<handling<t_definitions>...>;
+
+  // Creates the handling in its place in 'm_handlings', as it is not copied
+  // nor moved when returned from the conversion operator
+  template <typename t_definition>
+  struct creator
+  {
+    operator handling<t_definition>() const
+    {
+      return handling<t_definition>(
+          definition.name, log, std::move(definition.events_handler),
+          std::move(definition.events_queue), definition.num_handlers, p_pool,
+          t_definition::priority, definition.batch_size);
+    }
+
+    logger       &log;
+    pool         *p_pool;
+    t_definition &definition;
+  };
+
+  // Positions in 'm_handlings', from the highest to the lowest priority, and in
+  // the order they were defined, if the priority is the same
+  static constexpr std::array<std::size_t, num_handlings> by_priority{
+      []()
+      {
+        constexpr std::array<dat::handling_priority, num_handlings> _priorities{
+            t_definitions::priority...};
+
+        std::array<std::size_t, num_handlings> _positions{};
+        for (std::size_t _i = 0; _i < num_handlings; ++_i)
+        {
+          _positions[_i] = _i;
+        }
+        // insertion sort keeps the order of handlings with the same priority
+        for (std::size_t _i = 1; _i < num_handlings; ++_i)
+        {
+          for (std::size_t _j = _i;
+               (_j > 0)
+               && (_priorities[_positions[_j - 1]]
+                   < _priorities[_positions[_j]]);
+               --_j)
+          {
+            std::swap(_positions[_j - 1], _positions[_j]);
+          }
+        }
+        return _positions;
+      }()};
+
+  template <std::size_t t_idx>
+  using event_at = typename std::tuple_element_t<
+      t_idx, std::tuple<t_definitions...>>::event;
+
+  // Position in 'm_handlings' of the last handling of 't_event' to be called
+  template <typename t_event>
+  static constexpr std::size_t last_handling{
+      []()
+      {
+        std::size_t _last{num_handlings};
+        [&]<std::size_t... t_order>(std::index_sequence<t_order...>)
+        {
+          ((std::same_as<event_at<by_priority[t_order]>, t_event>
+                ? (_last = by_priority[t_order])
+                : _last),
+           ...);
+        }(std::make_index_sequence<num_handlings>{});
+        return _last;
+      }()};
+
+private:
+  // Calls \p p_function with each handling of \p t_event, from the highest to
+  // the lowest priority
+  template <typename t_event, typename t_function>
+  void for_each_by_priority(t_function &&p_function)
+  {
+    [&]<std::size_t... t_order>(std::index_sequence<t_order...>)
+    {
+      (
+          [&]()
+          {
+            constexpr std::size_t _idx{by_priority[t_order]};
+            if constexpr (std::same_as<event_at<_idx>, t_event>)
+            {
+              p_function(std::get<_idx>(m_handlings));
+            }
+          }(),
+          ...);
+    }(std::make_index_sequence<num_handlings>{});
+  }
+
+  // Copies \p p_event to all handlings of \p t_event but the last, to which it
+  // is moved
+  template <typename t_event>
+  dat::result fan_out(t_event &&p_event)
+  {
+    dat::result _result{dat::result::OK};
+    [&]<std::size_t... t_order>(std::index_sequence<t_order...>)
+    {
+      (
+          [&]()
+          {
+            constexpr std::size_t _idx{by_priority[t_order]};
+            if constexpr (!std::same_as<event_at<_idx>, t_event>)
+            {
+            }
+            else if constexpr (_idx == last_handling<t_event>)
+            {
+              merge(_result,
+                    std::get<_idx>(m_handlings).add_event(std::move(p_event)));
+            }
+            else
+            {
+              merge(_result,
+                    std::get<_idx>(m_handlings).add_event(t_event{p_event}));
+            }
+          }(),
+          ...);
+    }(std::make_index_sequence<num_handlings>{});
+    return _result;
+  }
+
+  // Keeps in \p p_result the first error of the handlings of an event, as the
+  // event is still added to the other handlings
+  static void merge(dat::result &p_result, dat::result p_handling_result)
+  {
+    if (p_result == dat::result::OK)
+    {
+      p_result = p_handling_result;
+    }
+  }
+
+private:
+  logger &m_logger;
+
+  handlings m_handlings;
+};
+
+} // namespace tnct::async::bus
+
+#endif
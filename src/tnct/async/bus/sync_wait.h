@@ -0,0 +1,104 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_SYNC_WAIT_H
+#define TNCT_ASYNC_BUS_SYNC_WAIT_H
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "tnct/async/dat/task.h"
+#include "tnct/async/internal/bus/detached.h"
+
+namespace tnct::async::internal::bus
+{
+
+template <typename t_value>
+struct sync_wait_state
+{
+  std::optional<t_value> value;
+};
+
+template <>
+struct sync_wait_state<void>
+{
+};
+
+// Where 'sync_wait' waits for the task to finish
+template <typename t_value>
+struct sync_waiting : sync_wait_state<t_value>
+{
+  std::exception_ptr exception;
+
+  bool done{false};
+
+  std::mutex mutex;
+
+  std::condition_variable cond;
+};
+
+template <typename t_value>
+detached sync_wait_run(async::dat::task<t_value> &p_task,
+                       sync_waiting<t_value>     &p_waiting)
+{
+  try
+  {
+    if constexpr (std::is_void_v<t_value>)
+    {
+      co_await std::move(p_task);
+    }
+    else
+    {
+      p_waiting.value.emplace(co_await std::move(p_task));
+    }
+  }
+  catch (...)
+  {
+    p_waiting.exception = std::current_exception();
+  }
+
+  // nothing of 'p_waiting' is used after 'mutex' is released, as
+  // 'sync_wait' may return
+  std::lock_guard<std::mutex> _lock(p_waiting.mutex);
+  p_waiting.done = true;
+  p_waiting.cond.notify_one();
+}
+
+} // namespace tnct::async::internal::bus
+
+namespace tnct::async::bus
+{
+
+/// \brief Runs \p p_task, blocking the thread until it finishes, so a
+/// \p dat::task can be used where there is no coroutine to \p co_await it
+///
+/// \return What \p p_task returns, or throws what it throws
+template <typename t_value>
+t_value sync_wait(dat::task<t_value> &&p_task)
+{
+  internal::bus::sync_waiting<t_value> _waiting;
+  internal::bus::sync_wait_run(p_task, _waiting);
+  {
+    std::unique_lock<std::mutex> _lock(_waiting.mutex);
+    _waiting.cond.wait(_lock, [&_waiting]() { return _waiting.done; });
+  }
+
+  if (_waiting.exception)
+  {
+    std::rethrow_exception(_waiting.exception);
+  }
+  if constexpr (!std::is_void_v<t_value>)
+  {
+    return std::move(*_waiting.value);
+  }
+}
+
+} // namespace tnct::async::bus
+
+#endif
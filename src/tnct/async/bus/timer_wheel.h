@@ -0,0 +1,530 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_TIMER_WHEEL_H
+#define TNCT_ASYNC_BUS_TIMER_WHEEL_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tnct::async::bus
+{
+
+/// \brief Calls many functions periodically, in a small fixed set of threads
+///
+/// The moments the functions must be called are kept in a hierarchical timing
+/// wheel, with \p num_levels levels of \p num_slots slots, where a slot of the
+/// first level lasts a tick, and a slot of the next level lasts as much as all
+/// the slots of the previous one. A thread advances the wheel, sleeping until
+/// the next tick with timers, and the functions due are called by the worker
+/// threads, so adding and cancelling a timer costs O(1), no matter how many
+/// timers there are.
+///
+/// A function is first called as soon as its timer is started, and then at
+/// each \p interval from that moment, not from the end of the previous call,
+/// so the calls do not drift. A function is never called again before its
+/// previous call finishes, and if a call takes longer than the interval, the
+/// moments missed are skipped. A function started by \p start_once is called
+/// only once, after a delay.
+///
+/// A function is not called before the moment it is due, and it is called at
+/// most one tick, plus the time a worker thread takes to be free, after it.
+class timer_wheel
+{
+public:
+  using clock    = std::chrono::steady_clock;
+  using function = std::function<void()>;
+
+  struct timer;
+
+  /// \brief Identifies a timer started, and allows to cancel it
+  using timer_ptr = std::shared_ptr<timer>;
+
+  static constexpr std::size_t num_slots{256};
+  static constexpr std::size_t num_levels{4};
+
+  /// \param p_num_workers is the amount of threads that call the functions,
+  /// which is at least 1
+  ///
+  /// \param p_tick is the duration of a slot of the first level of the wheel
+  explicit timer_wheel(
+      std::size_t               p_num_workers = default_num_workers(),
+      std::chrono::nanoseconds  p_tick        = std::chrono::milliseconds{1})
+      : m_tick(std::max(p_tick, std::chrono::nanoseconds{1}))
+  {
+    m_workers.reserve(std::max(p_num_workers, std::size_t{1}));
+    for (std::size_t _i = 0; _i < std::max(p_num_workers, std::size_t{1});
+         ++_i)
+    {
+      m_workers.push_back(std::thread([this]() { work(); }));
+    }
+    m_ticker = std::thread([this]() { tick(); });
+  }
+
+  timer_wheel(const timer_wheel &)            = delete;
+  timer_wheel(timer_wheel &&)                 = delete;
+  timer_wheel &operator=(const timer_wheel &) = delete;
+  timer_wheel &operator=(timer_wheel &&)      = delete;
+
+  /// \brief Stops the threads, and the functions are not called anymore
+  ~timer_wheel()
+  {
+    {
+      std::lock_guard<std::mutex> _lock(m_wheel_mutex);
+      m_stopping = true;
+    }
+    m_wheel_cond.notify_all();
+    {
+      std::lock_guard<std::mutex> _lock(m_ready_mutex);
+      m_ready_stopping = true;
+    }
+    m_ready_cond.notify_all();
+
+    m_ticker.join();
+    for (std::thread &_worker : m_workers)
+    {
+      _worker.join();
+    }
+  }
+
+  /// \brief The wheel shared by all the \p sleeping_loop objects that are not
+  /// given one, and by \p sleep_for, created the first time it is used
+  static timer_wheel &shared()
+  {
+    static timer_wheel _timer_wheel;
+    return _timer_wheel;
+  }
+
+  /// \brief Calls \p p_function now, and then at each \p p_interval
+  [[nodiscard]] timer_ptr start(function                 p_function,
+                                std::chrono::nanoseconds p_interval)
+  {
+    timer_ptr _timer{std::make_shared<timer>(
+        std::move(p_function),
+        std::max(p_interval, std::chrono::nanoseconds{1}), clock::now())};
+    ready(_timer);
+    return _timer;
+  }
+
+  /// \brief Calls \p p_function only once, \p p_delay from now
+  timer_ptr start_once(function p_function, std::chrono::nanoseconds p_delay)
+  {
+    const clock::time_point _now{clock::now()};
+    timer_ptr _timer{std::make_shared<timer>(
+        std::move(p_function), std::chrono::nanoseconds{0}, _now + p_delay)};
+    if (p_delay <= std::chrono::nanoseconds{0})
+    {
+      ready(_timer);
+    }
+    else
+    {
+      ++m_num_timers;
+      schedule(timer_ptr{_timer}, _now);
+    }
+    return _timer;
+  }
+
+  /// \brief Stops calling the function of \p p_timer, without waiting for a
+  /// call that may be running
+  static void cancel(const timer_ptr &p_timer)
+  {
+    p_timer->cancelled.store(true);
+  }
+
+  /// \brief Waits for a call of the function of \p p_timer that may be
+  /// running, unless it is called from inside the function
+  static void wait(const timer_ptr &p_timer)
+  {
+    if (p_timer->caller.load() == std::this_thread::get_id())
+    {
+      return;
+    }
+    while (p_timer->running.load())
+    {
+      p_timer->running.wait(true);
+    }
+  }
+
+  [[nodiscard]] std::size_t get_num_workers() const
+  {
+    return m_workers.size();
+  }
+
+  [[nodiscard]] std::chrono::nanoseconds get_tick() const
+  {
+    return m_tick;
+  }
+
+  /// \brief Amount of timers in the wheel, or waiting for a worker
+  [[nodiscard]] std::size_t get_num_timers() const
+  {
+    return m_num_timers.load();
+  }
+
+  struct timer
+  {
+    timer(function p_function, std::chrono::nanoseconds p_interval,
+          clock::time_point p_next)
+        : call(std::move(p_function)), interval(p_interval), next(p_next)
+    {
+    }
+
+    function call;
+
+    // 0 if the function is called only once
+    std::chrono::nanoseconds interval;
+
+    // Moment the function is due
+    clock::time_point next;
+
+    std::atomic_bool cancelled{false};
+
+    // If the function is being called
+    std::atomic_bool running{false};
+
+    std::atomic<std::thread::id> caller{};
+  };
+
+private:
+  using slot  = std::vector<timer_ptr>;
+  using level = std::array<slot, num_slots>;
+
+  static constexpr std::size_t slot_bits{8};
+
+  static_assert((std::size_t{1} << slot_bits) == num_slots);
+
+private:
+  static std::size_t default_num_workers()
+  {
+    return std::clamp(std::size_t{std::thread::hardware_concurrency()},
+                      std::size_t{1}, std::size_t{4});
+  }
+
+  // First tick at, or after, \p p_time, so a function is never called early
+  std::uint64_t to_tick(clock::time_point p_time) const
+  {
+    if (p_time <= m_origin)
+    {
+      return 0;
+    }
+    const auto _elapsed{p_time - m_origin};
+    return static_cast<std::uint64_t>((_elapsed + m_tick - clock::duration{1})
+                                      / m_tick);
+  }
+
+  // Last tick that started at, or before, \p p_time
+  std::uint64_t elapsed_ticks(clock::time_point p_time) const
+  {
+    if (p_time <= m_origin)
+    {
+      return 0;
+    }
+    return static_cast<std::uint64_t>((p_time - m_origin) / m_tick);
+  }
+
+  clock::time_point to_time(std::uint64_t p_tick) const
+  {
+    return m_origin
+           + std::chrono::duration_cast<clock::duration>(
+               m_tick * static_cast<std::int64_t>(p_tick));
+  }
+
+  // Puts \p p_timer in the slot of its tick, or in the ready queue, if it is
+  // due; 'm_wheel_mutex' must be locked
+  void insert(timer_ptr &&p_timer, std::vector<timer_ptr> &p_ready)
+  {
+    const std::uint64_t _tick{to_tick(p_timer->next)};
+    if (_tick <= m_current)
+    {
+      p_ready.push_back(std::move(p_timer));
+      return;
+    }
+
+    const std::uint64_t _delta{_tick - m_current};
+    for (std::size_t _level = 0; _level < num_levels; ++_level)
+    {
+      if (_delta < (std::uint64_t{1} << (slot_bits * (_level + 1))))
+      {
+        m_levels[_level][(_tick >> (slot_bits * _level)) % num_slots]
+            .push_back(std::move(p_timer));
+        return;
+      }
+    }
+
+    // beyond the wheel, it waits in the slot of the last level that is
+    // cascaded the latest, and is inserted again from there
+    constexpr std::size_t _last{num_levels - 1};
+    m_levels[_last][((m_current >> (slot_bits * _last)) + num_slots - 1)
+                    % num_slots]
+        .push_back(std::move(p_timer));
+  }
+
+  // Moves the timers in the current slot of the higher levels to the lower
+  // ones, and the ones due in the current tick to \p p_ready
+  void advance(std::vector<timer_ptr> &p_ready)
+  {
+    ++m_current;
+
+    // from the highest level, as its timers may go to a slot of a lower level
+    // that is cascaded in this same tick
+    for (std::size_t _level = num_levels - 1; _level > 0; --_level)
+    {
+      const std::size_t _shift{slot_bits * _level};
+      if ((m_current & ((std::uint64_t{1} << _shift) - 1)) != 0)
+      {
+        continue;
+      }
+      slot _slot{std::move(m_levels[_level][(m_current >> _shift) % num_slots])};
+      for (timer_ptr &_timer : _slot)
+      {
+        insert(std::move(_timer), p_ready);
+      }
+    }
+
+    slot &_slot{m_levels[0][m_current % num_slots]};
+    std::move(_slot.begin(), _slot.end(), std::back_inserter(p_ready));
+    _slot.clear();
+  }
+
+  // Thread that advances the wheel at each tick
+  void tick()
+  {
+    std::vector<timer_ptr> _ready;
+    std::unique_lock<std::mutex> _lock(m_wheel_mutex);
+    while (!m_stopping)
+    {
+      if (m_num_in_wheel == 0)
+      {
+        m_wheel_cond.wait(_lock, [this]()
+                          { return m_stopping || (m_num_in_wheel != 0); });
+        if (m_stopping)
+        {
+          break;
+        }
+      }
+
+      const std::uint64_t _now{elapsed_ticks(clock::now())};
+      while ((m_current < _now) && (m_num_in_wheel != 0))
+      {
+        advance(_ready);
+        m_num_in_wheel -= _ready.size();
+        if (!_ready.empty())
+        {
+          _lock.unlock();
+          ready(_ready);
+          _lock.lock();
+        }
+      }
+      if (m_num_in_wheel == 0)
+      {
+        // the wheel is empty, so it can jump to the present
+        m_current = std::max(m_current, _now);
+        continue;
+      }
+
+      m_wake_at = next_tick_with_work();
+      m_wheel_cond.wait_until(_lock, to_time(m_wake_at), [this]()
+                              { return m_stopping || m_woken_earlier; });
+      m_wake_at       = std::numeric_limits<std::uint64_t>::max();
+      m_woken_earlier = false;
+    }
+  }
+
+  // The next tick with timers in its slot of the first level, or where the
+  // higher levels are cascaded; 'm_wheel_mutex' must be locked
+  std::uint64_t next_tick_with_work() const
+  {
+    const std::uint64_t _cascade{(m_current | (num_slots - 1)) + 1};
+    for (std::uint64_t _tick = m_current + 1; _tick < _cascade; ++_tick)
+    {
+      if (!m_levels[0][_tick % num_slots].empty())
+      {
+        return _tick;
+      }
+    }
+    return _cascade;
+  }
+
+  // Thread that calls the functions due
+  void work()
+  {
+    while (true)
+    {
+      timer_ptr _timer;
+      {
+        std::unique_lock<std::mutex> _lock(m_ready_mutex);
+        m_ready_cond.wait(_lock, [this]()
+                          { return m_ready_stopping || !m_ready.empty(); });
+        if (m_ready_stopping)
+        {
+          return;
+        }
+        _timer = std::move(m_ready.front());
+        m_ready.pop_front();
+      }
+      call(std::move(_timer));
+    }
+  }
+
+  void call(timer_ptr &&p_timer)
+  {
+    // 'running' is set before 'cancelled' is checked, and 'cancel' sets
+    // 'cancelled' before 'wait' checks 'running', so after 'cancel' and
+    // 'wait' the function is not called
+    p_timer->caller.store(std::this_thread::get_id());
+    p_timer->running.store(true);
+    if (!p_timer->cancelled.load())
+    {
+      try
+      {
+        p_timer->call();
+      }
+      catch (...)
+      {
+      }
+    }
+    p_timer->caller.store(std::thread::id{});
+    p_timer->running.store(false);
+    p_timer->running.notify_all();
+
+    if (p_timer->cancelled.load()
+        || (p_timer->interval == std::chrono::nanoseconds{0}))
+    {
+      --m_num_timers;
+      return;
+    }
+
+    // the next moment is counted from the previous one, so it does not drift
+    const clock::time_point _now{clock::now()};
+    p_timer->next += p_timer->interval;
+    if (p_timer->next <= _now)
+    {
+      const auto _missed{(_now - p_timer->next) / p_timer->interval + 1};
+      p_timer->next += p_timer->interval * _missed;
+    }
+
+    schedule(std::move(p_timer), _now);
+  }
+
+  // Inserts \p p_timer in the wheel, or in the timers due, if its moment has
+  // already come
+  void schedule(timer_ptr &&p_timer, clock::time_point p_now)
+  {
+    std::vector<timer_ptr> _ready;
+    {
+      std::lock_guard<std::mutex> _lock(m_wheel_mutex);
+      const std::uint64_t _tick{to_tick(p_timer->next)};
+      if (m_num_in_wheel == 0)
+      {
+        // the wheel was not advanced while it was empty
+        m_current = std::max(m_current, elapsed_ticks(p_now));
+      }
+      insert(std::move(p_timer), _ready);
+      if (_ready.empty())
+      {
+        // the ticker sleeps until the next tick with timers
+        if ((m_num_in_wheel++ == 0) || (_tick < m_wake_at))
+        {
+          m_woken_earlier = true;
+          m_wheel_cond.notify_one();
+        }
+      }
+    }
+    if (!_ready.empty())
+    {
+      ready(_ready);
+    }
+  }
+
+  void ready(timer_ptr p_timer)
+  {
+    ++m_num_timers;
+    {
+      std::lock_guard<std::mutex> _lock(m_ready_mutex);
+      m_ready.push_back(std::move(p_timer));
+    }
+    m_ready_cond.notify_one();
+  }
+
+  void ready(std::vector<timer_ptr> &p_timers)
+  {
+    {
+      std::lock_guard<std::mutex> _lock(m_ready_mutex);
+      for (timer_ptr &_timer : p_timers)
+      {
+        m_ready.push_back(std::move(_timer));
+      }
+    }
+    if (p_timers.size() == 1)
+    {
+      m_ready_cond.notify_one();
+    }
+    else
+    {
+      m_ready_cond.notify_all();
+    }
+    p_timers.clear();
+  }
+
+private:
+  const std::chrono::nanoseconds m_tick;
+
+  // Moment of tick 0
+  const clock::time_point m_origin{clock::now()};
+
+  // Last tick processed
+  std::uint64_t m_current{0};
+
+  std::array<level, num_levels> m_levels;
+
+  // Tick until which the ticker sleeps
+  std::uint64_t m_wake_at{std::numeric_limits<std::uint64_t>::max()};
+
+  // A timer was inserted before 'm_wake_at', so the ticker must find again
+  // until when to sleep
+  bool m_woken_earlier{false};
+
+  // Amount of timers in 'm_levels'
+  std::size_t m_num_in_wheel{0};
+
+  // Amount of timers not cancelled, or whose cancellation was not noticed
+  std::atomic_size_t m_num_timers{0};
+
+  bool m_stopping{false};
+
+  std::mutex m_wheel_mutex;
+
+  std::condition_variable m_wheel_cond;
+
+  // Timers due, waiting for a worker
+  std::deque<timer_ptr> m_ready;
+
+  bool m_ready_stopping{false};
+
+  std::mutex m_ready_mutex;
+
+  std::condition_variable m_ready_cond;
+
+  std::thread m_ticker;
+
+  std::vector<std::thread> m_workers;
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -0,0 +1,355 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_BUS_WORK_STEALING_POOL_H
+#define TNCT_ASYNC_BUS_WORK_STEALING_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::bus
+{
+
+/// \brief A fixed set of threads that execute tasks, where an idle thread
+/// steals tasks from the other threads
+///
+/// Each worker thread has its own queue of tasks. A task submitted from a
+/// worker thread goes to that worker's queue, and a task submitted from any
+/// other thread goes to the queues in a round-robin way. A worker executes
+/// the tasks in its own queue, and when it is empty, it takes tasks from the
+/// other workers' queues.
+///
+/// A task can have a \p dat::handling_priority, and tasks with higher priority
+/// are always taken, from its own queue or from another worker's queue, before
+/// tasks with lower priority. Among tasks with the same priority, a worker takes
+/// the oldest one from its own queue, and the newest one from another worker's
+/// queue.
+///
+/// Submitting a task, and taking one, locks only the queue of the worker, and
+/// an idle worker sleeps until a task is submitted, or the pool is stopped.
+///
+/// A \p bus::dispatcher can use a \p work_stealing_pool to execute all of its
+/// handlers, and many dispatchers can share the same pool. The pool must be
+/// destroyed after all the dispatchers that use it, and not by one of its
+/// tasks.
+template <log::cpt::logger t_logger>
+class work_stealing_pool final
+{
+public:
+  using logger = t_logger;
+  using task   = std::function<void()>;
+
+  /// \param p_num_workers is the number of threads in the pool, which will be
+  /// at least 1
+  work_stealing_pool(logger     &p_logger,
+                     std::size_t p_num_workers = default_num_workers())
+      : m_logger(p_logger)
+  {
+    if (p_num_workers == 0)
+    {
+      p_num_workers = 1;
+    }
+
+    for (std::size_t _i = 0; _i < p_num_workers; ++_i)
+    {
+      m_workers.push_back(std::make_unique<worker>());
+    }
+
+    for (std::size_t _i = 0; _i < p_num_workers; ++_i)
+    {
+      m_workers[_i]->thread = std::thread([this, _i]() { loop(_i); });
+    }
+
+    TNCT_LOG_TRA(m_logger, format::bus::fmt("work_stealing_pool with ",
+                                            p_num_workers, " workers"));
+  }
+
+  work_stealing_pool()                                      = delete;
+  work_stealing_pool(const work_stealing_pool &)            = delete;
+  work_stealing_pool(work_stealing_pool &&)                 = delete;
+  work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+  work_stealing_pool &operator=(work_stealing_pool &&)      = delete;
+
+  /// \brief Executes the tasks already submitted, and joins the threads
+  ///
+  /// It must not be called from one of the tasks
+  ~work_stealing_pool()
+  {
+    stop();
+  }
+
+  /// \brief Submits a task to be executed by one of the workers
+  ///
+  /// \return \p false if the pool is stopped, and the task will not be
+  /// executed
+  bool submit(task                 &&p_task,
+              dat::handling_priority p_priority = dat::handling_priority::medium)
+  {
+    // counted before 'm_stopped' is checked, so a worker that sees the pool
+    // stopped also sees the task, and does not leave while it is being queued
+    ++m_pending;
+    if (m_stopped)
+    {
+      --m_pending;
+      wake_up_all();
+      return false;
+    }
+
+    const std::size_t _idx{is_worker() ? *current_worker_idx
+                                       : m_next_worker++ % m_workers.size()};
+
+    {
+      worker                     &_worker{*m_workers[_idx]};
+      std::lock_guard<std::mutex> _lock(_worker.mutex);
+      _worker.queues[priority_idx(p_priority)].push_back(std::move(p_task));
+    }
+
+    ++m_epoch;
+    if (m_sleeping > 0)
+    {
+      m_epoch.notify_one();
+    }
+    return true;
+  }
+
+  /// \brief Stops accepting tasks, waits for the submitted ones to be
+  /// executed, and joins the threads
+  ///
+  /// If it is called from one of the tasks, the pool stops accepting tasks,
+  /// but the threads are joined only by a later call from another thread, or
+  /// by the destructor
+  void stop()
+  {
+    if (!m_stopped.exchange(true))
+    {
+      wake_up_all();
+    }
+
+    if (is_worker())
+    {
+      return;
+    }
+
+    std::lock_guard<std::mutex> _lock(m_join_mutex);
+    for (std::unique_ptr<worker> &_worker : m_workers)
+    {
+      if (_worker->thread.joinable())
+      {
+        _worker->thread.join();
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t get_num_workers() const
+  {
+    return m_workers.size();
+  }
+
+  [[nodiscard]] bool is_stopped() const
+  {
+    return m_stopped;
+  }
+
+  /// \return If the current thread is one of the workers of this pool
+  [[nodiscard]] bool is_worker() const
+  {
+    return current_pool == this;
+  }
+
+  static std::size_t default_num_workers()
+  {
+    const std::size_t _num{std::thread::hardware_concurrency()};
+    return (_num == 0 ? 1 : _num);
+  }
+
+private:
+  // one queue for each 'dat::handling_priority' value
+  static constexpr std::size_t num_priorities{
+      static_cast<std::size_t>(dat::handling_priority::highest)};
+
+  using tasks = std::array<std::deque<task>, num_priorities>;
+
+  struct worker
+  {
+    std::mutex  mutex;
+    tasks       queues;
+    std::thread thread;
+  };
+
+  using workers = std::vector<std::unique_ptr<worker>>;
+
+private:
+  static constexpr std::size_t priority_idx(dat::handling_priority p_priority)
+  {
+    return static_cast<std::size_t>(p_priority) - 1;
+  }
+
+  // Takes the task with the highest priority from the worker \p p_idx, from
+  // the front of its queue if it is its own, or from the back if it is stealing
+  std::optional<task> take(std::size_t p_idx, bool p_own)
+  {
+    worker                     &_worker{*m_workers[p_idx]};
+    std::lock_guard<std::mutex> _lock(_worker.mutex);
+    for (std::size_t _priority = num_priorities; _priority > 0; --_priority)
+    {
+      std::deque<task> &_tasks{_worker.queues[_priority - 1]};
+      if (!_tasks.empty())
+      {
+        task _task;
+        if (p_own)
+        {
+          _task = std::move(_tasks.front());
+          _tasks.pop_front();
+        }
+        else
+        {
+          _task = std::move(_tasks.back());
+          _tasks.pop_back();
+        }
+        return {std::move(_task)};
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::optional<task> find_task(std::size_t p_idx)
+  {
+    if (std::optional<task> _task{take(p_idx, true)}; _task)
+    {
+      return _task;
+    }
+
+    for (std::size_t _i = 1; _i < m_workers.size(); ++_i)
+    {
+      if (std::optional<task> _task{
+              take((p_idx + _i) % m_workers.size(), false)};
+          _task)
+      {
+        return _task;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void wake_up_all()
+  {
+    ++m_epoch;
+    m_epoch.notify_all();
+  }
+
+  // Waits for a task, and returns \p std::nullopt if the pool is stopped, and
+  // there are no more tasks to execute
+  std::optional<task> wait_task(std::size_t p_idx)
+  {
+    while (true)
+    {
+      if (std::optional<task> _task{find_task(p_idx)}; _task)
+      {
+        return _task;
+      }
+
+      // the epoch is read before looking for tasks again, so a task queued
+      // after that changes it, and the worker does not sleep on it
+      ++m_sleeping;
+      const std::uint32_t _epoch{m_epoch};
+
+      if (std::optional<task> _task{find_task(p_idx)}; _task)
+      {
+        --m_sleeping;
+        return _task;
+      }
+
+      if (m_stopped && (m_pending == 0))
+      {
+        --m_sleeping;
+        return std::nullopt;
+      }
+
+      m_epoch.wait(_epoch);
+      --m_sleeping;
+    }
+  }
+
+  void loop(std::size_t p_idx)
+  {
+    current_worker_idx = p_idx;
+    current_pool       = this;
+
+    while (true)
+    {
+      std::optional<task> _task{wait_task(p_idx)};
+      if (!_task)
+      {
+        break;
+      }
+
+      if ((--m_pending == 0) && m_stopped)
+      {
+        // the workers sleeping because this task was pending can leave
+        wake_up_all();
+      }
+
+      try
+      {
+        (*_task)();
+      }
+      catch (std::exception &_ex)
+      {
+        TNCT_LOG_ERR(m_logger, format::bus::fmt("task raised '", _ex.what(),
+                                                '\''));
+      }
+      catch (...)
+      {
+        TNCT_LOG_ERR(m_logger, "task raised an unknown exception");
+      }
+    }
+    current_pool = nullptr;
+    current_worker_idx.reset();
+  }
+
+private:
+  // index of the worker running in the current thread, if any
+  static inline thread_local std::optional<std::size_t> current_worker_idx;
+
+  // pool of the worker running in the current thread, if any
+  static inline thread_local const work_stealing_pool *current_pool{nullptr};
+
+  logger &m_logger;
+
+  workers m_workers;
+
+  // amount of tasks submitted and not yet taken by a worker
+  std::atomic_size_t m_pending{0};
+
+  std::atomic_bool m_stopped{false};
+
+  std::atomic_size_t m_next_worker{0};
+
+  // changed when a task is queued, or the pool is stopped, so the idle
+  // workers, counted in 'm_sleeping', wake up
+  std::atomic_uint32_t m_epoch{0};
+  std::atomic_size_t   m_sleeping{0};
+
+  // joining is done by one thread at a time
+  std::mutex m_join_mutex;
+};
+
+} // namespace tnct::async::bus
+
+#endif
@@ -10,7 +10,7 @@
 #include "tnct/async/dat/handling_priority.h"
 #include "tnct/async/dat/result.h"
 #include "tnct/async/cpt/is_event.h"
-#include "tnct/async/cpt/is_handler.h"
+#include "tnct/async/cpt/is_any_handler.h"
 #include "tnct/container/cpt/queue.h"
 
 namespace tnct::async::cpt
@@ -24,7 +24,7 @@ template <typename t, typename t_event, typename t_queue, typename t_handler>
 concept has_add_handling_method =
     async::cpt::is_event<t_event>
     && container::cpt::queue<t_queue, t_event>
-    && async::cpt::is_handler<t_handler, t_event>
+    && async::cpt::is_any_handler<t_handler, t_event>
     && requires(t &d, async::dat::handling_name &&p_handling_name,
                 t_queue &&p_queue, t_handler &&p_handler,
                 async::dat::handling_priority &&p_handling_priority,
@@ -35,7 +35,7 @@ concept has_add_handling_method =
                p_handling_name, std::move(p_queue),
                std::move(p_handler), p_handling_priority,
                p_num_handlers)
-         } -> std::same_as<async::dat::result>;
+         } -> std::convertible_to<async::dat::result>;
        };
 
 } // namespace tnct::async::cpt
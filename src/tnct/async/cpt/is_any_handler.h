@@ -0,0 +1,24 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_ANY_HANDLER_H
+#define TNCT_ASYNC_CPT_IS_ANY_HANDLER_H
+
+#include "tnct/async/cpt/is_batch_handler.h"
+#include "tnct/async/cpt/is_coroutine_handler.h"
+#include "tnct/async/cpt/is_handler.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief A handler that receives one event at a time, or many events at once,
+/// or that is a coroutine
+template <typename t, typename t_event>
+concept is_any_handler = is_handler<t, t_event> || is_batch_handler<t, t_event>
+                         || is_coroutine_handler<t, t_event>;
+
+} // namespace tnct::async::cpt
+
+#endif
@@ -0,0 +1,31 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_BATCH_HANDLER_H
+#define TNCT_ASYNC_CPT_IS_BATCH_HANDLER_H
+
+#include <concepts>
+#include <span>
+
+#include "tnct/async/cpt/is_event.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief A handler that receives many events at once, which it can move from
+template <typename t, typename t_event>
+concept is_batch_handler =
+
+    is_event<t_event> &&
+
+    requires(t p_t, std::span<t_event> p_events) {
+      {
+        p_t(p_events)
+      } -> std::same_as<void>;
+    };
+
+} // namespace tnct::async::cpt
+
+#endif
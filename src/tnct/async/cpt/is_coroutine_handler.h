@@ -0,0 +1,39 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_COROUTINE_HANDLER_H
+#define TNCT_ASYNC_CPT_IS_COROUTINE_HANDLER_H
+
+#include <concepts>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/task.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief A handler that is a coroutine, which can \p co_await, for example, a
+/// \p async::dat::reply or \p async::bus::sleep_for, without keeping a handler
+/// thread busy while it is suspended
+///
+/// Like a \p async::cpt::is_handler, it receives the event as a rvalue
+/// reference, and the event lives until the coroutine finishes
+template <typename t, typename t_event>
+concept is_coroutine_handler =
+
+    is_event<t_event> &&
+
+    requires(t p_t, t_event &&evt) {
+      {
+        p_t(std::move(evt))
+      } -> std::same_as<async::dat::task<void>>;
+    } &&
+
+    !requires(t p_t, t_event &evt) { p_t(evt); }
+    && !requires(t p_t, const t_event &evt) { p_t(evt); };
+
+} // namespace tnct::async::cpt
+
+#endif
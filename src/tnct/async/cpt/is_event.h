@@ -6,6 +6,7 @@
 #ifndef TNCT_ASYNC_CPT_IS_EVENT_H
 #define TNCT_ASYNC_CPT_IS_EVENT_H
 
+#include <concepts>
 #include <type_traits>
 
 #include "tnct/ostream/cpt/has_output_operator.h"
@@ -13,9 +14,11 @@
 namespace tnct::async::cpt
 {
 
+/// \brief An event only needs to be movable, so events that own resources, or
+/// are expensive to copy, can be published by moving them
 template <typename t>
 concept is_event =
-    /*std::default_initializable<t> && */ std::copyable<t> // && std::movable<t>
+    /*std::default_initializable<t> && */ std::movable<t>
     && ostream::cpt::has_output_operator<t> && std::is_class_v<t>;
 
 }
@@ -0,0 +1,31 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_EVENT_FILTER_H
+#define TNCT_ASYNC_CPT_IS_EVENT_FILTER_H
+
+#include <concepts>
+
+#include "tnct/async/cpt/is_event.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief Tells, from the content of an event, if a handling is interested in
+/// it, like a temperature from a certain sensor
+template <typename t, typename t_event>
+concept is_event_filter =
+
+    is_event<t_event> && std::move_constructible<t> &&
+
+    requires(const t p_t, const t_event &p_event) {
+      {
+        p_t(p_event)
+      } -> std::convertible_to<bool>;
+    };
+
+} // namespace tnct::async::cpt
+
+#endif
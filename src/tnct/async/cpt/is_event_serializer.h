@@ -0,0 +1,42 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_EVENT_SERIALIZER_H
+#define TNCT_ASYNC_CPT_IS_EVENT_SERIALIZER_H
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "tnct/async/cpt/is_event.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief Converts a \p t_event to bytes, and back, so it can be recorded by a
+/// \p async::bus::recorder, and replayed by a \p async::bus::replayer
+///
+/// \p serialize appends the bytes of the event to the buffer, and
+/// \p deserialize returns \p std::nullopt if the bytes are not a \p t_event.
+/// The type is passed to \p deserialize in a \p std::type_identity, so a
+/// serializer can handle many types of events.
+template <typename t, typename t_event>
+concept is_event_serializer =
+    is_event<t_event>
+    && requires(t &p_serializer, const t_event &p_event,
+                std::vector<std::byte> &p_buffer,
+                std::span<const std::byte> p_bytes) {
+         p_serializer.serialize(p_event, p_buffer);
+         {
+           p_serializer.deserialize(p_bytes, std::type_identity<t_event>{})
+         } -> std::same_as<std::optional<t_event>>;
+       };
+
+} // namespace tnct::async::cpt
+
+#endif
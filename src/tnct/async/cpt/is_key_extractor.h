@@ -0,0 +1,34 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_KEY_EXTRACTOR_H
+#define TNCT_ASYNC_CPT_IS_KEY_EXTRACTOR_H
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "tnct/async/cpt/is_event.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief Returns, from an event, a key that can be hashed by \p std::hash,
+/// like the id of the sensor that generated a temperature
+template <typename t, typename t_event>
+concept is_key_extractor =
+
+    is_event<t_event> && std::copy_constructible<t> &&
+
+    requires(const t p_t, const t_event &p_event) {
+      {
+        std::hash<std::remove_cvref_t<decltype(p_t(p_event))>>{}(p_t(p_event))
+      } -> std::convertible_to<std::size_t>;
+    };
+
+} // namespace tnct::async::cpt
+
+#endif
@@ -0,0 +1,43 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_CPT_IS_PMR_EVENT_H
+#define TNCT_ASYNC_CPT_IS_PMR_EVENT_H
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "tnct/async/cpt/is_event.h"
+
+namespace tnct::async::cpt
+{
+
+/// \brief An event that allocates its members, like a \p std::pmr::string or
+/// a \p std::pmr::vector, with a \p std::pmr::polymorphic_allocator, which it
+/// receives as the last parameter of its constructors, or after
+/// \p std::allocator_arg, so it can be moved, or copied, to the memory of a
+/// \p async::dat::event_pool
+///
+/// \p get_allocator returns the allocator the event uses
+template <typename t>
+concept is_pmr_event =
+    is_event<t>
+    && std::uses_allocator_v<t, std::pmr::polymorphic_allocator<std::byte>>
+    && (std::constructible_from<t, t &&,
+                                std::pmr::polymorphic_allocator<std::byte>>
+        || std::constructible_from<t, std::allocator_arg_t,
+                                   std::pmr::polymorphic_allocator<std::byte>,
+                                   t &&>)
+    && requires(const t &p_event) {
+         {
+           p_event.get_allocator().resource()
+         } -> std::convertible_to<std::pmr::memory_resource *>;
+       };
+
+} // namespace tnct::async::cpt
+
+#endif
@@ -0,0 +1,87 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_AFFINITY_H
+#define TNCT_ASYNC_DAT_AFFINITY_H
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace tnct::async::dat
+{
+
+/// \brief Indexes of CPUs, as the operating system numbers them
+using cpu_set = std::vector<std::size_t>;
+
+/// \brief CPUs where the handler threads of a handling may run
+///
+/// A handler whose index has a non empty set in \p per_handler runs in those
+/// CPUs, and the others run in \p cpus. If the set of a handler is empty, its
+/// thread runs in any CPU, as a thread with no affinity.
+struct affinity
+{
+  cpu_set cpus;
+
+  std::vector<cpu_set> per_handler;
+
+  /// \return The CPUs where the handler at \p p_handler_pos may run
+  [[nodiscard]] const cpu_set &of(std::size_t p_handler_pos) const
+  {
+    if ((p_handler_pos < per_handler.size())
+        && !per_handler[p_handler_pos].empty())
+    {
+      return per_handler[p_handler_pos];
+    }
+    return cpus;
+  }
+
+  /// \return \p true if no handler has CPUs defined
+  [[nodiscard]] bool empty() const
+  {
+    if (!cpus.empty())
+    {
+      return false;
+    }
+    for (const cpu_set &_cpus : per_handler)
+    {
+      if (!_cpus.empty())
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  friend std::ostream &operator<<(std::ostream   &p_out,
+                                  const affinity &p_affinity)
+  {
+    p_out << "{cpus ";
+    print(p_out, p_affinity.cpus);
+    p_out << ", per handler {";
+    for (std::size_t _i = 0; _i < p_affinity.per_handler.size(); ++_i)
+    {
+      p_out << (_i == 0 ? "" : ",");
+      print(p_out, p_affinity.per_handler[_i]);
+    }
+    p_out << "}}";
+    return p_out;
+  }
+
+private:
+  static void print(std::ostream &p_out, const cpu_set &p_cpus)
+  {
+    p_out << '{';
+    for (std::size_t _i = 0; _i < p_cpus.size(); ++_i)
+    {
+      p_out << (_i == 0 ? "" : ",") << p_cpus[_i];
+    }
+    p_out << '}';
+  }
+};
+
+} // namespace tnct::async::dat
+
+#endif
@@ -0,0 +1,95 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_AUTOSCALING_H
+#define TNCT_ASYNC_DAT_AUTOSCALING_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+
+#include "tnct/async/dat/handling_name.h"
+
+namespace tnct::async::dat
+{
+
+/// \brief What an evaluation of a \p autoscaling policy found, and decided
+struct autoscaling_decision
+{
+  handling_name name;
+
+  /// \brief Amount of handlers before the evaluation
+  std::size_t from{0};
+
+  /// \brief Amount of handlers after the evaluation, equal to \p from if
+  /// nothing changed
+  std::size_t to{0};
+
+  /// \brief Amount of events in the queue
+  std::size_t queued{0};
+
+  /// \brief Fraction, from 0 to 1, of the time since the previous evaluation
+  /// the handlers spent handling events
+  double utilisation{0.0};
+
+  friend std::ostream &operator<<(std::ostream               &p_out,
+                                  const autoscaling_decision &p_decision)
+  {
+    p_out << "{name '" << p_decision.name << "', from " << p_decision.from
+          << ", to " << p_decision.to << ", queued " << p_decision.queued
+          << ", utilisation " << p_decision.utilisation << '}';
+    return p_out;
+  }
+};
+
+/// \brief Policy that grows and shrinks the amount of handler threads of a
+/// handling, between \p min_handlers and \p max_handlers
+///
+/// At each evaluation, if there are more than \p grow_above_queued events in
+/// the queue per handler, it is a vote to grow, and if the queue is empty and
+/// the handlers were busy less than \p shrink_below_utilisation of the time,
+/// it is a vote to shrink. One handler is added after
+/// \p evaluations_to_grow votes to grow in a row, and one handler is removed
+/// after \p evaluations_to_shrink votes to shrink in a row, so a short burst,
+/// or pause, does not change the amount of handlers.
+struct autoscaling
+{
+  std::size_t min_handlers{1};
+
+  std::size_t max_handlers{1};
+
+  std::size_t grow_above_queued{64};
+
+  double shrink_below_utilisation{0.25};
+
+  std::size_t evaluations_to_grow{2};
+
+  std::size_t evaluations_to_shrink{5};
+
+  /// \brief Time between evaluations, where 0 means the handling is only
+  /// evaluated when \p bus::dispatcher::autoscale is called
+  std::chrono::milliseconds interval{100};
+
+  /// \brief Called after each evaluation, by the thread that evaluated
+  std::function<void(const autoscaling_decision &)> on_decision;
+
+  friend std::ostream &operator<<(std::ostream      &p_out,
+                                  const autoscaling &p_autoscaling)
+  {
+    p_out << "{min " << p_autoscaling.min_handlers << ", max "
+          << p_autoscaling.max_handlers << ", grow above queued "
+          << p_autoscaling.grow_above_queued << ", shrink below utilisation "
+          << p_autoscaling.shrink_below_utilisation << ", evaluations to grow "
+          << p_autoscaling.evaluations_to_grow << ", evaluations to shrink "
+          << p_autoscaling.evaluations_to_shrink << ", interval "
+          << p_autoscaling.interval.count() << "ms}";
+    return p_out;
+  }
+};
+
+} // namespace tnct::async::dat
+
+#endif
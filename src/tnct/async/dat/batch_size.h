@@ -0,0 +1,20 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_BATCH_SIZE_H
+#define TNCT_ASYNC_DAT_BATCH_SIZE_H
+
+#include <cstddef>
+
+namespace tnct::async::dat
+{
+
+/// \brief Maximum amount of events passed at once to a batch handler, if not
+/// informed when the handling is added
+inline constexpr std::size_t default_batch_size{64};
+
+} // namespace tnct::async::dat
+
+#endif
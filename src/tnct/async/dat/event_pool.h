@@ -0,0 +1,45 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_EVENT_POOL_H
+#define TNCT_ASYNC_DAT_EVENT_POOL_H
+
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+
+namespace tnct::async::dat
+{
+
+/// \brief Memory of a handling, where its events, and what they allocate with
+/// a \p std::pmr::polymorphic_allocator, are kept while they are queued and
+/// handled
+///
+/// Blocks of up to \p largest_block bytes are taken from chunks of up to
+/// \p blocks_per_chunk blocks, requested to \p upstream, and a block is reused
+/// when the event that allocated it is destroyed, so, once the handling has
+/// seen as many events as it holds at the same time, handling an event does
+/// not allocate from \p upstream. Larger blocks are requested to \p upstream
+/// each time.
+struct event_pool
+{
+  std::size_t largest_block{4096};
+
+  std::size_t blocks_per_chunk{256};
+
+  /// \brief Must live longer than the handling
+  std::pmr::memory_resource *upstream{std::pmr::new_delete_resource()};
+
+  friend std::ostream &operator<<(std::ostream &p_out, const event_pool &p_pool)
+  {
+    p_out << "{largest block " << p_pool.largest_block
+          << ", blocks per chunk " << p_pool.blocks_per_chunk << '}';
+    return p_out;
+  }
+};
+
+} // namespace tnct::async::dat
+
+#endif
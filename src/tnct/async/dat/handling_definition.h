@@ -0,0 +1,59 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_HANDLING_DEFINITION_H
+#define TNCT_ASYNC_DAT_HANDLING_DEFINITION_H
+
+#include <cstddef>
+#include <utility>
+
+#include "tnct/async/cpt/is_any_handler.h"
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/batch_size.h"
+#include "tnct/async/dat/handling_name.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/container/cpt/queue.h"
+
+namespace tnct::async::dat
+{
+
+/// \brief Everything needed to create a handling in a
+/// \p async::bus::static_dispatcher
+///
+/// The types of the event, of the queue and of the handler, and the priority,
+/// are known at compile time, so the \p async::bus::static_dispatcher can call
+/// the handling directly
+template <async::cpt::is_event t_event, container::cpt::queue<t_event> t_queue,
+          async::cpt::is_any_handler<t_event> t_handler,
+          handling_priority t_priority = handling_priority::medium>
+struct handling_definition
+{
+  using event   = t_event;
+  using queue   = t_queue;
+  using handler = t_handler;
+
+  static constexpr handling_priority priority{t_priority};
+
+  /// \param p_batch_size is the maximum amount of events passed at once to
+  /// \p p_handler, if it is a \p async::cpt::is_batch_handler
+  handling_definition(handling_name p_name, queue &&p_queue,
+                      handler &&p_handler, std::size_t p_num_handlers = 1,
+                      std::size_t p_batch_size = default_batch_size)
+      : name(p_name), events_queue(std::move(p_queue)),
+        events_handler(std::move(p_handler)), num_handlers(p_num_handlers),
+        batch_size(p_batch_size)
+  {
+  }
+
+  handling_name name;
+  queue         events_queue;
+  handler       events_handler;
+  std::size_t   num_handlers;
+  std::size_t   batch_size;
+};
+
+} // namespace tnct::async::dat
+
+#endif
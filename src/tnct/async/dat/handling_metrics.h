@@ -0,0 +1,114 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_HANDLING_METRICS_H
+#define TNCT_ASYNC_DAT_HANDLING_METRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tnct/async/dat/histogram.h"
+
+namespace tnct::async::dat
+{
+
+/// \brief Metrics of one of the handlers of a handling
+struct handler_metrics
+{
+  /// \brief Amount of events passed to the handler
+  std::uint64_t handled{0};
+
+  /// \brief Time spent inside the handler
+  std::chrono::nanoseconds busy{0};
+
+  /// \brief Time since the handler was created, not spent inside the handler
+  std::chrono::nanoseconds idle{0};
+
+  friend std::ostream &operator<<(std::ostream          &p_out,
+                                  const handler_metrics &p_metrics)
+  {
+    p_out << "{handled " << p_metrics.handled << ", busy "
+          << p_metrics.busy.count() << "ns, idle " << p_metrics.idle.count()
+          << "ns}";
+    return p_out;
+  }
+};
+
+/// \brief Snapshot of the metrics of a handling, since it was created
+///
+/// The counters are read one at a time, while events may be being published
+/// and handled, so they may not add up exactly
+struct handling_metrics
+{
+  std::string name;
+
+  /// \brief Amount of events published to the handling, including the ones
+  /// dropped or rejected due to its \p dat::overflow_policy
+  std::uint64_t published{0};
+
+  /// \brief Amount of events passed to the handlers
+  std::uint64_t handled{0};
+
+  /// \brief Amount of events discarded by \p dat::overflow_policy::drop_newest
+  /// or \p dat::overflow_policy::drop_oldest
+  std::uint64_t dropped{0};
+
+  /// \brief Amount of events discarded by \p dat::overflow_policy::reject
+  std::uint64_t rejected{0};
+
+  /// \brief Amount of events that replaced, in the queue, an event with the
+  /// same key not handled yet, when the queue is a
+  /// \p container::cpt::coalescing_queue
+  std::uint64_t coalesced{0};
+
+  /// \brief Amount of events not added to the handling because its filter
+  /// did not accept them, which are not counted in \p published
+  std::uint64_t filtered{0};
+
+  /// \brief Amount of events in the queue
+  std::size_t queued{0};
+
+  /// \brief Greatest amount of events that were in the queue at the same time
+  std::size_t high_water_mark{0};
+
+  /// \brief Time from the moment events were added to the queue to the moment
+  /// a handler took them, not recorded if the queue does not pop the events in
+  /// the order they were added, like a \p container::cpt::multi_level_queue
+  histogram enqueue_to_dequeue;
+
+  /// \brief Time each call to a handler took
+  histogram handler_time;
+
+  /// \brief Metrics of each handler of the handling
+  std::vector<handler_metrics> handlers;
+
+  friend std::ostream &operator<<(std::ostream           &p_out,
+                                  const handling_metrics &p_metrics)
+  {
+    p_out << "{name '" << p_metrics.name << "', published "
+          << p_metrics.published << ", handled " << p_metrics.handled
+          << ", dropped " << p_metrics.dropped << ", rejected "
+          << p_metrics.rejected << ", coalesced " << p_metrics.coalesced
+          << ", filtered " << p_metrics.filtered
+          << ", queued " << p_metrics.queued
+          << ", high water mark " << p_metrics.high_water_mark
+          << ", enqueue to dequeue " << p_metrics.enqueue_to_dequeue
+          << ", handler time " << p_metrics.handler_time << ", handlers [";
+    for (std::size_t _i = 0; _i < p_metrics.handlers.size(); ++_i)
+    {
+      p_out << (_i == 0 ? "" : ", ") << p_metrics.handlers[_i];
+    }
+    p_out << "]}";
+    return p_out;
+  }
+};
+
+} // namespace tnct::async::dat
+
+#endif
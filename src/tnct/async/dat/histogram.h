@@ -0,0 +1,189 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_HISTOGRAM_H
+#define TNCT_ASYNC_DAT_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+namespace tnct::async::dat
+{
+
+/// \brief Distribution of durations, in nanoseconds
+///
+/// Like an HDR histogram, the width of the buckets grows with the values, so
+/// any value, including the minimum and the maximum, is reported with an error
+/// of at most 1/16 of itself, while all the values from 1 nanosecond to
+/// hundreds of years fit in a fixed number of buckets
+class histogram
+{
+public:
+  using duration = std::chrono::nanoseconds;
+
+  /// \brief Each power of 2 is divided in this amount of buckets
+  static constexpr std::size_t sub_buckets{16};
+
+  static constexpr std::size_t num_buckets{
+      (std::numeric_limits<std::uint64_t>::digits
+       - std::bit_width(sub_buckets - 1) + 1)
+      * sub_buckets};
+
+  /// \return Index of the bucket where \p p_value is counted
+  static constexpr std::size_t bucket(std::uint64_t p_value)
+  {
+    if (p_value < sub_buckets)
+    {
+      return static_cast<std::size_t>(p_value);
+    }
+    const std::size_t _shift{static_cast<std::size_t>(std::bit_width(p_value))
+                             - sub_bucket_bits - 1};
+    return ((_shift + 1) * sub_buckets)
+           + static_cast<std::size_t>((p_value >> _shift) - sub_buckets);
+  }
+
+  /// \return Smallest value counted in the bucket \p p_bucket
+  static constexpr std::uint64_t lowest_in_bucket(std::size_t p_bucket)
+  {
+    if (p_bucket < sub_buckets)
+    {
+      return p_bucket;
+    }
+    const std::size_t   _shift{(p_bucket / sub_buckets) - 1};
+    const std::uint64_t _sub{sub_buckets + (p_bucket % sub_buckets)};
+    return _sub << _shift;
+  }
+
+  /// \return Greatest value counted in the bucket \p p_bucket
+  static constexpr std::uint64_t highest_in_bucket(std::size_t p_bucket)
+  {
+    if (p_bucket + 1 == num_buckets)
+    {
+      return std::numeric_limits<std::uint64_t>::max();
+    }
+    return lowest_in_bucket(p_bucket + 1) - 1;
+  }
+
+  void record(duration p_duration)
+  {
+    add(bucket(static_cast<std::uint64_t>(
+            std::max(p_duration.count(), std::int64_t{0}))),
+        1);
+  }
+
+  /// \brief Adds \p p_count values counted in the bucket \p p_bucket
+  void add(std::size_t p_bucket, std::uint64_t p_count)
+  {
+    m_buckets[p_bucket] += p_count;
+    m_count += p_count;
+  }
+
+  void merge(const histogram &p_histogram)
+  {
+    for (std::size_t _bucket = 0; _bucket < num_buckets; ++_bucket)
+    {
+      m_buckets[_bucket] += p_histogram.m_buckets[_bucket];
+    }
+    m_count += p_histogram.m_count;
+  }
+
+  [[nodiscard]] std::uint64_t get_count() const
+  {
+    return m_count;
+  }
+
+  [[nodiscard]] duration get_min() const
+  {
+    return get_percentile(0.0);
+  }
+
+  [[nodiscard]] duration get_max() const
+  {
+    return get_percentile(1.0);
+  }
+
+  [[nodiscard]] duration get_mean() const
+  {
+    if (m_count == 0)
+    {
+      return duration{0};
+    }
+    double _sum{0};
+    for (std::size_t _bucket = 0; _bucket < num_buckets; ++_bucket)
+    {
+      if (m_buckets[_bucket] != 0)
+      {
+        _sum += static_cast<double>(m_buckets[_bucket])
+                * ((static_cast<double>(lowest_in_bucket(_bucket))
+                    + static_cast<double>(highest_in_bucket(_bucket)))
+                   / 2.0);
+      }
+    }
+    return duration{
+        static_cast<duration::rep>(_sum / static_cast<double>(m_count))};
+  }
+
+  /// \return The greatest value of the bucket where the value greater than, or
+  /// equal to, \p p_percentile (from 0.0 to 1.0) of the values recorded is
+  [[nodiscard]] duration get_percentile(double p_percentile) const
+  {
+    if (m_count == 0)
+    {
+      return duration{0};
+    }
+    const auto _rank{std::max(
+        std::uint64_t{1},
+        static_cast<std::uint64_t>(std::clamp(p_percentile, 0.0, 1.0)
+                                   * static_cast<double>(m_count)))};
+
+    std::uint64_t _counted{0};
+    std::size_t   _bucket{0};
+    for (; _bucket < num_buckets; ++_bucket)
+    {
+      _counted += m_buckets[_bucket];
+      if (_counted >= _rank)
+      {
+        break;
+      }
+    }
+    return duration{static_cast<duration::rep>(std::min(
+        highest_in_bucket(_bucket),
+        static_cast<std::uint64_t>(std::numeric_limits<duration::rep>::max())))};
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out,
+                                  const histogram &p_histogram)
+  {
+    p_out << "{count " << p_histogram.get_count() << ", min "
+          << p_histogram.get_min().count() << "ns, p50 "
+          << p_histogram.get_percentile(0.50).count() << "ns, p90 "
+          << p_histogram.get_percentile(0.90).count() << "ns, p99 "
+          << p_histogram.get_percentile(0.99).count() << "ns, p99.9 "
+          << p_histogram.get_percentile(0.999).count() << "ns, max "
+          << p_histogram.get_max().count() << "ns}";
+    return p_out;
+  }
+
+private:
+  static constexpr std::size_t sub_bucket_bits{
+      static_cast<std::size_t>(std::bit_width(sub_buckets - 1))};
+
+  static_assert(std::has_single_bit(sub_buckets));
+
+private:
+  std::array<std::uint64_t, num_buckets> m_buckets{};
+
+  std::uint64_t m_count{0};
+};
+
+} // namespace tnct::async::dat
+
+#endif
@@ -0,0 +1,62 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_OVERFLOW_POLICY_H
+#define TNCT_ASYNC_DAT_OVERFLOW_POLICY_H
+
+#include <cstdint>
+#include <iostream>
+
+namespace tnct::async::dat
+{
+
+/// \brief Defines what happens when an event is published to a handling that
+/// already holds its maximum capacity of events
+enum class overflow_policy : uint8_t
+{
+  /// \brief The queue grows, ignoring the maximum capacity
+  grow = 0,
+  /// \brief The publisher waits until a handler takes an event from the queue
+  block,
+  /// \brief The event published is discarded
+  drop_newest,
+  /// \brief The oldest event in the queue is discarded, or, if the queue has
+  /// levels of urgency, the oldest of the least urgent level
+  drop_oldest,
+  /// \brief The event published is discarded, and \p publish returns
+  /// \p dat::result::ERROR_QUEUE_FULL
+  reject
+};
+
+/// \brief Output operator for \p overflow_policy
+inline std::ostream &operator<<(std::ostream &p_out, overflow_policy p_policy)
+{
+  switch (p_policy)
+  {
+  case overflow_policy::grow:
+    p_out << "grow";
+    break;
+  case overflow_policy::block:
+    p_out << "block";
+    break;
+  case overflow_policy::drop_newest:
+    p_out << "drop newest";
+    break;
+  case overflow_policy::drop_oldest:
+    p_out << "drop oldest";
+    break;
+  case overflow_policy::reject:
+    p_out << "reject";
+    break;
+  default:
+    p_out << "UNDEFINED";
+    break;
+  }
+  return p_out;
+}
+
+} // namespace tnct::async::dat
+
+#endif
@@ -0,0 +1,108 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_REPLY_H
+#define TNCT_ASYNC_DAT_REPLY_H
+
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "tnct/async/internal/dat/reply_slot.h"
+
+namespace tnct::async::dat
+{
+
+/// \brief The reply to an \p async::dat::request, returned by
+/// \p async::bus::dispatcher::request, that is fulfilled by the handler that
+/// handles the request
+///
+/// The reply can be taken only once, and \p get returns \p std::nullopt if the
+/// request was not replied, because there was no handling for it, the handling
+/// was stopped or dropped the request, or no handler replied to it
+///
+/// A coroutine can \p co_await the reply, and it is resumed by the thread
+/// that replies to the request
+template <std::movable t_reply>
+class reply
+{
+public:
+  using slot = internal::dat::reply_slot<t_reply>;
+
+  explicit reply(std::shared_ptr<slot> p_slot) : m_slot(std::move(p_slot))
+  {
+  }
+
+  reply(const reply &)            = delete;
+  reply(reply &&)                 = default;
+  reply &operator=(const reply &) = delete;
+  reply &operator=(reply &&)      = default;
+
+  ~reply() = default;
+
+  /// \return \p true if \p get will not block
+  [[nodiscard]] bool is_ready() const
+  {
+    return !m_slot || m_slot->is_done();
+  }
+
+  /// \brief Waits for the reply
+  [[nodiscard]] std::optional<t_reply> get()
+  {
+    if (!m_slot)
+    {
+      return std::nullopt;
+    }
+    return std::exchange(m_slot, nullptr)->take();
+  }
+
+  /// \brief Waits at most \p p_timeout for the reply
+  ///
+  /// \return \p std::nullopt if the request was not replied in \p p_timeout
+  template <typename t_rep, typename t_period>
+  [[nodiscard]] std::optional<t_reply>
+  get(std::chrono::duration<t_rep, t_period> p_timeout)
+  {
+    if (!m_slot)
+    {
+      return std::nullopt;
+    }
+    return std::exchange(m_slot, nullptr)->take_for(p_timeout);
+  }
+
+  auto operator co_await() noexcept
+  {
+    struct awaiter
+    {
+      bool await_ready() const
+      {
+        return m_reply.is_ready();
+      }
+
+      bool await_suspend(std::coroutine_handle<> p_awaiting)
+      {
+        return m_reply.m_slot->resume_when_done(p_awaiting);
+      }
+
+      std::optional<t_reply> await_resume()
+      {
+        return m_reply.get();
+      }
+
+      reply &m_reply;
+    };
+    return awaiter{*this};
+  }
+
+private:
+  std::shared_ptr<slot> m_slot;
+};
+
+} // namespace tnct::async::dat
+
+#endif
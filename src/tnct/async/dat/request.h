@@ -0,0 +1,132 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_REQUEST_H
+#define TNCT_ASYNC_DAT_REQUEST_H
+
+#include <concepts>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/internal/dat/reply_slot.h"
+
+namespace tnct::async::dat
+{
+
+/// \brief Event published by \p async::bus::dispatcher::request, that carries
+/// \p t_event and the slot where the handler puts the reply to it
+///
+/// A handling for \p request<t_event, t_reply> is added like any other, and
+/// \p request<t_event, t_reply> must be one of the events of the
+/// \p async::bus::dispatcher
+///
+/// The copies of a request, made when it is published to more than one
+/// handling, share the same slot, and only the first reply is kept
+template <async::cpt::is_event t_event, std::movable t_reply>
+class request
+{
+public:
+  using event      = t_event;
+  using reply_type = t_reply;
+  using slot       = internal::dat::reply_slot<t_reply>;
+
+  request(t_event &&p_event, std::shared_ptr<slot> p_slot)
+      : m_event(std::move(p_event)), m_slot(std::move(p_slot))
+  {
+    if (m_slot)
+    {
+      m_slot->add_request();
+    }
+  }
+
+  request(const request &p_request)
+  requires std::copy_constructible<t_event>
+      : m_event(p_request.m_event), m_slot(p_request.m_slot)
+  {
+    if (m_slot)
+    {
+      m_slot->add_request();
+    }
+  }
+
+  request(request &&p_request)
+      : m_event(std::move(p_request.m_event)),
+        m_slot(std::exchange(p_request.m_slot, nullptr))
+  {
+  }
+
+  request &operator=(const request &p_request)
+  requires std::copy_constructible<t_event>
+  {
+    if (this != &p_request)
+    {
+      *this = request{p_request};
+    }
+    return *this;
+  }
+
+  request &operator=(request &&p_request)
+  {
+    if (this != &p_request)
+    {
+      release();
+      m_event = std::move(p_request.m_event);
+      m_slot  = std::exchange(p_request.m_slot, nullptr);
+    }
+    return *this;
+  }
+
+  ~request()
+  {
+    release();
+  }
+
+  [[nodiscard]] const t_event &get_event() const
+  {
+    return m_event;
+  }
+
+  [[nodiscard]] t_event &get_event()
+  {
+    return m_event;
+  }
+
+  /// \return \p false if the request was already replied, and \p p_reply is
+  /// discarded
+  bool reply(t_reply p_reply)
+  {
+    if (!m_slot)
+    {
+      return false;
+    }
+    return m_slot->set(std::move(p_reply));
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out, const request &p_request)
+  {
+    p_out << "request " << p_request.m_event;
+    return p_out;
+  }
+
+private:
+  void release()
+  {
+    if (m_slot)
+    {
+      std::exchange(m_slot, nullptr)->remove_request();
+    }
+  }
+
+private:
+  t_event m_event;
+
+  std::shared_ptr<slot> m_slot;
+};
+
+} // namespace tnct::async::dat
+
+#endif
@@ -23,8 +23,12 @@ enum class result : std::uint8_t
   ERROR_ADDING_HANDLER,
   ERROR_STOPPING,
   ERROR_HANDLER_ALREADY_IN_USE,
-  ERROR_CREATING_QUEUE
-
+  ERROR_CREATING_QUEUE,
+  ERROR_QUEUE_FULL,
+  ERROR_SETTING_AFFINITY,
+  ERROR_RECORDING,
+  ERROR_REPLAYING,
+  ERROR_HANDLING
 };
 
 static inline std::ostream &operator<<(std::ostream &p_out, result p_result)
@@ -61,6 +65,21 @@ static inline std::ostream &operator<<(std::ostream &p_out, result p_result)
   case result::ERROR_CREATING_QUEUE:
     p_out << "error creating queue";
     break;
+  case result::ERROR_QUEUE_FULL:
+    p_out << "error queue is full";
+    break;
+  case result::ERROR_SETTING_AFFINITY:
+    p_out << "error setting the CPUs where a thread runs";
+    break;
+  case result::ERROR_RECORDING:
+    p_out << "error recording events";
+    break;
+  case result::ERROR_REPLAYING:
+    p_out << "error replaying events";
+    break;
+  case result::ERROR_HANDLING:
+    p_out << "error handling an event";
+    break;
   }
 
   return p_out;
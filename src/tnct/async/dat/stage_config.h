@@ -0,0 +1,55 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_STAGE_CONFIG_H
+#define TNCT_ASYNC_DAT_STAGE_CONFIG_H
+
+#include <cstddef>
+#include <iostream>
+
+namespace tnct::async::dat
+{
+
+/// \brief How a stage of a \p bus::pipeline runs
+///
+/// A fused stage has no queue and no thread: it is called by the thread of
+/// the stage before it, or by the publisher, if it is the first stage, as
+/// soon as that stage produces a value. It is meant for stages that take less
+/// time than a queue hop, which costs a copy, a lock and a wake up.
+///
+/// A stage that is not fused has a queue of at most \p capacity values, and
+/// \p handlers threads that take the values from it. The stage before it, or
+/// the publisher, waits for space when the queue is full, so a slow stage
+/// slows down the ones before it, instead of making its queue grow.
+struct stage_config
+{
+  bool fuse{false};
+
+  std::size_t handlers{1};
+
+  std::size_t capacity{1024};
+
+  friend std::ostream &operator<<(std::ostream       &p_out,
+                                  const stage_config &p_config)
+  {
+    if (p_config.fuse)
+    {
+      p_out << "{fused}";
+    }
+    else
+    {
+      p_out << "{handlers " << p_config.handlers << ", capacity "
+            << p_config.capacity << '}';
+    }
+    return p_out;
+  }
+};
+
+/// \brief A \p stage_config of a stage fused to the one before it
+inline constexpr stage_config fused{true, 0, 0};
+
+} // namespace tnct::async::dat
+
+#endif
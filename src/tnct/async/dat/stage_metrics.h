@@ -0,0 +1,78 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_STAGE_METRICS_H
+#define TNCT_ASYNC_DAT_STAGE_METRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace tnct::async::dat
+{
+
+/// \brief Metrics of a stage of a \p bus::pipeline
+struct stage_metrics
+{
+  std::string name;
+
+  bool fused{false};
+
+  /// \brief Amount of threads that call the stage, which, for a fused stage,
+  /// are the ones of the stage it is fused to
+  std::size_t threads{1};
+
+  /// \brief Amount of values the stage function was called with
+  std::uint64_t handled{0};
+
+  /// \brief Time spent inside the stage function, not counting the time of
+  /// the stages fused after it
+  std::chrono::nanoseconds busy{0};
+
+  /// \brief Time since the stage was created
+  std::chrono::nanoseconds elapsed{0};
+
+  /// \brief Amount of values in the queue of the stage, always 0 if it is
+  /// fused
+  std::size_t queued{0};
+
+  /// \return Values handled per second
+  [[nodiscard]] double throughput() const
+  {
+    return elapsed.count() == 0 ? 0.0
+                                : static_cast<double>(handled) * 1e9
+                                      / static_cast<double>(elapsed.count());
+  }
+
+  /// \return Fraction, from 0 to 1, of the time of its threads spent inside
+  /// the stage function, so the stage with the greatest one is the bottleneck
+  [[nodiscard]] double utilisation() const
+  {
+    if ((elapsed.count() == 0) || (threads == 0))
+    {
+      return 0.0;
+    }
+    return static_cast<double>(busy.count())
+           / (static_cast<double>(elapsed.count())
+              * static_cast<double>(threads));
+  }
+
+  friend std::ostream &operator<<(std::ostream        &p_out,
+                                  const stage_metrics &p_metrics)
+  {
+    p_out << "{name '" << p_metrics.name << "', fused "
+          << (p_metrics.fused ? 'T' : 'F') << ", threads " << p_metrics.threads
+          << ", handled " << p_metrics.handled << ", queued "
+          << p_metrics.queued << ", throughput " << p_metrics.throughput()
+          << "/s, utilisation " << p_metrics.utilisation() << '}';
+    return p_out;
+  }
+};
+
+} // namespace tnct::async::dat
+
+#endif
@@ -0,0 +1,218 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_DAT_TASK_H
+#define TNCT_ASYNC_DAT_TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace tnct::async::dat
+{
+
+template <typename t_value = void>
+class task;
+
+} // namespace tnct::async::dat
+
+namespace tnct::async::internal::dat
+{
+
+// What the promise of every 'async::dat::task' has in common
+struct task_promise_base
+{
+  // Resumes the coroutine that awaits the task, if there is one, when the task
+  // finishes
+  struct final_awaiter
+  {
+    bool await_ready() noexcept
+    {
+      return false;
+    }
+
+    template <typename t_promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<t_promise> p_handle) noexcept
+    {
+      return p_handle.promise().continuation;
+    }
+
+    void await_resume() noexcept
+    {
+    }
+  };
+
+  std::suspend_always initial_suspend() noexcept
+  {
+    return {};
+  }
+
+  final_awaiter final_suspend() noexcept
+  {
+    return {};
+  }
+
+  void unhandled_exception() noexcept
+  {
+    exception = std::current_exception();
+  }
+
+  void rethrow_if_exception() const
+  {
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  std::coroutine_handle<> continuation{std::noop_coroutine()};
+
+  std::exception_ptr exception;
+};
+
+template <typename t_value>
+struct task_promise : task_promise_base
+{
+  async::dat::task<t_value> get_return_object() noexcept;
+
+  template <typename t_from>
+  void return_value(t_from &&p_value)
+  {
+    value.emplace(std::forward<t_from>(p_value));
+  }
+
+  t_value take()
+  {
+    rethrow_if_exception();
+    return std::move(*value);
+  }
+
+  std::optional<t_value> value;
+};
+
+template <>
+struct task_promise<void> : task_promise_base
+{
+  async::dat::task<void> get_return_object() noexcept;
+
+  void return_void() noexcept
+  {
+  }
+
+  void take()
+  {
+    rethrow_if_exception();
+  }
+};
+
+} // namespace tnct::async::internal::dat
+
+namespace tnct::async::dat
+{
+
+/// \brief Type returned by a coroutine that only starts when it is awaited,
+/// and that resumes the coroutine awaiting it when it finishes
+///
+/// A coroutine handler, as defined in \p async::cpt::is_coroutine_handler,
+/// returns a \p task<void>, and the handling starts it. An exception thrown
+/// inside the coroutine is thrown again by \p co_await.
+template <typename t_value>
+class [[nodiscard]] task
+{
+public:
+  using value        = t_value;
+  using promise_type = internal::dat::task_promise<t_value>;
+  using handle       = std::coroutine_handle<promise_type>;
+
+  explicit task(handle p_handle) noexcept : m_handle(p_handle)
+  {
+  }
+
+  task(const task &) = delete;
+
+  task(task &&p_task) noexcept
+      : m_handle(std::exchange(p_task.m_handle, nullptr))
+  {
+  }
+
+  task &operator=(const task &) = delete;
+
+  task &operator=(task &&p_task) noexcept
+  {
+    if (this != &p_task)
+    {
+      destroy();
+      m_handle = std::exchange(p_task.m_handle, nullptr);
+    }
+    return *this;
+  }
+
+  ~task()
+  {
+    destroy();
+  }
+
+  auto operator co_await() && noexcept
+  {
+    struct awaiter
+    {
+      bool await_ready() const noexcept
+      {
+        return !m_handle || m_handle.done();
+      }
+
+      std::coroutine_handle<>
+      await_suspend(std::coroutine_handle<> p_awaiting) noexcept
+      {
+        m_handle.promise().continuation = p_awaiting;
+        return m_handle;
+      }
+
+      t_value await_resume()
+      {
+        return m_handle.promise().take();
+      }
+
+      handle m_handle;
+    };
+    return awaiter{m_handle};
+  }
+
+private:
+  void destroy()
+  {
+    if (m_handle)
+    {
+      std::exchange(m_handle, nullptr).destroy();
+    }
+  }
+
+private:
+  handle m_handle;
+};
+
+} // namespace tnct::async::dat
+
+namespace tnct::async::internal::dat
+{
+
+template <typename t_value>
+async::dat::task<t_value> task_promise<t_value>::get_return_object() noexcept
+{
+  return async::dat::task<t_value>{
+      std::coroutine_handle<task_promise<t_value>>::from_promise(*this)};
+}
+
+inline async::dat::task<void> task_promise<void>::get_return_object() noexcept
+{
+  return async::dat::task<void>{
+      std::coroutine_handle<task_promise<void>>::from_promise(*this)};
+}
+
+} // namespace tnct::async::internal::dat
+
+#endif
@@ -0,0 +1,135 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_AFFINITY_COST_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_AFFINITY_COST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "tnct/async/bus/affinity.h"
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/dat/affinity.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/exp/dispatcher_000/event.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/container/dat/circular_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief Amount of handlers of the handling in the affinity comparison
+static constexpr std::size_t affinity_cost_handlers{2};
+
+/// \brief Publishes \p p_amount events in a thread running in
+/// \p p_publisher, to a handling whose queue is created in \p p_queue, and
+/// whose handlers run in \p p_handlers, and returns how many thousands of
+/// events were handled per second
+///
+/// An empty set of CPUs means the thread runs in any CPU
+inline double pinned_throughput(logger &p_logger, std::size_t p_amount,
+                                const dat::cpu_set &p_publisher,
+                                const dat::cpu_set &p_queue,
+                                const dat::cpu_set &p_handlers)
+{
+  using event      = event<'p'>;
+  using dispatcher = async::bus::dispatcher<logger, event>;
+  using queue      = container::dat::circular_queue<logger, event>;
+
+  std::optional<queue> _queue{async::bus::call_pinned(
+      p_queue, [&]() { return queue::create(p_logger, 1024); })};
+  if (!_queue)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating queue");
+    return 0;
+  }
+
+  std::atomic_size_t _handled{0};
+  dispatcher         _dispatcher(p_logger);
+
+  if (_dispatcher.add_handling<event>(
+          "affinity", std::move(*_queue), [&](event &&) { ++_handled; },
+          dat::affinity{p_handlers, {}}, dat::handling_priority::medium,
+          affinity_cost_handlers)
+      != dat::result::OK)
+  {
+    TNCT_LOG_ERR(p_logger, "error adding handling");
+    return 0;
+  }
+
+  return async::bus::call_pinned(
+      p_publisher,
+      [&]()
+      {
+        const auto _start{std::chrono::high_resolution_clock::now()};
+        for (std::size_t _i = 0; _i < p_amount; ++_i)
+        {
+          if (_dispatcher.publish<event>() != dat::result::OK)
+          {
+            return 0.0;
+          }
+        }
+        while (_handled < p_amount)
+        {
+          std::this_thread::yield();
+        }
+        const std::chrono::duration<double, std::milli> _diff{
+            std::chrono::high_resolution_clock::now() - _start};
+        return static_cast<double>(p_amount) / _diff.count();
+      });
+}
+
+/// \brief Compares the throughput of a handling whose threads run in any CPU,
+/// with the one of a handling whose publisher, queue and handlers are in the
+/// same NUMA node, and, if there is a second node, with the one of a handling
+/// whose handlers are in a node different of the publisher and the queue
+inline std::string compare_affinity(logger &p_logger, std::size_t p_amount)
+{
+  const std::optional<dat::cpu_set> _node_0{async::bus::cpus_of_numa_node(0)};
+  const std::optional<dat::cpu_set> _node_1{async::bus::cpus_of_numa_node(1)};
+
+  std::stringstream _stream;
+  _stream << "affinity, " << p_amount << " events to a handling with "
+          << affinity_cost_handlers
+          << " handlers (thousands of events/second)\n";
+
+  if (!_node_0)
+  {
+    _stream << "no NUMA node found\n";
+    return _stream.str();
+  }
+
+  _stream << "node 0 has " << _node_0->size() << " CPUs";
+  if (_node_1)
+  {
+    _stream << ", node 1 has " << _node_1->size() << " CPUs";
+  }
+  _stream << "\nany CPU | same node | other node\n"
+          << pinned_throughput(p_logger, p_amount, {}, {}, {}) << " | "
+          << pinned_throughput(p_logger, p_amount, *_node_0, *_node_0,
+                               *_node_0)
+          << " | ";
+  if (_node_1)
+  {
+    _stream << pinned_throughput(p_logger, p_amount, *_node_0, *_node_0,
+                                 *_node_1);
+  }
+  else
+  {
+    _stream << "-";
+  }
+  _stream << '\n';
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
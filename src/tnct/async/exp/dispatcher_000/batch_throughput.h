@@ -0,0 +1,125 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_BATCH_THROUGHPUT_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_BATCH_THROUGHPUT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/exp/dispatcher_000/event.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/container/dat/circular_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief Measures how many events per second go from the publisher to a
+/// handler, publishing and handling \p p_batch_size events at once
+///
+/// If \p p_batch_size is 1, the events are published with \p publish, and the
+/// handler receives one event at a time, otherwise they are published with
+/// \p publish_batch, and the handler receives a \p std::span of events
+inline double batch_throughput(logger &p_logger, std::size_t p_batch_size,
+                               std::size_t p_amount)
+{
+  using event      = event<'a'>;
+  using dispatcher = async::bus::dispatcher<logger, event>;
+  using queue      = container::dat::circular_queue<logger, event>;
+
+  std::atomic_size_t _handled{0};
+
+  auto _queue{queue::create(p_logger, 1024)};
+  if (!_queue)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating queue");
+    return 0;
+  }
+
+  dispatcher _dispatcher(p_logger);
+
+  dat::result _result{dat::result::OK};
+  if (p_batch_size == 1)
+  {
+    _result = _dispatcher.add_handling<event>(
+        "batch-throughput", std::move(*_queue),
+        [&](event &&) { ++_handled; });
+  }
+  else
+  {
+    _result = _dispatcher.add_handling<event>(
+        "batch-throughput", std::move(*_queue),
+        [&](std::span<event> p_events) { _handled += p_events.size(); },
+        dat::handling_priority::medium, 1, p_batch_size);
+  }
+  if (_result != dat::result::OK)
+  {
+    TNCT_LOG_ERR(p_logger, "error adding handling");
+    return 0;
+  }
+
+  const std::vector<event> _batch(p_batch_size);
+  const std::size_t        _total{(p_amount / p_batch_size) * p_batch_size};
+
+  const auto _start{std::chrono::high_resolution_clock::now()};
+
+  for (std::size_t _published = 0; _published < _total;
+       _published += p_batch_size)
+  {
+    if (p_batch_size == 1)
+    {
+      _result = _dispatcher.publish<event>();
+    }
+    else
+    {
+      _result = _dispatcher.publish_batch<event>(_batch);
+    }
+    if (_result != dat::result::OK)
+    {
+      TNCT_LOG_ERR(p_logger, "error publishing");
+      return 0;
+    }
+  }
+
+  while (_handled < _total)
+  {
+    std::this_thread::yield();
+  }
+
+  const std::chrono::duration<double> _diff{
+      std::chrono::high_resolution_clock::now() - _start};
+
+  return static_cast<double>(_total) / _diff.count();
+}
+
+/// \brief Compares the throughput of a dispatcher for some batch sizes
+inline std::string compare_batch_sizes(logger &p_logger, std::size_t p_amount)
+{
+  std::stringstream _stream;
+  _stream << "dispatcher throughput, " << p_amount
+          << " events (events/second)\nbatch size | events/second\n";
+
+  for (std::size_t _batch_size : {1, 8, 64, 256})
+  {
+    _stream << _batch_size << " | "
+            << static_cast<std::size_t>(
+                   batch_throughput(p_logger, _batch_size, p_amount))
+            << '\n';
+  }
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
@@ -11,6 +11,7 @@
 #include <cstddef>
 #include <iostream>
 #include <optional>
+#include <string>
 #include <string_view>
 
 #include "tnct/log/cpt/logger.h"
@@ -83,6 +84,18 @@ struct configuration
     {
       read_handling_cfg(_i, _sections);
     }
+
+    read_queue_cfg(_sections);
+
+    read_batch_cfg(_sections);
+
+    read_latency_cfg(_sections);
+
+    read_static_cfg(_sections);
+
+    read_affinity_cfg(_sections);
+
+    read_replay_cfg(_sections);
   }
 
   friend std::ostream &operator<<(std::ostream        &p_out,
@@ -106,6 +119,35 @@ struct configuration
       ++_idx;
     }
 
+    p_out << "Queue:"
+          << "\n\ttype = " << p_configuration.queue_type
+          << "\n\tcompare_throughput = "
+          << (p_configuration.compare_queues_throughput ? "true" : "false")
+          << '\n';
+
+    p_out << "Batch:"
+          << "\n\tcompare_sizes = "
+          << (p_configuration.compare_batch_sizes ? "true" : "false") << '\n';
+
+    p_out << "Latency:"
+          << "\n\tcompare_wake = "
+          << (p_configuration.compare_wake_latency ? "true" : "false")
+          << "\n\tcompare_shm = "
+          << (p_configuration.compare_shm_latency ? "true" : "false") << '\n';
+
+    p_out << "Static:"
+          << "\n\tcompare_publish = "
+          << (p_configuration.compare_publish_cost ? "true" : "false") << '\n';
+
+    p_out << "Affinity:"
+          << "\n\tcompare_pinning = "
+          << (p_configuration.compare_affinity ? "true" : "false") << '\n';
+
+    p_out << "Replay:"
+          << "\n\trecord = " << p_configuration.record_file
+          << "\n\treplay = " << p_configuration.replay_file
+          << "\n\tspeed = " << p_configuration.replay_speed << '\n';
+
     return p_out;
   }
 
@@ -114,6 +156,47 @@ struct configuration
       std::chrono::milliseconds::zero()};
   std::array<handling_cfg, t_num_handlings> handlings_cfg;
 
+  /// \brief Queue used by the handlings, "circular_queue" or "mpmc_queue"
+  std::string queue_type{"circular_queue"};
+
+  /// \brief If the throughput of the queues should be compared before
+  /// running the dispatcher
+  bool compare_queues_throughput{false};
+
+  /// \brief If the throughput of the dispatcher for some batch sizes should be
+  /// compared before running the dispatcher
+  bool compare_batch_sizes{false};
+
+  /// \brief If the latency to wake up handlers should be compared before
+  /// running the dispatcher
+  bool compare_wake_latency{false};
+
+  /// \brief If the latency of a handling in the same process as the
+  /// publisher, and in another process, reached through shared memory, should
+  /// be compared before running the dispatcher
+  bool compare_shm_latency{false};
+
+  /// \brief If the cost of publishing with a \p dispatcher and with a
+  /// \p static_dispatcher should be compared before running the dispatcher
+  bool compare_publish_cost{false};
+
+  /// \brief If the throughput of a handling whose handlers run in any CPU,
+  /// and in the CPUs of a NUMA node, should be compared before running the
+  /// dispatcher
+  bool compare_affinity{false};
+
+  /// \brief File where the events published while running the dispatcher are
+  /// recorded, if not empty
+  std::string record_file;
+
+  /// \brief File whose events are replayed before running the dispatcher, if
+  /// not empty
+  std::string replay_file;
+
+  /// \brief How many times faster than recorded the events are replayed, where
+  /// 0 means as fast as possible
+  double replay_speed{1.0};
+
 private:
   using ini_file = parser::bus::ini_file<t_logger>;
 
@@ -174,6 +257,144 @@ private:
     handlings_cfg[p_index] = {_use, _amount_handlers, _sleep_to_simulate_work};
   }
 
+  // the 'QUEUE' section is optional
+  void read_queue_cfg(const typename ini_file::sections &p_sections)
+  {
+    typename ini_file::sections::const_iterator _ite_sections{
+        p_sections.find("QUEUE")};
+    if (_ite_sections == p_sections.end())
+    {
+      return;
+    }
+
+    typename ini_file::properties::const_iterator _ite_properties{
+        _ite_sections->second.find("type")};
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      if ((_ite_properties->second != "circular_queue")
+          && (_ite_properties->second != "mpmc_queue"))
+      {
+        throw std::runtime_error(
+            "'type' property is not 'circular_queue' neither 'mpmc_queue'");
+      }
+      queue_type = _ite_properties->second;
+    }
+
+    _ite_properties = _ite_sections->second.find("compare_throughput");
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      compare_queues_throughput = (_ite_properties->second == "true");
+    }
+  }
+
+  // the 'BATCH' section is optional
+  void read_batch_cfg(const typename ini_file::sections &p_sections)
+  {
+    typename ini_file::sections::const_iterator _ite_sections{
+        p_sections.find("BATCH")};
+    if (_ite_sections == p_sections.end())
+    {
+      return;
+    }
+
+    typename ini_file::properties::const_iterator _ite_properties{
+        _ite_sections->second.find("compare_sizes")};
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      compare_batch_sizes = (_ite_properties->second == "true");
+    }
+  }
+
+  // the 'LATENCY' section is optional
+  void read_latency_cfg(const typename ini_file::sections &p_sections)
+  {
+    typename ini_file::sections::const_iterator _ite_sections{
+        p_sections.find("LATENCY")};
+    if (_ite_sections == p_sections.end())
+    {
+      return;
+    }
+
+    typename ini_file::properties::const_iterator _ite_properties{
+        _ite_sections->second.find("compare_wake")};
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      compare_wake_latency = (_ite_properties->second == "true");
+    }
+
+    _ite_properties = _ite_sections->second.find("compare_shm");
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      compare_shm_latency = (_ite_properties->second == "true");
+    }
+  }
+
+  // the 'STATIC' section is optional
+  void read_static_cfg(const typename ini_file::sections &p_sections)
+  {
+    typename ini_file::sections::const_iterator _ite_sections{
+        p_sections.find("STATIC")};
+    if (_ite_sections == p_sections.end())
+    {
+      return;
+    }
+
+    typename ini_file::properties::const_iterator _ite_properties{
+        _ite_sections->second.find("compare_publish")};
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      compare_publish_cost = (_ite_properties->second == "true");
+    }
+  }
+
+  // the 'AFFINITY' section is optional
+  void read_affinity_cfg(const typename ini_file::sections &p_sections)
+  {
+    typename ini_file::sections::const_iterator _ite_sections{
+        p_sections.find("AFFINITY")};
+    if (_ite_sections == p_sections.end())
+    {
+      return;
+    }
+
+    typename ini_file::properties::const_iterator _ite_properties{
+        _ite_sections->second.find("compare_pinning")};
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      compare_affinity = (_ite_properties->second == "true");
+    }
+  }
+
+  // the 'REPLAY' section is optional
+  void read_replay_cfg(const typename ini_file::sections &p_sections)
+  {
+    typename ini_file::sections::const_iterator _ite_sections{
+        p_sections.find("REPLAY")};
+    if (_ite_sections == p_sections.end())
+    {
+      return;
+    }
+
+    typename ini_file::properties::const_iterator _ite_properties{
+        _ite_sections->second.find("record")};
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      record_file = _ite_properties->second;
+    }
+
+    _ite_properties = _ite_sections->second.find("replay");
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      replay_file = _ite_properties->second;
+    }
+
+    _ite_properties = _ite_sections->second.find("speed");
+    if (_ite_properties != _ite_sections->second.end())
+    {
+      replay_speed = std::stod(_ite_properties->second);
+    }
+  }
+
 private:
   ini_file m_ini;
 };
@@ -5,20 +5,30 @@
 
 /// \example dispatcher/dispatcher_000/main.cpp
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <optional>
 
 #include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/exp/dispatcher_000/affinity_cost.h"
+#include "tnct/async/exp/dispatcher_000/batch_throughput.h"
 #include "tnct/async/exp/dispatcher_000/configuration.h"
 #include "tnct/async/exp/dispatcher_000/event.h"
 #include "tnct/async/exp/dispatcher_000/event_handled.h"
 #include "tnct/async/exp/dispatcher_000/handler.h"
 #include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/async/exp/dispatcher_000/publish_cost.h"
 #include "tnct/async/exp/dispatcher_000/publisher.h"
+#include "tnct/async/exp/dispatcher_000/queue_throughput.h"
+#include "tnct/async/exp/dispatcher_000/replay_load.h"
 #include "tnct/async/exp/dispatcher_000/results.h"
+#include "tnct/async/exp/dispatcher_000/shm_latency.h"
+#include "tnct/async/exp/dispatcher_000/wake_latency.h"
 #include "tnct/container/dat/circular_queue.h"
+#include "tnct/container/dat/mpmc_queue.h"
 #include "tnct/format/bus/fmt.h"
 
 using namespace std::chrono_literals;
@@ -66,8 +76,73 @@ struct pgm
 
       TNCT_LOG_TST(_logger, format::bus::fmt("\n", _configuration));
 
+      if (_configuration.compare_queues_throughput)
+      {
+        std::cout << async::exp::compare_queues_throughput(
+            _logger, 1024, _configuration.amount_events_to_publish)
+                  << std::endl;
+      }
+
+      if (_configuration.compare_batch_sizes)
+      {
+        std::cout << async::exp::compare_batch_sizes(
+            _logger, _configuration.amount_events_to_publish)
+                  << std::endl;
+      }
+
+      if (_configuration.compare_wake_latency)
+      {
+        std::cout << async::exp::compare_wake_latency(
+            _logger, std::min<std::size_t>(
+                         _configuration.amount_events_to_publish, 10000))
+                  << std::endl;
+      }
+
+      if (_configuration.compare_shm_latency)
+      {
+        std::cout << async::exp::compare_shm_latency(
+            _logger, std::min<std::size_t>(
+                         _configuration.amount_events_to_publish, 10000))
+                  << std::endl;
+      }
+
+      if (_configuration.compare_publish_cost)
+      {
+        std::cout << async::exp::compare_publish_cost(
+            _logger, _configuration.amount_events_to_publish)
+                  << std::endl;
+      }
+
+      if (_configuration.compare_affinity)
+      {
+        std::cout << async::exp::compare_affinity(
+            _logger, _configuration.amount_events_to_publish)
+                  << std::endl;
+      }
+
+      if (!_configuration.replay_file.empty())
+      {
+        std::cout << async::exp::replay_load(_logger,
+                                             _configuration.replay_file,
+                                             _configuration.replay_speed)
+                  << std::endl;
+      }
+
       dispatcher _dispatcher(_logger);
 
+      std::optional<async::exp::event_recorder> _recorder;
+      if (!_configuration.record_file.empty())
+      {
+        _recorder = async::exp::event_recorder::create(
+            _logger, _configuration.record_file);
+        if (!_recorder
+            || (_recorder->attach(_dispatcher) != async::dat::result::OK))
+        {
+          TNCT_LOG_ERR(_logger, "error creating recorder");
+          return 1;
+        }
+      }
+
       async::exp::results _results;
 
       const size_t _total_to_be_published{
@@ -110,7 +185,15 @@ struct pgm
                            _configuration.interval_for_events_publishing,
                            _total_to_be_published, "pub 1"};
 
-      define_handlings(_dispatcher, _logger, _configuration);
+      if (_configuration.queue_type == "mpmc_queue")
+      {
+        define_handlings<mpmc_queue_event_a>(_dispatcher, _logger,
+                                             _configuration);
+      }
+      else
+      {
+        define_handlings<queue_event_a>(_dispatcher, _logger, _configuration);
+      }
 
       const auto _start = std::chrono::high_resolution_clock::now();
 
@@ -123,6 +206,16 @@ struct pgm
 
       const auto _end = std::chrono::high_resolution_clock::now();
 
+      if (_recorder)
+      {
+        _recorder->stop();
+        TNCT_LOG_TST(_logger,
+                     format::bus::fmt("recorded ",
+                                      _recorder->get_amount_recorded(),
+                                      " events in '",
+                                      _configuration.record_file, '\''));
+      }
+
       const std::chrono::duration<double> _diff = _end - _start;
 
       TNCT_LOG_TST(_logger,
@@ -150,6 +243,8 @@ private:
 
   using queue_event_a = container::dat::circular_queue<logger, event_a>;
 
+  using mpmc_queue_event_a = container::dat::mpmc_queue<logger, event_a>;
+
   static constexpr size_t num_handlings{5};
 
   using handler_0 = async::exp::handler<'a', 0, dispatcher>;
@@ -204,12 +299,13 @@ private:
     std::condition_variable &m_cond_all_handled;
   };
 
+  template <container::cpt::queue<event_a> t_queue>
   void define_handlings(dispatcher &p_dispatcher, async::exp::logger &p_logger,
                         const configuration &p_configuration)
   {
     if (p_configuration.handlings_cfg[0].use)
     {
-      auto _queue_event_a{queue_event_a::create(p_logger, 5000)};
+      auto _queue_event_a{t_queue::create(p_logger, 5000)};
       if (!_queue_event_a)
       {
         TNCT_LOG_ERR(p_logger, "Error creating queue for 'handling-0'");
@@ -226,7 +322,7 @@ private:
 
     if (p_configuration.handlings_cfg[1].use)
     {
-      auto _queue_event_a{queue_event_a::create(p_logger, 5000)};
+      auto _queue_event_a{t_queue::create(p_logger, 5000)};
       if (!_queue_event_a)
       {
         TNCT_LOG_ERR(p_logger, "Error creating queue for 'handling-1'");
@@ -242,7 +338,7 @@ private:
 
     if (p_configuration.handlings_cfg[2].use)
     {
-      auto _queue_event_a{queue_event_a::create(p_logger, 200)};
+      auto _queue_event_a{t_queue::create(p_logger, 200)};
 
       if (!_queue_event_a)
       {
@@ -260,7 +356,7 @@ private:
 
     if (p_configuration.handlings_cfg[3].use)
     {
-      auto _queue_event_a{queue_event_a::create(p_logger, 1000)};
+      auto _queue_event_a{t_queue::create(p_logger, 1000)};
       if (!_queue_event_a)
       {
         TNCT_LOG_ERR(p_logger, "Error creating queue for 'handling-3'");
@@ -277,7 +373,7 @@ private:
 
     if (p_configuration.handlings_cfg[4].use)
     {
-      auto _queue_event_a{queue_event_a::create(p_logger, 200)};
+      auto _queue_event_a{t_queue::create(p_logger, 200)};
       if (!_queue_event_a)
       {
         TNCT_LOG_ERR(p_logger, "Error creating queue for 'handling-4'");
@@ -351,6 +447,29 @@ private:
                  "use=<true/false>\n"
                  "amount_handlers=<number>\n"
                  "sleep_to_simulate_work=<time-in-milliseconds>\n"
+                 "\n"
+                 "[QUEUE] (optional)\n"
+                 "type=<circular_queue/mpmc_queue>\n"
+                 "compare_throughput=<true/false>\n"
+                 "\n"
+                 "[BATCH] (optional)\n"
+                 "compare_sizes=<true/false>\n"
+                 "\n"
+                 "[LATENCY] (optional)\n"
+                 "compare_wake=<true/false>\n"
+                 "compare_shm=<true/false>\n"
+                 "\n"
+                 "[STATIC] (optional)\n"
+                 "compare_publish=<true/false>\n"
+                 "\n"
+                 "[AFFINITY] (optional)\n"
+                 "compare_pinning=<true/false>\n"
+                 "\n"
+                 "[REPLAY] (optional)\n"
+                 "record=<file where the events published are recorded>\n"
+                 "replay=<file whose events are replayed before running>\n"
+                 "speed=<times faster than recorded, 0 for as fast as "
+                 "possible>\n"
 
               << std::endl;
   }
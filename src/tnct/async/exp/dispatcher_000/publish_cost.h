@@ -0,0 +1,139 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_PUBLISH_COST_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_PUBLISH_COST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/static_dispatcher.h"
+#include "tnct/async/dat/handling_definition.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/exp/dispatcher_000/event.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/container/dat/circular_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief Amount of handlings of the same event in the publishing cost
+/// comparison
+static constexpr std::size_t publish_cost_handlings{3};
+
+/// \brief Publishes \p p_amount events with \p p_publish, waits for the
+/// handlers, and returns the average time, in nanoseconds, of each publish
+template <typename t_publish>
+double publish_cost(t_publish &&p_publish, const std::atomic_size_t &p_handled,
+                    std::size_t p_amount)
+{
+  const auto _start{std::chrono::high_resolution_clock::now()};
+  for (std::size_t _i = 0; _i < p_amount; ++_i)
+  {
+    if (p_publish() != dat::result::OK)
+    {
+      return 0;
+    }
+  }
+  const std::chrono::duration<double, std::nano> _diff{
+      std::chrono::high_resolution_clock::now() - _start};
+
+  while (p_handled < (publish_cost_handlings * p_amount))
+  {
+    std::this_thread::yield();
+  }
+  return _diff.count() / static_cast<double>(p_amount);
+}
+
+/// \brief Cost of publishing an event to 3 handlings of a \p dispatcher
+inline double dispatcher_publish_cost(logger &p_logger, std::size_t p_amount)
+{
+  using event      = event<'s'>;
+  using dispatcher = async::bus::dispatcher<logger, event>;
+  using queue      = container::dat::circular_queue<logger, event>;
+
+  std::atomic_size_t _handled{0};
+  dispatcher         _dispatcher(p_logger);
+
+  // a handler type can be used in only one handling of a 'dispatcher'
+  auto _add = [&](const char *p_name, auto &&p_handler)
+  {
+    auto _queue{queue::create(p_logger, 1024)};
+    return _queue
+           && (_dispatcher.add_handling<event>(p_name, std::move(*_queue),
+                                               std::move(p_handler))
+               == dat::result::OK);
+  };
+
+  if (!_add("cost-0", [&](event &&) { ++_handled; })
+      || !_add("cost-1", [&](event &&) { ++_handled; })
+      || !_add("cost-2", [&](event &&) { ++_handled; }))
+  {
+    TNCT_LOG_ERR(p_logger, "error adding handling");
+    return 0;
+  }
+
+  return publish_cost([&]() { return _dispatcher.publish<event>(); }, _handled,
+                      p_amount);
+}
+
+/// \brief Cost of publishing an event to 3 handlings of a
+/// \p static_dispatcher
+inline double static_dispatcher_publish_cost(logger     &p_logger,
+                                             std::size_t p_amount)
+{
+  using event = event<'s'>;
+  using queue = container::dat::circular_queue<logger, event>;
+
+  std::atomic_size_t _handled{0};
+
+  auto _handler = [&](event &&) { ++_handled; };
+
+  using definition = dat::handling_definition<event, queue, decltype(_handler)>;
+  using dispatcher =
+      async::bus::static_dispatcher<logger, definition, definition, definition>;
+
+  auto _queue_0{queue::create(p_logger, 1024)};
+  auto _queue_1{queue::create(p_logger, 1024)};
+  auto _queue_2{queue::create(p_logger, 1024)};
+  if (!_queue_0 || !_queue_1 || !_queue_2)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating queue");
+    return 0;
+  }
+
+  dispatcher _dispatcher(
+      p_logger,
+      definition{"cost-0", std::move(*_queue_0), decltype(_handler){_handler}},
+      definition{"cost-1", std::move(*_queue_1), decltype(_handler){_handler}},
+      definition{"cost-2", std::move(*_queue_2), decltype(_handler){_handler}});
+
+  return publish_cost([&]() { return _dispatcher.publish<event>(); }, _handled,
+                      p_amount);
+}
+
+/// \brief Compares the cost of publishing an event to the handlings of a
+/// \p dispatcher, and of a \p static_dispatcher
+inline std::string compare_publish_cost(logger &p_logger, std::size_t p_amount)
+{
+  std::stringstream _stream;
+  _stream << "publishing cost, " << p_amount << " events to "
+          << publish_cost_handlings
+          << " handlings (nanoseconds/publish)\ndispatcher | "
+             "static_dispatcher\n"
+          << dispatcher_publish_cost(p_logger, p_amount) << " | "
+          << static_dispatcher_publish_cost(p_logger, p_amount) << '\n';
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
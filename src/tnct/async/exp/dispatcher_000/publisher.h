@@ -7,6 +7,7 @@
 #define TNCT_ASYNC_EXP_DISPATCHER_000_PUBLISHER_H
 
 #include <chrono>
+#include <memory>
 #include <string_view>
 #include <vector>
 
@@ -14,6 +15,7 @@
 #include "tnct/async/exp/dispatcher_000/logger.h"
 #include "tnct/async/dat/result.h"
 #include "tnct/async/bus/sleeping_loop.h"
+#include "tnct/async/bus/timer_wheel.h"
 #include "tnct/async/cpt/is_dispatcher.h"
 
 namespace tnct::async::exp {
@@ -31,7 +33,8 @@ struct publisher {
       : m_logger(p_logger), m_dispatcher(p_dispatcher),
         m_total_events(p_total_events), m_interval(p_interval), m_id(p_id),
         m_slepping_loop(
-            m_logger, [this]() { sleeping_function(); }, m_interval, m_id)
+            m_logger, *m_timer_wheel, [this]() { sleeping_function(); },
+            m_interval, m_id)
 
   {}
 
@@ -42,7 +45,8 @@ struct publisher {
         m_num_events{p_publisher.m_num_events},
         m_interval(p_publisher.m_interval), m_id{p_publisher.m_id},
         m_slepping_loop(
-            m_logger, [this]() { sleeping_function(); }, m_interval, m_id) {}
+            m_logger, *m_timer_wheel, [this]() { sleeping_function(); },
+            m_interval, m_id) {}
   ~publisher() { m_slepping_loop.stop(); }
 
   void start() {
@@ -86,6 +90,11 @@ private:
   size_t m_num_events{0};
   std::chrono::milliseconds m_interval;
   std::string m_id{"not-assigned"};
+  // 'publish' may block, under 'dat::overflow_policy::block', so each
+  // publisher has its own thread, and does not hold the ones shared by the
+  // other loops
+  std::unique_ptr<bus::timer_wheel> m_timer_wheel{
+      std::make_unique<bus::timer_wheel>(1)};
   async::sleeping_loop<logger> m_slepping_loop;
   const event m_event{};
 };
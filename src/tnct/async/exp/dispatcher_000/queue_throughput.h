@@ -0,0 +1,122 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_QUEUE_THROUGHPUT_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_QUEUE_THROUGHPUT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/exp/dispatcher_000/event.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/container/cpt/queue.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/container/dat/mpmc_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief Measures how many events per second can go through a queue, with
+/// \p p_producers threads pushing and \p p_consumers threads popping, which is
+/// what a handling does with its queue
+template <container::cpt::queue<event<'a'>> t_queue>
+double queue_throughput(t_queue &p_queue, std::size_t p_producers,
+                        std::size_t p_consumers, std::size_t p_amount)
+{
+  const std::size_t _per_producer{p_amount / p_producers};
+  const std::size_t _total{_per_producer * p_producers};
+
+  std::atomic_size_t       _popped{0};
+  std::vector<std::thread> _threads;
+
+  const auto _start{std::chrono::high_resolution_clock::now()};
+
+  for (std::size_t _c = 0; _c < p_consumers; ++_c)
+  {
+    _threads.emplace_back(
+        [&]()
+        {
+          while (_popped < _total)
+          {
+            if (p_queue.pop())
+            {
+              ++_popped;
+            }
+            else
+            {
+              std::this_thread::yield();
+            }
+          }
+        });
+  }
+
+  for (std::size_t _p = 0; _p < p_producers; ++_p)
+  {
+    _threads.emplace_back(
+        [&]()
+        {
+          for (std::size_t _i = 0; _i < _per_producer; ++_i)
+          {
+            p_queue.push(event<'a'>{});
+          }
+        });
+  }
+
+  for (std::thread &_thread : _threads)
+  {
+    _thread.join();
+  }
+
+  const std::chrono::duration<double> _diff{
+      std::chrono::high_resolution_clock::now() - _start};
+
+  return static_cast<double>(_total) / _diff.count();
+}
+
+/// \brief Compares the throughput of \p container::dat::circular_queue and
+/// \p container::dat::mpmc_queue, for some combinations of producers and
+/// consumers
+inline std::string compare_queues_throughput(logger     &p_logger,
+                                             std::size_t p_capacity,
+                                             std::size_t p_amount)
+{
+  using circular_queue = container::dat::circular_queue<logger, event<'a'>>;
+  using mpmc_queue     = container::dat::mpmc_queue<logger, event<'a'>>;
+
+  std::stringstream _stream;
+  _stream << "queue throughput, " << p_amount
+          << " events (events/second)\nproducers x consumers | circular_queue "
+             "| mpmc_queue\n";
+
+  for (std::size_t _threads : {1, 2, 4, 8})
+  {
+    auto _circular_queue{circular_queue::create(p_logger, p_capacity)};
+    auto _mpmc_queue{mpmc_queue::create(p_logger, p_capacity)};
+    if (!_circular_queue || !_mpmc_queue)
+    {
+      TNCT_LOG_ERR(p_logger, "error creating queues to compare");
+      return _stream.str();
+    }
+
+    _stream << _threads << " x " << _threads << " | "
+            << static_cast<std::size_t>(queue_throughput(
+                   *_circular_queue, _threads, _threads, p_amount))
+            << " | "
+            << static_cast<std::size_t>(
+                   queue_throughput(*_mpmc_queue, _threads, _threads, p_amount))
+            << '\n';
+  }
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
@@ -0,0 +1,108 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_REPLAY_LOAD_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_REPLAY_LOAD_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/recorder.h"
+#include "tnct/async/bus/replayer.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/exp/dispatcher_000/event.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/container/dat/circular_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief The events of the experiment carry no data, so only their type, and
+/// the moment they were published, are recorded
+struct event_serializer
+{
+  template <char t_id>
+  void serialize(const event<t_id> &, std::vector<std::byte> &)
+  {
+  }
+
+  template <char t_id>
+  std::optional<event<t_id>> deserialize(std::span<const std::byte> p_bytes,
+                                         std::type_identity<event<t_id>>)
+  {
+    if (!p_bytes.empty())
+    {
+      return std::nullopt;
+    }
+    return event<t_id>{};
+  }
+};
+
+/// \brief Records the events of type \p event<'a'> published to a dispatcher
+using event_recorder =
+    async::bus::recorder<logger, event_serializer, event<'a'>>;
+
+/// \brief Replays the events recorded in \p p_file, \p p_speed times faster
+/// than they were recorded, or as fast as possible, if \p p_speed is 0, to a
+/// handling that only counts them, and reports how long it took
+inline std::string replay_load(logger &p_logger, const std::string &p_file,
+                               double p_speed)
+{
+  using event      = event<'a'>;
+  using dispatcher = async::bus::dispatcher<logger, event>;
+  using queue      = container::dat::circular_queue<logger, event>;
+  using replayer   = async::bus::replayer<logger, event_serializer, event>;
+
+  std::stringstream _stream;
+  _stream << "replay of '" << p_file << "' at speed " << p_speed << '\n';
+
+  std::optional<replayer> _replayer{replayer::create(p_logger, p_file)};
+  std::optional<queue>    _queue{queue::create(p_logger, 1024)};
+  if (!_replayer || !_queue)
+  {
+    _stream << "could not be started\n";
+    return _stream.str();
+  }
+
+  std::atomic_size_t _handled{0};
+  dispatcher         _dispatcher(p_logger);
+  if (_dispatcher.add_handling<event>(
+          "replayed", std::move(*_queue), [&](event &&) { ++_handled; })
+      != dat::result::OK)
+  {
+    _stream << "could not add the handling\n";
+    return _stream.str();
+  }
+
+  const auto        _start{std::chrono::steady_clock::now()};
+  const dat::result _result{_replayer->replay(_dispatcher, p_speed)};
+  while (_handled < _replayer->get_amount_replayed())
+  {
+    std::this_thread::yield();
+  }
+  const std::chrono::duration<double, std::milli> _diff{
+      std::chrono::steady_clock::now() - _start};
+
+  _stream << "events | milliseconds | thousands of events/second | result\n"
+          << _replayer->get_amount_replayed() << " | " << _diff.count()
+          << " | "
+          << static_cast<double>(_replayer->get_amount_replayed())
+                 / _diff.count()
+          << " | " << _result << '\n';
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
@@ -0,0 +1,226 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_SHM_LATENCY_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_SHM_LATENCY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/shm_receiver.h"
+#include "tnct/async/bus/shm_sender.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/async/exp/dispatcher_000/wake_latency.h"
+#include "tnct/container/dat/circular_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief A \p timed_event is its index followed by the moment it was
+/// published, which is the same clock in all the processes of the machine
+struct timed_event_serializer
+{
+  void serialize(const timed_event &p_event, std::vector<std::byte> &p_buffer)
+  {
+    const std::int64_t _published{
+        p_event.published.time_since_epoch().count()};
+    p_buffer.resize(sizeof(p_event.idx) + sizeof(_published));
+    std::memcpy(p_buffer.data(), &p_event.idx, sizeof(p_event.idx));
+    std::memcpy(p_buffer.data() + sizeof(p_event.idx), &_published,
+                sizeof(_published));
+  }
+
+  std::optional<timed_event> deserialize(std::span<const std::byte> p_bytes,
+                                         std::type_identity<timed_event>)
+  {
+    std::int64_t _published{0};
+    if (p_bytes.size() != sizeof(timed_event::idx) + sizeof(_published))
+    {
+      return std::nullopt;
+    }
+    timed_event _event;
+    std::memcpy(&_event.idx, p_bytes.data(), sizeof(_event.idx));
+    std::memcpy(&_published, p_bytes.data() + sizeof(_event.idx),
+                sizeof(_published));
+    _event.published = std::chrono::steady_clock::time_point{
+        std::chrono::steady_clock::duration{_published}};
+    return _event;
+  }
+};
+
+/// \brief Measures, in a child process, the latencies of the events sent by
+/// this process through shared memory to a handling with one handler, and
+/// returns their p50 and p99, in microseconds, or nothing on error
+///
+/// The child is created before any thread of this function, and the sender
+/// waits for it to start receiving before publishing
+inline std::optional<std::array<double, 2>>
+shm_latencies(logger &p_logger, std::size_t p_amount,
+              std::chrono::microseconds p_interval)
+{
+#ifdef __linux__
+  using dispatcher = async::bus::dispatcher<logger, timed_event>;
+  using queue      = container::dat::circular_queue<logger, timed_event>;
+  using sender =
+      async::bus::shm_sender<logger, timed_event_serializer, timed_event>;
+  using receiver =
+      async::bus::shm_receiver<logger, timed_event_serializer, timed_event>;
+
+  const std::string _name{"/tnct-dispatcher_000-"
+                          + std::to_string(::getpid())};
+
+  std::optional<sender> _sender{sender::create(p_logger, _name, 1 << 16)};
+  int                   _pipe[2];
+  if (!_sender || (::pipe(_pipe) == -1))
+  {
+    TNCT_LOG_ERR(p_logger, "error creating sender");
+    return std::nullopt;
+  }
+
+  const pid_t _child{::fork()};
+  if (_child == -1)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating the receiving process");
+    return std::nullopt;
+  }
+
+  if (_child == 0)
+  {
+    // receives, and writes to the pipe a byte when it is ready, and then the
+    // two percentiles
+    ::close(_pipe[0]);
+    std::array<double, 2> _result{-1, -1};
+
+    latencies               _latencies(p_amount);
+    std::atomic_size_t      _handled{0};
+    std::optional<receiver> _receiver{receiver::create(p_logger, _name)};
+    std::optional<queue>    _queue{queue::create(p_logger, 1024)};
+    dispatcher              _dispatcher(p_logger);
+
+    const bool _ready{
+        _receiver && _queue
+        && (_dispatcher.add_handling<timed_event>(
+                "shm-latency", std::move(*_queue),
+                [&](timed_event &&p_event)
+                {
+                  _latencies[p_event.idx] =
+                      nanoseconds_since(p_event.published);
+                  ++_handled;
+                })
+            == dat::result::OK)
+        && (_receiver->start(_dispatcher) == dat::result::OK)};
+
+    const char _byte{_ready ? '1' : '0'};
+    static_cast<void>(::write(_pipe[1], &_byte, 1));
+    if (_ready)
+    {
+      const auto _limit{std::chrono::steady_clock::now()
+                        + std::chrono::minutes{1}};
+      while ((_handled < p_amount)
+             && (std::chrono::steady_clock::now() < _limit))
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+      _receiver->stop();
+      if (_handled == p_amount)
+      {
+        _result = {percentile(_latencies, 0.50),
+                   percentile(_latencies, 0.99)};
+      }
+    }
+    static_cast<void>(::write(_pipe[1], _result.data(), sizeof(_result)));
+    ::close(_pipe[1]);
+    // the threads of the dispatcher end with the process
+    ::_exit(0);
+  }
+
+  ::close(_pipe[1]);
+  std::optional<std::array<double, 2>> _result;
+
+  char _byte{'0'};
+  if ((::read(_pipe[0], &_byte, 1) == 1) && (_byte == '1'))
+  {
+    dispatcher _dispatcher(p_logger);
+    if (_sender->attach(_dispatcher) == dat::result::OK)
+    {
+      for (std::size_t _i = 0; _i < p_amount; ++_i)
+      {
+        std::this_thread::sleep_for(p_interval);
+        static_cast<void>(_dispatcher.publish<timed_event>(
+            _i, std::chrono::steady_clock::now()));
+      }
+    }
+
+    std::array<double, 2> _percentiles{};
+    if ((::read(_pipe[0], _percentiles.data(), sizeof(_percentiles))
+         == sizeof(_percentiles))
+        && (_percentiles[0] >= 0))
+    {
+      _result = _percentiles;
+    }
+  }
+
+  ::close(_pipe[0]);
+  ::waitpid(_child, nullptr, 0);
+  return _result;
+#else
+  static_cast<void>(p_amount);
+  static_cast<void>(p_interval);
+  TNCT_LOG_ERR(p_logger, "shared memory is only supported on Linux");
+  return std::nullopt;
+#endif
+}
+
+/// \brief Compares the latency, from publishing to handling, of a handling in
+/// the same process as the publisher, and of a handling in another process,
+/// to which the events are sent through shared memory
+inline std::string compare_shm_latency(logger &p_logger, std::size_t p_amount)
+{
+  constexpr std::chrono::microseconds _interval{200};
+
+  std::stringstream _stream;
+  _stream << "cross process latency, " << p_amount << " events, one each "
+          << _interval.count()
+          << "us (microseconds)\nsame process p50 | same process p99 | "
+             "other process p50 | other process p99\n";
+
+  // the child process is created before the threads of the other dispatcher
+  const std::optional<std::array<double, 2>> _other{
+      shm_latencies(p_logger, p_amount, _interval)};
+  latencies _same{dispatcher_latencies(p_logger, 1, p_amount, _interval)};
+
+  _stream << percentile(_same, 0.50) << " | " << percentile(_same, 0.99);
+  if (_other)
+  {
+    _stream << " | " << (*_other)[0] << " | " << (*_other)[1] << '\n';
+  }
+  else
+  {
+    _stream << " | error | error\n";
+  }
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
@@ -0,0 +1,208 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_EXP_DISPATCHER_000_WAKE_LATENCY_H
+#define TNCT_ASYNC_EXP_DISPATCHER_000_WAKE_LATENCY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/exp/dispatcher_000/logger.h"
+#include "tnct/container/dat/circular_queue.h"
+
+namespace tnct::async::exp
+{
+
+/// \brief Event that carries the moment it was published
+struct timed_event
+{
+  friend std::ostream &operator<<(std::ostream      &p_out,
+                                  const timed_event &p_event)
+  {
+    p_out << "timed_event " << p_event.idx;
+    return p_out;
+  }
+
+  std::size_t                           idx{0};
+  std::chrono::steady_clock::time_point published;
+};
+
+/// \brief Latencies, in nanoseconds, from the publishing of an event to the
+/// moment a handler receives it
+using latencies = std::vector<std::int64_t>;
+
+inline std::int64_t
+nanoseconds_since(std::chrono::steady_clock::time_point p_start)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - p_start)
+      .count();
+}
+
+/// \brief Measures the latencies of the previous way a handling woke up its
+/// handlers, where every event caused a \p notify_all to all of them
+inline latencies notify_all_latencies(std::size_t               p_handlers,
+                                      std::size_t               p_amount,
+                                      std::chrono::microseconds p_interval)
+{
+  latencies               _latencies(p_amount);
+  std::deque<timed_event> _queue;
+  std::mutex              _mutex;
+  std::condition_variable _cond;
+  bool                    _stop{false};
+
+  std::vector<std::thread> _threads;
+  for (std::size_t _i = 0; _i < p_handlers; ++_i)
+  {
+    _threads.emplace_back(
+        [&]()
+        {
+          while (true)
+          {
+            std::unique_lock<std::mutex> _lock(_mutex);
+            _cond.wait(_lock, [&]() { return _stop || !_queue.empty(); });
+            if (_queue.empty())
+            {
+              break;
+            }
+            const timed_event _event{_queue.front()};
+            _queue.pop_front();
+            _lock.unlock();
+            _latencies[_event.idx] = nanoseconds_since(_event.published);
+          }
+        });
+  }
+
+  for (std::size_t _i = 0; _i < p_amount; ++_i)
+  {
+    std::this_thread::sleep_for(p_interval);
+    std::lock_guard<std::mutex> _lock(_mutex);
+    _queue.push_back({_i, std::chrono::steady_clock::now()});
+    _cond.notify_all();
+  }
+
+  {
+    std::lock_guard<std::mutex> _lock(_mutex);
+    _stop = true;
+    _cond.notify_all();
+  }
+  for (std::thread &_thread : _threads)
+  {
+    _thread.join();
+  }
+  return _latencies;
+}
+
+/// \brief Measures the latencies of a \p dispatcher handling with
+/// \p p_handlers handlers
+inline latencies dispatcher_latencies(logger &p_logger, std::size_t p_handlers,
+                                      std::size_t               p_amount,
+                                      std::chrono::microseconds p_interval)
+{
+  using dispatcher = async::bus::dispatcher<logger, timed_event>;
+  using queue      = container::dat::circular_queue<logger, timed_event>;
+
+  latencies          _latencies(p_amount);
+  std::atomic_size_t _handled{0};
+
+  auto _queue{queue::create(p_logger, 1024)};
+  if (!_queue)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating queue");
+    return {};
+  }
+
+  dispatcher _dispatcher(p_logger);
+
+  if (_dispatcher.add_handling<timed_event>(
+          "wake-latency", std::move(*_queue),
+          [&](timed_event &&p_event)
+          {
+            _latencies[p_event.idx] = nanoseconds_since(p_event.published);
+            ++_handled;
+          },
+          dat::handling_priority::medium, p_handlers)
+      != dat::result::OK)
+  {
+    TNCT_LOG_ERR(p_logger, "error adding handling");
+    return {};
+  }
+
+  for (std::size_t _i = 0; _i < p_amount; ++_i)
+  {
+    std::this_thread::sleep_for(p_interval);
+    if (_dispatcher.publish<timed_event>(_i, std::chrono::steady_clock::now())
+        != dat::result::OK)
+    {
+      TNCT_LOG_ERR(p_logger, "error publishing");
+      return {};
+    }
+  }
+
+  while (_handled < p_amount)
+  {
+    std::this_thread::yield();
+  }
+  return _latencies;
+}
+
+/// \return The \p p_percentile latency, in microseconds
+inline double percentile(latencies &p_latencies, double p_percentile)
+{
+  if (p_latencies.empty())
+  {
+    return 0;
+  }
+  std::sort(p_latencies.begin(), p_latencies.end());
+  const auto _idx{static_cast<std::size_t>(
+      p_percentile * static_cast<double>(p_latencies.size() - 1))};
+  return static_cast<double>(p_latencies[_idx]) / 1000.0;
+}
+
+/// \brief Compares the latency, from publishing to handling, of a handling
+/// that wakes all its handlers with \p notify_all for every event, and of the
+/// \p dispatcher, that spins and parks each handler, and wakes only one
+inline std::string compare_wake_latency(logger &p_logger, std::size_t p_amount)
+{
+  constexpr std::chrono::microseconds _interval{200};
+
+  std::stringstream _stream;
+  _stream << "wake to handle latency, " << p_amount << " events, one each "
+          << _interval.count()
+          << "us (microseconds)\nhandlers | notify_all p50 | notify_all p99 "
+             "| dispatcher p50 | dispatcher p99\n";
+
+  for (std::size_t _handlers : {1, 4, 8})
+  {
+    latencies _notify_all{
+        notify_all_latencies(_handlers, p_amount, _interval)};
+    latencies _dispatcher{
+        dispatcher_latencies(p_logger, _handlers, p_amount, _interval)};
+
+    _stream << _handlers << " | " << percentile(_notify_all, 0.50) << " | "
+            << percentile(_notify_all, 0.99) << " | "
+            << percentile(_dispatcher, 0.50) << " | "
+            << percentile(_dispatcher, 0.99) << '\n';
+  }
+  return _stream.str();
+}
+
+} // namespace tnct::async::exp
+
+#endif
@@ -5,9 +5,14 @@
 
 /// \example executer_000/main.cpp
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <stop_token>
 
 #include "tnct/async/bus/exec_sync.h"
 
@@ -238,6 +243,32 @@ void executer_011() {
   }
 }
 
+void executer_012() {
+  // stops as soon as the timeout is reached, instead of after sleeping 1s
+  auto _function = [](std::stop_token p_stop, int16_t p_i) -> int16_t {
+    std::mutex _mutex;
+    std::condition_variable_any _cond;
+    std::unique_lock<std::mutex> _lock{_mutex};
+    _cond.wait_for(_lock, p_stop, 1s, []() { return false; });
+    if (p_stop.stop_requested()) {
+      std::cout << "stop requested\n";
+      return -1;
+    }
+    return p_i;
+  };
+
+  const auto _start{std::chrono::steady_clock::now()};
+  std::optional<int16_t> _maybe = async::exec_sync(200ms, _function, 4);
+  const auto _elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - _start)};
+  if (_maybe) {
+    std::cout << "function should timeout, but it has not, and returned "
+              << *_maybe << '\n';
+    return;
+  }
+  std::cout << "timeout after " << _elapsed.count() << "ms\n";
+}
+
 int main() {
   executer_000();
   executer_001();
@@ -251,4 +282,5 @@ int main() {
   executer_009();
   executer_010();
   executer_011();
+  executer_012();
 }
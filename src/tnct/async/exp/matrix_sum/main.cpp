@@ -13,6 +13,7 @@
 #include <string_view>
 
 #include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/parallel.h"
 #include "tnct/async/dat/result.h"
 #include "tnct/container/dat/circular_queue.h"
 #include "tnct/container/dat/matrix.h"
@@ -318,6 +319,30 @@ void async_sum_matrix_wrapper(matrix &p_matrix, logger &p_logger) {
   TNCT_LOG_TST(p_logger, format::bus::fmt("ASYNC time = ", _diff.count(),
                                           " seconds, sum: ", _sum));
 }
+// Sums each row in parallel, in a pool that is created once, and reused by
+// the next sums
+void parallel_sum_matrix_wrapper(const matrix &p_matrix, logger &p_logger) {
+  const auto _start = std::chrono::high_resolution_clock::now();
+
+  const matrix::data _sum{async::bus::parallel_reduce<logger>(
+      matrix::index{0}, p_matrix.get_num_rows(), 0, matrix::data{0},
+      [&](matrix::index p_row) {
+        matrix::data _row_sum{0};
+        for (matrix::index _c = 0; _c < p_matrix.get_num_cols(); ++_c) {
+          _row_sum += p_matrix(p_row, _c);
+        }
+        return _row_sum;
+      },
+      [](matrix::data p_a, matrix::data p_b) { return p_a + p_b; })};
+
+  const auto _end = std::chrono::high_resolution_clock::now();
+
+  const std::chrono::duration<double> _diff = _end - _start;
+
+  TNCT_LOG_TST(p_logger, format::bus::fmt("PARALLEL time = ", _diff.count(),
+                                          " seconds, sum: ", _sum));
+}
+
 // clang-format off
 //rodrigo@wayne:~/development/prd/linux-release-64/exp$ ./tnct.async.exp.matrix_sum 60260
 //TST|2025-04-06 11:58:08,584990|140374769088320|main.cpp                           |00079|time = 1.73989 seconds, sum: 6593052193220513800
@@ -347,4 +372,6 @@ int main(int argc, char **argv) {
   sync_sum_matrix_wrapper(*_matrix, _logger);
 
   async_sum_matrix_wrapper(*_matrix, _logger);
+
+  parallel_sum_matrix_wrapper(*_matrix, _logger);
 }
@@ -0,0 +1,174 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+/// \example sleeping_loop_001/main.cpp
+///
+/// Measures how late the functions of many \p async::sleeping_loop objects are
+/// called, and how much CPU the shared \p async::bus::timer_wheel uses
+///
+/// Syntax: tnct.async.exp.sleeping_loop_001 [amount-of-loops=10000]
+/// [interval-in-ms=100] [duration-in-secs=10]
+
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/sleeping_loop.h"
+#include "tnct/async/bus/timer_wheel.h"
+#include "tnct/async/dat/histogram.h"
+#include "tnct/log/bus/cerr.h"
+
+using namespace std::chrono_literals;
+using namespace tnct;
+
+using logger = log::cerr;
+
+using clock_type = async::bus::timer_wheel::clock;
+
+// Time spent by the process in the CPU, in user and system mode
+std::chrono::microseconds cpu_time()
+{
+  rusage _usage{};
+  getrusage(RUSAGE_SELF, &_usage);
+  return std::chrono::seconds{_usage.ru_utime.tv_sec + _usage.ru_stime.tv_sec}
+         + std::chrono::microseconds{_usage.ru_utime.tv_usec
+                                     + _usage.ru_stime.tv_usec};
+}
+
+std::string num_threads()
+{
+  std::ifstream _status{"/proc/self/status"};
+  std::string   _line;
+  while (std::getline(_status, _line))
+  {
+    if (_line.starts_with("Threads:"))
+    {
+      return _line.substr(8);
+    }
+  }
+  return " unknown";
+}
+
+// Records how late each call of a loop was, compared to the moment it was
+// due, counted from the first call
+struct lateness
+{
+  explicit lateness(std::chrono::nanoseconds p_interval)
+      : m_interval(p_interval)
+  {
+  }
+
+  void operator()()
+  {
+    const clock_type::time_point _now{clock_type::now()};
+    if (m_calls == 0)
+    {
+      m_first = _now;
+    }
+    else
+    {
+      const auto _late{(_now - m_first) - (m_interval * m_calls)};
+      m_histogram.record(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(_late));
+    }
+    ++m_calls;
+  }
+
+  const async::dat::histogram &get_histogram() const
+  {
+    return m_histogram;
+  }
+
+  std::uint64_t get_calls() const
+  {
+    return m_calls;
+  }
+
+private:
+  std::chrono::nanoseconds m_interval;
+  clock_type::time_point   m_first;
+  std::uint64_t            m_calls{0};
+  async::dat::histogram    m_histogram;
+};
+
+int main(int argc, char **argv)
+{
+  const std::size_t _amount{argc > 1 ? std::stoul(argv[1]) : 10000};
+  const std::chrono::milliseconds _interval{argc > 2 ? std::stoul(argv[2])
+                                                     : 100};
+  const std::chrono::seconds _duration{argc > 3 ? std::stoul(argv[3]) : 10};
+
+  logger _logger;
+
+  std::vector<std::unique_ptr<lateness>> _latenesses;
+  _latenesses.reserve(_amount);
+
+  std::vector<async::sleeping_loop<logger>> _loops;
+  _loops.reserve(_amount);
+  for (std::size_t _i = 0; _i < _amount; ++_i)
+  {
+    _latenesses.push_back(std::make_unique<lateness>(_interval));
+    _loops.emplace_back(
+        _logger, [_lateness = _latenesses.back().get()]() { (*_lateness)(); },
+        _interval);
+  }
+
+  const std::chrono::microseconds _cpu_start{cpu_time()};
+  const clock_type::time_point    _start{clock_type::now()};
+
+  for (async::sleeping_loop<logger> &_loop : _loops)
+  {
+    _loop.start();
+  }
+
+  std::this_thread::sleep_for(_duration);
+  const std::string _threads{num_threads()};
+
+  for (async::sleeping_loop<logger> &_loop : _loops)
+  {
+    _loop.stop();
+  }
+
+  const auto _wall{std::chrono::duration_cast<std::chrono::microseconds>(
+      clock_type::now() - _start)};
+  const std::chrono::microseconds _cpu{cpu_time() - _cpu_start};
+
+  _loops.clear();
+
+  async::dat::histogram _histogram;
+  std::uint64_t         _calls{0};
+  for (const std::unique_ptr<lateness> &_lateness : _latenesses)
+  {
+    _histogram.merge(_lateness->get_histogram());
+    _calls += _lateness->get_calls();
+  }
+
+  const async::bus::timer_wheel &_timer_wheel{
+      async::bus::timer_wheel::shared()};
+
+  std::cout << "loops " << _amount << ", interval " << _interval.count()
+            << "ms, duration " << _duration.count() << "s, worker threads "
+            << _timer_wheel.get_num_workers() << ", tick "
+            << _timer_wheel.get_tick().count() << "ns\n"
+            << "threads in the process" << _threads << '\n'
+            << "calls " << _calls << ", expected about "
+            << (_amount * (_duration / _interval + 1)) << '\n'
+            << "lateness " << _histogram << '\n'
+            << "CPU " << _cpu.count() << "us in " << _wall.count() << "us ("
+            << ((100.0 * static_cast<double>(_cpu.count()))
+                / static_cast<double>(_wall.count()))
+            << "% of one core)" << std::endl;
+
+  return 0;
+}
@@ -69,7 +69,8 @@ struct sensors
     }
   }
 
-  using sensor_ptr = std::unique_ptr<sensor<t_logger, t_dispatcher>>;
+  // Shared, so a sensor being set is not destroyed if it is removed meanwhile
+  using sensor_ptr = std::shared_ptr<sensor<t_logger, t_dispatcher>>;
 
   struct sensor_cmp
   {
@@ -87,7 +88,7 @@ private:
   void on_add_sensor(evt::add_sensor &&p_evt)
   {
     std::lock_guard<std::mutex> _lock(m_mutex);
-    auto _sensor = std::make_unique<sensor<t_logger, t_dispatcher>>(
+    auto _sensor = std::make_shared<sensor<t_logger, t_dispatcher>>(
         m_logger, m_dispatcher, 500ms, p_evt.sensor_id, dat::temperature{25.5},
         dat::temperature{0.75});
     _sensor->start();
@@ -104,13 +105,21 @@ private:
     }
   }
 
+  // 'm_mutex' is held only to find the sensor, which has its own lock, so
+  // the shards set the temperatures of different sensors in parallel
   void on_set_temperature(evt::set_temperature &&p_evt)
   {
-    iterator _ite = find(p_evt.sensor_id);
-    if (_ite != m_collection.end())
+    sensor_ptr _sensor;
     {
-      (*_ite)->reset_temperature(p_evt.temperature);
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      iterator                    _ite = find(p_evt.sensor_id);
+      if (_ite == m_collection.end())
+      {
+        return;
+      }
+      _sensor = *_ite;
     }
+    _sensor->reset_temperature(p_evt.temperature);
   }
 
   iterator find(dat::sensor_id p_sensor_id)
@@ -175,9 +184,10 @@ private:
     auto _handler = [this](evt::set_temperature &&p_evt)
     { this->on_set_temperature(std::move(p_evt)); };
 
-    static_assert(
-        async::cpt::has_add_handling_method<t_dispatcher, evt::set_temperature,
-                                            queue, decltype(_handler)>);
+    // the temperatures of a sensor are set in the order they were published,
+    // while the ones of different sensors are set in parallel
+    auto _sensor_id = [](const evt::set_temperature &p_evt)
+    { return p_evt.sensor_id; };
 
     auto _queue{queue::create(m_logger, 10)};
     if (!_queue)
@@ -186,9 +196,9 @@ private:
       return async::dat::result::ERROR_CREATING_QUEUE;
     }
 
-    return m_dispatcher.template add_handling<evt::set_temperature>(
+    return m_dispatcher.template add_sharded_handling<evt::set_temperature>(
         "set-temperature", std::move(*_queue), std::move(_handler),
-        async::dat::handling_priority::medium, 1);
+        std::move(_sensor_id), 4);
   }
 
 private:
@@ -0,0 +1,130 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_COROUTINE_RUNNER_H
+#define TNCT_ASYNC_INTERNAL_BUS_COROUTINE_RUNNER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "tnct/async/cpt/is_coroutine_handler.h"
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/internal/bus/detached.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Starts the coroutines of a coroutine handler, and keeps count of
+/// the ones that did not finish, so the handling is not destroyed before them
+///
+/// A coroutine runs in the thread that calls \p start until it suspends, and
+/// then in the thread that resumes it, so a thread of the handling handles
+/// the next event while the coroutine waits
+template <log::cpt::logger t_logger>
+class coroutine_runner
+{
+public:
+  explicit coroutine_runner(t_logger &p_logger) : m_logger(p_logger)
+  {
+  }
+
+  coroutine_runner(const coroutine_runner &)            = delete;
+  coroutine_runner(coroutine_runner &&)                 = delete;
+  coroutine_runner &operator=(const coroutine_runner &) = delete;
+  coroutine_runner &operator=(coroutine_runner &&)      = delete;
+
+  ~coroutine_runner()
+  {
+    wait();
+  }
+
+  /// \brief Calls \p p_handler with \p p_event, which lives until the
+  /// coroutine finishes, and then calls \p p_on_finish
+  template <async::cpt::is_event                         t_event,
+            async::cpt::is_coroutine_handler<t_event> t_handler,
+            typename t_on_finish>
+  void start(t_handler &p_handler, t_event &&p_event,
+             t_on_finish &&p_on_finish)
+  {
+    {
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      ++m_running;
+    }
+    run(p_handler, std::move(p_event), std::forward<t_on_finish>(p_on_finish));
+  }
+
+  /// \brief Waits for all the coroutines started to finish
+  void wait()
+  {
+    std::unique_lock<std::mutex> _lock(m_mutex);
+    m_cond.wait(_lock, [this]() { return m_running == 0; });
+  }
+
+  [[nodiscard]] std::size_t get_num_running() const
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    return m_running;
+  }
+
+private:
+  template <typename t_event, typename t_handler, typename t_on_finish>
+  detached run(t_handler &p_handler, t_event p_event, t_on_finish p_on_finish)
+  {
+    // the parameters are destroyed with the frame, after 'm_mutex' is
+    // released, when the handling, and the memory of its events, may be gone,
+    // so they are moved to these, which are emptied before, leaving the
+    // parameters with nothing to release
+    std::optional<t_event>     _event{std::move(p_event)};
+    std::optional<t_on_finish> _on_finish{std::move(p_on_finish)};
+
+    try
+    {
+      co_await p_handler(std::move(*_event));
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("coroutine handler: ", _ex.what()));
+    }
+    catch (...)
+    {
+      TNCT_LOG_ERR(m_logger, "coroutine handler: unknown exception");
+    }
+
+    _event.reset();
+
+    (*_on_finish)();
+    _on_finish.reset();
+
+    // nothing of this object is used after 'm_mutex' is released, as 'wait'
+    // may return, and it may be destroyed
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    if (--m_running == 0)
+    {
+      m_cond.notify_all();
+    }
+  }
+
+private:
+  t_logger &m_logger;
+
+  // Amount of coroutines started, and not finished
+  std::size_t m_running{0};
+
+  mutable std::mutex m_mutex;
+
+  std::condition_variable m_cond;
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
@@ -0,0 +1,51 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_DETACHED_H
+#define TNCT_ASYNC_INTERNAL_BUS_DETACHED_H
+
+#include <coroutine>
+#include <exception>
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Type returned by a coroutine that starts as soon as it is called,
+/// and that destroys itself when it finishes, so no one owns it
+///
+/// The coroutine must not let an exception escape
+struct detached
+{
+  struct promise_type
+  {
+    detached get_return_object() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never initial_suspend() noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never final_suspend() noexcept
+    {
+      return {};
+    }
+
+    void return_void() noexcept
+    {
+    }
+
+    void unhandled_exception() noexcept
+    {
+      std::terminate();
+    }
+  };
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
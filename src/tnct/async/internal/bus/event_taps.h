@@ -0,0 +1,152 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_EVENT_TAPS_H
+#define TNCT_ASYNC_INTERNAL_BUS_EVENT_TAPS_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "tnct/async/bus/handle.h"
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/handling_name.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/tuple/bus/get_type_index.h"
+
+namespace tnct::async::internal::bus
+{
+
+// Index of 't_event' in the tuple 't_events', written with each event so the
+// reader knows its type
+template <typename t_events, async::cpt::is_event t_event>
+inline constexpr std::uint32_t event_index{static_cast<std::uint32_t>(
+    *tuple::bus::get_type_index<t_events, t_event>())};
+
+// Handlings that pass each event of 't_events' published to a dispatcher to
+// 't_sink::write', in the thread of the publisher, used by the classes that
+// take the events out of the dispatcher, like 'bus::recorder'
+//
+// 't_sink' is shared with the handlings, so it lives while the dispatcher can
+// call them. As the handlings are inline, publishing one of 't_events' copies
+// the event for the tap if the dispatcher has other handlings for it, and
+// 't_sink::write' is called by all the publishers of the type.
+template <typename t_sink, async::cpt::is_event... t_events> class event_taps
+{
+public:
+  event_taps() = default;
+
+  event_taps(const event_taps &) = delete;
+
+  // The handlings are removed only by the object moved to
+  event_taps(event_taps &&p_taps) noexcept
+      : m_detach(std::exchange(p_taps.m_detach, {}))
+  {
+  }
+
+  event_taps &operator=(const event_taps &) = delete;
+
+  event_taps &operator=(event_taps &&p_taps) noexcept
+  {
+    if (this != &p_taps)
+    {
+      detach();
+      m_detach = std::exchange(p_taps.m_detach, {});
+    }
+    return *this;
+  }
+
+  ~event_taps() = default;
+
+  // Adds to 'p_dispatcher' a handling called 'p_name', with the highest
+  // priority, for each type in 't_events', or none of them if one fails
+  //
+  // Like adding a handling, it must not be called while other threads
+  // publish the events
+  template <typename t_dispatcher>
+  async::dat::result attach(t_dispatcher                     &p_dispatcher,
+                            const async::dat::handling_name &p_name,
+                            const std::shared_ptr<t_sink>   &p_sink)
+  {
+    handles _handles;
+
+    async::dat::result _result{async::dat::result::OK};
+    (
+        [&]()
+        {
+          if (_result == async::dat::result::OK)
+          {
+            std::get<async::bus::handle<t_events>>(_handles) =
+                p_dispatcher.template add_inline_handling<t_events>(
+                    p_name, tap<t_events>{p_sink},
+                    async::dat::handling_priority::highest);
+            _result = std::get<async::bus::handle<t_events>>(_handles);
+          }
+        }(),
+        ...);
+
+    auto _remove{
+        [_dispatcher{&p_dispatcher}, _handles]()
+        {
+          (
+              [&]()
+              {
+                const async::bus::handle<t_events> &_handle{
+                    std::get<async::bus::handle<t_events>>(_handles)};
+                // a valid handle means the dispatcher still exists
+                if (_handle.is_valid())
+                {
+                  static_cast<void>(_dispatcher->remove_handling(_handle));
+                }
+              }(),
+              ...);
+        }};
+
+    if (_result != async::dat::result::OK)
+    {
+      _remove();
+      return _result;
+    }
+
+    detach();
+    m_detach = std::move(_remove);
+    return _result;
+  }
+
+  // Removes the handlings added by 'attach', if the dispatcher still exists
+  //
+  // Like removing a handling, it must not be called while other threads
+  // publish the events
+  void detach()
+  {
+    if (m_detach)
+    {
+      std::exchange(m_detach, {})();
+    }
+  }
+
+private:
+  using handles = std::tuple<async::bus::handle<t_events>...>;
+
+  template <async::cpt::is_event t_event> struct tap
+  {
+    void operator()(t_event &&p_event)
+    {
+      sink->write(p_event);
+    }
+
+    std::shared_ptr<t_sink> sink;
+  };
+
+private:
+  std::function<void()> m_detach;
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
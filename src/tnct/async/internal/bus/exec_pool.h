@@ -0,0 +1,189 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_EXEC_POOL_H
+#define TNCT_ASYNC_INTERNAL_BUS_EXEC_POOL_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Threads where \p async::exec_sync runs the functions
+///
+/// A function is run by a thread that is idle, and a new thread is created
+/// only if all of them are busy, so the threads are reused. As the functions
+/// may block, none of them waits for another to finish, so there are as many
+/// threads as functions running at the same time, and a thread idle for
+/// longer than the idle timeout finishes, so a burst of functions does not
+/// leave threads behind.
+class exec_pool
+{
+public:
+  using task = std::function<void()>;
+
+  static constexpr std::chrono::milliseconds default_idle_timeout{10000};
+
+  explicit exec_pool(
+      std::chrono::milliseconds p_idle_timeout = default_idle_timeout)
+      : m_idle_timeout(p_idle_timeout)
+  {
+  }
+
+  exec_pool(const exec_pool &)            = delete;
+  exec_pool(exec_pool &&)                 = delete;
+  exec_pool &operator=(const exec_pool &) = delete;
+  exec_pool &operator=(exec_pool &&)      = delete;
+
+  ~exec_pool()
+  {
+    std::vector<std::thread> _threads;
+    {
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      m_stopping = true;
+      // no thread retires after 'm_stopping' is set
+      _threads.swap(m_threads);
+    }
+    m_cond.notify_all();
+    for (std::thread &_thread : _threads)
+    {
+      _thread.join();
+    }
+    join_retired();
+  }
+
+  /// \brief The pool used by \p async::exec_sync, created the first time it is
+  /// used
+  static exec_pool &shared()
+  {
+    static exec_pool _exec_pool;
+    return _exec_pool;
+  }
+
+  /// \brief Runs \p p_task, and then \p p_done, when the thread is already
+  /// idle, so a call to \p run made after \p p_done reuses the thread
+  void run(task &&p_task, task &&p_done)
+  {
+    join_retired();
+
+    {
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      m_tasks.push_back({std::move(p_task), std::move(p_done)});
+      if (m_tasks.size() > m_idle)
+      {
+        // the new thread is idle until it takes a task
+        ++m_idle;
+        m_threads.push_back(std::thread([this]() { work(); }));
+        return;
+      }
+    }
+    m_cond.notify_one();
+  }
+
+  /// \return Amount of threads that did not finish
+  [[nodiscard]] std::size_t get_num_threads() const
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    return m_threads.size();
+  }
+
+private:
+  struct scheduled
+  {
+    task run;
+    task done;
+  };
+
+private:
+  void work()
+  {
+    std::unique_lock<std::mutex> _lock(m_mutex);
+    while (true)
+    {
+      const bool _woken{m_cond.wait_for(
+          _lock, m_idle_timeout,
+          [this]() { return m_stopping || !m_tasks.empty(); })};
+      if (m_stopping)
+      {
+        return;
+      }
+      if (!_woken)
+      {
+        retire();
+        return;
+      }
+      scheduled _scheduled{std::move(m_tasks.front())};
+      m_tasks.pop_front();
+      --m_idle;
+
+      _lock.unlock();
+      _scheduled.run();
+      _lock.lock();
+
+      ++m_idle;
+
+      _lock.unlock();
+      _scheduled.done();
+      _lock.lock();
+    }
+  }
+
+  // Moves the thread calling it, which is idle, and leaving 'work', from
+  // 'm_threads' to 'm_retired', to be joined by 'run', or by the destructor
+  void retire()
+  {
+    --m_idle;
+    const auto _ite{std::find_if(
+        m_threads.begin(), m_threads.end(), [](const std::thread &p_thread)
+        { return p_thread.get_id() == std::this_thread::get_id(); })};
+    m_retired.push_back(std::move(*_ite));
+    m_threads.erase(_ite);
+  }
+
+  void join_retired()
+  {
+    std::vector<std::thread> _retired;
+    {
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      _retired.swap(m_retired);
+    }
+    for (std::thread &_thread : _retired)
+    {
+      _thread.join();
+    }
+  }
+
+private:
+  const std::chrono::milliseconds m_idle_timeout;
+
+  std::vector<std::thread> m_threads;
+
+  // Threads that finished for being idle for too long, and were not joined
+  std::vector<std::thread> m_retired;
+
+  std::deque<scheduled> m_tasks;
+
+  // Amount of threads without a task, which is never less than the amount of
+  // tasks not taken, so each of them is taken with no new thread
+  std::size_t m_idle{0};
+
+  bool m_stopping{false};
+
+  mutable std::mutex m_mutex;
+
+  std::condition_variable m_cond;
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
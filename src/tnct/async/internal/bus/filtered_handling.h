@@ -0,0 +1,206 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_FILTERED_HANDLING_H
+#define TNCT_ASYNC_INTERNAL_BUS_FILTERED_HANDLING_H
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/cpt/is_event_filter.h"
+#include "tnct/async/dat/autoscaling.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/handling_name.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/handling.h"
+#include "tnct/async/internal/dat/handler_id.h"
+#include "tnct/async/internal/dat/handling_id.h"
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Handling that only receives the events \p t_filter accepts, and
+/// forwards everything else to a \p t_handling
+///
+/// The dispatcher calls \p accepts before copying the event, so an event that
+/// is not accepted costs no copy, no space in the queue, and does not wake up
+/// a handler. \p add_events passes the accepted events to \p t_handling in
+/// sequences, without copying them.
+template <async::cpt::is_event t_event, typename t_handling,
+          async::cpt::is_event_filter<t_event> t_filter>
+requires std::derived_from<t_handling, handling<t_event>>
+class filtered_handling final : public handling<t_event>
+{
+public:
+  using event     = t_event;
+  using filter    = t_filter;
+  using decorated = t_handling;
+
+  /// \param p_params are used to create the \p t_handling
+  template <typename... t_params>
+  filtered_handling(filter &&p_filter, t_params &&...p_params)
+      : m_filter(std::move(p_filter)),
+        m_handling(std::forward<t_params>(p_params)...)
+  {
+  }
+
+  filtered_handling(const filtered_handling &)            = delete;
+  filtered_handling(filtered_handling &&)                 = delete;
+  filtered_handling &operator=(const filtered_handling &) = delete;
+  filtered_handling &operator=(filtered_handling &&)      = delete;
+
+  ~filtered_handling() override = default;
+
+  [[nodiscard]] bool accepts(const event &p_event) const override
+  {
+    if (m_filter(p_event))
+    {
+      return true;
+    }
+    m_filtered.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  async::dat::result add_event(event &&p_event) override
+  {
+    return m_handling.add_event(std::move(p_event));
+  }
+
+  std::optional<async::dat::result> try_add_event(event &&p_event) override
+  {
+    return m_handling.try_add_event(std::move(p_event));
+  }
+
+  bool resume_on_space(const event            &p_event,
+                       std::coroutine_handle<> p_awaiting) override
+  {
+    return m_handling.resume_on_space(p_event, p_awaiting);
+  }
+
+  async::dat::result add_events(std::span<const event> p_events) override
+  {
+    async::dat::result _result{async::dat::result::OK};
+
+    auto _add{[&](std::size_t p_begin, std::size_t p_end)
+              {
+                if (p_begin == p_end)
+                {
+                  return;
+                }
+                if (const async::dat::result _added{m_handling.add_events(
+                        p_events.subspan(p_begin, p_end - p_begin))};
+                    (_added != async::dat::result::OK)
+                    && (_result == async::dat::result::OK))
+                {
+                  _result = _added;
+                }
+              }};
+
+    std::size_t _begin{0};
+    for (std::size_t _i = 0; _i < p_events.size(); ++_i)
+    {
+      if (!accepts(p_events[_i]))
+      {
+        _add(_begin, _i);
+        _begin = _i + 1;
+      }
+    }
+    _add(_begin, p_events.size());
+
+    return _result;
+  }
+
+  [[nodiscard]] std::pmr::memory_resource *get_event_pool() const override
+  {
+    return m_handling.get_event_pool();
+  }
+
+  void set_overflow_policy(async::dat::overflow_policy p_policy,
+                           std::size_t                 p_max_capacity) override
+  {
+    m_handling.set_overflow_policy(p_policy, p_max_capacity);
+  }
+
+  void stop() override
+  {
+    m_handling.stop();
+  }
+
+  constexpr bool is_stopped() const override
+  {
+    return m_handling.is_stopped();
+  }
+
+  [[nodiscard]] constexpr size_t get_amount_handlers() const override
+  {
+    return m_handling.get_amount_handlers();
+  }
+
+  std::optional<async::dat::autoscaling_decision> autoscale() override
+  {
+    return m_handling.autoscale();
+  }
+
+  async::dat::result increment_handlers(size_t p_num_handlers) override
+  {
+    return m_handling.increment_handlers(p_num_handlers);
+  }
+
+  [[nodiscard]] dat::handling_id get_id() const override
+  {
+    return m_handling.get_id();
+  }
+
+  [[nodiscard]] async::dat::handling_name get_name() const override
+  {
+    return m_handling.get_name();
+  }
+
+  [[nodiscard]] constexpr size_t get_num_events() const override
+  {
+    return m_handling.get_num_events();
+  }
+
+  [[nodiscard]] constexpr size_t get_events_capacity() const override
+  {
+    return m_handling.get_events_capacity();
+  }
+
+  [[nodiscard]] internal::dat::handler_id get_handler_id() const override
+  {
+    return m_handling.get_handler_id();
+  }
+
+  [[nodiscard]] async::dat::handling_metrics get_metrics() const override
+  {
+    async::dat::handling_metrics _metrics{m_handling.get_metrics()};
+    _metrics.filtered = m_filtered.load(std::memory_order_relaxed);
+    return _metrics;
+  }
+
+  void clear() override
+  {
+    m_handling.clear();
+  }
+
+private:
+  filter m_filter;
+
+  decorated m_handling;
+
+  mutable std::atomic<std::uint64_t> m_filtered{0};
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
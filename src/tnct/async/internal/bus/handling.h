@@ -6,20 +6,48 @@
 #ifndef TNCT_ASYNC_INTERNAL_HANDLING_H
 #define TNCT_ASYNC_INTERNAL_HANDLING_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
 #include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <typeinfo>
 #include <vector>
 
+#include "tnct/async/bus/affinity.h"
+#include "tnct/async/bus/timer_wheel.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/cpt/is_any_handler.h"
+#include "tnct/async/cpt/is_batch_handler.h"
+#include "tnct/async/cpt/is_coroutine_handler.h"
 #include "tnct/async/cpt/is_event.h"
-#include "tnct/async/cpt/is_handler.h"
+#include "tnct/async/cpt/is_pmr_event.h"
+#include "tnct/async/dat/affinity.h"
+#include "tnct/async/dat/autoscaling.h"
+#include "tnct/async/dat/event_pool.h"
+#include "tnct/async/dat/handling_metrics.h"
 #include "tnct/async/dat/handling_name.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/coroutine_runner.h"
+#include "tnct/async/internal/bus/metrics_recorder.h"
 #include "tnct/async/internal/dat/handler_id.h"
 #include "tnct/async/internal/dat/handling_id.h"
+#include "tnct/container/cpt/coalescing_queue.h"
+#include "tnct/container/cpt/multi_level_queue.h"
 #include "tnct/container/cpt/queue.h"
+#include "tnct/container/cpt/stamped_queue.h"
 #include "tnct/format/bus/fmt.h"
 #include "tnct/log/cpt/logger.h"
 #include "tnct/log/cpt/macros.h"
@@ -33,9 +61,91 @@ class handling
 public:
   virtual ~handling() = default;
 
-  virtual void add_event(const t_event &p_event) = 0;
+  /// \brief Tells if \p p_event should be added to the handling, and it is
+  /// called before the event is copied to be added
+  [[nodiscard]] virtual bool accepts(const t_event &p_event) const
+  {
+    static_cast<void>(p_event);
+    return true;
+  }
+
+  virtual async::dat::result add_event(t_event &&p_event) = 0;
+
+  /// \brief Like \p add_event, but if the handling is full, and its
+  /// \p async::dat::overflow_policy is \p block, \p p_event is not added,
+  /// and not moved from
+  ///
+  /// \return \p std::nullopt if \p p_event was not added because the
+  /// handling is full
+  virtual std::optional<async::dat::result> try_add_event(t_event &&p_event)
+  {
+    return add_event(std::move(p_event));
+  }
+
+  /// \brief Resumes \p p_awaiting when there may be space for \p p_event,
+  /// after \p try_add_event did not add it
+  ///
+  /// \return \p false if there is already space, and \p p_awaiting is not
+  /// resumed
+  virtual bool resume_on_space(const t_event          &p_event,
+                               std::coroutine_handle<> p_awaiting)
+  {
+    static_cast<void>(p_event);
+    static_cast<void>(p_awaiting);
+    return false;
+  }
+
+  /// \brief Evaluates the \p async::dat::autoscaling policy of the handling,
+  /// which may add or remove handlers
+  ///
+  /// \return \p std::nullopt if the handling has no autoscaling policy
+  virtual std::optional<async::dat::autoscaling_decision> autoscale()
+  {
+    return std::nullopt;
+  }
+
+  /// \brief Adds copies of \p p_events, notifying the handlers only once
+  virtual async::dat::result add_events(std::span<const t_event> p_events) = 0;
+
+  /// \brief Memory where the events of the handling are kept, if it has an
+  /// \p async::dat::event_pool, or \p nullptr
+  [[nodiscard]] virtual std::pmr::memory_resource *get_event_pool() const
+  {
+    return nullptr;
+  }
+
+  /// \brief Copies \p p_event to the memory of the handling, if it has an
+  /// \p async::dat::event_pool, and \p t_event is a
+  /// \p async::cpt::is_pmr_event, so the copy does not allocate elsewhere
+  [[nodiscard]] t_event copy_event(const t_event &p_event) const
+  requires std::copy_constructible<t_event>
+  {
+    if constexpr (async::cpt::is_pmr_event<t_event>)
+    {
+      if (std::pmr::memory_resource *_pool{get_event_pool()};
+          _pool != nullptr)
+      {
+        return std::make_obj_using_allocator<t_event>(
+            std::pmr::polymorphic_allocator<std::byte>{_pool}, p_event);
+      }
+    }
+    return t_event{p_event};
+  }
 
-  // virtual void increment_handlers(size_t p_num_handlers) = 0;
+  /// \brief Defines what happens when an event is added and there are already
+  /// \p p_max_capacity events in the handling, where 0 means no limit
+  virtual void set_overflow_policy(async::dat::overflow_policy p_policy,
+                                   std::size_t p_max_capacity) = 0;
+
+  /// \brief Starts \p p_num_handlers more handlers, while the handling runs
+  ///
+  /// \return \p async::dat::result::ERROR_ADDING_HANDLER if the handling can
+  /// not have more handlers
+  virtual async::dat::result increment_handlers(size_t p_num_handlers)
+  {
+    static_cast<void>(p_num_handlers);
+    return async::dat::result::ERROR_ADDING_HANDLER;
+  }
 
   virtual void stop() = 0;
 
@@ -53,12 +163,57 @@ public:
 
   [[nodiscard]] virtual internal::dat::handler_id get_handler_id() const = 0;
 
+  [[nodiscard]] virtual async::dat::handling_metrics get_metrics() const = 0;
+
   virtual void clear() = 0;
 };
 
+/// \brief Handling that calls its handlers in its own threads, or in tasks of a
+/// \p async::bus::work_stealing_pool, if one is informed
+///
+/// When a pool is used, \p p_num_handlers is the maximum number of pool tasks
+/// calling the handlers of this handling at the same time, so with one handler
+/// the events are handled in the order they were added
+///
+/// If \p t_handler is a \p async::cpt::is_batch_handler, it receives up to
+/// \p p_batch_size events that were in the queue at each call
+///
+/// If \p t_handler is a \p async::cpt::is_coroutine_handler, the handler
+/// takes the next event as soon as the coroutine suspends, so there can be many
+/// more events being handled than handlers. The handling is destroyed only
+/// after all the coroutines finish.
+///
+/// If an \p async::dat::autoscaling policy is informed, and there is no pool,
+/// the amount of handler threads changes between its minimum and maximum, as
+/// the policy decides, and \p p_num_handlers is the amount it starts with.
+/// All the possible handlers are created, and the metrics of all of them are
+/// reported, but only the active ones have a thread.
+///
+/// If an \p async::dat::affinity is informed, and there is no pool, each
+/// handler thread pins itself to its CPUs when it starts.
+///
+/// If an \p async::dat::event_pool is informed, and \p t_event is an
+/// \p async::cpt::is_pmr_event, each event added is moved, or copied, to the
+/// memory of the handling, so what it allocates comes from there, and is
+/// reused when the event is destroyed after it is handled. An event built with
+/// the allocator of \p get_event_pool is moved with no copy. A handler that
+/// keeps an event must not keep it longer than the handling.
+///
+/// If \p t_queue is a \p container::cpt::coalescing_queue, an event that
+/// replaces another in the queue does not count as a new event, and does not
+/// take more space, but a publisher may still wait for space, as defined in
+/// \p async::dat::overflow_policy::block, before the event replaces the other.
+///
+/// If \p t_queue is a \p container::cpt::multi_level_queue, the event
+/// discarded by \p async::dat::overflow_policy::drop_oldest is the oldest of
+/// the least urgent level, so urgent events are not lost to make room.
+///
+/// If \p t_queue is a \p container::cpt::stamped_queue, each event carries
+/// the moment it was pushed, so the metrics of the handling have the time each
+/// event waited in the queue, otherwise they have no enqueue to dequeue time.
 template <log::cpt::logger t_logger, async::cpt::is_event t_event,
-          container::cpt::queue<t_event>  t_queue,
-          async::cpt::is_handler<t_event> t_handler>
+          container::cpt::queue<t_event>      t_queue,
+          async::cpt::is_any_handler<t_event> t_handler>
 class handling_concrete final : public handling<t_event>
 {
 public:
@@ -66,38 +221,76 @@ public:
   using event   = t_event;
   using queue   = t_queue;
   using handler = t_handler;
+  using pool    = async::bus::work_stealing_pool<t_logger>;
 
   handling_concrete(const async::dat::handling_name &p_handling_name,
                     t_logger &p_logger, handler &&p_handler, queue &&p_queue,
-                    size_t p_num_handlers = 1)
+                    size_t p_num_handlers = 1, pool *p_pool = nullptr,
+                    async::dat::handling_priority p_priority =
+                        async::dat::handling_priority::medium,
+                    size_t p_batch_size = 1,
+                    std::optional<async::dat::autoscaling> p_autoscaling =
+                        std::nullopt,
+                    async::dat::affinity p_affinity = {},
+                    std::optional<async::dat::event_pool> p_event_pool =
+                        std::nullopt)
       : m_logger(p_logger), m_handling_name(p_handling_name),
         m_handling_id(internal::dat::get_handling_id(m_handling_name)),
-        m_handler(p_handler), m_queue(std::move(p_queue)),
-        m_handler_id(internal::dat::get_handler_id<t_event, t_handler>())
+        m_handler(p_handler), m_event_pool(create_event_pool(p_event_pool)),
+        m_queue(std::move(p_queue)),
+        m_handler_id(internal::dat::get_handler_id<t_event, t_handler>()),
+        m_pool(p_pool), m_priority(p_priority),
+        m_batch_size(p_batch_size == 0 ? 1 : p_batch_size),
+        m_coroutines(p_logger), m_affinity(std::move(p_affinity))
   {
     TNCT_LOG_TRA(m_logger,
                  format::bus::fmt("m_handling_id = ", m_handling_id,
                                   ", m_handling_name = ", m_handling_name,
                                   ", m_handler_id = ", m_handler_id,
                                   ", p_num_handlers = ", p_num_handlers));
-    increment_handlers(p_num_handlers);
+
+    if (p_autoscaling && (m_pool == nullptr))
+    {
+      start_autoscaling(std::move(*p_autoscaling), p_num_handlers);
+    }
+    else
+    {
+      create_handlers(p_num_handlers);
+    }
   }
 
   handling_concrete(const handling_concrete &) = delete;
 
   handling_concrete(handling_concrete &&p_handling)
-      : m_logger(p_handling.m_logger), m_handling_id(p_handling.m_handling_id),
-        m_handler(std::move(p_handling.m_handler)), m_queue(p_handling.m_queue),
-        m_handler_id(p_handling.m_handler_id)
+      : m_logger(p_handling.m_logger),
+        m_handling_name(p_handling.m_handling_name),
+        m_handling_id(p_handling.m_handling_id),
+        m_handler(std::move(p_handling.m_handler)),
+        m_event_pool(std::move(p_handling.m_event_pool)),
+        m_queue(std::move(p_handling.m_queue)),
+        m_handler_id(p_handling.m_handler_id), m_pool(p_handling.m_pool),
+        m_priority(p_handling.m_priority), m_batch_size(p_handling.m_batch_size),
+        m_coroutines(p_handling.m_logger), m_affinity(p_handling.m_affinity)
   {
     const bool _right_handling_was_stopped{p_handling.is_stopped()};
     p_handling.stop();
 
     m_queued_data.store(p_handling.m_queued_data);
-    m_queue = std::move(p_handling.m_queue);
+    m_events.store(p_handling.m_events);
+    m_occupied.store(p_handling.m_occupied);
+    m_overflow_policy.store(p_handling.m_overflow_policy);
+    m_max_capacity.store(p_handling.m_max_capacity);
     if (!_right_handling_was_stopped)
     {
-      increment_handlers(p_handling.get_amount_handlers());
+      if (p_handling.m_autoscaling)
+      {
+        start_autoscaling(*p_handling.m_autoscaling,
+                          p_handling.get_amount_handlers());
+      }
+      else
+      {
+        create_handlers(p_handling.get_amount_handlers());
+      }
     }
   }
 
@@ -110,23 +303,116 @@ public:
   {
     TNCT_LOG_TRA(m_logger, trace("entering destructor"));
     stop();
+    m_coroutines.wait();
     TNCT_LOG_TRA(m_logger, trace("leaving destructor"));
   }
 
   handling_concrete &operator=(const handling_concrete &) = default;
   handling_concrete &operator=(handling_concrete &&)      = default;
 
-  void add_event(const event &p_event) override
+  async::dat::result add_event(event &&p_event) override
   {
 
     TNCT_LOG_TRA(m_logger, format::bus::fmt("event = ", p_event));
 
-    m_queue.push(p_event);
+    if (const async::dat::result _result{push(std::move(p_event))};
+        _result != async::dat::result::OK)
+    {
+      return _result;
+    }
 
-    std::lock_guard<std::mutex> _lock(m_data_mutex);
-    m_data_cond.notify_all();
+    wake_up();
+    return async::dat::result::OK;
+  }
 
-    ++m_queued_data;
+  std::optional<async::dat::result> try_add_event(event &&p_event) override
+  {
+    const admission _admission{admit(false)};
+    if (_admission == admission::full)
+    {
+      return std::nullopt;
+    }
+
+    if (const async::dat::result _result{
+            push(std::move(p_event), _admission)};
+        _result != async::dat::result::OK)
+    {
+      return _result;
+    }
+
+    wake_up();
+    return async::dat::result::OK;
+  }
+
+  /// \brief \p p_awaiting is resumed by the thread that takes an event from
+  /// the queue, or that stops or clears the handling
+  bool resume_on_space(const event &,
+                       std::coroutine_handle<> p_awaiting) override
+  {
+    std::lock_guard<std::mutex> _lock(m_space_waiters_mutex);
+
+    // counted before the space is checked, so 'free_space' either finds it, or
+    // the space is found here
+    ++m_num_space_waiters;
+    if (m_stopped
+        || (m_overflow_policy != async::dat::overflow_policy::block)
+        || (m_max_capacity == 0) || (m_occupied < m_max_capacity))
+    {
+      --m_num_space_waiters;
+      return false;
+    }
+    m_space_waiters.push_back(p_awaiting);
+    return true;
+  }
+
+  async::dat::result add_events(std::span<const event> p_events) override
+  {
+    if constexpr (std::copy_constructible<event>)
+    {
+      TNCT_LOG_TRA(m_logger,
+                   format::bus::fmt("amount of events = ", p_events.size()));
+
+      async::dat::result _result{async::dat::result::OK};
+      for (const event &_event : p_events)
+      {
+        if (const async::dat::result _pushed{push(this->copy_event(_event))};
+            _pushed != async::dat::result::OK)
+        {
+          _result = _pushed;
+        }
+      }
+
+      if (m_pool != nullptr)
+      {
+        for (std::size_t _i = 0; (_i < p_events.size()) && schedule(); ++_i)
+        {
+        }
+      }
+      else
+      {
+        for (std::size_t _i = 0; (_i < p_events.size()) && unpark_one(); ++_i)
+        {
+        }
+      }
+      return _result;
+    }
+    else
+    {
+      TNCT_LOG_ERR(m_logger, trace("events can not be copied"));
+      return async::dat::result::ERROR_PUBLISHNG;
+    }
+  }
+
+  void set_overflow_policy(async::dat::overflow_policy p_policy,
+                           std::size_t                 p_max_capacity) override
+  {
+    TNCT_LOG_TRA(m_logger, format::bus::fmt("overflow policy = ", p_policy,
+                                            ", max capacity = ",
+                                            p_max_capacity));
+    m_max_capacity.store(p_max_capacity);
+    m_overflow_policy.store(p_policy);
+    // publishers blocked by the previous policy check the new one
+    free_space();
   }
 
   // \brief Stops this handling
@@ -138,18 +424,32 @@ public:
     {
       TNCT_LOG_TRA(m_logger, trace("not stopping because it is stopped"));
 
-      std::lock_guard<std::mutex> _lock(m_data_mutex);
-      m_data_cond.notify_all();
+      unpark_all();
       return;
     }
     TNCT_LOG_TRA(m_logger, trace("notifying loops to stop"));
 
+    m_stopped.store(true);
+
+    if (m_autoscaling_timer)
+    {
+      async::bus::timer_wheel::cancel(m_autoscaling_timer);
+      async::bus::timer_wheel::wait(m_autoscaling_timer);
+    }
+
+    unpark_all();
+    free_space();
+
+    if (m_pool != nullptr)
     {
-      std::lock_guard<std::mutex> _lock(m_data_mutex);
-      m_stopped.store(true);
-      m_data_cond.notify_all();
+      // the pool tasks submitted will not call the handlers anymore, but they
+      // refer to this handling, so they must finish
+      std::unique_lock<std::mutex> _lock(m_pool_tasks_mutex);
+      m_pool_tasks_cond.wait(_lock, [this]() { return m_pool_tasks == 0; });
     }
 
+    // 'autoscale' does not start, or join, threads while they are joined here
+    std::lock_guard<std::mutex> _lock(m_scaling_mutex);
     for (std::thread &_thread : m_loops)
     {
       if (_thread.joinable())
@@ -176,7 +476,77 @@ public:
 
   [[nodiscard]] constexpr size_t get_amount_handlers() const override
   {
-    return m_handling_handlers.size();
+    return m_num_active;
+  }
+
+  [[nodiscard]] std::pmr::memory_resource *get_event_pool() const override
+  {
+    return m_event_pool.get();
+  }
+
+  /// \brief Adds one handler if the policy voted to grow enough times in a
+  /// row, or removes one if it voted to shrink, and then calls
+  /// \p async::dat::autoscaling::on_decision
+  std::optional<async::dat::autoscaling_decision> autoscale() override
+  {
+    if (!m_autoscaling)
+    {
+      return std::nullopt;
+    }
+
+    async::dat::autoscaling_decision _decision;
+    {
+      std::lock_guard<std::mutex> _lock(m_scaling_mutex);
+      if (m_stopped)
+      {
+        return std::nullopt;
+      }
+      _decision = evaluate();
+      if (_decision.to > _decision.from)
+      {
+        grow(_decision.to);
+      }
+      else if (_decision.to < _decision.from)
+      {
+        shrink(_decision.to);
+      }
+    }
+
+    TNCT_LOG_DEB(m_logger, format::bus::fmt("autoscaling ", _decision));
+
+    // called without 'm_scaling_mutex', so it can call 'autoscale' again
+    if (m_autoscaling->on_decision)
+    {
+      m_autoscaling->on_decision(_decision);
+    }
+    return _decision;
+  }
+
+  /// \brief Starts \p p_num_handlers of the handlers created for the
+  /// \p async::dat::autoscaling policy, up to its maximum, as the handlers of
+  /// a handling without one can not change while their threads run
+  async::dat::result increment_handlers(size_t p_num_handlers) override
+  {
+    if (!m_autoscaling)
+    {
+      TNCT_LOG_ERR(m_logger, trace("handlers can only be added to a handling "
+                                   "with an autoscaling policy"));
+      return async::dat::result::ERROR_ADDING_HANDLER;
+    }
+
+    std::lock_guard<std::mutex> _lock(m_scaling_mutex);
+    if (m_stopped
+        || ((m_num_active + p_num_handlers) > m_autoscaling->max_handlers))
+    {
+      TNCT_LOG_ERR(m_logger,
+                   trace(format::bus::fmt("can not add ", p_num_handlers,
+                                          " handlers to ", m_num_active.load(),
+                                          ", as the maximum is ",
+                                          m_autoscaling->max_handlers)));
+      return async::dat::result::ERROR_ADDING_HANDLER;
+    }
+    grow(m_num_active + p_num_handlers);
+    return async::dat::result::OK;
   }
 
   [[nodiscard]] async::dat::handling_name get_name() const override
@@ -202,9 +572,20 @@ public:
 
   void clear() override
   {
-    std::lock_guard<std::mutex> _lock(m_data_mutex);
-    m_queue.clear();
-    m_data_cond.notify_all();
+    // keeps 'm_events' equal to the amount of events in the queue
+    while (m_queue.pop().has_value())
+    {
+      --m_events;
+      --m_occupied;
+    }
+    free_space();
+  }
+
+  [[nodiscard]] async::dat::handling_metrics get_metrics() const override
+  {
+    async::dat::handling_metrics _metrics{m_metrics.get(get_queued())};
+    _metrics.name = m_handling_name;
+    return _metrics;
   }
 
   friend std::ostream &operator<<(std::ostream            &p_out,
@@ -236,46 +617,40 @@ private:
 
   using handling_handler_pos = typename handling_handlers::size_type;
 
-private:
-  // void increment_handlers(size_t p_num_handlers) override {
-  //     if (p_num_handlers == 0) {
-  //         return;
-  //     }
-
-  //     if (m_stopped) {
-  //         TNCT_LOG_TRA(m_logger,
-  //                      trace("not adding subscriber because handling is
-  //                      stopped"));
-  //         return;
-  //     }
-
-  //     TNCT_LOG_TRA(m_logger, trace(format::bus::fmt("adding ",
-  //     p_num_handlers,
-  //                                              " event handlers")));
-
-  //     std::lock_guard<std::mutex> _lock(m_add_subscriber_mutex);
-
-  //     // std::size_t _total_num_handlers{m_handling_handlers.size()};
-
-  //     for (decltype(p_num_handlers) _i = 0; _i < p_num_handlers; ++_i) {
-  //         m_handling_handlers.push_back(m_handler);
-
-  //         const handling_handler_pos
-  //         _new_handler_pos{m_handling_handlers.size()
-  //                                                     -
-  //                                                     1};
+  // Events passed at once to a batch handler, and the moments they were pushed
+  struct batch
+  {
+    std::vector<event>        events;
+    std::vector<std::int64_t> pushed_at;
+  };
 
-  //         TNCT_LOG_TRA(m_logger,
-  //                      format::bus::fmt("_new_handler_pos ",
-  //                      _new_handler_pos));
+  // What 'admit' decides about a new event
+  enum class admission : std::uint8_t
+  {
+    push,
+    drop,
+    reject,
+    stopped,
+    // the handling is full, and the publisher does not want to wait
+    full
+  };
+
+  // avoids the signals of different handlers sharing a cache line
+  static constexpr std::size_t cache_line_size{64};
+
+  // A handler thread sleeps until 'signal' is not 0
+  struct alignas(cache_line_size) parking
+  {
+    std::atomic_uint32_t signal{0};
 
-  //         m_loops.push_back(std::thread([this, _new_handler_pos]() -> void {
-  //             handler_loop(_new_handler_pos);
-  //         }));
-  //     }
-  // }
+    // set when the handler is removed by 'shrink', so its thread finishes
+    std::atomic_bool retired{false};
+  };
 
-  void increment_handlers(size_t p_num_handlers)
+private:
+  // Creates \p p_num_handlers handlers, and starts their threads, or makes
+  // them available to the pool, before any event is added
+  void create_handlers(size_t p_num_handlers)
   {
     if (p_num_handlers == 0)
     {
@@ -285,104 +660,769 @@ private:
     TNCT_LOG_TRA(m_logger, trace(format::bus::fmt("adding ", p_num_handlers,
                                                   " event handlers")));
 
-    // std::size_t _total_num_handlers{m_handling_handlers.size()};
+    // the handlers are all inserted before any of them is called, so
+    // 'm_handling_handlers' and 'm_parkings' do not change while being used
+    const handling_handler_pos _first_handler_pos{m_handling_handlers.size()};
 
+    m_metrics.add_handlers(p_num_handlers);
+    m_num_active += p_num_handlers;
     for (decltype(p_num_handlers) _i = 0; _i < p_num_handlers; ++_i)
     {
       m_handling_handlers.push_back(m_handler);
+      if (m_pool == nullptr)
+      {
+        m_parkings.push_back(std::make_unique<parking>());
+      }
+    }
 
-      const handling_handler_pos _new_handler_pos{m_handling_handlers.size()
-                                                  - 1};
+    for (handling_handler_pos _new_handler_pos = _first_handler_pos;
+         _new_handler_pos < m_handling_handlers.size(); ++_new_handler_pos)
+    {
+      if (m_pool != nullptr)
+      {
+        std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+        m_idle_handlers.push_back(_new_handler_pos);
+        continue;
+      }
 
       m_loops.push_back(std::thread([this, _new_handler_pos]() -> void
                                     { handler_loop(_new_handler_pos); }));
     }
+
+    if (m_pool != nullptr)
+    {
+      schedule();
+    }
   }
 
-  // Waits for an event to be available in the event queue, then remove it and
-  // call the handler in \p p_handling_handler_pos in \p m_handling_handlers. It
-  // exits when \p m_stop is set.
-  void handler_loop(handling_handler_pos p_handling_handler_pos)
+  // Memory resource of the events, if 'p_event_pool' is informed, and
+  // 't_event' can allocate from it
+  static std::unique_ptr<std::pmr::memory_resource> create_event_pool(
+      const std::optional<async::dat::event_pool> &p_event_pool)
+  {
+    if constexpr (async::cpt::is_pmr_event<event>)
+    {
+      if (p_event_pool)
+      {
+        return std::make_unique<std::pmr::synchronized_pool_resource>(
+            std::pmr::pool_options{p_event_pool->blocks_per_chunk,
+                                   p_event_pool->largest_block},
+            p_event_pool->upstream);
+      }
+    }
+    return nullptr;
+  }
+
+  // Creates 'max_handlers' handlers, but starts the threads of only
+  // \p p_num_handlers of them, within the limits of \p p_autoscaling, so
+  // 'm_handling_handlers', 'm_parkings' and 'm_loops' do not change while the
+  // threads run
+  void start_autoscaling(async::dat::autoscaling p_autoscaling,
+                         size_t                  p_num_handlers)
   {
+    if (p_autoscaling.max_handlers == 0)
+    {
+      p_autoscaling.max_handlers = 1;
+    }
+    p_autoscaling.min_handlers =
+        std::min(p_autoscaling.min_handlers, p_autoscaling.max_handlers);
 
-    // auto _queue_addr{&m_queue};
-    auto _loop_id{std::this_thread::get_id()};
+    TNCT_LOG_TRA(m_logger,
+                 trace(format::bus::fmt("autoscaling ", p_autoscaling)));
 
-    TNCT_LOG_TRA(
-        m_logger,
-        format::bus::fmt("p_handling_handler_pos = ", p_handling_handler_pos,
-                         " ", trace("starting subscriber's loop", _loop_id)));
+    const std::size_t _max{p_autoscaling.max_handlers};
+    const std::chrono::milliseconds _interval{p_autoscaling.interval};
+    const std::size_t _first{std::clamp(
+        p_num_handlers, p_autoscaling.min_handlers, _max)};
 
-    // auto _subscriber_id{&m_handling_handlers[p_handling_handler_pos]};
+    m_autoscaling.emplace(std::move(p_autoscaling));
 
-    if (m_stopped)
+    m_metrics.add_handlers(_max);
+    for (std::size_t _i = 0; _i < _max; ++_i)
     {
-      TNCT_LOG_TRA(m_logger, trace("already stopped", _loop_id));
-      return;
+      m_handling_handlers.push_back(m_handler);
+      m_parkings.push_back(std::make_unique<parking>());
     }
+    m_loops.resize(_max);
 
-    TNCT_LOG_TRA(m_logger, trace("entering loop"));
+    m_last_evaluation = metrics_recorder::now();
+    m_last_busy       = m_metrics.get_busy();
 
-    while (true)
     {
+      std::lock_guard<std::mutex> _lock(m_scaling_mutex);
+      grow(_first);
+    }
+
+    if (_interval.count() > 0)
+    {
+      m_autoscaling_timer = async::bus::timer_wheel::shared().start(
+          [this]() { autoscale(); }, _interval);
+    }
+  }
+
+  // Decides how many handlers there should be, counting the votes to grow or
+  // to shrink. 'm_scaling_mutex' must be locked.
+  async::dat::autoscaling_decision evaluate()
+  {
+    const async::dat::autoscaling &_policy{*m_autoscaling};
+
+    const std::size_t   _active{m_num_active};
+    const std::size_t   _queued{get_queued()};
+    const std::int64_t  _now{metrics_recorder::now()};
+    const std::uint64_t _busy{m_metrics.get_busy()};
+    const std::int64_t  _elapsed{_now - m_last_evaluation};
+
+    double _utilisation{0.0};
+    if ((_elapsed > 0) && (_active > 0))
+    {
+      _utilisation = std::min(
+          1.0, static_cast<double>(_busy - m_last_busy)
+                   / (static_cast<double>(_elapsed)
+                      * static_cast<double>(_active)));
+    }
+    m_last_evaluation = _now;
+    m_last_busy       = _busy;
+
+    async::dat::autoscaling_decision _decision{
+        m_handling_name, _active, _active, _queued, _utilisation};
+
+    if (_active < _policy.min_handlers)
+    {
+      _decision.to = _policy.min_handlers;
+      m_grow_votes = m_shrink_votes = 0;
+    }
+    else if (_active > _policy.max_handlers)
+    {
+      _decision.to = _policy.max_handlers;
+      m_grow_votes = m_shrink_votes = 0;
+    }
+    else if (_queued > (_policy.grow_above_queued * _active))
+    {
+      m_shrink_votes = 0;
+      if ((++m_grow_votes >= _policy.evaluations_to_grow)
+          && (_active < _policy.max_handlers))
+      {
+        _decision.to = _active + 1;
+        m_grow_votes = 0;
+      }
+    }
+    else if ((_queued == 0)
+             && (_utilisation < _policy.shrink_below_utilisation))
+    {
+      m_grow_votes = 0;
+      if ((++m_shrink_votes >= _policy.evaluations_to_shrink)
+          && (_active > _policy.min_handlers))
+      {
+        _decision.to   = _active - 1;
+        m_shrink_votes = 0;
+      }
+    }
+    else
+    {
+      m_grow_votes = m_shrink_votes = 0;
+    }
+    return _decision;
+  }
+
+  // Starts the threads of the handlers from 'm_num_active' to \p p_to.
+  // 'm_scaling_mutex' must be locked.
+  void grow(std::size_t p_to)
+  {
+    const std::size_t _from{m_num_active};
+    for (handling_handler_pos _pos = _from; _pos < p_to; ++_pos)
+    {
+      // a thread retired by 'shrink' finishes after its current call
+      if (m_loops[_pos].joinable())
       {
-        TNCT_LOG_TRA(m_logger, trace("locking", _loop_id));
+        m_loops[_pos].join();
+      }
+      m_parkings[_pos]->retired.store(false);
+    }
+    m_num_active = p_to;
+    for (handling_handler_pos _pos = _from; _pos < p_to; ++_pos)
+    {
+      m_loops[_pos] =
+          std::thread([this, _pos]() -> void { handler_loop(_pos); });
+    }
+  }
 
-        std::unique_lock<std::mutex> _lock(m_data_mutex);
-        m_data_cond.wait(
-            _lock,
-            [this, /*_subscriber_id,*/ _loop_id /*,_queue_addr*/]() -> bool
-            {
-              TNCT_LOG_TRA(m_logger, trace("entering condition", _loop_id));
+  // Retires the threads of the handlers from \p p_to to 'm_num_active', which
+  // are joined by 'grow' or 'stop'. 'm_scaling_mutex' must be locked.
+  void shrink(std::size_t p_to)
+  {
+    const std::size_t _from{m_num_active};
+    for (handling_handler_pos _pos = p_to; _pos < _from; ++_pos)
+    {
+      m_parkings[_pos]->retired.store(true);
+    }
+    m_num_active = p_to;
 
-              if (m_stopped)
-              {
-                TNCT_LOG_TRA(m_logger, trace("stopped", _loop_id));
-                return true;
-              }
-              if (!m_queue.empty())
-              {
-                TNCT_LOG_TRA(m_logger, trace("there is data", _loop_id));
-                return true;
-              }
-              TNCT_LOG_TRA(m_logger, trace("waiting", _loop_id));
-              return false;
-            });
+    for (handling_handler_pos _pos = p_to; _pos < _from; ++_pos)
+    {
+      {
+        std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+        auto _ite{
+            std::find(m_idle_handlers.begin(), m_idle_handlers.end(), _pos)};
+        if (_ite == m_idle_handlers.end())
+        {
+          // not parked, so it will see 'retired' before parking again
+          continue;
+        }
+        m_idle_handlers.erase(_ite);
+        --m_num_parked;
       }
+      std::atomic_uint32_t &_signal{m_parkings[_pos]->signal};
+      _signal.store(1);
+      _signal.notify_one();
+    }
+  }
 
-      TNCT_LOG_TRA(m_logger, trace("lock released", _loop_id));
+  // If there is an idle handler and an event in the queue, submits a task to
+  // the pool to call the handler, and returns true
+  bool schedule()
+  {
+    if (m_stopped)
+    {
+      return false;
+    }
 
-      if (m_stopped)
+    handling_handler_pos _handler_pos{0};
+    {
+      std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+      if (m_idle_handlers.empty() || (m_events <= 0))
+      {
+        return false;
+      }
+      _handler_pos = m_idle_handlers.back();
+      m_idle_handlers.pop_back();
+    }
+
+    submit(_handler_pos);
+    return true;
+  }
+
+  void submit(handling_handler_pos p_handler_pos)
+  {
+    {
+      std::lock_guard<std::mutex> _lock(m_pool_tasks_mutex);
+      ++m_pool_tasks;
+    }
+
+    if (!m_pool->submit([this, p_handler_pos]() { drain(p_handler_pos); },
+                        m_priority))
+    {
+      TNCT_LOG_ERR(m_logger, trace("pool is stopped"));
+      release(p_handler_pos);
+      finish_task();
+    }
+  }
+
+  // Pool task that calls the handler at \p p_handler_pos for a limited number
+  // of events, so other handlings get their turn in the pool
+  void drain(handling_handler_pos p_handler_pos)
+  {
+    batch       _batch;
+    std::size_t _handled{0};
+    while (!m_stopped && (_handled < max_events_per_pool_task))
+    {
+      const std::size_t _amount{handle(p_handler_pos, _batch)};
+      if (_amount == 0)
       {
-        TNCT_LOG_TRA(m_logger, trace("stopped due to explicit stop", _loop_id));
         break;
       }
+      _handled += _amount;
+    }
+
+    if (!m_stopped && (_handled >= max_events_per_pool_task)
+        && (m_events > 0))
+    {
+      // keeps the handler, and goes to the end of the pool queue
+      submit(p_handler_pos);
+    }
+    else
+    {
+      release(p_handler_pos);
+      // an event may have been added while the handler was not idle
+      schedule();
+    }
+    finish_task();
+  }
+
+  // Pops up to 'm_batch_size' events, if 'handler' is a batch handler, or one
+  // event otherwise, and calls the handler at \p p_handler_pos with them
+  //
+  // Returns the amount of events handled
+  std::size_t handle(handling_handler_pos p_handler_pos, batch &p_batch)
+  {
+    if constexpr (async::cpt::is_batch_handler<handler, event>)
+    {
+      while (p_batch.events.size() < m_batch_size)
+      {
+        std::int64_t         _pushed_at{0};
+        std::optional<event> _maybe{pop(_pushed_at)};
+        if (!_maybe.has_value())
+        {
+          break;
+        }
+        p_batch.events.push_back(std::move(*_maybe));
+        p_batch.pushed_at.push_back(_pushed_at);
+      }
 
-      TNCT_LOG_TRA(m_logger, trace("getting event from the queue", _loop_id));
+      const std::size_t _amount{p_batch.events.size()};
+      if (_amount == 0)
+      {
+        return 0;
+      }
+      m_events -= static_cast<std::int64_t>(_amount);
+      m_occupied -= _amount;
+      free_space();
 
-      std::optional<event> _maybe{m_queue.pop()};
+      const std::int64_t _start{metrics_recorder::now()};
+      for (const std::int64_t _pushed_at : p_batch.pushed_at)
+      {
+        on_popped(p_handler_pos, _pushed_at, _start);
+      }
+
+      m_handling_handlers[p_handler_pos](std::span<event>{p_batch.events});
+
+      m_metrics.on_handled(p_handler_pos, _amount, _start,
+                           metrics_recorder::now());
+      p_batch.events.clear();
+      p_batch.pushed_at.clear();
+      return _amount;
+    }
+    else
+    {
+      std::int64_t         _pushed_at{0};
+      std::optional<event> _maybe{pop(_pushed_at)};
       if (!_maybe.has_value())
       {
-        TNCT_LOG_TRA(m_logger, trace("no event in queue", _loop_id));
+        return 0;
+      }
+      --m_events;
+      --m_occupied;
+      free_space();
+
+      const std::int64_t _start{metrics_recorder::now()};
+      on_popped(p_handler_pos, _pushed_at, _start);
+
+      if constexpr (async::cpt::is_coroutine_handler<handler, event>)
+      {
+        // the time of the handler is counted until the coroutine finishes, in
+        // the thread that resumed it
+        m_coroutines.start(m_handling_handlers[p_handler_pos],
+                           std::move(*_maybe),
+                           [this, p_handler_pos, _start]()
+                           {
+                             m_metrics.on_called(p_handler_pos, 1, _start,
+                                                 metrics_recorder::now());
+                           });
+      }
+      else
+      {
+        m_handling_handlers[p_handler_pos](std::move(*_maybe));
+
+        m_metrics.on_handled(p_handler_pos, 1, _start,
+                             metrics_recorder::now());
+      }
+      return 1;
+    }
+  }
+
+  // Pushes \p p_event into the queue, if 'm_overflow_policy' allows
+  async::dat::result push(event &&p_event)
+  {
+    return push(std::move(p_event), admit(true));
+  }
+
+  // Pushes \p p_event into the queue, as 'admit' decided in \p p_admission
+  async::dat::result push(event &&p_event, admission p_admission)
+  {
+    m_metrics.on_published();
+
+    switch (p_admission)
+    {
+    case admission::push:
+      break;
+    case admission::drop:
+      TNCT_LOG_TRA(m_logger, trace("event dropped"));
+      m_metrics.on_dropped();
+      return async::dat::result::OK;
+    case admission::reject:
+      TNCT_LOG_TRA(m_logger, trace("event rejected"));
+      m_metrics.on_rejected();
+      return async::dat::result::ERROR_QUEUE_FULL;
+    case admission::stopped:
+      TNCT_LOG_TRA(m_logger, trace("stopped while waiting for space"));
+      return async::dat::result::ERROR_PUBLISHNG;
+    case admission::full:
+      return async::dat::result::ERROR_QUEUE_FULL;
+    }
+
+    if constexpr (async::cpt::is_pmr_event<event>)
+    {
+      if (m_event_pool
+          && (p_event.get_allocator().resource() != m_event_pool.get()))
+      {
+        // moving to a different memory resource copies what 'p_event'
+        // allocated, and what it allocated is freed when it is destroyed
+        return enqueue(std::make_obj_using_allocator<event>(
+            std::pmr::polymorphic_allocator<std::byte>{m_event_pool.get()},
+            std::move(p_event)));
+      }
+    }
+    return enqueue(std::move(p_event));
+  }
+
+  // Pops the next event, and writes to \p p_pushed_at the moment it was
+  // pushed, if 'm_queue' keeps it
+  std::optional<event> pop(std::int64_t &p_pushed_at)
+  {
+    if constexpr (container::cpt::stamped_queue<queue, event>)
+    {
+      return m_queue.pop(p_pushed_at);
+    }
+    else
+    {
+      return m_queue.pop();
+    }
+  }
+
+  // Records the time in the queue of an event pushed at \p p_pushed_at, and
+  // popped at \p p_popped_at, if 'm_queue' keeps the moment it was pushed
+  void on_popped(handling_handler_pos p_handler_pos, std::int64_t p_pushed_at,
+                 std::int64_t p_popped_at)
+  {
+    if constexpr (container::cpt::stamped_queue<queue, event>)
+    {
+      m_metrics.on_popped(p_handler_pos, p_pushed_at, p_popped_at);
+    }
+  }
+
+  // 'm_events', which is never less than 0
+  [[nodiscard]] std::size_t get_queued() const
+  {
+    return static_cast<std::size_t>(
+        std::max(m_events.load(), std::int64_t{0}));
+  }
+
+  // Pushes \p p_event, for which 'admit' reserved space, into the queue
+  async::dat::result enqueue(event &&p_event)
+  {
+    if constexpr (container::cpt::coalescing_queue<queue, event>)
+    {
+      if (replace_or_push(std::move(p_event)))
+      {
+        // the space reserved by 'admit' was not used
+        --m_occupied;
+        m_metrics.on_coalesced();
+        free_space();
+        return async::dat::result::OK;
+      }
+      m_metrics.on_pushing(m_occupied);
+    }
+    else
+    {
+      m_metrics.on_pushing(m_occupied);
+      if constexpr (container::cpt::stamped_queue<queue, event>)
+      {
+        m_queue.push(std::move(p_event), metrics_recorder::now());
+      }
+      else
+      {
+        m_queue.push(std::move(p_event));
+      }
+    }
+    ++m_queued_data;
+    ++m_events;
+    return async::dat::result::OK;
+  }
+
+  // Replaces the event in 'm_queue' with the same key of \p p_event, or pushes
+  // it with the moment it was pushed, if 'm_queue' keeps it
+  bool replace_or_push(event &&p_event)
+  requires container::cpt::coalescing_queue<queue, event>
+  {
+    if constexpr (container::cpt::stamped_queue<queue, event>)
+    {
+      return m_queue.replace_or_push(std::move(p_event),
+                                     metrics_recorder::now());
+    }
+    else
+    {
+      return m_queue.replace_or_push(std::move(p_event));
+    }
+  }
+
+  // Reserves a place in the queue for a new event, applying
+  // 'm_overflow_policy' if there are already 'm_max_capacity' events
+  //
+  // If \p p_wait is false, it does not block waiting for space
+  admission admit(bool p_wait)
+  {
+    const async::dat::overflow_policy _policy{m_overflow_policy};
+    const std::size_t                 _max_capacity{m_max_capacity};
+
+    if ((_max_capacity == 0) || (_policy == async::dat::overflow_policy::grow))
+    {
+      ++m_occupied;
+      return admission::push;
+    }
+
+    while (true)
+    {
+      const std::uint32_t _space_signal{m_space_signal};
+
+      std::size_t _occupied{m_occupied};
+      while (_occupied < _max_capacity)
+      {
+        if (m_occupied.compare_exchange_weak(_occupied, _occupied + 1))
+        {
+          return admission::push;
+        }
+      }
+
+      switch (_policy)
+      {
+      case async::dat::overflow_policy::drop_newest:
+        return admission::drop;
+      case async::dat::overflow_policy::reject:
+        return admission::reject;
+      case async::dat::overflow_policy::drop_oldest:
+        if (pop_to_discard().has_value())
+        {
+          // the new event takes the place of the oldest
+          --m_events;
+          m_metrics.on_dropped();
+          return admission::push;
+        }
+        // a handler took the oldest event
+        std::this_thread::yield();
+        break;
+      default:
+        if (m_stopped)
+        {
+          return admission::stopped;
+        }
+        if (!p_wait)
+        {
+          return admission::full;
+        }
+        m_space_signal.wait(_space_signal);
+        if (m_overflow_policy != _policy)
+        {
+          return admit(p_wait);
+        }
+        break;
+      }
+    }
+  }
+
+  // Pops the event discarded by 'overflow_policy::drop_oldest', which, in a
+  // 'container::cpt::multi_level_queue', is the oldest of the least urgent
+  // level, and not the next one to be handled
+  std::optional<event> pop_to_discard()
+  {
+    if constexpr (container::cpt::multi_level_queue<queue, event>)
+    {
+      return m_queue.pop_least_urgent();
+    }
+    else
+    {
+      return m_queue.pop();
+    }
+  }
+
+  // Wakes up publishers blocked in 'admit', and resumes the ones waiting in
+  // 'resume_on_space'
+  void free_space()
+  {
+    if (m_overflow_policy == async::dat::overflow_policy::block)
+    {
+      ++m_space_signal;
+      m_space_signal.notify_all();
+    }
+
+    if (m_num_space_waiters == 0)
+    {
+      return;
+    }
+
+    std::vector<std::coroutine_handle<>> _waiters;
+    {
+      std::lock_guard<std::mutex> _lock(m_space_waiters_mutex);
+      _waiters.swap(m_space_waiters);
+      m_num_space_waiters -= _waiters.size();
+    }
+    for (std::coroutine_handle<> _waiter : _waiters)
+    {
+      _waiter.resume();
+    }
+  }
+
+  // Calls a handler for an event added
+  void wake_up()
+  {
+    if (m_pool != nullptr)
+    {
+      schedule();
+    }
+    else
+    {
+      unpark_one();
+    }
+  }
+
+  void release(handling_handler_pos p_handler_pos)
+  {
+    std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+    m_idle_handlers.push_back(p_handler_pos);
+  }
+
+  void finish_task()
+  {
+    std::lock_guard<std::mutex> _lock(m_pool_tasks_mutex);
+    if (--m_pool_tasks == 0)
+    {
+      m_pool_tasks_cond.notify_all();
+    }
+  }
+
+  // Calls the handler in \p p_handling_handler_pos in \p m_handling_handlers
+  // while there are events in the queue. When the queue is empty, it spins for
+  // a while, and then parks the thread until \p unpark_one or \p unpark_all
+  // wakes it up. It exits when \p m_stopped is set, or when \p shrink retires
+  // it.
+  void handler_loop(handling_handler_pos p_handling_handler_pos)
+  {
+    auto _loop_id{std::this_thread::get_id()};
+
+    TNCT_LOG_TRA(
+        m_logger,
+        format::bus::fmt("p_handling_handler_pos = ", p_handling_handler_pos,
+                         " ", trace("starting subscriber's loop", _loop_id)));
+
+    if (async::bus::pin_current_thread(m_affinity.of(p_handling_handler_pos))
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_WAR(m_logger, format::bus::fmt("could not pin handler ",
+                                              p_handling_handler_pos,
+                                              " with affinity ", m_affinity));
+    }
+
+    batch _batch;
+
+    const std::atomic_bool &_retired{
+        m_parkings[p_handling_handler_pos]->retired};
+
+    while (!m_stopped && !_retired)
+    {
+      if (handle(p_handling_handler_pos, _batch) > 0)
+      {
+        TNCT_LOG_TRA(m_logger, trace("event handled", _loop_id));
         continue;
       }
-      event _event{std::move(*_maybe)};
 
-      TNCT_LOG_TRA(
-          m_logger,
-          format::bus::fmt("p_handling_handler_pos = ", p_handling_handler_pos,
-                           ", handler address = ",
-                           &m_handling_handlers[p_handling_handler_pos], " ",
-                           trace("about to call subscriber", _loop_id)));
+      if (spin())
+      {
+        continue;
+      }
 
-      m_handling_handlers[p_handling_handler_pos](std::move(_event));
+      TNCT_LOG_TRA(m_logger, trace("parking", _loop_id));
+      park(p_handling_handler_pos);
+      TNCT_LOG_TRA(m_logger, trace("unparked", _loop_id));
+    }
 
-      TNCT_LOG_TRA(m_logger, trace("event handled", _loop_id));
+    // a wake up meant for this thread is passed to another one
+    if (_retired && !m_stopped && (m_events > 0))
+    {
+      unpark_one();
     }
 
     TNCT_LOG_TRA(m_logger, trace("leaving subscriber's loop", _loop_id));
   }
 
+  // Returns true if an event was added, or the handling was stopped, while
+  // spinning
+  bool spin() const
+  {
+    for (std::size_t _i = 0; _i < spins_before_parking; ++_i)
+    {
+      if (m_stopped || (m_events > 0))
+      {
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    return false;
+  }
+
+  // Makes the thread of the handler at \p p_handler_pos sleep until it is
+  // chosen by \p unpark_one
+  void park(handling_handler_pos p_handler_pos)
+  {
+    std::atomic_uint32_t &_signal{m_parkings[p_handler_pos]->signal};
+    _signal.store(0);
+
+    {
+      std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+      m_idle_handlers.push_back(p_handler_pos);
+      ++m_num_parked;
+    }
+
+    // an event added, a stop, or a retirement, before the handler was in
+    // 'm_idle_handlers' would not unpark it
+    if (m_stopped || (m_events > 0) || m_parkings[p_handler_pos]->retired)
+    {
+      std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+
+      auto _ite{std::find(m_idle_handlers.begin(), m_idle_handlers.end(),
+                          p_handler_pos)};
+      if (_ite != m_idle_handlers.end())
+      {
+        m_idle_handlers.erase(_ite);
+        --m_num_parked;
+        return;
+      }
+      // it was already chosen by 'unpark_one'
+    }
+
+    _signal.wait(0);
+  }
+
+  // Wakes up exactly one parked handler thread, if there is one
+  bool unpark_one()
+  {
+    if (m_num_parked == 0)
+    {
+      return false;
+    }
+
+    handling_handler_pos _handler_pos{0};
+    {
+      std::lock_guard<std::mutex> _lock(m_idle_handlers_mutex);
+      if (m_idle_handlers.empty())
+      {
+        return false;
+      }
+      _handler_pos = m_idle_handlers.back();
+      m_idle_handlers.pop_back();
+      --m_num_parked;
+    }
+
+    std::atomic_uint32_t &_signal{m_parkings[_handler_pos]->signal};
+    _signal.store(1);
+    _signal.notify_one();
+    return true;
+  }
+
+  void unpark_all()
+  {
+    while (unpark_one())
+    {
+    }
+  }
+
   void empty_queue(const std::thread::id &p_loop_id, handler p_subscriber)
   {
     TNCT_LOG_TRA(m_logger, trace("entering empty_queue", p_loop_id));
@@ -426,6 +1466,9 @@ private:
 
   handler m_handler;
 
+  // Declared before 'm_queue', so it is destroyed after the events in it
+  std::unique_ptr<std::pmr::memory_resource> m_event_pool;
+
   queue m_queue;
 
   // size_t m_handler_id{0};
@@ -446,11 +1489,95 @@ private:
   // Controls access to the \p m_loops while inserting a new handler
   // std::mutex m_add_subscriber_mutex;
 
-  // Controls access to inserting data
-  std::mutex m_data_mutex;
+  // Where each thread in 'm_loops' sleeps when there are no events
+  std::vector<std::unique_ptr<parking>> m_parkings;
+
+  // Amount of threads in 'm_loops' sleeping
+  std::atomic_size_t m_num_parked{0};
+
+  // Pool where the handlers are called, if not in the threads of 'm_loops'
+  pool *m_pool{nullptr};
+
+  async::dat::handling_priority m_priority;
+
+  // Positions in 'm_handling_handlers' not being called by a pool task, or
+  // whose thread in 'm_loops' is parked
+  std::vector<handling_handler_pos> m_idle_handlers;
+
+  std::mutex m_idle_handlers_mutex;
+
+  // Amount of events in the queue, counted after they are pushed, and after
+  // they are popped, so it may be briefly negative, when a handler pops an
+  // event before its publisher counts it, and it is read with 'get_queued'
+  std::atomic<std::int64_t> m_events{0};
+
+  // Amount of pool tasks submitted, and not finished
+  std::size_t m_pool_tasks{0};
+
+  std::mutex m_pool_tasks_mutex;
+
+  std::condition_variable m_pool_tasks_cond;
+
+  // Maximum amount of events passed at once to a batch handler
+  std::size_t m_batch_size{1};
+
+  static constexpr std::size_t max_events_per_pool_task{64};
+
+  // What happens when an event is added, and there are 'm_max_capacity' events
+  std::atomic<async::dat::overflow_policy> m_overflow_policy{
+      async::dat::overflow_policy::grow};
+
+  // 0 means no limit
+  std::atomic_size_t m_max_capacity{0};
+
+  // Amount of events in the queue, counted before they are pushed, so it is
+  // never greater than 'm_max_capacity', if there is a limit
+  std::atomic_size_t m_occupied{0};
+
+  // Changed, and notified, when an event is taken from the queue, so blocked
+  // publishers check for space
+  std::atomic_uint32_t m_space_signal{0};
+
+  // Coroutines of publishers waiting for space, with the block policy
+  std::vector<std::coroutine_handle<>> m_space_waiters;
+
+  std::atomic_size_t m_num_space_waiters{0};
+
+  std::mutex m_space_waiters_mutex;
+
+  metrics_recorder m_metrics;
+
+  // Coroutines of a coroutine handler that did not finish
+  coroutine_runner<t_logger> m_coroutines;
+
+  // CPUs where each thread in 'm_loops' runs
+  async::dat::affinity m_affinity;
+
+  // Policy that changes the amount of threads in 'm_loops', if there is one
+  std::optional<async::dat::autoscaling> m_autoscaling;
+
+  // Calls 'autoscale' at each 'async::dat::autoscaling::interval'
+  async::bus::timer_wheel::timer_ptr m_autoscaling_timer;
+
+  // Serializes 'autoscale' and the joining of the threads in 'stop'
+  std::mutex m_scaling_mutex;
+
+  // Amount of handlers whose thread is running, or that can be called by a
+  // pool task
+  std::atomic_size_t m_num_active{0};
+
+  std::size_t m_grow_votes{0};
+
+  std::size_t m_shrink_votes{0};
+
+  // When 'evaluate' was last called, as returned by 'metrics_recorder::now'
+  std::int64_t m_last_evaluation{0};
+
+  // 'metrics_recorder::get_busy' when 'evaluate' was last called
+  std::uint64_t m_last_busy{0};
 
-  // Controls access to the data produced
-  std::condition_variable m_data_cond;
+  // Times a handler checks for events, yielding the thread, before parking
+  static constexpr std::size_t spins_before_parking{64};
 };
 
 } // namespace tnct::async::internal::bus
@@ -0,0 +1,288 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_INLINE_HANDLING_H
+#define TNCT_ASYNC_INTERNAL_BUS_INLINE_HANDLING_H
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "tnct/async/cpt/is_any_handler.h"
+#include "tnct/async/cpt/is_batch_handler.h"
+#include "tnct/async/cpt/is_coroutine_handler.h"
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/handling_name.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/coroutine_runner.h"
+#include "tnct/async/internal/bus/handling.h"
+#include "tnct/async/internal/bus/metrics_recorder.h"
+#include "tnct/async/internal/dat/handler_id.h"
+#include "tnct/async/internal/dat/handling_id.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Handling that calls its handler in the thread that adds the event,
+/// with no queue and no thread of its own
+///
+/// When events are published by many threads at the same time, the handler is
+/// called by all of them at the same time, so it must be thread safe
+///
+/// If \p t_handler is a \p async::cpt::is_batch_handler, \p add_event calls it
+/// with one event, and \p add_events with up to \p p_batch_size events at each
+/// call
+///
+/// An exception raised by the handler is logged, and \p add_event returns
+/// \p async::dat::result::ERROR_HANDLING, so it does not reach the publisher
+///
+/// If \p t_handler is a \p async::cpt::is_coroutine_handler, \p add_event
+/// returns when the coroutine suspends, and the handling is destroyed only
+/// after all the coroutines finish
+template <log::cpt::logger t_logger, async::cpt::is_event t_event,
+          async::cpt::is_any_handler<t_event> t_handler>
+class inline_handling final : public handling<t_event>
+{
+public:
+  using logger  = t_logger;
+  using event   = t_event;
+  using handler = t_handler;
+
+  inline_handling(const async::dat::handling_name &p_handling_name,
+                  t_logger &p_logger, handler &&p_handler,
+                  std::size_t p_batch_size = 1)
+      : m_logger(p_logger), m_handling_name(p_handling_name),
+        m_handling_id(internal::dat::get_handling_id(m_handling_name)),
+        m_handler(std::move(p_handler)),
+        m_batch_size(p_batch_size == 0 ? 1 : p_batch_size),
+        m_coroutines(p_logger)
+  {
+    TNCT_LOG_TRA(m_logger,
+                 format::bus::fmt("m_handling_id = ", m_handling_id,
+                                  ", m_handling_name = ", m_handling_name));
+    m_metrics.add_handlers(1);
+  }
+
+  inline_handling(const inline_handling &)            = delete;
+  inline_handling(inline_handling &&)                 = delete;
+  inline_handling &operator=(const inline_handling &) = delete;
+  inline_handling &operator=(inline_handling &&)      = delete;
+
+  ~inline_handling() override = default;
+
+  async::dat::result add_event(event &&p_event) override
+  {
+    m_metrics.on_published();
+    if (m_stopped)
+    {
+      TNCT_LOG_TRA(m_logger, format::bus::fmt("handling '", m_handling_name,
+                                              "' is stopped"));
+      return async::dat::result::OK;
+    }
+
+    const std::int64_t _start{metrics_recorder::now()};
+    if constexpr (async::cpt::is_coroutine_handler<handler, event>)
+    {
+      m_coroutines.start(m_handler, std::move(p_event),
+                         [this, _start]()
+                         {
+                           m_metrics.on_called(0, 1, _start,
+                                               metrics_recorder::now());
+                         });
+      return async::dat::result::OK;
+    }
+    else if constexpr (async::cpt::is_batch_handler<handler, event>)
+    {
+      const async::dat::result _result{
+          call(std::span<event>{&p_event, 1})};
+      m_metrics.on_called(0, 1, _start, metrics_recorder::now());
+      return _result;
+    }
+    else
+    {
+      const async::dat::result _result{call(std::move(p_event))};
+      m_metrics.on_called(0, 1, _start, metrics_recorder::now());
+      return _result;
+    }
+  }
+
+  async::dat::result add_events(std::span<const event> p_events) override
+  {
+    if constexpr (std::copy_constructible<event>)
+    {
+      if constexpr (async::cpt::is_batch_handler<handler, event>)
+      {
+        for (std::size_t _i = 0; _i < p_events.size(); ++_i)
+        {
+          m_metrics.on_published();
+        }
+        if (m_stopped)
+        {
+          return async::dat::result::OK;
+        }
+
+        async::dat::result _result{async::dat::result::OK};
+        std::vector<event> _batch;
+        _batch.reserve(std::min(m_batch_size, p_events.size()));
+        for (std::size_t _first = 0; _first < p_events.size();
+             _first += m_batch_size)
+        {
+          const std::span<const event> _events{p_events.subspan(
+              _first, std::min(m_batch_size, p_events.size() - _first))};
+          _batch.assign(_events.begin(), _events.end());
+
+          const std::int64_t       _start{metrics_recorder::now()};
+          const async::dat::result _called{call(std::span<event>{_batch})};
+          m_metrics.on_called(0, _batch.size(), _start,
+                              metrics_recorder::now());
+          if (_result == async::dat::result::OK)
+          {
+            _result = _called;
+          }
+        }
+        return _result;
+      }
+      else
+      {
+        async::dat::result _result{async::dat::result::OK};
+        for (const event &_event : p_events)
+        {
+          const async::dat::result _added{add_event(event{_event})};
+          if (_result == async::dat::result::OK)
+          {
+            _result = _added;
+          }
+        }
+        return _result;
+      }
+    }
+    else
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("events of handling '", m_handling_name,
+                                    "' can not be copied"));
+      return async::dat::result::ERROR_PUBLISHNG;
+    }
+  }
+
+  /// \brief There is no queue, so there is no overflow
+  void set_overflow_policy(async::dat::overflow_policy p_policy,
+                           std::size_t                 p_max_capacity) override
+  {
+    TNCT_LOG_WAR(m_logger,
+                 format::bus::fmt("handling '", m_handling_name,
+                                  "' has no queue, so overflow policy ",
+                                  p_policy, " with max capacity ",
+                                  p_max_capacity, " is ignored"));
+  }
+
+  void stop() override
+  {
+    m_stopped = true;
+  }
+
+  constexpr bool is_stopped() const override
+  {
+    return m_stopped;
+  }
+
+  [[nodiscard]] constexpr size_t get_amount_handlers() const override
+  {
+    return 1;
+  }
+
+  [[nodiscard]] dat::handling_id get_id() const override
+  {
+    return m_handling_id;
+  }
+
+  [[nodiscard]] async::dat::handling_name get_name() const override
+  {
+    return m_handling_name;
+  }
+
+  [[nodiscard]] constexpr size_t get_num_events() const override
+  {
+    return 0;
+  }
+
+  [[nodiscard]] constexpr size_t get_events_capacity() const override
+  {
+    return 0;
+  }
+
+  [[nodiscard]] internal::dat::handler_id get_handler_id() const override
+  {
+    return internal::dat::get_handler_id<t_event, t_handler>();
+  }
+
+  [[nodiscard]] async::dat::handling_metrics get_metrics() const override
+  {
+    async::dat::handling_metrics _metrics{m_metrics.get(0)};
+    _metrics.name = m_handling_name;
+    return _metrics;
+  }
+
+  void clear() override
+  {
+  }
+
+private:
+  // Calls the handler, so an exception it raises does not reach the
+  // publisher, and the other handlings still receive the event
+  template <typename t_argument>
+  async::dat::result call(t_argument &&p_argument)
+  {
+    try
+    {
+      m_handler(std::forward<t_argument>(p_argument));
+      return async::dat::result::OK;
+    }
+    catch (std::exception &_ex)
+    {
+      TNCT_LOG_ERR(m_logger, format::bus::fmt("handler of '", m_handling_name,
+                                              "' raised '", _ex.what(), '\''));
+    }
+    catch (...)
+    {
+      TNCT_LOG_ERR(m_logger, format::bus::fmt("handler of '", m_handling_name,
+                                              "' raised an unknown exception"));
+    }
+    return async::dat::result::ERROR_HANDLING;
+  }
+
+private:
+  logger &m_logger;
+
+  async::dat::handling_name m_handling_name;
+
+  dat::handling_id m_handling_id;
+
+  handler m_handler;
+
+  // Maximum amount of events passed at once to a batch handler
+  std::size_t m_batch_size{1};
+
+  std::atomic_bool m_stopped{false};
+
+  metrics_recorder m_metrics;
+
+  // Coroutines of a coroutine handler that did not finish
+  coroutine_runner<t_logger> m_coroutines;
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
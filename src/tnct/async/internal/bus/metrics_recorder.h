@@ -0,0 +1,265 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_METRICS_RECORDER_H
+#define TNCT_ASYNC_INTERNAL_BUS_METRICS_RECORDER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/histogram.h"
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Records the metrics of a handling, without locks
+///
+/// The counters of the publishers are spread over shards, each in its own
+/// cache line, and a publisher thread always uses the same shard. Each
+/// handler has its own shard, written only by the thread calling it.
+///
+/// The moment an event is pushed, as returned by \p now, is carried with the
+/// event in the queue, if it is a \p container::cpt::stamped_queue, and passed
+/// to \p on_popped by the handler that pops it, so the time in the queue is
+/// recorded for each event, in whatever order the queue pops them.
+class metrics_recorder
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+  metrics_recorder() = default;
+
+  metrics_recorder(const metrics_recorder &)            = delete;
+  metrics_recorder(metrics_recorder &&)                 = delete;
+  metrics_recorder &operator=(const metrics_recorder &) = delete;
+  metrics_recorder &operator=(metrics_recorder &&)      = delete;
+
+  /// \brief Adds the shards of \p p_amount handlers, which must be done
+  /// before any of them is called
+  void add_handlers(std::size_t p_amount)
+  {
+    for (std::size_t _i = 0; _i < p_amount; ++_i)
+    {
+      m_handlers.push_back(std::make_unique<handler_shard>());
+    }
+  }
+
+  void on_published()
+  {
+    publisher().published.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_dropped()
+  {
+    publisher().dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_rejected()
+  {
+    publisher().rejected.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void on_coalesced()
+  {
+    publisher().coalesced.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief Called just before an event is pushed into the queue, which will
+  /// hold \p p_occupied events
+  void on_pushing(std::size_t p_occupied)
+  {
+    std::atomic_size_t &_high_water_mark{publisher().high_water_mark};
+    std::size_t         _current{
+        _high_water_mark.load(std::memory_order_relaxed)};
+    while ((p_occupied > _current)
+           && !_high_water_mark.compare_exchange_weak(
+               _current, p_occupied, std::memory_order_relaxed))
+    {
+    }
+  }
+
+  /// \brief Called when the handler at \p p_handler_pos popped an event
+  /// pushed at \p p_pushed_at, at \p p_popped_at, both as returned by \p now
+  void on_popped(std::size_t p_handler_pos, std::int64_t p_pushed_at,
+                 std::int64_t p_popped_at)
+  {
+    m_handlers[p_handler_pos]->enqueue_to_dequeue.record(p_popped_at
+                                                         - p_pushed_at);
+  }
+
+  /// \brief Called when the handler at \p p_handler_pos handled \p p_amount
+  /// events in a call that started at \p p_start, and finished at \p p_end
+  void on_handled(std::size_t p_handler_pos, std::size_t p_amount,
+                  std::int64_t p_start, std::int64_t p_end)
+  {
+    handler_shard &_shard{*m_handlers[p_handler_pos]};
+    add(_shard.handled, p_amount);
+    add(_shard.busy, static_cast<std::uint64_t>(p_end - p_start));
+    _shard.handler_time.record(p_end - p_start);
+  }
+
+  /// \brief Like \p on_handled, but for a handler that can be called by many
+  /// threads at the same time, with no queue, so there is no enqueue to
+  /// dequeue time
+  void on_called(std::size_t p_handler_pos, std::size_t p_amount,
+                 std::int64_t p_start, std::int64_t p_end)
+  {
+    handler_shard &_shard{*m_handlers[p_handler_pos]};
+    _shard.handled.fetch_add(p_amount, std::memory_order_relaxed);
+    _shard.busy.fetch_add(static_cast<std::uint64_t>(p_end - p_start),
+                          std::memory_order_relaxed);
+    _shard.handler_time.record_shared(p_end - p_start);
+  }
+
+  /// \return Nanoseconds all the handlers spent handling events
+  [[nodiscard]] std::uint64_t get_busy() const
+  {
+    std::uint64_t _busy{0};
+    for (const std::unique_ptr<handler_shard> &_shard : m_handlers)
+    {
+      _busy += _shard->busy.load(std::memory_order_relaxed);
+    }
+    return _busy;
+  }
+
+  [[nodiscard]] async::dat::handling_metrics get(std::size_t p_queued) const
+  {
+    async::dat::handling_metrics _metrics;
+
+    for (const publisher_shard &_shard : m_publishers)
+    {
+      _metrics.published += _shard.published.load(std::memory_order_relaxed);
+      _metrics.dropped += _shard.dropped.load(std::memory_order_relaxed);
+      _metrics.rejected += _shard.rejected.load(std::memory_order_relaxed);
+      _metrics.coalesced += _shard.coalesced.load(std::memory_order_relaxed);
+      _metrics.high_water_mark = std::max(
+          _metrics.high_water_mark,
+          _shard.high_water_mark.load(std::memory_order_relaxed));
+    }
+
+    _metrics.queued = p_queued;
+
+    const std::int64_t _now{now()};
+    for (const std::unique_ptr<handler_shard> &_shard : m_handlers)
+    {
+      async::dat::handler_metrics _handler;
+      _handler.handled = _shard->handled.load(std::memory_order_relaxed);
+      _handler.busy    = std::chrono::nanoseconds{
+          _shard->busy.load(std::memory_order_relaxed)};
+      _handler.idle = std::max(
+          std::chrono::nanoseconds{0},
+          std::chrono::nanoseconds{_now - _shard->created} - _handler.busy);
+
+      _metrics.handled += _handler.handled;
+      _shard->enqueue_to_dequeue.add_to(_metrics.enqueue_to_dequeue);
+      _shard->handler_time.add_to(_metrics.handler_time);
+      _metrics.handlers.push_back(_handler);
+    }
+    return _metrics;
+  }
+
+  /// \return Nanoseconds since the epoch of \p clock
+  static std::int64_t now()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               clock::now().time_since_epoch())
+        .count();
+  }
+
+private:
+  static constexpr std::size_t cache_line_size{64};
+
+  static constexpr std::size_t num_publisher_shards{16};
+
+  // Histogram written by only one thread, and read by any thread
+  struct shard_histogram
+  {
+    void record(std::int64_t p_nanosecs)
+    {
+      add(buckets[async::dat::histogram::bucket(
+              static_cast<std::uint64_t>(
+                  std::max(p_nanosecs, std::int64_t{0})))],
+          1);
+    }
+
+    // When more than one thread records
+    void record_shared(std::int64_t p_nanosecs)
+    {
+      buckets[async::dat::histogram::bucket(
+                  static_cast<std::uint64_t>(
+                      std::max(p_nanosecs, std::int64_t{0})))]
+          .fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void add_to(async::dat::histogram &p_histogram) const
+    {
+      for (std::size_t _bucket = 0;
+           _bucket < async::dat::histogram::num_buckets; ++_bucket)
+      {
+        if (const std::uint64_t _count{
+                buckets[_bucket].load(std::memory_order_relaxed)};
+            _count != 0)
+        {
+          p_histogram.add(_bucket, _count);
+        }
+      }
+    }
+
+    std::array<std::atomic_uint64_t, async::dat::histogram::num_buckets>
+        buckets{};
+  };
+
+  struct alignas(cache_line_size) publisher_shard
+  {
+    std::atomic_uint64_t published{0};
+    std::atomic_uint64_t dropped{0};
+    std::atomic_uint64_t rejected{0};
+    std::atomic_uint64_t coalesced{0};
+    std::atomic_size_t   high_water_mark{0};
+  };
+
+  struct alignas(cache_line_size) handler_shard
+  {
+    std::atomic_uint64_t handled{0};
+    std::atomic_uint64_t busy{0};
+    const std::int64_t   created{now()};
+    shard_histogram      enqueue_to_dequeue;
+    shard_histogram      handler_time;
+  };
+
+private:
+  // Only one thread writes to 'p_counter', so there is no need for a
+  // read-modify-write operation
+  static void add(std::atomic_uint64_t &p_counter, std::uint64_t p_value)
+  {
+    p_counter.store(p_counter.load(std::memory_order_relaxed) + p_value,
+                    std::memory_order_relaxed);
+  }
+
+  publisher_shard &publisher()
+  {
+    static std::atomic_size_t             _next_shard{0};
+    static thread_local const std::size_t _shard{
+        _next_shard.fetch_add(1, std::memory_order_relaxed)
+        % num_publisher_shards};
+    return m_publishers[_shard];
+  }
+
+private:
+  std::array<publisher_shard, num_publisher_shards> m_publishers;
+
+  std::vector<std::unique_ptr<handler_shard>> m_handlers;
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
@@ -0,0 +1,239 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_PIPELINE_STAGE_H
+#define TNCT_ASYNC_INTERNAL_BUS_PIPELINE_STAGE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/dat/stage_config.h"
+#include "tnct/async/dat/stage_metrics.h"
+#include "tnct/async/internal/bus/handling.h"
+#include "tnct/async/internal/bus/metrics_recorder.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/log/cpt/logger.h"
+
+namespace tnct::async::internal::bus
+{
+
+// Type of the values a stage function passes to the next stage: the type it
+// returns, or 'X', if it returns 'std::optional<X>', where 'std::nullopt'
+// means the value is dropped
+template <typename t_result> struct stage_output
+{
+  using type = t_result;
+};
+
+template <typename t_result> struct stage_output<std::optional<t_result>>
+{
+  using type = t_result;
+};
+
+template <typename t_function, typename t_in>
+using stage_output_t = typename stage_output<
+    std::remove_cvref_t<std::invoke_result_t<t_function &, t_in &&>>>::type;
+
+// Where a stage passes the values it produces, and nothing for the sink
+template <typename t_value> struct downstream_of
+{
+  using type = std::function<async::dat::result(t_value &&)>;
+};
+
+template <> struct downstream_of<void>
+{
+  using type = std::nullptr_t;
+};
+
+template <typename t_value>
+using downstream = typename downstream_of<t_value>::type;
+
+// Part of a 'bus::pipeline' that can be stopped, and that reports its metrics
+class pipeline_stage
+{
+public:
+  virtual ~pipeline_stage() = default;
+
+  virtual void stop() = 0;
+
+  [[nodiscard]] virtual async::dat::stage_metrics get_metrics() const = 0;
+};
+
+// Calls 't_function' with the values of type 't_in' it receives, and passes
+// what it returns to the next stage, directly, if it is fused, or through a
+// 'handling_concrete' with a bounded queue, if it is not
+template <log::cpt::logger t_logger, async::cpt::is_event t_in,
+          typename t_function>
+class pipeline_stage_concrete final : public pipeline_stage
+{
+public:
+  using input  = t_in;
+  using result = std::invoke_result_t<t_function &, t_in &&>;
+  using output = stage_output_t<t_function, t_in>;
+
+  // 'p_next' is not used if 't_function' returns 'void', which means the
+  // stage is the sink
+  pipeline_stage_concrete(t_logger &p_logger, std::string p_name,
+                          t_function                       p_function,
+                          const async::dat::stage_config &p_config,
+                          std::size_t                      p_threads,
+                          downstream<output>               p_next)
+      : m_name(std::move(p_name)), m_function(std::move(p_function)),
+        m_fused(p_config.fuse),
+        m_threads(p_config.fuse ? p_threads : p_config.handlers),
+        m_next(std::move(p_next))
+  {
+    if (m_fused)
+    {
+      return;
+    }
+
+    const std::size_t    _capacity{p_config.capacity == 0 ? 1
+                                                          : p_config.capacity};
+    std::optional<queue> _queue{queue::create(p_logger, _capacity)};
+    if (!_queue)
+    {
+      throw std::runtime_error("error creating the queue of stage " + m_name);
+    }
+
+    // 'm_name' lives as long as the handling, which refers to it
+    m_handling = std::make_unique<handling>(
+        m_name, p_logger, handler{this}, std::move(*_queue),
+        p_config.handlers == 0 ? 1 : p_config.handlers);
+    m_handling->set_overflow_policy(async::dat::overflow_policy::block,
+                                    _capacity);
+  }
+
+  pipeline_stage_concrete(const pipeline_stage_concrete &)            = delete;
+  pipeline_stage_concrete(pipeline_stage_concrete &&)                 = delete;
+  pipeline_stage_concrete &operator=(const pipeline_stage_concrete &) = delete;
+  pipeline_stage_concrete &operator=(pipeline_stage_concrete &&)      = delete;
+
+  ~pipeline_stage_concrete() override
+  {
+    stop();
+  }
+
+  // Calls the function now, if the stage is fused, or adds \p p_value to the
+  // queue, waiting for space if it is full
+  async::dat::result add(t_in &&p_value)
+  {
+    if (m_fused)
+    {
+      return process(std::move(p_value));
+    }
+    return m_handling->add_event(std::move(p_value));
+  }
+
+  void stop() override
+  {
+    if (m_handling)
+    {
+      m_handling->stop();
+    }
+  }
+
+  [[nodiscard]] async::dat::stage_metrics get_metrics() const override
+  {
+    async::dat::stage_metrics _metrics;
+    _metrics.name    = m_name;
+    _metrics.fused   = m_fused;
+    _metrics.threads = m_threads;
+    _metrics.handled = m_handled.load(std::memory_order_relaxed);
+    _metrics.busy =
+        std::chrono::nanoseconds{m_busy.load(std::memory_order_relaxed)};
+    _metrics.elapsed =
+        std::chrono::nanoseconds{metrics_recorder::now() - m_created};
+    _metrics.queued = (m_handling ? m_handling->get_num_events() : 0);
+    return _metrics;
+  }
+
+private:
+  // Called by the threads of 'm_handling'
+  struct handler
+  {
+    void operator()(t_in &&p_value)
+    {
+      stage->process(std::move(p_value));
+    }
+
+    pipeline_stage_concrete *stage;
+  };
+
+  using queue    = container::dat::circular_queue<t_logger, t_in>;
+  using handling = handling_concrete<t_logger, t_in, queue, handler>;
+
+private:
+  async::dat::result process(t_in &&p_value)
+  {
+    const std::int64_t _start{metrics_recorder::now()};
+
+    if constexpr (std::is_void_v<result>)
+    {
+      m_function(std::move(p_value));
+      count(_start);
+      return async::dat::result::OK;
+    }
+    else
+    {
+      result _result{m_function(std::move(p_value))};
+      count(_start);
+
+      if constexpr (std::is_same_v<std::remove_cvref_t<result>, output>)
+      {
+        return m_next(std::move(_result));
+      }
+      else
+      {
+        return _result ? m_next(std::move(*_result))
+                       : async::dat::result::OK;
+      }
+    }
+  }
+
+  void count(std::int64_t p_start)
+  {
+    m_busy.fetch_add(
+        static_cast<std::uint64_t>(metrics_recorder::now() - p_start),
+        std::memory_order_relaxed);
+    m_handled.fetch_add(1, std::memory_order_relaxed);
+  }
+
+private:
+  std::string m_name;
+
+  t_function m_function;
+
+  bool m_fused;
+
+  std::size_t m_threads;
+
+  downstream<output> m_next;
+
+  std::unique_ptr<handling> m_handling;
+
+  std::atomic_uint64_t m_handled{0};
+
+  // Nanoseconds spent inside 'm_function'
+  std::atomic_uint64_t m_busy{0};
+
+  const std::int64_t m_created{metrics_recorder::now()};
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
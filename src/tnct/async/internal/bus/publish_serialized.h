@@ -0,0 +1,60 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_PUBLISH_SERIALIZED_H
+#define TNCT_ASYNC_INTERNAL_BUS_PUBLISH_SERIALIZED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "tnct/async/dat/result.h"
+
+namespace tnct::async::internal::bus
+{
+
+// Deserializes 'p_bytes' as the type at 'p_index' in 't_events', with
+// 'p_serializer', and publishes it to 'p_dispatcher'
+//
+// Returns what 'publish' returned, or 'std::nullopt' if 'p_index' is not a
+// type in 't_events', or if 'p_bytes' is not an event of that type
+template <typename t_events, typename t_serializer, typename t_dispatcher>
+std::optional<async::dat::result>
+publish_serialized(t_serializer &p_serializer, t_dispatcher &p_dispatcher,
+                   std::uint32_t p_index, std::span<const std::byte> p_bytes)
+{
+  std::optional<async::dat::result> _result;
+
+  auto _publish{
+      [&]<std::size_t... t_idx>(std::index_sequence<t_idx...>)
+      {
+        static_cast<void>((
+            ((p_index == t_idx)
+             && ([&]()
+                 {
+                   using event = std::tuple_element_t<t_idx, t_events>;
+
+                   std::optional<event> _event{p_serializer.deserialize(
+                       p_bytes, std::type_identity<event>{})};
+                   if (_event)
+                   {
+                     _result = p_dispatcher.publish(std::move(*_event));
+                   }
+                   return true;
+                 }()))
+            || ...));
+      }};
+
+  _publish(std::make_index_sequence<std::tuple_size_v<t_events>>{});
+  return _result;
+}
+
+} // namespace tnct::async::internal::bus
+
+#endif
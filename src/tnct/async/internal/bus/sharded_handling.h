@@ -0,0 +1,294 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_SHARDED_HANDLING_H
+#define TNCT_ASYNC_INTERNAL_BUS_SHARDED_HANDLING_H
+
+#include <algorithm>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/cpt/is_any_handler.h"
+#include "tnct/async/cpt/is_event.h"
+#include "tnct/async/cpt/is_key_extractor.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/handling_name.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/internal/bus/handling.h"
+#include "tnct/async/internal/dat/handler_id.h"
+#include "tnct/async/internal/dat/handling_id.h"
+#include "tnct/container/cpt/queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+
+namespace tnct::async::internal::bus
+{
+
+/// \brief Handling whose events are spread over shards, each with its own
+/// queue and a single handler, by the key \p t_key_extractor returns
+///
+/// Events with the same key always go to the same shard, so they are handled in
+/// the order they were added, while events with different keys can be handled
+/// at the same time by the handlers of the other shards
+///
+/// Each shard is a \p handling_concrete with a copy of \p t_queue and of
+/// \p t_handler, which runs in its own thread, or in tasks of the
+/// \p async::bus::work_stealing_pool, if one is informed
+template <log::cpt::logger t_logger, async::cpt::is_event t_event,
+          container::cpt::queue<t_event>          t_queue,
+          async::cpt::is_any_handler<t_event>     t_handler,
+          async::cpt::is_key_extractor<t_event> t_key_extractor>
+requires(std::copy_constructible<t_queue>
+         && std::copy_constructible<t_handler>)
+class sharded_handling final : public handling<t_event>
+{
+public:
+  using logger        = t_logger;
+  using event         = t_event;
+  using queue         = t_queue;
+  using handler       = t_handler;
+  using key_extractor = t_key_extractor;
+  using pool          = async::bus::work_stealing_pool<t_logger>;
+
+  /// \param p_num_shards is the amount of shards, and so of handlers, which is
+  /// at least 1
+  sharded_handling(const async::dat::handling_name &p_handling_name,
+                   t_logger &p_logger, handler &&p_handler, queue &&p_queue,
+                   key_extractor &&p_key_extractor, std::size_t p_num_shards,
+                   pool                         *p_pool = nullptr,
+                   async::dat::handling_priority p_priority =
+                       async::dat::handling_priority::medium,
+                   std::size_t p_batch_size = 1)
+      : m_logger(p_logger), m_handling_name(p_handling_name),
+        m_handling_id(internal::dat::get_handling_id(m_handling_name)),
+        m_key_extractor(std::move(p_key_extractor))
+  {
+    const std::size_t _num_shards{std::max(p_num_shards, std::size_t{1})};
+
+    TNCT_LOG_TRA(m_logger,
+                 format::bus::fmt("m_handling_name = ", m_handling_name,
+                                  ", num shards = ", _num_shards));
+
+    m_shards.reserve(_num_shards);
+    for (std::size_t _i = 0; _i < _num_shards; ++_i)
+    {
+      m_shards.push_back(std::make_unique<shard>(
+          m_handling_name, m_logger, handler{p_handler}, queue{p_queue}, 1,
+          p_pool, p_priority, p_batch_size));
+    }
+  }
+
+  sharded_handling(const sharded_handling &)            = delete;
+  sharded_handling(sharded_handling &&)                 = delete;
+  sharded_handling &operator=(const sharded_handling &) = delete;
+  sharded_handling &operator=(sharded_handling &&)      = delete;
+
+  ~sharded_handling() override
+  {
+    stop();
+  }
+
+  async::dat::result add_event(event &&p_event) override
+  {
+    return get_shard(p_event).add_event(std::move(p_event));
+  }
+
+  std::optional<async::dat::result> try_add_event(event &&p_event) override
+  {
+    return get_shard(p_event).try_add_event(std::move(p_event));
+  }
+
+  /// \brief Waits for space in the shard of \p p_event
+  bool resume_on_space(const event            &p_event,
+                       std::coroutine_handle<> p_awaiting) override
+  {
+    return get_shard(p_event).resume_on_space(p_event, p_awaiting);
+  }
+
+  /// \brief Adds copies of \p p_events to their shards, notifying the handler
+  /// of each shard only once
+  async::dat::result add_events(std::span<const event> p_events) override
+  {
+    if constexpr (std::copy_constructible<event>)
+    {
+      if (m_shards.size() == 1)
+      {
+        return m_shards.front()->add_events(p_events);
+      }
+
+      std::vector<std::vector<event>> _per_shard(m_shards.size());
+      for (const event &_event : p_events)
+      {
+        _per_shard[get_shard_pos(_event)].push_back(_event);
+      }
+
+      async::dat::result _result{async::dat::result::OK};
+      for (std::size_t _i = 0; _i < m_shards.size(); ++_i)
+      {
+        if (_per_shard[_i].empty())
+        {
+          continue;
+        }
+        if (const async::dat::result _added{m_shards[_i]->add_events(
+                std::span<const event>{_per_shard[_i]})};
+            _added != async::dat::result::OK)
+        {
+          _result = _added;
+        }
+      }
+      return _result;
+    }
+    else
+    {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("events of handling '", m_handling_name,
+                                    "' can not be copied"));
+      return async::dat::result::ERROR_PUBLISHNG;
+    }
+  }
+
+  /// \brief Sets \p p_policy to each shard, and \p p_max_capacity is the
+  /// maximum amount of events of each shard
+  void set_overflow_policy(async::dat::overflow_policy p_policy,
+                           std::size_t                 p_max_capacity) override
+  {
+    for (std::unique_ptr<shard> &_shard : m_shards)
+    {
+      _shard->set_overflow_policy(p_policy, p_max_capacity);
+    }
+  }
+
+  void stop() override
+  {
+    for (std::unique_ptr<shard> &_shard : m_shards)
+    {
+      _shard->stop();
+    }
+  }
+
+  constexpr bool is_stopped() const override
+  {
+    return std::all_of(m_shards.begin(), m_shards.end(),
+                       [](const std::unique_ptr<shard> &p_shard)
+                       { return p_shard->is_stopped(); });
+  }
+
+  [[nodiscard]] constexpr size_t get_amount_handlers() const override
+  {
+    return m_shards.size();
+  }
+
+  [[nodiscard]] dat::handling_id get_id() const override
+  {
+    return m_handling_id;
+  }
+
+  [[nodiscard]] async::dat::handling_name get_name() const override
+  {
+    return m_handling_name;
+  }
+
+  [[nodiscard]] constexpr size_t get_num_events() const override
+  {
+    std::size_t _num_events{0};
+    for (const std::unique_ptr<shard> &_shard : m_shards)
+    {
+      _num_events += _shard->get_num_events();
+    }
+    return _num_events;
+  }
+
+  [[nodiscard]] constexpr size_t get_events_capacity() const override
+  {
+    std::size_t _capacity{0};
+    for (const std::unique_ptr<shard> &_shard : m_shards)
+    {
+      _capacity += _shard->get_events_capacity();
+    }
+    return _capacity;
+  }
+
+  [[nodiscard]] internal::dat::handler_id get_handler_id() const override
+  {
+    return internal::dat::get_handler_id<t_event, t_handler>();
+  }
+
+  /// \return The metrics of all the shards added, where \p high_water_mark is
+  /// the greatest of the shards, and \p handlers has one handler per shard
+  [[nodiscard]] async::dat::handling_metrics get_metrics() const override
+  {
+    async::dat::handling_metrics _metrics;
+    _metrics.name = m_handling_name;
+    for (const std::unique_ptr<shard> &_shard : m_shards)
+    {
+      const async::dat::handling_metrics _shard_metrics{_shard->get_metrics()};
+      _metrics.published += _shard_metrics.published;
+      _metrics.handled += _shard_metrics.handled;
+      _metrics.dropped += _shard_metrics.dropped;
+      _metrics.rejected += _shard_metrics.rejected;
+      _metrics.coalesced += _shard_metrics.coalesced;
+      _metrics.queued += _shard_metrics.queued;
+      _metrics.high_water_mark =
+          std::max(_metrics.high_water_mark, _shard_metrics.high_water_mark);
+      _metrics.enqueue_to_dequeue.merge(_shard_metrics.enqueue_to_dequeue);
+      _metrics.handler_time.merge(_shard_metrics.handler_time);
+      _metrics.handlers.insert(_metrics.handlers.end(),
+                               _shard_metrics.handlers.begin(),
+                               _shard_metrics.handlers.end());
+    }
+    return _metrics;
+  }
+
+  void clear() override
+  {
+    for (std::unique_ptr<shard> &_shard : m_shards)
+    {
+      _shard->clear();
+    }
+  }
+
+private:
+  using shard = handling_concrete<t_logger, t_event, t_queue, t_handler>;
+
+  using key = std::remove_cvref_t<std::invoke_result_t<
+      const key_extractor &, const event &>>;
+
+private:
+  [[nodiscard]] std::size_t get_shard_pos(const event &p_event) const
+  {
+    return std::hash<key>{}(m_key_extractor(p_event)) % m_shards.size();
+  }
+
+  [[nodiscard]] shard &get_shard(const event &p_event)
+  {
+    return *m_shards[get_shard_pos(p_event)];
+  }
+
+private:
+  logger &m_logger;
+
+  async::dat::handling_name m_handling_name;
+
+  dat::handling_id m_handling_id;
+
+  key_extractor m_key_extractor;
+
+  std::vector<std::unique_ptr<shard>> m_shards;
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
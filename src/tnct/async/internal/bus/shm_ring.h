@@ -0,0 +1,488 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_BUS_SHM_RING_H
+#define TNCT_ASYNC_INTERNAL_BUS_SHM_RING_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace tnct::async::internal::bus
+{
+
+// Beginning of the shared memory segment, followed by 'capacity' bytes where
+// the events are written, each as a 'shm_record' followed by its bytes,
+// padded to 8 bytes
+//
+// 'head' is only changed by the sender, and 'tail' only by the receiver, and
+// both only grow, so the position of a byte is its offset modulo 'capacity'
+struct shm_header
+{
+  std::array<char, 8> magic;
+
+  std::uint32_t amount_events;
+
+  std::uint64_t capacity;
+
+  alignas(64) std::atomic_uint64_t head;
+
+  alignas(64) std::atomic_uint64_t tail;
+
+  // Incremented after each event written, and the word the receiver waits on
+  alignas(64) std::atomic_uint32_t data_signal;
+
+  std::atomic_uint32_t receiver_waiting;
+
+  // Incremented after each event read, and the word the sender waits on
+  alignas(64) std::atomic_uint32_t space_signal;
+
+  std::atomic_uint32_t sender_waiting;
+};
+
+struct shm_record
+{
+  // 'wrap' means the rest of the ring is not used, and the next event is at
+  // its beginning
+  std::uint32_t size;
+
+  std::uint32_t event_index;
+};
+
+static_assert(std::atomic_uint64_t::is_always_lock_free
+              && std::atomic_uint32_t::is_always_lock_free);
+
+// Ring buffer in a POSIX shared memory segment, written by one process and
+// read by another, where a process waits for events, or for space, with a
+// futex, so it sleeps in the kernel, and is woken up only if it is waiting
+//
+// The segment is created by the sender, which removes it when it is
+// destroyed, and opened by the receiver. Only Linux is supported, and on other
+// systems 'create' and 'open' throw.
+class shm_ring final
+{
+public:
+  static constexpr std::uint32_t wrap{
+      std::numeric_limits<std::uint32_t>::max()};
+
+  static constexpr std::array<char, 8> magic{'t', 'n', 'c', 't',
+                                             's', 'h', 'm', '1'};
+
+  static constexpr std::size_t min_capacity{4096};
+
+  shm_ring()                            = delete;
+  shm_ring(const shm_ring &)            = delete;
+  shm_ring &operator=(const shm_ring &) = delete;
+
+  shm_ring(shm_ring &&p_ring) noexcept
+      : m_name(std::move(p_ring.m_name)),
+        m_header(std::exchange(p_ring.m_header, nullptr)),
+        m_data(std::exchange(p_ring.m_data, nullptr)),
+        m_size(std::exchange(p_ring.m_size, 0)),
+        m_owner(std::exchange(p_ring.m_owner, false))
+  {
+  }
+
+  shm_ring &operator=(shm_ring &&p_ring) noexcept
+  {
+    if (this != &p_ring)
+    {
+      release();
+      m_name   = std::move(p_ring.m_name);
+      m_header = std::exchange(p_ring.m_header, nullptr);
+      m_data   = std::exchange(p_ring.m_data, nullptr);
+      m_size   = std::exchange(p_ring.m_size, 0);
+      m_owner  = std::exchange(p_ring.m_owner, false);
+    }
+    return *this;
+  }
+
+  ~shm_ring()
+  {
+    release();
+  }
+
+  // Creates the segment 'p_name', replacing one that exists, with at least
+  // 'p_capacity' bytes for events, rounded up to a power of 2
+  static shm_ring create(const std::string &p_name, std::size_t p_capacity,
+                         std::uint32_t p_amount_events)
+  {
+#ifdef __linux__
+    const std::size_t _capacity{
+        std::bit_ceil(std::max(p_capacity, min_capacity))};
+    const std::size_t _size{sizeof(shm_header) + _capacity};
+
+    ::shm_unlink(p_name.c_str());
+    const int _fd{::shm_open(p_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)};
+    if (_fd == -1)
+    {
+      throw std::runtime_error(error("creating", p_name));
+    }
+    if (::ftruncate(_fd, static_cast<off_t>(_size)) == -1)
+    {
+      const std::string _error{error("sizing", p_name)};
+      ::close(_fd);
+      ::shm_unlink(p_name.c_str());
+      throw std::runtime_error(_error);
+    }
+
+    void *_address{nullptr};
+    try
+    {
+      _address = map(_fd, _size, p_name);
+    }
+    catch (...)
+    {
+      ::shm_unlink(p_name.c_str());
+      throw;
+    }
+    shm_ring _ring{p_name, _address, _size, true};
+
+    shm_header *_header{new (_address) shm_header{}};
+    _header->amount_events = p_amount_events;
+    _header->capacity      = _capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    _header->magic = magic;
+
+    return _ring;
+#else
+    static_cast<void>(p_capacity);
+    static_cast<void>(p_amount_events);
+    throw std::runtime_error("shared memory bridge is only supported on "
+                             "Linux, so '"
+                             + p_name + "' was not created");
+#endif
+  }
+
+  // Opens the segment 'p_name', created by a sender of 'p_amount_events'
+  // types of events
+  static shm_ring open(const std::string &p_name,
+                       std::uint32_t      p_amount_events)
+  {
+#ifdef __linux__
+    const int _fd{::shm_open(p_name.c_str(), O_RDWR, 0600)};
+    if (_fd == -1)
+    {
+      throw std::runtime_error(error("opening", p_name));
+    }
+    struct stat _stat{};
+    if ((::fstat(_fd, &_stat) == -1)
+        || (static_cast<std::size_t>(_stat.st_size) <= sizeof(shm_header)))
+    {
+      ::close(_fd);
+      throw std::runtime_error("'" + p_name + "' is not a shared memory ring");
+    }
+
+    const std::size_t _size{static_cast<std::size_t>(_stat.st_size)};
+    shm_ring          _ring{p_name, map(_fd, _size, p_name), _size, false};
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if ((_ring.m_header->magic != magic)
+        || (_ring.m_header->capacity != (_size - sizeof(shm_header))))
+    {
+      throw std::runtime_error("'" + p_name + "' is not a shared memory ring");
+    }
+    if (_ring.m_header->amount_events != p_amount_events)
+    {
+      throw std::runtime_error(
+          "'" + p_name + "' has "
+          + std::to_string(_ring.m_header->amount_events)
+          + " types of events, but " + std::to_string(p_amount_events)
+          + " were expected");
+    }
+    return _ring;
+#else
+    static_cast<void>(p_amount_events);
+    throw std::runtime_error("shared memory bridge is only supported on "
+                             "Linux, so '"
+                             + p_name + "' was not opened");
+#endif
+  }
+
+  [[nodiscard]] std::size_t get_capacity() const
+  {
+    return m_header->capacity;
+  }
+
+  // Largest amount of bytes of an event
+  [[nodiscard]] std::size_t get_max_event_size() const
+  {
+    return (m_header->capacity / 2) - sizeof(shm_record);
+  }
+
+  // Writes an event, waiting up to 'p_timeout' while there is no space,
+  // unless 'p_stop' is set
+  //
+  // Must not be called by more than one thread at the same time
+  //
+  // Returns false if the event is larger than 'get_max_event_size', if
+  // 'p_stop' was set while waiting, or if there was no space after 'p_timeout'
+  bool write(std::uint32_t p_event_index, std::span<const std::byte> p_bytes,
+             const std::atomic_bool   &p_stop,
+             std::chrono::milliseconds p_timeout)
+  {
+    if (p_bytes.size() > get_max_event_size())
+    {
+      return false;
+    }
+
+    const std::uint64_t _need{record_size(p_bytes.size())};
+    const std::uint64_t _capacity{m_header->capacity};
+    std::uint64_t _head{m_header->head.load(std::memory_order_relaxed)};
+
+    const std::uint64_t _until_end{_capacity - (_head & (_capacity - 1))};
+    const std::uint64_t _total{_need + (_until_end < _need ? _until_end : 0)};
+
+    const std::chrono::steady_clock::time_point _deadline{
+        std::chrono::steady_clock::now() + p_timeout};
+    while ((_capacity
+            - (_head - m_header->tail.load(std::memory_order_acquire)))
+           < _total)
+    {
+      const std::chrono::steady_clock::time_point _now{
+          std::chrono::steady_clock::now()};
+      if (p_stop || (_now >= _deadline))
+      {
+        return false;
+      }
+      wait(m_header->space_signal, m_header->sender_waiting,
+           [&]()
+           {
+             return (_capacity
+                     - (_head - m_header->tail.load(std::memory_order_seq_cst)))
+                    >= _total;
+           },
+           std::min(max_wait, std::chrono::ceil<std::chrono::milliseconds>(
+                                  _deadline - _now)));
+    }
+
+    if (_until_end < _need)
+    {
+      record_at(_head)->size = wrap;
+      _head += _until_end;
+    }
+
+    shm_record *_record{record_at(_head)};
+    _record->size        = static_cast<std::uint32_t>(p_bytes.size());
+    _record->event_index = p_event_index;
+    if (!p_bytes.empty())
+    {
+      std::memcpy(_record + 1, p_bytes.data(), p_bytes.size());
+    }
+
+    m_header->head.store(_head + _need, std::memory_order_seq_cst);
+    signal(m_header->data_signal, m_header->receiver_waiting);
+    return true;
+  }
+
+  // Calls 'p_consume' with the index of the type and the bytes of the next
+  // event, waiting for it up to 'p_timeout', and then frees its space
+  //
+  // The bytes are in the shared memory, and are valid only while
+  // 'p_consume' runs. Returns false if there was no event.
+  template <typename t_consume>
+  bool read(t_consume &&p_consume, std::chrono::milliseconds p_timeout)
+  {
+    const std::uint64_t _capacity{m_header->capacity};
+    std::uint64_t _tail{m_header->tail.load(std::memory_order_relaxed)};
+
+    if (m_header->head.load(std::memory_order_acquire) == _tail)
+    {
+      wait(m_header->data_signal, m_header->receiver_waiting,
+           [&]()
+           {
+             return m_header->head.load(std::memory_order_seq_cst) != _tail;
+           },
+           p_timeout);
+      if (m_header->head.load(std::memory_order_acquire) == _tail)
+      {
+        return false;
+      }
+    }
+
+    const shm_record *_record{record_at(_tail)};
+    if (_record->size == wrap)
+    {
+      _tail += _capacity - (_tail & (_capacity - 1));
+      _record = record_at(_tail);
+    }
+
+    p_consume(_record->event_index,
+              std::span<const std::byte>{
+                  reinterpret_cast<const std::byte *>(_record + 1),
+                  _record->size});
+
+    m_header->tail.store(_tail + record_size(_record->size),
+                         std::memory_order_seq_cst);
+    signal(m_header->space_signal, m_header->sender_waiting);
+    return true;
+  }
+
+  // Wakes up a receiver waiting in 'read'
+  void wake_up_receiver()
+  {
+    m_header->data_signal.fetch_add(1, std::memory_order_seq_cst);
+    futex_wake(m_header->data_signal);
+  }
+
+private:
+  shm_ring(std::string p_name, void *p_address, std::size_t p_size,
+           bool p_owner)
+      : m_name(std::move(p_name)),
+        m_header(static_cast<shm_header *>(p_address)),
+        m_data(static_cast<std::byte *>(p_address) + sizeof(shm_header)),
+        m_size(p_size), m_owner(p_owner)
+  {
+  }
+
+  static std::uint64_t record_size(std::size_t p_bytes)
+  {
+    return sizeof(shm_record) + ((p_bytes + 7) & ~std::uint64_t{7});
+  }
+
+  shm_record *record_at(std::uint64_t p_offset) const
+  {
+    return reinterpret_cast<shm_record *>(
+        m_data + (p_offset & (m_header->capacity - 1)));
+  }
+
+  // Sleeps on 'p_signal' until 'p_ready', or until 'p_timeout'
+  //
+  // 'p_waiting' is set before 'p_ready' is checked, and the other process
+  // changes what 'p_ready' checks before it reads 'p_waiting', so either this
+  // process sees the change, or the other one sees it waiting, and wakes it
+  template <typename t_ready>
+  static void wait(std::atomic_uint32_t &p_signal,
+                   std::atomic_uint32_t &p_waiting, t_ready &&p_ready,
+                   std::chrono::milliseconds p_timeout = max_wait)
+  {
+    const std::uint32_t _signal{p_signal.load(std::memory_order_seq_cst)};
+    p_waiting.store(1, std::memory_order_seq_cst);
+    if (!p_ready())
+    {
+      futex_wait(p_signal, _signal, p_timeout);
+    }
+    p_waiting.store(0, std::memory_order_seq_cst);
+  }
+
+  static void signal(std::atomic_uint32_t &p_signal,
+                     std::atomic_uint32_t &p_waiting)
+  {
+    p_signal.fetch_add(1, std::memory_order_seq_cst);
+    if (p_waiting.load(std::memory_order_seq_cst) != 0)
+    {
+      futex_wake(p_signal);
+    }
+  }
+
+  static void futex_wait(std::atomic_uint32_t &p_word, std::uint32_t p_expected,
+                         std::chrono::milliseconds p_timeout)
+  {
+#ifdef __linux__
+    const std::chrono::seconds _seconds{
+        std::chrono::duration_cast<std::chrono::seconds>(p_timeout)};
+    const timespec _timeout{
+        static_cast<time_t>(_seconds.count()),
+        static_cast<long>(
+            std::chrono::nanoseconds{p_timeout - _seconds}.count())};
+    // not FUTEX_PRIVATE_FLAG, as the word is shared between processes
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&p_word),
+              FUTEX_WAIT, p_expected, &_timeout, nullptr, 0);
+#else
+    static_cast<void>(p_word);
+    static_cast<void>(p_expected);
+    static_cast<void>(p_timeout);
+#endif
+  }
+
+  static void futex_wake(std::atomic_uint32_t &p_word)
+  {
+#ifdef __linux__
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&p_word),
+              FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+    static_cast<void>(p_word);
+#endif
+  }
+
+#ifdef __linux__
+  static void *map(int p_fd, std::size_t p_size, const std::string &p_name)
+  {
+    void *_address{::mmap(nullptr, p_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          p_fd, 0)};
+    const std::string _error{_address == MAP_FAILED ? error("mapping", p_name)
+                                                    : std::string{}};
+    ::close(p_fd);
+    if (_address == MAP_FAILED)
+    {
+      throw std::runtime_error(_error);
+    }
+    return _address;
+  }
+
+  static std::string error(const char *p_action, const std::string &p_name)
+  {
+    return std::string{"error "} + p_action + " '" + p_name
+           + "': " + std::strerror(errno);
+  }
+#endif
+
+  void release()
+  {
+#ifdef __linux__
+    if (m_header != nullptr)
+    {
+      ::munmap(m_header, m_size);
+      if (m_owner)
+      {
+        ::shm_unlink(m_name.c_str());
+      }
+    }
+#endif
+    m_header = nullptr;
+  }
+
+private:
+  // A process that misses a wake up, which the protocol should not allow,
+  // still checks again after this time
+  static constexpr std::chrono::milliseconds max_wait{100};
+
+  std::string m_name;
+
+  shm_header *m_header{nullptr};
+
+  std::byte *m_data{nullptr};
+
+  std::size_t m_size{0};
+
+  // If this process created the segment, and removes it
+  bool m_owner{false};
+};
+
+} // namespace tnct::async::internal::bus
+
+#endif
@@ -9,15 +9,15 @@
 #include <typeinfo>
 
 #include "tnct/async/cpt/is_event.h"
-#include "tnct/async/cpt/is_handler.h"
+#include "tnct/async/cpt/is_any_handler.h"
 
 namespace tnct::async::internal::dat
 {
 
 using handler_id = size_t;
 
-template <async::cpt::is_event            t_event,
-          async::cpt::is_handler<t_event> t_handler>
+template <async::cpt::is_event                t_event,
+          async::cpt::is_any_handler<t_event> t_handler>
 inline handler_id get_handler_id()
 {
   return static_cast<handler_id>(typeid(t_handler).hash_code());
@@ -0,0 +1,38 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_DAT_RECORD_FORMAT_H
+#define TNCT_ASYNC_INTERNAL_DAT_RECORD_FORMAT_H
+
+#include <array>
+#include <cstdint>
+
+namespace tnct::async::internal::dat
+{
+
+// A file written by 'bus::recorder' starts with 'record_magic', followed by
+// the amount of types of events recorded, as a 'std::uint32_t', and then, for
+// each event published, a 'record_header' followed by the 'size' bytes of the
+// serialized event, all in the byte order of the machine that recorded it
+
+inline constexpr std::array<char, 8> record_magic{'t', 'n', 'c', 't',
+                                                  'r', 'e', 'c', '1'};
+
+struct record_header
+{
+  // Since the recorder was created
+  std::uint64_t nanoseconds{0};
+
+  // Index of the type of the event in the types of the recorder
+  std::uint32_t event_index{0};
+
+  std::uint32_t size{0};
+};
+
+static_assert(sizeof(record_header) == 16);
+
+} // namespace tnct::async::internal::dat
+
+#endif
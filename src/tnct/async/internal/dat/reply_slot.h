@@ -0,0 +1,160 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_INTERNAL_DAT_REPLY_SLOT_H
+#define TNCT_ASYNC_INTERNAL_DAT_REPLY_SLOT_H
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace tnct::async::internal::dat
+{
+
+/// \brief Where the reply to an \p async::dat::request is stored, shared by the
+/// copies of the request and by the \p async::dat::reply that waits for it
+///
+/// It is allocated once per request, together with the storage of the reply,
+/// and it is done when the first copy of the request replies, or when all the
+/// copies are destroyed without replying, so the waiting side does not wait for
+/// a reply that will never come
+///
+/// A coroutine that waits for the slot is resumed by the thread that makes it
+/// done
+template <std::movable t_reply>
+class reply_slot
+{
+public:
+  reply_slot() = default;
+
+  reply_slot(const reply_slot &)            = delete;
+  reply_slot(reply_slot &&)                 = delete;
+  reply_slot &operator=(const reply_slot &) = delete;
+  reply_slot &operator=(reply_slot &&)      = delete;
+
+  ~reply_slot() = default;
+
+  /// \return \p false if the slot is already done, and \p p_reply is discarded
+  bool set(t_reply &&p_reply)
+  {
+    std::coroutine_handle<> _awaiting;
+    {
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      if (m_done)
+      {
+        return false;
+      }
+      m_reply.emplace(std::move(p_reply));
+      m_done    = true;
+      _awaiting = std::exchange(m_awaiting, nullptr);
+    }
+    m_cond.notify_all();
+    if (_awaiting)
+    {
+      _awaiting.resume();
+    }
+    return true;
+  }
+
+  /// \brief A new copy of the request refers to the slot
+  void add_request()
+  {
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /// \brief A copy of the request was destroyed, and if it was the last one,
+  /// the slot is done, even if there is no reply
+  void remove_request()
+  {
+    if (m_requests.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+      return;
+    }
+    std::coroutine_handle<> _awaiting;
+    {
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      m_done    = true;
+      _awaiting = std::exchange(m_awaiting, nullptr);
+    }
+    m_cond.notify_all();
+    if (_awaiting)
+    {
+      _awaiting.resume();
+    }
+  }
+
+  /// \brief \p p_awaiting will be resumed when the slot is done
+  ///
+  /// \return \p false if the slot is already done, and \p p_awaiting is not
+  /// resumed
+  bool resume_when_done(std::coroutine_handle<> p_awaiting)
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    if (m_done)
+    {
+      return false;
+    }
+    m_awaiting = p_awaiting;
+    return true;
+  }
+
+  [[nodiscard]] bool is_done() const
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    return m_done;
+  }
+
+  /// \brief Waits until the slot is done
+  ///
+  /// \return The reply, moved out of the slot, or \p std::nullopt if no request
+  /// replied
+  std::optional<t_reply> take()
+  {
+    std::unique_lock<std::mutex> _lock(m_mutex);
+    m_cond.wait(_lock, [this]() { return m_done; });
+    return std::exchange(m_reply, std::nullopt);
+  }
+
+  /// \brief Waits until the slot is done, or \p p_timeout has passed
+  ///
+  /// \return The reply, moved out of the slot, or \p std::nullopt if no request
+  /// replied in \p p_timeout
+  template <typename t_rep, typename t_period>
+  std::optional<t_reply>
+  take_for(std::chrono::duration<t_rep, t_period> p_timeout)
+  {
+    std::unique_lock<std::mutex> _lock(m_mutex);
+    if (!m_cond.wait_for(_lock, p_timeout, [this]() { return m_done; }))
+    {
+      return std::nullopt;
+    }
+    return std::exchange(m_reply, std::nullopt);
+  }
+
+private:
+  std::optional<t_reply> m_reply;
+
+  bool m_done{false};
+
+  // Coroutine waiting for the slot to be done
+  std::coroutine_handle<> m_awaiting;
+
+  // Amount of copies of the request that can still reply
+  std::atomic_size_t m_requests{0};
+
+  mutable std::mutex m_mutex;
+
+  std::condition_variable m_cond;
+};
+
+} // namespace tnct::async::internal::dat
+
+#endif
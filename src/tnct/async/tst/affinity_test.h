@@ -0,0 +1,221 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_AFFINITY_TEST_H
+#define TNCT_ASYNC_TST_AFFINITY_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "tnct/async/bus/affinity.h"
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/dat/affinity.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_pinned
+{
+  event_pinned(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream       &p_out,
+                                  const event_pinned &p_event)
+  {
+    p_out << "pinned " << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+using pinned_dispatcher = async::bus::dispatcher<log::cerr, event_pinned>;
+
+using pinned_queue = container::dat::circular_queue<log::cerr, event_pinned>;
+
+struct affinity_000
+{
+  static std::string desc()
+  {
+    return "The CPUs of a handler are the ones of its index, if there are, "
+           "or the ones of all the handlers";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    async::dat::affinity _affinity;
+    if (!_affinity.empty())
+    {
+      _logger.err("a default affinity should be empty");
+      return false;
+    }
+
+    _affinity.cpus        = {0, 1};
+    _affinity.per_handler = {{2}, {}, {3, 4}};
+
+    _logger.tst(format::bus::fmt(_affinity));
+
+    return !_affinity.empty()
+           && (_affinity.of(0) == async::dat::cpu_set{2})
+           && (_affinity.of(1) == async::dat::cpu_set{0, 1})
+           && (_affinity.of(2) == async::dat::cpu_set{3, 4})
+           && (_affinity.of(3) == async::dat::cpu_set{0, 1});
+  }
+};
+
+struct affinity_001
+{
+  static std::string desc()
+  {
+    return "The 3 handlers of a handling pinned to the first CPU of the NUMA "
+           "node 0, with its queue created in that CPU, run only in it";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const std::optional<async::dat::cpu_set> _node{
+        async::bus::cpus_of_numa_node(0)};
+    if (!_node || _node->empty())
+    {
+      _logger.tst("no NUMA node 0, so nothing to test");
+      return true;
+    }
+
+    const async::dat::cpu_set _cpus{_node->front()};
+
+    std::optional<pinned_queue> _queue{async::bus::call_pinned(
+        _cpus, [&]() { return pinned_queue::create(_logger, 256); })};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    std::mutex            _mutex;
+    std::set<std::size_t> _cpus_used;
+    std::atomic_size_t    _handled{0};
+
+    pinned_dispatcher _dispatcher(_logger);
+    if (_dispatcher.add_handling<event_pinned>(
+            "pinned", std::move(*_queue),
+            [&](event_pinned &&)
+            {
+#ifdef __linux__
+              std::lock_guard<std::mutex> _lock(_mutex);
+              _cpus_used.insert(static_cast<std::size_t>(sched_getcpu()));
+#endif
+              ++_handled;
+            },
+            async::dat::affinity{_cpus, {}},
+            async::dat::handling_priority::medium, 3)
+        != async::dat::result::OK)
+    {
+      _logger.err("error adding handling");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_pinned>(_i) != async::dat::result::OK)
+      {
+        _logger.err(format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+    for (int _i = 0; (_i < 200) && (_handled < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    _logger.tst(format::bus::fmt("handled = ", _handled.load(),
+                                 ", CPUs used = ", _cpus_used.size()));
+
+#ifdef __linux__
+    return (_handled == m_amount) && (_cpus_used.size() == 1)
+           && (*_cpus_used.begin() == _cpus.front());
+#else
+    return _handled == m_amount;
+#endif
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{1000};
+};
+
+struct affinity_002
+{
+  static std::string desc()
+  {
+    return "'call_pinned' returns what the function returns, and rethrows "
+           "what it throws, and a dispatcher whose handlers are called in a "
+           "pool does not accept a handling with affinity";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    if (async::bus::call_pinned({0}, []() { return 42; }) != 42)
+    {
+      _logger.err("wrong value returned");
+      return false;
+    }
+
+    bool _caught{false};
+    try
+    {
+      async::bus::call_pinned({0},
+                              []() { throw std::runtime_error("pinned"); });
+    }
+    catch (const std::runtime_error &)
+    {
+      _caught = true;
+    }
+    if (!_caught)
+    {
+      _logger.err("exception not rethrown");
+      return false;
+    }
+
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 2);
+    pinned_dispatcher                         _dispatcher(_logger, _pool);
+
+    auto _queue{pinned_queue::create(_logger, 16)};
+    return _queue
+           && (_dispatcher.add_handling<event_pinned>(
+                   "pinned", std::move(*_queue), [](event_pinned &&) {},
+                   async::dat::affinity{{0}, {}})
+               == async::dat::result::ERROR_ADDING_HANDLER);
+  }
+};
+
+} // namespace tnct::async::tst
+
+#endif
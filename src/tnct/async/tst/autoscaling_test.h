@@ -0,0 +1,417 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_AUTOSCALING_TEST_H
+#define TNCT_ASYNC_TST_AUTOSCALING_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/dat/autoscaling.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_load
+{
+  event_load(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream     &p_out,
+                                  const event_load &p_event)
+  {
+    p_out << "load " << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+using load_dispatcher = async::bus::dispatcher<log::cerr, event_load>;
+
+using load_queue = container::dat::circular_queue<log::cerr, event_load>;
+
+// Evaluated only when 'dispatcher::autoscale' is called
+inline async::dat::autoscaling manual_autoscaling()
+{
+  async::dat::autoscaling _autoscaling;
+  _autoscaling.min_handlers          = 1;
+  _autoscaling.max_handlers          = 3;
+  _autoscaling.grow_above_queued     = 4;
+  _autoscaling.evaluations_to_grow   = 2;
+  _autoscaling.evaluations_to_shrink = 3;
+  _autoscaling.interval              = 0ms;
+  return _autoscaling;
+}
+
+struct autoscaling_000
+{
+  static std::string desc()
+  {
+    return "While the handlers are blocked, and events pile up in the queue, a "
+           "handling grows by one handler each 2 evaluations, up to 3, and "
+           "then all the events are handled";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr       _logger;
+    load_dispatcher _dispatcher(_logger);
+
+    std::atomic_bool   _released{false};
+    std::atomic_size_t _handled{0};
+
+    auto _queue{load_queue::create(_logger, 64)};
+    if (!_queue
+        || (_dispatcher.add_handling<event_load>(
+                "load", std::move(*_queue),
+                [&](event_load &&)
+                {
+                  _released.wait(false);
+                  ++_handled;
+                },
+                manual_autoscaling())
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_load>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+
+    const std::vector<std::size_t> _expected{1, 2, 2, 3, 3, 3};
+    std::vector<std::size_t>       _amounts;
+    for (std::size_t _i = 0; _i < _expected.size(); ++_i)
+    {
+      const std::optional<async::dat::autoscaling_decision> _decision{
+          _dispatcher.autoscale<event_load>("load")};
+      if (!_decision)
+      {
+        TNCT_LOG_ERR(_logger, "no autoscaling decision");
+        return false;
+      }
+      TNCT_LOG_TST(_logger, format::bus::fmt(*_decision));
+      _amounts.push_back(_decision->to);
+      // the new handler takes an event, and blocks
+      std::this_thread::sleep_for(20ms);
+    }
+
+    _released = true;
+    _released.notify_all();
+
+    for (int _i = 0; (_i < 200) && (_handled < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled = ", _handled.load()));
+
+    return (_amounts == _expected) && (_handled == m_amount);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{40};
+};
+
+struct autoscaling_001
+{
+  static std::string desc()
+  {
+    return "After a burst, a handling with 3 handlers shrinks by one handler "
+           "each 3 idle evaluations, down to 1, and still handles the events "
+           "published after that";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr       _logger;
+    load_dispatcher _dispatcher(_logger);
+
+    std::atomic_bool   _released{false};
+    std::atomic_size_t _handled{0};
+
+    std::vector<async::dat::autoscaling_decision> _decisions;
+
+    async::dat::autoscaling _autoscaling{manual_autoscaling()};
+    _autoscaling.on_decision =
+        [&](const async::dat::autoscaling_decision &p_decision)
+    { _decisions.push_back(p_decision); };
+
+    auto _queue{load_queue::create(_logger, 64)};
+    if (!_queue
+        || (_dispatcher.add_handling<event_load>(
+                "load", std::move(*_queue),
+                [&](event_load &&)
+                {
+                  _released.wait(false);
+                  ++_handled;
+                },
+                _autoscaling)
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_load>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        // the handlers are released, so the dispatcher can stop them
+        _released = true;
+        _released.notify_all();
+        return false;
+      }
+    }
+
+    for (int _i = 0; _i < 4; ++_i)
+    {
+      _dispatcher.autoscale<event_load>("load");
+      std::this_thread::sleep_for(20ms);
+    }
+
+    _released = true;
+    _released.notify_all();
+    for (int _i = 0; (_i < 200) && (_handled < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::size_t _grown{_decisions.size()};
+
+    for (int _i = 0; _i < 12; ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+      _dispatcher.autoscale<event_load>("load");
+    }
+
+    for (const async::dat::autoscaling_decision &_decision : _decisions)
+    {
+      TNCT_LOG_TST(_logger, format::bus::fmt(_decision));
+    }
+
+    if ((_grown == 0) || (_decisions[_grown - 1].to != 3))
+    {
+      TNCT_LOG_ERR(_logger, "the handling did not grow to 3 handlers");
+      return false;
+    }
+
+    // each change is of one handler, after 3 idle evaluations in a row
+    std::size_t _idle{0};
+    for (std::size_t _i = _grown; _i < _decisions.size(); ++_i)
+    {
+      const async::dat::autoscaling_decision &_decision{_decisions[_i]};
+      const bool                              _is_idle{
+          (_decision.queued == 0)
+          && (_decision.utilisation
+              < _autoscaling.shrink_below_utilisation)};
+      _idle = (_is_idle ? _idle + 1 : 0);
+      if (_decision.to == _decision.from)
+      {
+        continue;
+      }
+      if ((_decision.to + 1 != _decision.from) || (_idle != 3))
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("wrong decision ", _decision));
+        return false;
+      }
+      _idle = 0;
+    }
+
+    if (_decisions.back().to != 1)
+    {
+      TNCT_LOG_ERR(_logger, "the handling did not shrink to 1 handler");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_load>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+    for (int _i = 0; (_i < 200) && (_handled < (2 * m_amount)); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled = ", _handled.load()));
+
+    return _handled == (2 * m_amount);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{40};
+};
+
+struct autoscaling_002
+{
+  static std::string desc()
+  {
+    return "A vote to grow followed by an evaluation that does not vote to "
+           "grow does not add a handler, as the votes must be in a row";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr       _logger;
+    load_dispatcher _dispatcher(_logger);
+
+    std::atomic_bool _released{false};
+
+    auto _queue{load_queue::create(_logger, 64)};
+    if (!_queue
+        || (_dispatcher.add_handling<event_load>(
+                "load", std::move(*_queue),
+                [&](event_load &&) { _released.wait(false); },
+                manual_autoscaling())
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    auto _burst{[&]()
+                {
+                  for (std::uint32_t _i = 0; _i < 20; ++_i)
+                  {
+                    if (_dispatcher.publish<event_load>(_i)
+                        != async::dat::result::OK)
+                    {
+                      TNCT_LOG_ERR(_logger,
+                                   format::bus::fmt("error publishing ", _i));
+                      return false;
+                    }
+                  }
+                  return true;
+                }};
+
+    std::vector<std::size_t> _amounts;
+    auto                     _evaluate{[&]()
+                   {
+                     std::optional<async::dat::autoscaling_decision> _decision{
+                         _dispatcher.autoscale<event_load>("load")};
+                     _amounts.push_back(_decision ? _decision->to : 0);
+                   }};
+
+    bool _published{true};
+    for (int _i = 0; _published && (_i < 3); ++_i)
+    {
+      _published = _burst();
+      _evaluate();
+      _dispatcher.clear<event_load>("load");
+      _evaluate();
+    }
+    _published = _published && _burst();
+    _evaluate();
+    _evaluate();
+
+    _released = true;
+    _released.notify_all();
+
+    if (!_published)
+    {
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("amounts = ", _amounts.size()));
+
+    const std::vector<std::size_t> _expected{1, 1, 1, 1, 1, 1, 1, 2};
+    return _amounts == _expected;
+  }
+};
+
+struct autoscaling_003
+{
+  static std::string desc()
+  {
+    return "A handling with an autoscaling interval is evaluated by a timer, "
+           "and a dispatcher whose handlers are called in a pool does not "
+           "accept an autoscaling handling";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::atomic_size_t _evaluations{0};
+    {
+      load_dispatcher _dispatcher(_logger);
+
+      async::dat::autoscaling _autoscaling{manual_autoscaling()};
+      _autoscaling.interval = 5ms;
+      _autoscaling.on_decision =
+          [&](const async::dat::autoscaling_decision &) { ++_evaluations; };
+
+      auto _queue{load_queue::create(_logger, 64)};
+      if (!_queue
+          || (_dispatcher.add_handling<event_load>(
+                  "load", std::move(*_queue), [](event_load &&) {},
+                  _autoscaling)
+              != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error adding handling");
+        return false;
+      }
+
+      for (int _i = 0; (_i < 200) && (_evaluations < 5); ++_i)
+      {
+        std::this_thread::sleep_for(10ms);
+      }
+    }
+
+    const std::size_t _after_stop{_evaluations};
+    std::this_thread::sleep_for(30ms);
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("evaluations = ", _evaluations.load()));
+
+    if ((_after_stop < 5) || (_evaluations != _after_stop))
+    {
+      TNCT_LOG_ERR(_logger, "wrong evaluations by the timer");
+      return false;
+    }
+
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 2);
+    load_dispatcher                           _dispatcher(_logger, _pool);
+
+    auto _queue{load_queue::create(_logger, 64)};
+    return _queue
+           && (_dispatcher.add_handling<event_load>(
+                   "load", std::move(*_queue), [](event_load &&) {},
+                   manual_autoscaling())
+               == async::dat::result::ERROR_ADDING_HANDLER);
+  }
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -0,0 +1,427 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_COROUTINE_TEST_H
+#define TNCT_ASYNC_TST_COROUTINE_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/sleep_for.h"
+#include "tnct/async/bus/sync_wait.h"
+#include "tnct/async/cpt/is_coroutine_handler.h"
+#include "tnct/async/cpt/is_handler.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/reply.h"
+#include "tnct/async/dat/request.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/dat/task.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_job
+{
+  event_job(std::uint32_t p_id = 0) : id(p_id)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out, const event_job &p_event)
+  {
+    p_out << "job " << p_event.id;
+    return p_out;
+  }
+
+  std::uint32_t id;
+};
+
+using request_double = async::dat::request<event_job, std::uint32_t>;
+
+using coroutine_dispatcher =
+    async::bus::dispatcher<log::cerr, event_job, request_double>;
+
+using job_queue = container::dat::circular_queue<log::cerr, event_job>;
+
+using request_double_queue =
+    container::dat::circular_queue<log::cerr, request_double>;
+
+// Waits at most 'p_timeout' for 'p_counter' to reach 'p_expected'
+inline bool wait_for_count(const std::atomic_size_t &p_counter,
+                           std::size_t p_expected, std::chrono::seconds p_timeout)
+{
+  const auto _deadline{std::chrono::steady_clock::now() + p_timeout};
+  while ((p_counter < p_expected)
+         && (std::chrono::steady_clock::now() < _deadline))
+  {
+    std::this_thread::sleep_for(5ms);
+  }
+  return p_counter == p_expected;
+}
+
+struct coroutine_000
+{
+  static std::string desc()
+  {
+    return "1000 jobs, each handled by a coroutine that sleeps 50ms, are "
+           "handled by 2 handler threads in much less than the 25s it would "
+           "take if the threads slept";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr            _logger;
+    coroutine_dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _handled{0};
+
+    auto _handler = [&_handled](event_job &&) -> async::dat::task<void>
+    {
+      co_await async::bus::sleep_for(50ms);
+      ++_handled;
+    };
+
+    static_assert(
+        async::cpt::is_coroutine_handler<decltype(_handler), event_job>);
+    static_assert(!async::cpt::is_handler<decltype(_handler), event_job>);
+
+    auto _queue{job_queue::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<event_job>(
+            "sleepy", std::move(*_queue), std::move(_handler),
+            async::dat::handling_priority::medium, 2)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    constexpr std::size_t _amount{1000};
+    const auto            _start{std::chrono::steady_clock::now()};
+    for (std::uint32_t _i = 0; _i < _amount; ++_i)
+    {
+      if (_dispatcher.publish<event_job>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+    }
+
+    const bool _all_handled{wait_for_count(_handled, _amount, 10s)};
+    const auto _elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _start)};
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _handled.load(), " in ",
+                                           _elapsed.count(), "ms"));
+
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_job>("sleepy")};
+    if (!_metrics || (_metrics->handled != _amount))
+    {
+      TNCT_LOG_ERR(_logger, "wrong metrics");
+      return false;
+    }
+
+    return _all_handled && (_elapsed < 3s);
+  }
+};
+
+struct coroutine_001
+{
+  static std::string desc()
+  {
+    return "A coroutine handler 'co_await's the reply to a request, handled "
+           "by another handling, for 100 jobs";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr            _logger;
+    coroutine_dispatcher _dispatcher(_logger);
+
+    auto _request_queue{request_double_queue::create(_logger, 16)};
+    if (!_request_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<request_double>(
+            "double", std::move(*_request_queue),
+            [](request_double &&p_request)
+            { p_request.reply(p_request.get_event().id * 2); })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding request handling");
+      return false;
+    }
+
+    std::atomic_size_t _right{0};
+    std::atomic_size_t _handled{0};
+
+    auto _queue{job_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<event_job>(
+            "requester", std::move(*_queue),
+            [&](event_job &&p_event) -> async::dat::task<void>
+            {
+              const std::optional<std::uint32_t> _reply{
+                  co_await _dispatcher.request<std::uint32_t>(
+                      event_job{p_event.id})};
+              if (_reply && (*_reply == (p_event.id * 2)))
+              {
+                ++_right;
+              }
+              ++_handled;
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding job handling");
+      return false;
+    }
+
+    constexpr std::size_t _amount{100};
+    for (std::uint32_t _i = 0; _i < _amount; ++_i)
+    {
+      if (_dispatcher.publish<event_job>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+    }
+
+    wait_for_count(_handled, _amount, 5s);
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("right replies ", _right.load()));
+
+    return _right == _amount;
+  }
+};
+
+struct coroutine_002
+{
+  static std::string desc()
+  {
+    return "A coroutine publishing 50 jobs with 'async_publish' to a handling "
+           "with 'block' policy and capacity 2 is suspended while the handling "
+           "is full, and all the jobs are handled in order";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr            _logger;
+    coroutine_dispatcher _dispatcher(_logger);
+
+    std::mutex                 _mutex;
+    std::vector<std::uint32_t> _ids;
+
+    auto _queue{job_queue::create(_logger, 2)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<event_job>(
+            "slow", std::move(*_queue),
+            [&](event_job &&p_event)
+            {
+              std::this_thread::sleep_for(2ms);
+              std::lock_guard<std::mutex> _lock(_mutex);
+              _ids.push_back(p_event.id);
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    if (_dispatcher.set_overflow_policy<event_job>(
+            "slow", async::dat::overflow_policy::block, 2)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error setting overflow policy");
+      return false;
+    }
+
+    constexpr std::uint32_t _amount{50};
+
+    auto _publisher = [&]() -> async::dat::task<std::uint32_t>
+    {
+      std::uint32_t _published{0};
+      for (std::uint32_t _i = 0; _i < _amount; ++_i)
+      {
+        if (co_await _dispatcher.async_publish(event_job{_i})
+            == async::dat::result::OK)
+        {
+          ++_published;
+        }
+      }
+      co_return _published;
+    };
+
+    const std::uint32_t _published{async::bus::sync_wait(_publisher())};
+    if (_published != _amount)
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt("published ", _published));
+      return false;
+    }
+
+    for (int _i = 0; _i < 200; ++_i)
+    {
+      {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (_ids.size() == _amount)
+        {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_job>("slow")};
+    if (!_metrics)
+    {
+      TNCT_LOG_ERR(_logger, "no metrics");
+      return false;
+    }
+    TNCT_LOG_TST(_logger, format::bus::fmt(*_metrics));
+
+    std::lock_guard<std::mutex> _lock(_mutex);
+    if (_ids.size() != _amount)
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt("handled ", _ids.size()));
+      return false;
+    }
+    for (std::uint32_t _i = 0; _i < _amount; ++_i)
+    {
+      if (_ids[_i] != _i)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("job ", _ids[_i], " at ", _i));
+        return false;
+      }
+    }
+    return (_metrics->high_water_mark <= 2) && (_metrics->rejected == 0)
+           && (_metrics->dropped == 0);
+  }
+};
+
+struct coroutine_003
+{
+  static std::string desc()
+  {
+    return "A dispatcher is destroyed while coroutine handlers wait for the "
+           "replies to requests that are still in the queue of another "
+           "handling, and the coroutines finish with no reply";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::atomic_size_t _handled{0};
+    std::atomic_size_t _not_replied{0};
+
+    constexpr std::size_t                 _amount{20};
+    std::chrono::steady_clock::time_point _destroying;
+    {
+      coroutine_dispatcher _dispatcher(_logger);
+
+      auto _request_queue{request_double_queue::create(_logger, 32)};
+      if (!_request_queue)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if (_dispatcher.add_handling<request_double>(
+              "too slow", std::move(*_request_queue),
+              [](request_double &&p_request)
+              {
+                std::this_thread::sleep_for(100ms);
+                p_request.reply(p_request.get_event().id);
+              })
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error adding request handling");
+        return false;
+      }
+
+      auto _queue{job_queue::create(_logger, 32)};
+      if (!_queue)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if (_dispatcher.add_handling<event_job>(
+              "requester", std::move(*_queue),
+              [&](event_job &&p_event) -> async::dat::task<void>
+              {
+                if (!co_await _dispatcher.request<std::uint32_t>(
+                        event_job{p_event.id}))
+                {
+                  ++_not_replied;
+                }
+                ++_handled;
+              })
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error adding job handling");
+        return false;
+      }
+
+      for (std::uint32_t _i = 0; _i < _amount; ++_i)
+      {
+        if (_dispatcher.publish<event_job>(_i) != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+      }
+      std::this_thread::sleep_for(50ms);
+
+      _destroying = std::chrono::steady_clock::now();
+    }
+    const auto _elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _destroying)};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("destroyed in ", _elapsed.count(),
+                                  "ms, handled ", _handled.load(),
+                                  ", not replied ", _not_replied.load()));
+
+    return (_handled == _amount) && (_not_replied > 0) && (_elapsed < 1s);
+  }
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -6,12 +6,14 @@
 #ifndef TNCT_ASYNC_TST_CPT_TEST_H
 #define TNCT_ASYNC_TST_CPT_TEST_H
 
+#include <span>
 #include <string>
 
 #include "tnct/async/bus/dispatcher.h"
 #include "tnct/async/cpt/has_add_handling_method.h"
 #include "tnct/async/cpt/has_publish_method.h"
 #include "tnct/async/cpt/is_dispatcher.h"
+#include "tnct/async/cpt/is_batch_handler.h"
 #include "tnct/async/cpt/is_event.h"
 #include "tnct/async/cpt/is_handler.h"
 #include "tnct/async/dat/handling_priority.h"
@@ -55,15 +57,14 @@ struct cpt_event_001
 {
   static std::string desc()
   {
-    return "Verifies that a class that is not copy contructible is not "
-           "compatible with 'event";
+    return "Verifies that a class that is not copy contructible, but is move "
+           "constructible, is compatible with 'event";
   }
 
   bool operator()(const program::bus::options &)
   {
-    static_assert(
-        !async::cpt::is_event<event_a>,
-        "'event_a' is not compatible with async::cpt::event<event_a>");
+    static_assert(async::cpt::is_event<event_a>,
+                  "'event_a' is compatible with async::cpt::event<event_a>");
 
     return true;
   }
@@ -71,8 +72,16 @@ struct cpt_event_001
 private:
   struct event_a
   {
-    event_a()                = default;
-    event_a(const event_a &) = delete;
+    event_a()                           = default;
+    event_a(const event_a &)            = delete;
+    event_a(event_a &&)                 = default;
+    event_a &operator=(const event_a &) = delete;
+    event_a &operator=(event_a &&)      = default;
+
+    friend std::ostream &operator<<(std::ostream &p_out, const event_a &)
+    {
+      return p_out;
+    }
   };
 };
 
@@ -872,6 +881,43 @@ private:
   };
 };
 
+struct cpt_handler_006
+{
+  static std::string desc()
+  {
+    return "A 'handle' class that receives a 'std::span' of events is "
+           "conformant to async::cpt::is_batch_handler, but not to "
+           "async::cpt::is_handler";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    static_assert(async::cpt::is_batch_handler<handle, event>,
+                  "'handle' class is conformant to "
+                  "async::cpt::is_batch_handler");
+    static_assert(!async::cpt::is_handler<handle, event>,
+                  "'handle' class is not conformant to "
+                  "async::cpt::is_handler");
+    return true;
+  }
+
+private:
+  struct event
+  {
+    friend std::ostream &operator<<(std::ostream &p_out, const event &)
+    {
+      return p_out;
+    }
+  };
+
+  struct handle
+  {
+    void operator()(std::span<event>)
+    {
+    }
+  };
+};
+
 } // namespace tnct::async::tst
 #endif
 
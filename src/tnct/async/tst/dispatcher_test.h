@@ -6,13 +6,27 @@
 #ifndef TNCT_ASYNC_TST_DISPATCHER_TEST_H
 #define TNCT_ASYNC_TST_DISPATCHER_TEST_H
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "tnct/async/bus/dispatcher.h"
 #include "tnct/async/cpt/is_dispatcher.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/overflow_policy.h"
 #include "tnct/async/dat/result.h"
 #include "tnct/container/dat/circular_queue.h"
+#include "tnct/container/dat/coalescing_queue.h"
+#include "tnct/container/dat/mpmc_queue.h"
+#include "tnct/container/dat/multi_level_queue.h"
 #include "tnct/format/bus/fmt.h"
 #include "tnct/log/bus/cerr.h"
 #include "tnct/log/cpt/logger.h"
@@ -313,7 +327,7 @@ struct dispatcher_007
         return false;
       }
 
-      auto _result{_dispatcher.add_handling<event_1>(
+      async::dat::result _result{_dispatcher.add_handling<event_1>(
           "handling-007", std::move(*_queue_1a), std::move(_handler_1),
           async::dat::handling_priority::medium, 1)};
 
@@ -370,7 +384,7 @@ struct dispatcher_008
         return false;
       }
 
-      auto _result{_dispatcher.add_handling<event_1>(
+      async::dat::result _result{_dispatcher.add_handling<event_1>(
           "handling-008", std::move(*_queue_1), std::move(_handler_1),
           async::dat::handling_priority::medium, 1)};
 
@@ -483,6 +497,1261 @@ private:
   }
 };
 
+struct dispatcher_010
+{
+  static std::string desc()
+  {
+    return "Publishes 1000 events to a handling with 3 handlers that uses a "
+           "'container::dat::mpmc_queue', and checks that all were handled";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using mpmc_queue = container::dat::mpmc_queue<logger, event_1>;
+
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _handled{0};
+
+    auto _handler = [&](event_1 &&) mutable { ++_handled; };
+
+    auto _queue{mpmc_queue::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    async::dat::result _result{_dispatcher.add_handling<event_1>(
+        "handling-010", std::move(*_queue), std::move(_handler),
+        async::dat::handling_priority::medium, 3)};
+    if (_result != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt("dat::result = ", _result));
+      return false;
+    }
+
+    for (int16_t _i = 0; _i < m_amount; ++_i)
+    {
+      _result = _dispatcher.publish<event_1>(_i);
+      if (_result != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt(_result));
+        return false;
+      }
+    }
+
+    for (int _i = 0; (_i < 100) && (_handled < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(20ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _handled.load()));
+
+    return _handled == m_amount;
+  }
+
+private:
+  static constexpr int16_t m_amount{1000};
+};
+
+struct dispatcher_011
+{
+  static std::string desc()
+  {
+    return "Publishes a movable event to 3 handlings, and checks that it was "
+           "copied only twice";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using dispatcher = async::bus::dispatcher<logger, event_counted>;
+    using queue      = container::dat::circular_queue<logger, event_counted>;
+
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _handled{0};
+
+    auto _handler_a = [&](event_counted &&) mutable { ++_handled; };
+    auto _handler_b = [&](event_counted &&) mutable { ++_handled; };
+    auto _handler_c = [&](event_counted &&) mutable { ++_handled; };
+
+    auto _queue_a{queue::create(_logger, 10)};
+    auto _queue_b{queue::create(_logger, 10)};
+    auto _queue_c{queue::create(_logger, 10)};
+    if (!_queue_a || !_queue_b || !_queue_c)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if ((_dispatcher.add_handling<event_counted>(
+             "handling-011-a", std::move(*_queue_a), std::move(_handler_a))
+         != async::dat::result::OK)
+        || (_dispatcher.add_handling<event_counted>(
+                "handling-011-b", std::move(*_queue_b), std::move(_handler_b))
+            != async::dat::result::OK)
+        || (_dispatcher.add_handling<event_counted>(
+                "handling-011-c", std::move(*_queue_c), std::move(_handler_c))
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    event_counted::copies = 0;
+
+    if (_dispatcher.publish(event_counted{}) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+
+    for (int _i = 0; (_i < 100) && (_handled < 3); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _handled.load(),
+                                           ", copies = ",
+                                           event_counted::copies.load()));
+
+    return (_handled == 3) && (event_counted::copies == 2);
+  }
+
+private:
+  struct event_counted
+  {
+    event_counted() = default;
+    event_counted(const event_counted &)
+    {
+      ++copies;
+    }
+    event_counted(event_counted &&) = default;
+    event_counted &operator=(const event_counted &)
+    {
+      ++copies;
+      return *this;
+    }
+    event_counted &operator=(event_counted &&) = default;
+
+    friend std::ostream &operator<<(std::ostream &p_out, const event_counted &)
+    {
+      return p_out << "event_counted";
+    }
+
+    static inline std::atomic_size_t copies{0};
+  };
+};
+
+struct dispatcher_012
+{
+  static std::string desc()
+  {
+    return "Publishes a move-only event to one handling, which must succeed, "
+           "and then to two handlings, which must fail";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using dispatcher = async::bus::dispatcher<logger, event_move_only>;
+    using queue      = container::dat::circular_queue<logger, event_move_only>;
+
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::atomic_int _value{0};
+
+    auto _handler_a = [&](event_move_only &&p_event) mutable
+    { _value = *p_event.value; };
+
+    auto _queue_a{queue::create(_logger, 10)};
+    if (!_queue_a)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+    if (_dispatcher.add_handling<event_move_only>(
+            "handling-012-a", std::move(*_queue_a), std::move(_handler_a))
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    if (_dispatcher.publish<event_move_only>(std::make_unique<int>(12))
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing to one handling");
+      return false;
+    }
+
+    for (int _i = 0; (_i < 100) && (_value != 12); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+    if (_value != 12)
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt("value should be 12, but it is ",
+                                             _value.load()));
+      return false;
+    }
+
+    auto _handler_b = [&](event_move_only &&) mutable {};
+    auto _queue_b{queue::create(_logger, 10)};
+    if (!_queue_b)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+    if (_dispatcher.add_handling<event_move_only>(
+            "handling-012-b", std::move(*_queue_b), std::move(_handler_b))
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    return _dispatcher.publish(event_move_only{std::make_unique<int>(13)})
+           == async::dat::result::ERROR_PUBLISHNG;
+  }
+
+private:
+  struct event_move_only
+  {
+    event_move_only() = default;
+    event_move_only(std::unique_ptr<int> &&p_value) : value(std::move(p_value))
+    {
+    }
+    event_move_only(event_move_only &&)            = default;
+    event_move_only &operator=(event_move_only &&) = default;
+
+    friend std::ostream &operator<<(std::ostream          &p_out,
+                                    const event_move_only &p_event)
+    {
+      if (p_event.value)
+      {
+        p_out << *p_event.value;
+      }
+      return p_out;
+    }
+
+    std::unique_ptr<int> value;
+  };
+};
+
+struct dispatcher_013
+{
+  static std::string desc()
+  {
+    return "Publishes 1000 events in batches of 100 to a handling whose "
+           "handler receives batches of at most 16 events, and checks that all "
+           "were handled in order";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::vector<int16_t> _handled;
+    std::size_t          _max_batch{0};
+    std::atomic_size_t   _amount{0};
+
+    auto _handler = [&](std::span<event_1> p_events)
+    {
+      _max_batch = std::max(_max_batch, p_events.size());
+      for (const event_1 &_event : p_events)
+      {
+        _handled.push_back(_event.i);
+      }
+      _amount += p_events.size();
+    };
+
+    auto _queue{queue_1::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<event_1>(
+            "handling-013", std::move(*_queue), std::move(_handler),
+            async::dat::handling_priority::medium, 1, m_batch_size)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    std::vector<event_1> _events;
+    for (int16_t _i = 0; _i < m_amount; ++_i)
+    {
+      _events.push_back(event_1{_i});
+      if (_events.size() == 100)
+      {
+        if (_dispatcher.publish_batch<event_1>(_events)
+            != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+        _events.clear();
+      }
+    }
+
+    for (int _i = 0; (_i < 100) && (_amount < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(20ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _amount.load(),
+                                           ", biggest batch = ", _max_batch));
+
+    if ((_amount != m_amount) || (_max_batch > m_batch_size))
+    {
+      return false;
+    }
+
+    for (int16_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_handled[static_cast<std::size_t>(_i)] != _i)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("expected ", _i, ", but got ",
+                                               _handled[_i]));
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr int16_t     m_amount{1000};
+  static constexpr std::size_t m_batch_size{16};
+};
+
+struct dispatcher_014
+{
+  static std::string desc()
+  {
+    return "A handling with a batch handler, in a dispatcher that uses a "
+           "'work_stealing_pool', handles all the events published";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger                                 _logger;
+    async::bus::work_stealing_pool<logger> _pool(_logger, 2);
+
+    std::atomic_size_t _amount{0};
+
+    {
+      dispatcher _dispatcher(_logger, _pool);
+
+      auto _handler = [&](std::span<event_2> p_events)
+      { _amount += p_events.size(); };
+
+      auto _queue{queue_2::create(_logger, 64)};
+      if (!_queue)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if (_dispatcher.add_handling<event_2>(
+              "handling-014", std::move(*_queue), std::move(_handler),
+              async::dat::handling_priority::medium, 2, 8)
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error adding handling");
+        return false;
+      }
+
+      std::vector<event_2> _events(m_amount / 2);
+      if (_dispatcher.publish_batch<event_2>(_events) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+      for (std::size_t _i = 0; _i < (m_amount / 2); ++_i)
+      {
+        if (_dispatcher.publish<event_2>() != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+      }
+
+      for (int _i = 0; (_i < 100) && (_amount < m_amount); ++_i)
+      {
+        std::this_thread::sleep_for(20ms);
+      }
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _amount.load()));
+
+    return _amount == m_amount;
+  }
+
+private:
+  static constexpr std::size_t m_amount{2000};
+};
+
+// Handling of 'event_1' whose only handler waits for 'release' after receiving
+// the first event, so the events published after it stay in the queue
+struct overflow_handling
+{
+  overflow_handling(logger &p_logger, dispatcher &p_dispatcher,
+                    async::dat::overflow_policy p_policy)
+      : m_logger(p_logger), m_dispatcher(p_dispatcher)
+  {
+    auto _queue{queue_1::create(m_logger, 2)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(m_logger, "error creating queue");
+      return;
+    }
+
+    if (m_dispatcher.add_handling<event_1>(
+            "handling-overflow", std::move(*_queue),
+            [this](event_1 &&p_event)
+            {
+              m_started = true;
+              while (!m_released)
+              {
+                std::this_thread::sleep_for(1ms);
+              }
+              std::lock_guard<std::mutex> _lock(m_mutex);
+              m_values.push_back(p_event.i);
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(m_logger, "error adding handling");
+      return;
+    }
+
+    if (m_dispatcher.set_overflow_policy<event_1>("handling-overflow",
+                                                  p_policy, max_capacity)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(m_logger, "error setting overflow policy");
+      return;
+    }
+
+    // the handler holds the first event, and the queue is empty
+    if (m_dispatcher.publish<event_1>(int16_t{0}) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(m_logger, "error publishing");
+      return;
+    }
+    for (int _i = 0; (_i < 100) && !m_started; ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+    m_ok = m_started;
+  }
+
+  // Releases the handler, and returns the values of the events handled
+  std::vector<int16_t> release(std::size_t p_expected)
+  {
+    m_released = true;
+    for (int _i = 0; (_i < 100) && (values().size() < p_expected); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+    return values();
+  }
+
+  std::vector<int16_t> values()
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    return m_values;
+  }
+
+  operator bool() const
+  {
+    return m_ok;
+  }
+
+  static constexpr std::size_t max_capacity{3};
+
+private:
+  logger              &m_logger;
+  dispatcher          &m_dispatcher;
+  bool                 m_ok{false};
+  std::atomic_bool     m_started{false};
+  std::atomic_bool     m_released{false};
+  std::mutex           m_mutex;
+  std::vector<int16_t> m_values;
+};
+
+struct dispatcher_015
+{
+  static std::string desc()
+  {
+    return "A handling with 'overflow_policy::reject' and maximum capacity of "
+           "3 events returns 'ERROR_QUEUE_FULL' when an event is published "
+           "and there are 3 events in the queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    overflow_handling _handling(_logger, _dispatcher,
+                                async::dat::overflow_policy::reject);
+    if (!_handling)
+    {
+      return false;
+    }
+
+    for (int16_t _i = 1; _i <= 3; ++_i)
+    {
+      if (_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+
+    if (_dispatcher.publish<event_1>(int16_t{4})
+        != async::dat::result::ERROR_QUEUE_FULL)
+    {
+      TNCT_LOG_ERR(_logger, "event 4 should have been rejected");
+      _handling.release(4);
+      return false;
+    }
+
+    const std::vector<int16_t> _values{_handling.release(4)};
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _values.size()));
+
+    return _values == std::vector<int16_t>{0, 1, 2, 3};
+  }
+};
+
+struct dispatcher_016
+{
+  static std::string desc()
+  {
+    return "A handling with 'overflow_policy::drop_newest' and maximum "
+           "capacity of 3 events ignores the events published while there are "
+           "3 events in the queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    overflow_handling _handling(_logger, _dispatcher,
+                                async::dat::overflow_policy::drop_newest);
+    if (!_handling)
+    {
+      return false;
+    }
+
+    for (int16_t _i = 1; _i <= 5; ++_i)
+    {
+      if (_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        _handling.release(4);
+        return false;
+      }
+    }
+
+    const std::vector<int16_t> _values{_handling.release(4)};
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _values.size()));
+
+    return _values == std::vector<int16_t>{0, 1, 2, 3};
+  }
+};
+
+struct dispatcher_017
+{
+  static std::string desc()
+  {
+    return "A handling with 'overflow_policy::drop_oldest' and maximum "
+           "capacity of 3 events removes the oldest event in the queue when an "
+           "event is published while there are 3 events in the queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    overflow_handling _handling(_logger, _dispatcher,
+                                async::dat::overflow_policy::drop_oldest);
+    if (!_handling)
+    {
+      return false;
+    }
+
+    for (int16_t _i = 1; _i <= 5; ++_i)
+    {
+      if (_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        _handling.release(4);
+        return false;
+      }
+    }
+
+    const std::vector<int16_t> _values{_handling.release(4)};
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _values.size()));
+
+    return _values == std::vector<int16_t>{0, 3, 4, 5};
+  }
+};
+
+struct dispatcher_018
+{
+  static std::string desc()
+  {
+    return "A handling with 'overflow_policy::block' and maximum capacity of "
+           "3 events blocks the publisher while there are 3 events in the "
+           "queue, and no event is lost";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    overflow_handling _handling(_logger, _dispatcher,
+                                async::dat::overflow_policy::block);
+    if (!_handling)
+    {
+      return false;
+    }
+
+    std::atomic_bool _published{false};
+
+    std::thread _publisher(
+        [&]()
+        {
+          for (int16_t _i = 1; _i <= 5; ++_i)
+          {
+            if (_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+            {
+              TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+            }
+          }
+          _published = true;
+        });
+
+    std::this_thread::sleep_for(100ms);
+    const bool _blocked{!_published};
+
+    const std::vector<int16_t> _values{_handling.release(6)};
+    _publisher.join();
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("blocked = ", _blocked,
+                                           ", handled ", _values.size()));
+
+    return _blocked && (_values == std::vector<int16_t>{0, 1, 2, 3, 4, 5});
+  }
+};
+
+struct dispatcher_019
+{
+  static std::string desc()
+  {
+    return "An inline handling calls its handler in the publisher thread, "
+           "before 'publish' returns, and has no queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::thread::id      _handler_thread;
+    std::vector<int16_t> _values;
+
+    if (_dispatcher.add_inline_handling<event_1>(
+            "handling-019",
+            [&](event_1 &&p_event)
+            {
+              _handler_thread = std::this_thread::get_id();
+              _values.push_back(p_event.i);
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    for (int16_t _i = 0; _i < 10; ++_i)
+    {
+      if (_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+      if ((_values.size() != static_cast<std::size_t>(_i + 1))
+          || (_values.back() != _i))
+      {
+        TNCT_LOG_ERR(_logger,
+                     format::bus::fmt("event ", _i, " was not handled"));
+        return false;
+      }
+    }
+
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_1>("handling-019")};
+
+    return (_handler_thread == std::this_thread::get_id())
+           && (_dispatcher.get_events_capacity<event_1>("handling-019") == 0)
+           && _metrics && (_metrics->published == 10)
+           && (_metrics->handled == 10)
+           && (_metrics->handler_time.get_count() == 10);
+  }
+};
+
+struct dispatcher_020
+{
+  static std::string desc()
+  {
+    return "An inline handling with a batch handler and batch size of 4 "
+           "receives 10 events published with 'publish_batch' in calls with "
+           "4, 4 and 2 events";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::vector<std::size_t> _sizes;
+    std::vector<float>       _values;
+
+    if (_dispatcher.add_inline_handling<event_2>(
+            "handling-020",
+            [&](std::span<event_2> p_events)
+            {
+              _sizes.push_back(p_events.size());
+              for (const event_2 &_event : p_events)
+              {
+                _values.push_back(_event.f);
+              }
+            },
+            async::dat::handling_priority::medium, 4)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    std::vector<event_2> _events;
+    for (int _i = 0; _i < 10; ++_i)
+    {
+      _events.emplace_back(static_cast<float>(_i));
+    }
+
+    if (_dispatcher.publish_batch<event_2>(_events) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+
+    std::vector<float> _expected;
+    for (const event_2 &_event : _events)
+    {
+      _expected.push_back(_event.f);
+    }
+
+    return (_sizes == std::vector<std::size_t>{4, 4, 2})
+           && (_values == _expected);
+  }
+};
+
+struct dispatcher_021
+{
+  static std::string desc()
+  {
+    return "An event published to an inline handling, and to a handling with "
+           "a queue, is handled by both, and the inline handler is called "
+           "by 4 publisher threads";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _inline{0};
+    std::atomic_size_t _queued{0};
+
+    if (_dispatcher.add_inline_handling<event_1>(
+            "handling-021-inline", [&](event_1 &&) { ++_inline; },
+            async::dat::handling_priority::high)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding inline handling");
+      return false;
+    }
+
+    auto _queue{queue_1::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+    if (_dispatcher.add_handling<event_1>("handling-021-queued",
+                                          std::move(*_queue),
+                                          [&](event_1 &&) { ++_queued; })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    std::vector<std::thread> _publishers;
+    for (int _p = 0; _p < 4; ++_p)
+    {
+      _publishers.emplace_back(
+          [&]()
+          {
+            for (std::size_t _i = 0; _i < m_amount; ++_i)
+            {
+              if (_dispatcher.publish<event_1>() != async::dat::result::OK)
+              {
+                TNCT_LOG_ERR(_logger, "error publishing");
+              }
+            }
+          });
+    }
+    for (std::thread &_publisher : _publishers)
+    {
+      _publisher.join();
+    }
+
+    for (int _i = 0; (_i < 100) && (_queued < (4 * m_amount)); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("inline = ", _inline.load(),
+                                           ", queued = ", _queued.load()));
+
+    return (_inline == (4 * m_amount)) && (_queued == (4 * m_amount));
+  }
+
+private:
+  static constexpr std::size_t m_amount{1000};
+};
+
+struct dispatcher_022
+{
+  static std::string desc()
+  {
+    return "An urgent event published to a handling whose queue is a "
+           "'container::dat::multi_level_queue' is handled before the bulk "
+           "events already waiting in the queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    // negative events are urgent
+    struct level_of_event
+    {
+      std::size_t operator()(const event_1 &p_event) const
+      {
+        return p_event.i < 0 ? 0 : 1;
+      }
+    };
+
+    using queue =
+        container::dat::multi_level_queue<logger, event_1, level_of_event>;
+
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::optional<queue> _queue{
+        queue::create(_logger, level_of_event{}, 2, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    std::mutex           _mutex;
+    std::vector<int16_t> _handled;
+    std::atomic_bool     _started{false};
+    std::atomic_bool     _release{false};
+
+    if (_dispatcher.add_handling<event_1>(
+            "handling-022", std::move(*_queue),
+            [&](event_1 &&p_event)
+            {
+              _started = true;
+              while (!_release)
+              {
+                std::this_thread::sleep_for(1ms);
+              }
+              std::lock_guard<std::mutex> _lock(_mutex);
+              _handled.push_back(p_event.i);
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    // the handler holds the first event, so the others wait in the queue
+    if (_dispatcher.publish<event_1>(int16_t{0}) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+    while (!_started)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    for (int16_t _i = 1; _i <= m_bulk; ++_i)
+    {
+      if (_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+    }
+    if (_dispatcher.publish<event_1>(int16_t{-1}) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+
+    _release = true;
+
+    for (int _i = 0; _i < 100; ++_i)
+    {
+      {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (_handled.size() == static_cast<std::size_t>(m_bulk + 2))
+        {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+
+    std::lock_guard<std::mutex> _lock(_mutex);
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _handled.size(),
+                                           " events, the second is ",
+                                           _handled.size() > 1 ? _handled[1]
+                                                               : 0));
+
+    return (_handled.size() == static_cast<std::size_t>(m_bulk + 2))
+           && (_handled[0] == 0) && (_handled[1] == -1)
+           && std::is_sorted(_handled.begin() + 2, _handled.end());
+  }
+
+private:
+  static constexpr int16_t m_bulk{20};
+};
+
+struct dispatcher_023
+{
+  static std::string desc()
+  {
+    return "Events published to a handling whose queue is a "
+           "'container::dat::coalescing_queue' replace the ones with the same "
+           "key not handled yet, so only the latest of each key is handled";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    // the key of an event is its sign, so there are 2 keys
+    struct sign_of_event
+    {
+      bool operator()(const event_1 &p_event) const
+      {
+        return p_event.i < 0;
+      }
+    };
+
+    using queue =
+        container::dat::coalescing_queue<logger, event_1, sign_of_event>;
+
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::optional<queue> _queue{queue::create(_logger, sign_of_event{})};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    std::mutex           _mutex;
+    std::vector<int16_t> _handled;
+    std::atomic_bool     _started{false};
+    std::atomic_bool     _release{false};
+
+    if (_dispatcher.add_handling<event_1>(
+            "handling-023", std::move(*_queue),
+            [&](event_1 &&p_event)
+            {
+              _started = true;
+              while (!_release)
+              {
+                std::this_thread::sleep_for(1ms);
+              }
+              std::lock_guard<std::mutex> _lock(_mutex);
+              _handled.push_back(p_event.i);
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    // the handler holds the first event, so the others wait in the queue
+    if (_dispatcher.publish<event_1>(int16_t{0}) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+    while (!_started)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    for (int16_t _i = 1; _i <= m_amount; ++_i)
+    {
+      if ((_dispatcher.publish<event_1>(_i) != async::dat::result::OK)
+          || (_dispatcher.publish<event_1>(static_cast<int16_t>(-_i))
+              != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+    }
+
+    if (_dispatcher.get_num_events<event_1>("handling-023")
+        != std::optional<std::size_t>{2})
+    {
+      TNCT_LOG_ERR(_logger, "there should be 2 events in the queue");
+      return false;
+    }
+
+    _release = true;
+
+    for (int _i = 0; _i < 100; ++_i)
+    {
+      {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (_handled.size() == 3)
+        {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_1>("handling-023")};
+
+    std::lock_guard<std::mutex> _lock(_mutex);
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _handled.size(),
+                                           " events, metrics = ",
+                                           *_metrics));
+
+    return (_handled == std::vector<int16_t>{0, m_amount, -m_amount})
+           && (_metrics->published == ((2 * m_amount) + 1))
+           && (_metrics->coalesced == ((2 * m_amount) - 2))
+           && (_metrics->handled == 3) && (_metrics->queued == 0);
+  }
+
+private:
+  static constexpr int16_t m_amount{50};
+};
+
+struct dispatcher_024
+{
+  static std::string desc()
+  {
+    return "When a handling whose queue is a "
+           "'container::dat::multi_level_queue' is full, and its policy is "
+           "'drop_oldest', the bulk events are discarded, and not the urgent "
+           "one, and the enqueue to dequeue time of each event handled is "
+           "recorded";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    // negative events are urgent
+    struct level_of_event
+    {
+      std::size_t operator()(const event_1 &p_event) const
+      {
+        return p_event.i < 0 ? 0 : 1;
+      }
+    };
+
+    using queue =
+        container::dat::multi_level_queue<logger, event_1, level_of_event>;
+
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::optional<queue> _queue{
+        queue::create(_logger, level_of_event{}, 2, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    std::mutex           _mutex;
+    std::vector<int16_t> _handled;
+    std::atomic_bool     _started{false};
+    std::atomic_bool     _release{false};
+
+    if ((_dispatcher.add_handling<event_1>(
+             "handling-024", std::move(*_queue),
+             [&](event_1 &&p_event)
+             {
+               _started = true;
+               while (!_release)
+               {
+                 std::this_thread::sleep_for(1ms);
+               }
+               std::lock_guard<std::mutex> _lock(_mutex);
+               _handled.push_back(p_event.i);
+             })
+         != async::dat::result::OK)
+        || (_dispatcher.set_overflow_policy<event_1>(
+                "handling-024", async::dat::overflow_policy::drop_oldest,
+                m_capacity)
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    // the handler holds the first event, so the others wait in the queue
+    if (_dispatcher.publish<event_1>(int16_t{0}) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      _release = true;
+      return false;
+    }
+    while (!_started)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    // the urgent event is the oldest in the queue, and it is kept while the
+    // bulk events 1, 2 and 3 are discarded to make room for 4, 5 and 6
+    bool _published{_dispatcher.publish<event_1>(int16_t{-1})
+                    == async::dat::result::OK};
+    for (int16_t _i = 1; _published && (_i <= m_bulk); ++_i)
+    {
+      _published = (_dispatcher.publish<event_1>(_i) == async::dat::result::OK);
+    }
+
+    _release = true;
+    if (!_published)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+
+    const std::vector<int16_t> _expected{0, -1, 4, 5, 6};
+    for (int _i = 0; _i < 100; ++_i)
+    {
+      {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (_handled.size() == _expected.size())
+        {
+          break;
+        }
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+
+    // the queue does not pop in the order of the pushes, but each event
+    // carries the moment it was pushed, so the time in the queue is recorded
+    // for each event handled
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_1>("handling-024")};
+
+    std::lock_guard<std::mutex> _lock(_mutex);
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled ", _handled.size(),
+                                           " events, the second is ",
+                                           _handled.size() > 1 ? _handled[1]
+                                                               : 0));
+
+    return (_handled == _expected) && _metrics
+           && (_metrics->enqueue_to_dequeue.get_count() == _expected.size());
+  }
+
+private:
+  static constexpr std::size_t m_capacity{4};
+  static constexpr int16_t     m_bulk{6};
+};
+
+struct dispatcher_025
+{
+  static std::string desc()
+  {
+    return "An exception raised by the handler of an inline handling does not "
+           "reach the publisher, the handling after it still receives the "
+           "event, and 'publish' returns 'ERROR_HANDLING'";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    logger     _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::vector<int16_t> _values;
+
+    if ((_dispatcher.add_inline_handling<event_1>(
+             "handling-025-throws",
+             [](event_1 &&) { throw std::runtime_error("handler failed"); },
+             async::dat::handling_priority::high)
+         != async::dat::result::OK)
+        || (_dispatcher.add_inline_handling<event_1>(
+                "handling-025",
+                [&](event_1 &&p_event) { _values.push_back(p_event.i); },
+                async::dat::handling_priority::low)
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    async::dat::result _result{async::dat::result::OK};
+    try
+    {
+      _result = _dispatcher.publish<event_1>(int16_t{25});
+    }
+    catch (...)
+    {
+      TNCT_LOG_ERR(_logger, "the exception reached the publisher");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("result = ", _result, ", handled ",
+                                           _values.size()));
+
+    return (_result == async::dat::result::ERROR_HANDLING)
+           && (_values == std::vector<int16_t>{25});
+  }
+};
+
 } // namespace tnct::async::tst
 
 #endif
@@ -0,0 +1,393 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_EVENT_POOL_TEST_H
+#define TNCT_ASYNC_TST_EVENT_POOL_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/sleep_for.h"
+#include "tnct/async/cpt/is_pmr_event.h"
+#include "tnct/async/dat/event_pool.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/dat/task.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_text
+{
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+  event_text(std::string_view p_text = {}, allocator_type p_allocator = {})
+      : text(p_text, p_allocator)
+  {
+  }
+
+  event_text(const event_text &p_event, allocator_type p_allocator = {})
+      : text(p_event.text, p_allocator)
+  {
+  }
+
+  event_text(event_text &&p_event, allocator_type p_allocator)
+      : text(std::move(p_event.text), p_allocator)
+  {
+  }
+
+  event_text(event_text &&p_event) noexcept = default;
+
+  event_text &operator=(const event_text &) = default;
+  event_text &operator=(event_text &&)      = default;
+
+  [[nodiscard]] allocator_type get_allocator() const
+  {
+    return text.get_allocator();
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out, const event_text &p_event)
+  {
+    p_out << "text with " << p_event.text.size() << " chars";
+    return p_out;
+  }
+
+  std::pmr::string text;
+};
+
+static_assert(async::cpt::is_pmr_event<event_text>);
+
+// Counts the bytes requested to it, which is the upstream of the pools
+class counting_resource final : public std::pmr::memory_resource
+{
+public:
+  [[nodiscard]] std::size_t get_allocated() const
+  {
+    return m_allocated;
+  }
+
+private:
+  void *do_allocate(std::size_t p_bytes, std::size_t p_alignment) override
+  {
+    m_allocated += p_bytes;
+    return std::pmr::new_delete_resource()->allocate(p_bytes, p_alignment);
+  }
+
+  void do_deallocate(void *p_block, std::size_t p_bytes,
+                     std::size_t p_alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(p_block, p_bytes, p_alignment);
+  }
+
+  [[nodiscard]] bool
+  do_is_equal(const std::pmr::memory_resource &p_other) const noexcept override
+  {
+    return this == &p_other;
+  }
+
+private:
+  std::atomic_size_t m_allocated{0};
+};
+
+using text_dispatcher = async::bus::dispatcher<log::cerr, event_text>;
+
+using text_queue = container::dat::circular_queue<log::cerr, event_text>;
+
+struct event_pool_000
+{
+  static std::string desc()
+  {
+    return "Events published to a handling with an event pool are copied to "
+           "it, and the memory of the handled events is reused, so the pool "
+           "requests much less memory than the events use";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    counting_resource _upstream;
+
+    std::atomic_size_t _handled{0};
+    std::atomic_size_t _out_of_pool{0};
+
+    text_dispatcher _dispatcher(_logger);
+
+    auto _queue{text_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    std::pmr::memory_resource *_pool{nullptr};
+    if (_dispatcher.add_handling<event_text>(
+            "pooled", std::move(*_queue),
+            [&](event_text &&p_event)
+            {
+              if (p_event.get_allocator().resource() != _pool)
+              {
+                ++_out_of_pool;
+              }
+              ++_handled;
+            },
+            async::dat::event_pool{.upstream = &_upstream})
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    _pool = _dispatcher.get_event_pool<event_text>("pooled");
+    if (_pool == nullptr)
+    {
+      TNCT_LOG_ERR(_logger, "handling has no event pool");
+      return false;
+    }
+
+    const std::string _text(m_text_size, 'x');
+    for (std::size_t _round = 0; _round < m_rounds; ++_round)
+    {
+      for (std::size_t _i = 0; _i < m_per_round; ++_i)
+      {
+        const event_text _event{_text};
+        if (_dispatcher.publish(_event) != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+      }
+      for (int _i = 0;
+           (_i < 200) && (_handled < ((_round + 1) * m_per_round)); ++_i)
+      {
+        std::this_thread::sleep_for(1ms);
+      }
+    }
+
+    const std::size_t _used{m_rounds * m_per_round * m_text_size};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("handled = ", _handled.load(),
+                                  ", out of pool = ", _out_of_pool.load(),
+                                  ", bytes used by the events = ", _used,
+                                  ", bytes requested by the pool = ",
+                                  _upstream.get_allocated()));
+
+    return (_handled == (m_rounds * m_per_round)) && (_out_of_pool == 0)
+           && (_upstream.get_allocated() < (_used / 10));
+  }
+
+private:
+  static constexpr std::size_t m_rounds{100};
+  static constexpr std::size_t m_per_round{10};
+  static constexpr std::size_t m_text_size{512};
+};
+
+struct event_pool_001
+{
+  static std::string desc()
+  {
+    return "An event built with the memory of the handling is moved to it "
+           "with no copy, and a handling with no event pool has no memory";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::atomic<const char *> _handled_text{nullptr};
+
+    text_dispatcher _dispatcher(_logger);
+    text_dispatcher _plain_dispatcher(_logger);
+
+    auto _pooled_queue{text_queue::create(_logger, 16)};
+    auto _plain_queue{text_queue::create(_logger, 16)};
+    if (!_pooled_queue || !_plain_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queues");
+      return false;
+    }
+
+    if ((_dispatcher.add_handling<event_text>(
+             "pooled", std::move(*_pooled_queue),
+             [&](event_text &&p_event)
+             { _handled_text = p_event.text.data(); },
+             async::dat::event_pool{})
+         != async::dat::result::OK)
+        || (_plain_dispatcher.add_handling<event_text>(
+                "plain", std::move(*_plain_queue), [](event_text &&) {})
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    if (_plain_dispatcher.get_event_pool<event_text>("plain") != nullptr)
+    {
+      TNCT_LOG_ERR(_logger, "handling 'plain' should have no event pool");
+      return false;
+    }
+
+    std::pmr::memory_resource *_pool{
+        _dispatcher.get_event_pool<event_text>("pooled")};
+    if (_pool == nullptr)
+    {
+      TNCT_LOG_ERR(_logger, "handling 'pooled' has no event pool");
+      return false;
+    }
+
+    // long enough not to be kept inside the string
+    event_text  _event{std::string(256, 'y'),
+                      event_text::allocator_type{_pool}};
+    const char *_text{_event.text.data()};
+
+    if (_dispatcher.publish(std::move(_event)) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+    for (int _i = 0; (_i < 200) && (_handled_text == nullptr); ++_i)
+    {
+      std::this_thread::sleep_for(1ms);
+    }
+
+    return _handled_text == _text;
+  }
+};
+
+// Takes a while to release its memory, so a pool destroyed before that is
+// noticed
+struct event_slow_text
+{
+  using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+  event_slow_text(std::string_view p_text = {}, allocator_type p_allocator = {})
+      : text(p_text, p_allocator)
+  {
+  }
+
+  event_slow_text(const event_slow_text &p_event,
+                  allocator_type         p_allocator = {})
+      : text(p_event.text, p_allocator)
+  {
+  }
+
+  event_slow_text(event_slow_text &&p_event, allocator_type p_allocator)
+      : text(std::move(p_event.text), p_allocator)
+  {
+  }
+
+  event_slow_text(event_slow_text &&p_event) noexcept = default;
+
+  event_slow_text &operator=(const event_slow_text &) = default;
+  event_slow_text &operator=(event_slow_text &&)      = default;
+
+  ~event_slow_text()
+  {
+    if (!text.empty())
+    {
+      std::this_thread::sleep_for(2ms);
+    }
+  }
+
+  [[nodiscard]] allocator_type get_allocator() const
+  {
+    return text.get_allocator();
+  }
+
+  friend std::ostream &operator<<(std::ostream          &p_out,
+                                  const event_slow_text &p_event)
+  {
+    p_out << "slow text with " << p_event.text.size() << " chars";
+    return p_out;
+  }
+
+  std::pmr::string text;
+};
+
+static_assert(async::cpt::is_pmr_event<event_slow_text>);
+
+struct event_pool_002
+{
+  static std::string desc()
+  {
+    return "A dispatcher destroyed just after the coroutines of a handling "
+           "with an event pool handle their events waits for the events to "
+           "release their memory before the pool is destroyed";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    using dispatcher = async::bus::dispatcher<log::cerr, event_slow_text>;
+    using queue = container::dat::circular_queue<log::cerr, event_slow_text>;
+
+    std::atomic_size_t _handled{0};
+
+    for (std::size_t _i = 0; _i < m_amount; ++_i)
+    {
+      dispatcher _dispatcher(_logger);
+
+      auto _queue{queue::create(_logger, 16)};
+      if (!_queue)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if (_dispatcher.add_handling<event_slow_text>(
+              "pooled", std::move(*_queue),
+              [&](event_slow_text &&) -> async::dat::task<void>
+              {
+                co_await async::bus::sleep_for(1ms);
+                ++_handled;
+              },
+              async::dat::event_pool{})
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error adding handling");
+        return false;
+      }
+
+      // long enough not to be kept inside the string
+      if (_dispatcher.publish(event_slow_text{std::string(256, 'z')})
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+      for (int _j = 0; (_j < 200) && (_handled <= _i); ++_j)
+      {
+        std::this_thread::sleep_for(1ms);
+      }
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled = ", _handled.load()));
+
+    return _handled == m_amount;
+  }
+
+private:
+  static constexpr std::size_t m_amount{20};
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -0,0 +1,229 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_EXEC_SYNC_TEST_H
+#define TNCT_ASYNC_TST_EXEC_SYNC_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "tnct/async/bus/exec_sync.h"
+#include "tnct/async/internal/bus/exec_pool.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct exec_sync_000
+{
+  static std::string desc()
+  {
+    return "1000 calls to 'exec_sync', one after the other, return the value "
+           "of the function, and reuse the same thread";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    auto _function = [](std::stop_token, int16_t p_i) -> int16_t
+    { return static_cast<int16_t>(p_i * 2); };
+
+    std::thread::id _thread;
+    auto _where = [&_thread](std::stop_token) -> void
+    { _thread = std::this_thread::get_id(); };
+
+    if (!async::exec_sync(1s, _where))
+    {
+      TNCT_LOG_ERR(_logger, "first call timed out");
+      return false;
+    }
+    const std::thread::id _first{_thread};
+
+    for (int16_t _i = 0; _i < 1000; ++_i)
+    {
+      const std::optional<int16_t> _maybe{async::exec_sync(1s, _function, _i)};
+      if (!_maybe || (*_maybe != (_i * 2)))
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("wrong result for ", _i));
+        return false;
+      }
+    }
+
+    if (!async::exec_sync(1s, _where))
+    {
+      TNCT_LOG_ERR(_logger, "last call timed out");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("threads in the pool = ",
+                                  internal::bus::exec_pool::shared()
+                                      .get_num_threads()));
+
+    return _thread == _first;
+  }
+};
+
+struct exec_sync_001
+{
+  static std::string desc()
+  {
+    return "A function that would take 10s, but waits on the 'stop_token', "
+           "returns as soon as 'exec_sync' times out after 100ms";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    bool _stopped{false};
+    auto _function = [&_stopped](std::stop_token p_stop) -> void
+    {
+      std::mutex                   _mutex;
+      std::condition_variable_any  _cond;
+      std::unique_lock<std::mutex> _lock{_mutex};
+      _cond.wait_for(_lock, p_stop, 10s, []() { return false; });
+      _stopped = p_stop.stop_requested();
+    };
+
+    const auto _start{std::chrono::steady_clock::now()};
+    const bool _in_time{async::exec_sync(100ms, _function)};
+    const auto _elapsed{std::chrono::steady_clock::now() - _start};
+
+    TNCT_LOG_TST(
+        _logger,
+        format::bus::fmt(
+            "in time = ", _in_time, ", stopped = ", _stopped, ", elapsed = ",
+            std::chrono::duration_cast<std::chrono::milliseconds>(_elapsed)
+                .count(),
+            "ms"));
+
+    return !_in_time && _stopped && (_elapsed < 1s);
+  }
+};
+
+struct exec_sync_002
+{
+  static std::string desc()
+  {
+    return "A function with the old 'std::function<bool()>' timeout parameter "
+           "sees it 'true' after 'exec_sync' times out, and an exception "
+           "thrown by a function is rethrown by 'exec_sync'";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    auto _function = [](std::function<bool()> p_timeout) -> int16_t
+    {
+      while (!p_timeout())
+      {
+        std::this_thread::sleep_for(1ms);
+      }
+      return -1;
+    };
+
+    if (async::exec_sync(50ms, _function).has_value())
+    {
+      TNCT_LOG_ERR(_logger, "function should have timed out");
+      return false;
+    }
+
+    auto _thrower = [](std::stop_token) -> void
+    { throw std::runtime_error("thrown"); };
+
+    try
+    {
+      const bool _in_time{async::exec_sync(1s, _thrower)};
+      TNCT_LOG_ERR(_logger,
+                   format::bus::fmt("no exception, in time = ", _in_time));
+      return false;
+    }
+    catch (std::runtime_error &_ex)
+    {
+      TNCT_LOG_TST(_logger, format::bus::fmt("exception: ", _ex.what()));
+      return std::string{_ex.what()} == "thrown";
+    }
+  }
+};
+
+struct exec_sync_003
+{
+  static std::string desc()
+  {
+    return "An 'exec_pool' creates a thread for each of 8 functions running at "
+           "the same time, and the threads finish after being idle for "
+           "longer than 100ms, and new ones are created for a new function";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                _logger;
+    internal::bus::exec_pool _pool(100ms);
+
+    std::atomic_bool   _release{false};
+    std::atomic_size_t _done{0};
+
+    for (std::size_t _i = 0; _i < m_amount; ++_i)
+    {
+      _pool.run(
+          [&]()
+          {
+            while (!_release)
+            {
+              std::this_thread::sleep_for(1ms);
+            }
+          },
+          [&]() { ++_done; });
+    }
+
+    const std::size_t _busy{_pool.get_num_threads()};
+    _release = true;
+
+    for (int _i = 0; (_i < 200) && (_pool.get_num_threads() != 0); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+    const std::size_t _idle{_pool.get_num_threads()};
+
+    std::atomic_bool _ran{false};
+    _pool.run([&]() { _ran = true; }, [&]() { ++_done; });
+    for (int _i = 0; (_i < 100) && (_done != (m_amount + 1)); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("busy threads = ", _busy,
+                                           ", idle threads = ", _idle,
+                                           ", done = ", _done.load()));
+
+    return (_busy == m_amount) && (_idle == 0) && _ran
+           && (_done == (m_amount + 1));
+  }
+
+private:
+  static constexpr std::size_t m_amount{8};
+};
+
+} // namespace tnct::async::tst
+
+#endif
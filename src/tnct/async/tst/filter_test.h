@@ -0,0 +1,362 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_FILTER_TEST_H
+#define TNCT_ASYNC_TST_FILTER_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/sync_wait.h"
+#include "tnct/async/cpt/is_event_filter.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/dat/task.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_quote
+{
+  event_quote(std::uint16_t p_symbol = 0, std::uint32_t p_price = 0)
+      : symbol(p_symbol), price(p_price)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out,
+                                  const event_quote &p_event)
+  {
+    p_out << '(' << p_event.symbol << ',' << p_event.price << ')';
+    return p_out;
+  }
+
+  std::uint16_t symbol;
+  std::uint32_t price;
+};
+
+// A quote that can not be copied
+struct event_quote_move_only
+{
+  event_quote_move_only(std::uint16_t p_symbol = 0)
+      : symbol(std::make_unique<std::uint16_t>(p_symbol))
+  {
+  }
+
+  event_quote_move_only(const event_quote_move_only &)            = delete;
+  event_quote_move_only(event_quote_move_only &&)                 = default;
+  event_quote_move_only &operator=(const event_quote_move_only &) = delete;
+  event_quote_move_only &operator=(event_quote_move_only &&)      = default;
+
+  friend std::ostream &operator<<(std::ostream                &p_out,
+                                  const event_quote_move_only &p_event)
+  {
+    p_out << '(' << (p_event.symbol ? *p_event.symbol : 0) << ')';
+    return p_out;
+  }
+
+  std::unique_ptr<std::uint16_t> symbol;
+};
+
+// Accepts the quotes of one symbol
+struct quote_of
+{
+  bool operator()(const event_quote &p_event) const
+  {
+    return p_event.symbol == symbol;
+  }
+
+  std::uint16_t symbol;
+};
+
+using quotes_dispatcher =
+    async::bus::dispatcher<log::cerr, event_quote, event_quote_move_only>;
+
+using quotes_queue = container::dat::circular_queue<log::cerr, event_quote>;
+
+struct filter_000
+{
+  static std::string desc()
+  {
+    return "Each of 3 handlings with a filter receives only the quotes of its "
+           "symbol, published one at a time and in a batch, while a handling "
+           "with no filter receives all of them";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    static_assert(async::cpt::is_event_filter<quote_of, event_quote>);
+
+    log::cerr         _logger;
+    quotes_dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _wrong{0};
+    std::atomic_size_t _all{0};
+
+    // as a handler can be used in only one handling, each symbol has its own
+    // handler type
+    auto _add{[&]<std::uint16_t t_symbol>(async::dat::handling_name p_name,
+                                           std::atomic_size_t &p_counter)
+              {
+                auto _queue{quotes_queue::create(_logger, 64)};
+                if (!_queue)
+                {
+                  return false;
+                }
+                return _dispatcher.add_handling<event_quote>(
+                           p_name, std::move(*_queue),
+                           [&](event_quote &&p_event)
+                           {
+                             if (p_event.symbol != t_symbol)
+                             {
+                               ++_wrong;
+                             }
+                             ++p_counter;
+                           },
+                           quote_of{t_symbol})
+                       == async::dat::result::OK;
+              }};
+
+    std::atomic_size_t _counters[m_symbols];
+    for (std::atomic_size_t &_counter : _counters)
+    {
+      _counter = 0;
+    }
+
+    if (!_add.template operator()<0>("symbol-0", _counters[0])
+        || !_add.template operator()<1>("symbol-1", _counters[1])
+        || !_add.template operator()<2>("symbol-2", _counters[2]))
+    {
+      TNCT_LOG_ERR(_logger, "error adding filtered handling");
+      return false;
+    }
+
+    auto _queue{quotes_queue::create(_logger, 64)};
+    if (!_queue
+        || (_dispatcher.add_handling<event_quote>(
+                "all", std::move(*_queue), [&](event_quote &&) { ++_all; })
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    std::vector<event_quote> _batch;
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      const event_quote _quote(static_cast<std::uint16_t>(_i % m_symbols), _i);
+      if ((_dispatcher.publish(_quote) != async::dat::result::OK)
+          || (_dispatcher.publish<event_quote>(_quote.symbol, _i)
+              != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+      _batch.push_back(_quote);
+    }
+    if (_dispatcher.publish_batch(std::span<const event_quote>{_batch})
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing batch");
+      return false;
+    }
+
+    constexpr std::size_t _per_symbol{(3 * m_amount) / m_symbols};
+    for (int _i = 0; (_i < 200) && (_all < (3 * m_amount)); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+    for (int _i = 0; (_i < 200)
+                     && ((_counters[0] < _per_symbol)
+                         || (_counters[1] < _per_symbol)
+                         || (_counters[2] < _per_symbol));
+         ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_quote>("symbol-1")};
+    if (!_metrics)
+    {
+      TNCT_LOG_ERR(_logger, "no metrics");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("all = ", _all.load(), ", symbols = ",
+                                  _counters[0].load(), ", ",
+                                  _counters[1].load(), ", ",
+                                  _counters[2].load(),
+                                  ", metrics of symbol-1 = ", *_metrics));
+
+    return (_wrong == 0) && (_all == (3 * m_amount))
+           && (_counters[0] == _per_symbol) && (_counters[1] == _per_symbol)
+           && (_counters[2] == _per_symbol)
+           && (_metrics->published == _per_symbol)
+           && (_metrics->filtered == ((3 * m_amount) - _per_symbol));
+  }
+
+private:
+  static constexpr std::size_t   m_symbols{3};
+  static constexpr std::uint32_t m_amount{300};
+};
+
+struct filter_001
+{
+  static std::string desc()
+  {
+    return "An event that can not be copied can be published to many "
+           "handlings, if only one of them accepts it";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue =
+        container::dat::circular_queue<log::cerr, event_quote_move_only>;
+
+    log::cerr         _logger;
+    quotes_dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _even{0};
+    std::atomic_size_t _odd{0};
+
+    auto _is_even{[](const event_quote_move_only &p_event)
+                  { return (*p_event.symbol % 2) == 0; }};
+    auto _is_odd{[](const event_quote_move_only &p_event)
+                 { return (*p_event.symbol % 2) == 1; }};
+
+    auto _queue_even{queue::create(_logger, 16)};
+    auto _queue_odd{queue::create(_logger, 16)};
+    if (!_queue_even || !_queue_odd)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queues");
+      return false;
+    }
+
+    if ((_dispatcher.add_handling<event_quote_move_only>(
+             "even", std::move(*_queue_even),
+             [&](event_quote_move_only &&) { ++_even; }, std::move(_is_even))
+         != async::dat::result::OK)
+        || (_dispatcher.add_handling<event_quote_move_only>(
+                "odd", std::move(*_queue_odd),
+                [&](event_quote_move_only &&) { ++_odd; }, std::move(_is_odd))
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    for (std::uint16_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish(event_quote_move_only{_i})
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+
+    for (int _i = 0; (_i < 200) && ((_even + _odd) < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("even = ", _even.load(),
+                                           ", odd = ", _odd.load()));
+
+    return (_even == (m_amount / 2)) && (_odd == (m_amount / 2));
+  }
+
+private:
+  static constexpr std::uint16_t m_amount{100};
+};
+
+struct filter_002
+{
+  static std::string desc()
+  {
+    return "A quote published by 'async_publish' is added only to the "
+           "handlings whose filter accepts it";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr         _logger;
+    quotes_dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _zero{0};
+    std::atomic_size_t _one{0};
+
+    auto _queue_zero{quotes_queue::create(_logger, 16)};
+    auto _queue_one{quotes_queue::create(_logger, 16)};
+    if (!_queue_zero || !_queue_one)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queues");
+      return false;
+    }
+
+    if ((_dispatcher.add_handling<event_quote>(
+             "zero", std::move(*_queue_zero),
+             [&](event_quote &&) { ++_zero; }, quote_of{0})
+         != async::dat::result::OK)
+        || (_dispatcher.add_handling<event_quote>(
+                "one", std::move(*_queue_one), [&](event_quote &&) { ++_one; },
+                quote_of{1})
+            != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    auto _publisher{[&]() -> async::dat::task<std::size_t>
+                    {
+                      std::size_t _ok{0};
+                      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+                      {
+                        if (co_await _dispatcher.async_publish(event_quote{
+                                static_cast<std::uint16_t>(_i % 3), _i})
+                            == async::dat::result::OK)
+                        {
+                          ++_ok;
+                        }
+                      }
+                      co_return _ok;
+                    }};
+
+    const std::size_t _published{async::bus::sync_wait(_publisher())};
+
+    for (int _i = 0; (_i < 200) && ((_zero + _one) < 20); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("published = ", _published,
+                                           ", zero = ", _zero.load(),
+                                           ", one = ", _one.load()));
+
+    return (_published == m_amount) && (_zero == 10) && (_one == 10);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{30};
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -0,0 +1,329 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_HANDLE_TEST_H
+#define TNCT_ASYNC_TST_HANDLE_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/dat/autoscaling.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_gauge
+{
+  event_gauge(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream      &p_out,
+                                  const event_gauge &p_event)
+  {
+    p_out << "gauge " << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+using gauge_dispatcher = async::bus::dispatcher<log::cerr, event_gauge>;
+
+using gauge_queue = container::dat::circular_queue<log::cerr, event_gauge>;
+
+using gauge_handle = gauge_dispatcher::handle<event_gauge>;
+
+struct handle_000
+{
+  static std::string desc()
+  {
+    return "The amount of events in the queue of a handling, and its capacity, "
+           "read with the handle returned by 'add_handling', are the same "
+           "read with its name, and 'clear' with the handle empties the queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr        _logger;
+    gauge_dispatcher _dispatcher(_logger);
+
+    std::atomic_bool _released{false};
+
+    auto _queue{gauge_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    const gauge_handle _handle{_dispatcher.add_handling<event_gauge>(
+        "gauge", std::move(*_queue),
+        [&](event_gauge &&) { _released.wait(false); })};
+    if ((_handle != async::dat::result::OK) || !_handle.is_valid())
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt("error adding handling: ",
+                                             _handle));
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_gauge>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+    // the handler takes one event, and blocks
+    std::this_thread::sleep_for(50ms);
+
+    const std::optional<std::size_t> _by_handle{
+        _dispatcher.get_num_events(_handle)};
+    const std::optional<std::size_t> _by_name{
+        _dispatcher.get_num_events<event_gauge>("gauge")};
+    const std::optional<std::size_t> _capacity{
+        _dispatcher.get_events_capacity(_handle)};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("by handle = ", _by_handle.value_or(0),
+                                  ", by name = ", _by_name.value_or(0),
+                                  ", capacity = ", _capacity.value_or(0)));
+
+    const bool _cleared{_dispatcher.clear(_handle) == async::dat::result::OK};
+    const std::optional<std::size_t> _after_clear{
+        _dispatcher.get_num_events(_handle)};
+
+    _released = true;
+    _released.notify_all();
+
+    return _by_handle && (*_by_handle == (m_amount - 1))
+           && (_by_handle == _by_name) && _capacity
+           && (_capacity
+               == _dispatcher.get_events_capacity<event_gauge>("gauge"))
+           && _cleared && _after_clear && (*_after_clear == 0);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{10};
+};
+
+struct handle_001
+{
+  static std::string desc()
+  {
+    return "After a handling is stopped with its handle, the events published "
+           "are handled only by the other handling, and publishing does not "
+           "fail";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr        _logger;
+    gauge_dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _handled_0{0};
+    std::atomic_size_t _handled_1{0};
+
+    auto _queue_0{gauge_queue::create(_logger, 16)};
+    auto _queue_1{gauge_queue::create(_logger, 16)};
+    if (!_queue_0 || !_queue_1)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queues");
+      return false;
+    }
+
+    const gauge_handle _handle_0{_dispatcher.add_handling<event_gauge>(
+        "gauge-0", std::move(*_queue_0),
+        [&](event_gauge &&) { ++_handled_0; })};
+    const gauge_handle _handle_1{_dispatcher.add_handling<event_gauge>(
+        "gauge-1", std::move(*_queue_1),
+        [&](event_gauge &&) { ++_handled_1; })};
+    if (!_handle_0.is_valid() || !_handle_1.is_valid())
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    if (_dispatcher.stop(_handle_0) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error stopping 'gauge-0'");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_gauge>(_i) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+
+    for (int _i = 0; (_i < 200) && (_handled_1 < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::optional<std::size_t> _queued_0{
+        _dispatcher.get_num_events(_handle_0)};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("handled 0 = ", _handled_0.load(),
+                                  ", handled 1 = ", _handled_1.load(),
+                                  ", queued 0 = ", _queued_0.value_or(0)));
+
+    return (_handled_0 == 0) && (_handled_1 == m_amount) && _queued_0
+           && (*_queued_0 == 0);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{20};
+};
+
+struct handle_002
+{
+  static std::string desc()
+  {
+    return "'increment_handlers' with a handle adds handlers to a handling "
+           "with an autoscaling policy up to its maximum, and fails for a "
+           "handling without one, or for a handle of another dispatcher";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr        _logger;
+    gauge_dispatcher _dispatcher(_logger);
+    gauge_dispatcher _other(_logger);
+
+    auto _queue_0{gauge_queue::create(_logger, 16)};
+    auto _queue_1{gauge_queue::create(_logger, 16)};
+    if (!_queue_0 || !_queue_1)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queues");
+      return false;
+    }
+
+    async::dat::autoscaling _autoscaling;
+    _autoscaling.min_handlers = 1;
+    _autoscaling.max_handlers = 3;
+    _autoscaling.interval     = 0ms;
+
+    const gauge_handle _scaling{_dispatcher.add_handling<event_gauge>(
+        "scaling", std::move(*_queue_0), [](event_gauge &&) {}, _autoscaling)};
+    const gauge_handle _fixed{_dispatcher.add_handling<event_gauge>(
+        "fixed", std::move(*_queue_1), [](event_gauge &&) {})};
+    if (!_scaling.is_valid() || !_fixed.is_valid())
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    const bool _incremented{_dispatcher.increment_handlers(_scaling, 2)
+                            == async::dat::result::OK};
+    const std::optional<std::size_t> _amount{
+        _dispatcher.get_amount_handlers(_scaling)};
+    const bool _above_max{_dispatcher.increment_handlers(_scaling, 1)
+                          == async::dat::result::ERROR_ADDING_HANDLER};
+    const bool _not_scaling{_dispatcher.increment_handlers(_fixed, 1)
+                            == async::dat::result::ERROR_ADDING_HANDLER};
+    const bool _not_owned{_other.increment_handlers(_scaling, 1)
+                          == async::dat::result::HANDLING_NOT_FOUND};
+    const bool _not_valid{!_other.get_num_events(gauge_handle{})};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("incremented = ", _incremented,
+                                  ", amount = ", _amount.value_or(0),
+                                  ", above max = ", _above_max,
+                                  ", not scaling = ", _not_scaling,
+                                  ", not owned = ", _not_owned,
+                                  ", not valid = ", _not_valid));
+
+    return _incremented && _amount && (*_amount == 3) && _above_max
+           && _not_scaling && _not_owned && _not_valid;
+  }
+};
+
+struct handle_003
+{
+  static std::string desc()
+  {
+    return "A handle is no longer valid after its handling is removed, or "
+           "after its dispatcher is destroyed, and the events published after "
+           "the removal go only to the other handling";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::atomic_size_t _handled_0{0};
+    std::atomic_size_t _handled_1{0};
+
+    gauge_handle _handle_0;
+    gauge_handle _handle_1;
+    {
+      gauge_dispatcher _dispatcher(_logger);
+
+      _handle_0 = _dispatcher.add_inline_handling<event_gauge>(
+          "gauge-0", [&](event_gauge &&) { ++_handled_0; });
+      _handle_1 = _dispatcher.add_inline_handling<event_gauge>(
+          "gauge-1", [&](event_gauge &&) { ++_handled_1; });
+      if (!_handle_0.is_valid() || !_handle_1.is_valid())
+      {
+        TNCT_LOG_ERR(_logger, "error adding handlings");
+        return false;
+      }
+
+      if ((_dispatcher.remove_handling(_handle_0) != async::dat::result::OK)
+          || _handle_0.is_valid()
+          || (_dispatcher.get_amount_handlings<event_gauge>() != 1)
+          || (_dispatcher.stop(_handle_0)
+              != async::dat::result::HANDLING_NOT_FOUND)
+          || (_dispatcher.remove_handling(_handle_0)
+              != async::dat::result::HANDLING_NOT_FOUND))
+      {
+        TNCT_LOG_ERR(_logger, "the handling was not removed");
+        return false;
+      }
+
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_dispatcher.publish<event_gauge>(_i) != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+          return false;
+        }
+      }
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("handled 0 = ", _handled_0.load(),
+                                           ", handled 1 = ",
+                                           _handled_1.load()));
+
+    return (_handled_0 == 0) && (_handled_1 == m_amount)
+           && !_handle_1.is_valid();
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{10};
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -3,10 +3,26 @@
 
 /// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
 
+#include "tnct/async/tst/affinity_test.h"
+#include "tnct/async/tst/autoscaling_test.h"
+#include "tnct/async/tst/coroutine_test.h"
 #include "tnct/async/tst/cpt_test.h"
 #include "tnct/async/tst/dispatcher_test.h"
+#include "tnct/async/tst/event_pool_test.h"
+#include "tnct/async/tst/exec_sync_test.h"
+#include "tnct/async/tst/filter_test.h"
+#include "tnct/async/tst/handle_test.h"
 #include "tnct/async/tst/handling_test.h"
+#include "tnct/async/tst/metrics_test.h"
+#include "tnct/async/tst/parallel_test.h"
+#include "tnct/async/tst/pipeline_test.h"
+#include "tnct/async/tst/record_test.h"
+#include "tnct/async/tst/request_test.h"
+#include "tnct/async/tst/sharded_handling_test.h"
+#include "tnct/async/tst/shm_test.h"
 #include "tnct/async/tst/sleeping_loop_test.h"
+#include "tnct/async/tst/static_dispatcher_test.h"
+#include "tnct/async/tst/work_stealing_pool_test.h"
 #include "tnct/tester/bus/test.h"
 
 using namespace tnct;
@@ -31,6 +47,16 @@ int main(int argc, char **argv)
   run_test(_tester, async::tst::sleeping_loop_000);
   run_test(_tester, async::tst::sleeping_loop_001);
   run_test(_tester, async::tst::sleeping_loop_002);
+  run_test(_tester, async::tst::sleeping_loop_003);
+  run_test(_tester, async::tst::sleeping_loop_004);
+  run_test(_tester, async::tst::sleeping_loop_005);
+  run_test(_tester, async::tst::sleeping_loop_006);
+  run_test(_tester, async::tst::sleeping_loop_007);
+
+  run_test(_tester, async::tst::exec_sync_000);
+  run_test(_tester, async::tst::exec_sync_001);
+  run_test(_tester, async::tst::exec_sync_002);
+  run_test(_tester, async::tst::exec_sync_003);
 
   run_test(_tester, async::tst::dispatcher_000);
   run_test(_tester, async::tst::dispatcher_001);
@@ -39,6 +65,77 @@ int main(int argc, char **argv)
   run_test(_tester, async::tst::dispatcher_007);
   run_test(_tester, async::tst::dispatcher_008);
   run_test(_tester, async::tst::dispatcher_009);
+  run_test(_tester, async::tst::dispatcher_010);
+  run_test(_tester, async::tst::dispatcher_011);
+  run_test(_tester, async::tst::dispatcher_012);
+  run_test(_tester, async::tst::dispatcher_013);
+  run_test(_tester, async::tst::dispatcher_014);
+  run_test(_tester, async::tst::dispatcher_015);
+  run_test(_tester, async::tst::dispatcher_016);
+  run_test(_tester, async::tst::dispatcher_017);
+  run_test(_tester, async::tst::dispatcher_018);
+  run_test(_tester, async::tst::dispatcher_019);
+  run_test(_tester, async::tst::dispatcher_020);
+  run_test(_tester, async::tst::dispatcher_021);
+  run_test(_tester, async::tst::dispatcher_022);
+  run_test(_tester, async::tst::dispatcher_023);
+  run_test(_tester, async::tst::dispatcher_024);
+  run_test(_tester, async::tst::dispatcher_025);
+
+  run_test(_tester, async::tst::work_stealing_pool_000);
+  run_test(_tester, async::tst::work_stealing_pool_001);
+  run_test(_tester, async::tst::work_stealing_pool_002);
+  run_test(_tester, async::tst::work_stealing_pool_003);
+  run_test(_tester, async::tst::work_stealing_pool_004);
+  run_test(_tester, async::tst::metrics_000);
+  run_test(_tester, async::tst::metrics_001);
+  run_test(_tester, async::tst::metrics_002);
+  run_test(_tester, async::tst::metrics_003);
+  run_test(_tester, async::tst::static_dispatcher_000);
+  run_test(_tester, async::tst::static_dispatcher_001);
+  run_test(_tester, async::tst::static_dispatcher_002);
+  run_test(_tester, async::tst::sharded_handling_000);
+  run_test(_tester, async::tst::sharded_handling_001);
+  run_test(_tester, async::tst::sharded_handling_002);
+  run_test(_tester, async::tst::request_000);
+  run_test(_tester, async::tst::request_001);
+  run_test(_tester, async::tst::request_002);
+  run_test(_tester, async::tst::request_003);
+  run_test(_tester, async::tst::handle_000);
+  run_test(_tester, async::tst::handle_001);
+  run_test(_tester, async::tst::handle_002);
+  run_test(_tester, async::tst::handle_003);
+  run_test(_tester, async::tst::coroutine_000);
+  run_test(_tester, async::tst::coroutine_001);
+  run_test(_tester, async::tst::coroutine_002);
+  run_test(_tester, async::tst::coroutine_003);
+  run_test(_tester, async::tst::filter_000);
+  run_test(_tester, async::tst::filter_001);
+  run_test(_tester, async::tst::filter_002);
+  run_test(_tester, async::tst::autoscaling_000);
+  run_test(_tester, async::tst::autoscaling_001);
+  run_test(_tester, async::tst::autoscaling_002);
+  run_test(_tester, async::tst::autoscaling_003);
+  run_test(_tester, async::tst::affinity_000);
+  run_test(_tester, async::tst::affinity_001);
+  run_test(_tester, async::tst::affinity_002);
+  run_test(_tester, async::tst::event_pool_000);
+  run_test(_tester, async::tst::event_pool_001);
+  run_test(_tester, async::tst::event_pool_002);
+  run_test(_tester, async::tst::pipeline_000);
+  run_test(_tester, async::tst::pipeline_001);
+  run_test(_tester, async::tst::pipeline_002);
+  run_test(_tester, async::tst::record_000);
+  run_test(_tester, async::tst::record_001);
+  run_test(_tester, async::tst::record_002);
+  run_test(_tester, async::tst::record_003);
+  run_test(_tester, async::tst::shm_000);
+  run_test(_tester, async::tst::shm_001);
+  run_test(_tester, async::tst::shm_002);
+  run_test(_tester, async::tst::shm_003);
+  run_test(_tester, async::tst::parallel_000);
+  run_test(_tester, async::tst::parallel_001);
+  run_test(_tester, async::tst::parallel_002);
 
   // cpt
   run_test(_tester, async::tst::cpt_event_000);
@@ -69,6 +166,7 @@ int main(int argc, char **argv)
   run_test(_tester, async::tst::cpt_handler_003);
   run_test(_tester, async::tst::cpt_handler_004);
   run_test(_tester, async::tst::cpt_handler_005);
+  run_test(_tester, async::tst::cpt_handler_006);
 
   return 0;
 }
@@ -0,0 +1,391 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_METRICS_TEST_H
+#define TNCT_ASYNC_TST_METRICS_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/histogram.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_metrics
+{
+  event_metrics(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream        &p_out,
+                                  const event_metrics &p_event)
+  {
+    p_out << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+struct metrics_000
+{
+  static std::string desc()
+  {
+    return "Records 1 to 100000 nanoseconds in a 'histogram', and checks that "
+           "the minimum, maximum and percentiles have an error of at most "
+           "1/16";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr      _logger;
+    dat::histogram _histogram;
+
+    for (std::int64_t _i = 1; _i <= 100000; ++_i)
+    {
+      _histogram.record(std::chrono::nanoseconds{_i});
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt(_histogram));
+
+    auto _near = [](std::chrono::nanoseconds p_value, std::int64_t p_expected)
+    {
+      const auto _value{static_cast<double>(p_value.count())};
+      const auto _expected{static_cast<double>(p_expected)};
+      return (_value >= _expected) && (_value <= (_expected * 17.0 / 16.0));
+    };
+
+    for (std::uint64_t _value : {0ULL, 1ULL, 15ULL, 16ULL, 1000ULL, 1ULL << 40})
+    {
+      const std::size_t _bucket{dat::histogram::bucket(_value)};
+      if ((dat::histogram::lowest_in_bucket(_bucket) > _value)
+          || (dat::histogram::highest_in_bucket(_bucket) < _value))
+      {
+        TNCT_LOG_ERR(_logger,
+                     format::bus::fmt(_value, " not in bucket ", _bucket));
+        return false;
+      }
+    }
+
+    return (_histogram.get_count() == 100000)
+           && _near(_histogram.get_min(), 1)
+           && _near(_histogram.get_max(), 100000)
+           && _near(_histogram.get_percentile(0.5), 50000)
+           && _near(_histogram.get_percentile(0.99), 99000);
+  }
+};
+
+struct metrics_001
+{
+  static std::string desc()
+  {
+    return "Publishes 200 events to a handling with 2 handlers that take 100 "
+           "microseconds each, and checks the counters, the histograms and the "
+           "busy time of the handlers";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using dispatcher = async::bus::dispatcher<log::cerr, event_metrics>;
+    using queue      = container::dat::circular_queue<log::cerr, event_metrics>;
+
+    log::cerr  _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::atomic_size_t _handled{0};
+
+    auto _queue{queue::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<event_metrics>(
+            "handling-metrics", std::move(*_queue),
+            [&](event_metrics &&)
+            {
+              std::this_thread::sleep_for(m_handler_time);
+              ++_handled;
+            },
+            dat::handling_priority::medium, 2)
+        != dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_dispatcher.publish<event_metrics>(_i) != dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+    }
+
+    for (int _i = 0; (_i < 200) && (_handled < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::optional<dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_metrics>("handling-metrics")};
+    if (!_metrics)
+    {
+      TNCT_LOG_ERR(_logger, "no metrics for 'handling-metrics'");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt(*_metrics));
+
+    if ((_metrics->published != m_amount) || (_metrics->handled != m_amount)
+        || (_metrics->dropped != 0) || (_metrics->rejected != 0)
+        || (_metrics->queued != 0) || (_metrics->handlers.size() != 2))
+    {
+      TNCT_LOG_ERR(_logger, "wrong counters");
+      return false;
+    }
+
+    if ((_metrics->handler_time.get_count() != m_amount)
+        || (_metrics->handler_time.get_min() < m_handler_time)
+        || (_metrics->enqueue_to_dequeue.get_count() != m_amount)
+        || (_metrics->high_water_mark < 2))
+    {
+      TNCT_LOG_ERR(_logger, "wrong histograms");
+      return false;
+    }
+
+    for (const dat::handler_metrics &_handler : _metrics->handlers)
+    {
+      if (_handler.busy < (_handler.handled * m_handler_time))
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("wrong busy time ", _handler));
+        return false;
+      }
+    }
+
+    return !_dispatcher.get_metrics<event_metrics>("no-handling").has_value();
+  }
+
+private:
+  static constexpr std::uint32_t             m_amount{200};
+  static constexpr std::chrono::microseconds m_handler_time{100};
+};
+
+struct metrics_002
+{
+  static std::string desc()
+  {
+    return "Counts the events dropped and rejected by the overflow policy of "
+           "a handling, and the high water mark of its queue";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using dispatcher = async::bus::dispatcher<log::cerr, event_metrics>;
+    using queue      = container::dat::circular_queue<log::cerr, event_metrics>;
+
+    log::cerr  _logger;
+    dispatcher _dispatcher(_logger);
+
+    std::atomic_bool _started{false};
+    std::atomic_bool _released{false};
+
+    auto _queue{queue::create(_logger, 8)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<event_metrics>(
+            "handling-metrics", std::move(*_queue),
+            [&](event_metrics &&)
+            {
+              _started = true;
+              while (!_released)
+              {
+                std::this_thread::sleep_for(1ms);
+              }
+            })
+        != dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    auto _publish = [&](dat::overflow_policy p_policy,
+                        dat::result          p_expected)
+    {
+      if (_dispatcher.set_overflow_policy<event_metrics>(
+              "handling-metrics", p_policy, m_max_capacity)
+          != dat::result::OK)
+      {
+        return false;
+      }
+      for (std::size_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_dispatcher.publish<event_metrics>() != p_expected)
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    // the handler holds the first event, and the queue is empty
+    if (_dispatcher.publish<event_metrics>() != dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+    for (int _i = 0; (_i < 100) && !_started; ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const bool _ok{
+        _started
+        && _publish(dat::overflow_policy::drop_newest, dat::result::OK)
+        && _publish(dat::overflow_policy::drop_oldest, dat::result::OK)
+        && _publish(dat::overflow_policy::reject,
+                    dat::result::ERROR_QUEUE_FULL)};
+
+    const std::optional<dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_metrics>("handling-metrics")};
+
+    _released = true;
+
+    if (!_ok || !_metrics)
+    {
+      TNCT_LOG_ERR(_logger, "error publishing");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt(*_metrics));
+
+    // 'drop_newest' drops all but 'm_max_capacity' events, 'drop_oldest'
+    // drops one event for each event published, and 'reject' rejects all
+    return (_metrics->published == ((3 * m_amount) + 1))
+           && (_metrics->dropped == ((2 * m_amount) - m_max_capacity))
+           && (_metrics->rejected == m_amount) && (_metrics->handled == 0)
+           && (_metrics->queued == m_max_capacity)
+           && (_metrics->high_water_mark == m_max_capacity);
+  }
+
+private:
+  static constexpr std::size_t m_amount{20};
+  static constexpr std::size_t m_max_capacity{5};
+};
+
+struct metrics_003
+{
+  static std::string desc()
+  {
+    return "The handlers of a handling in a 'work_stealing_pool' record their "
+           "busy time, and the events handled";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using dispatcher = async::bus::dispatcher<log::cerr, event_metrics>;
+    using queue      = container::dat::circular_queue<log::cerr, event_metrics>;
+
+    log::cerr                                 _logger;
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 2);
+
+    std::atomic_size_t _handled{0};
+    std::optional<dat::handling_metrics> _metrics;
+
+    {
+      dispatcher _dispatcher(_logger, _pool);
+
+      auto _queue{queue::create(_logger, 64)};
+      if (!_queue)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if (_dispatcher.add_handling<event_metrics>(
+              "handling-metrics", std::move(*_queue),
+              [&](event_metrics &&)
+              {
+                std::this_thread::sleep_for(50us);
+                ++_handled;
+              },
+              dat::handling_priority::medium, 2)
+          != dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error adding handling");
+        return false;
+      }
+
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_dispatcher.publish<event_metrics>(_i) != dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+      }
+
+      for (int _i = 0; (_i < 200) && (_handled < m_amount); ++_i)
+      {
+        std::this_thread::sleep_for(10ms);
+      }
+
+      _metrics = _dispatcher.get_metrics<event_metrics>("handling-metrics");
+    }
+
+    if (!_metrics)
+    {
+      TNCT_LOG_ERR(_logger, "no metrics for 'handling-metrics'");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt(*_metrics));
+
+    std::uint64_t _handled_by_handlers{0};
+    for (const dat::handler_metrics &_handler : _metrics->handlers)
+    {
+      _handled_by_handlers += _handler.handled;
+      if ((_handler.handled > 0) && (_handler.busy < 50us))
+      {
+        return false;
+      }
+    }
+
+    return (_metrics->handled == m_amount)
+           && (_handled_by_handlers == m_amount)
+           && (_metrics->handler_time.get_count() == m_amount);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{500};
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -0,0 +1,196 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_PARALLEL_TEST_H
+#define TNCT_ASYNC_TST_PARALLEL_TEST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/parallel.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+namespace tnct::async::tst
+{
+
+struct parallel_000
+{
+  static std::string desc()
+  {
+    return "parallel_for calls the function once for each index of a range, "
+           "in more than one thread, with automatic and explicit grains, and "
+           "reusing the same pool";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::set<std::thread::id> _threads;
+    std::mutex                _mutex;
+
+    for (std::size_t _grain : {std::size_t{0}, std::size_t{1},
+                               std::size_t{7}, m_amount * 2})
+    {
+      std::vector<std::atomic_uint32_t> _calls(m_amount);
+
+      async::bus::parallel_for<log::cerr>(
+          std::int32_t{-10}, static_cast<std::int32_t>(m_amount - 10), _grain,
+          [&](std::int32_t p_idx)
+          {
+            ++_calls[static_cast<std::size_t>(p_idx + 10)];
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _threads.insert(std::this_thread::get_id());
+          });
+
+      for (std::size_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_calls[_i] != 1)
+        {
+          TNCT_LOG_ERR(_logger, format::bus::fmt("grain ", _grain, ": index ",
+                                                 _i, " called ",
+                                                 _calls[_i].load(), " times"));
+          return false;
+        }
+      }
+    }
+
+    bool _called{false};
+    async::bus::parallel_for<log::cerr>(5, 5, 0,
+                                        [&](int) { _called = true; });
+
+    const std::size_t _workers{
+        async::bus::parallel_pool<log::cerr>().get_num_workers()};
+    TNCT_LOG_TST(_logger, format::bus::fmt("threads used = ", _threads.size(),
+                                           ", workers = ", _workers));
+
+    // the calling thread also executes chunks
+    return !_called && (_threads.size() > 1);
+  }
+
+private:
+  static constexpr std::size_t m_amount{100000};
+};
+
+struct parallel_001
+{
+  static std::string desc()
+  {
+    return "parallel_reduce gives the same result as a sequential loop, for "
+           "any grain, keeps the order of a non commutative reduction, and "
+           "returns the identity for an empty range";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const auto _square{[](std::uint64_t p_i) { return p_i * p_i; }};
+    const auto _sum{[](std::uint64_t p_a, std::uint64_t p_b)
+                    { return p_a + p_b; }};
+
+    std::uint64_t _expected{0};
+    for (std::uint64_t _i = 0; _i < m_amount; ++_i)
+    {
+      _expected += _i * _i;
+    }
+
+    for (std::size_t _grain : {std::size_t{0}, std::size_t{1},
+                               std::size_t{1000}})
+    {
+      const std::uint64_t _result{async::bus::parallel_reduce<log::cerr>(
+          std::uint64_t{0}, m_amount, _grain, std::uint64_t{0}, _square,
+          _sum)};
+      if (_result != _expected)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("grain ", _grain, ": ",
+                                               _result, " != ", _expected));
+        return false;
+      }
+    }
+
+    const std::string _digits{async::bus::parallel_reduce<log::cerr>(
+        0, 1000, 3, std::string{},
+        [](int p_i) { return std::to_string(p_i % 10); },
+        [](std::string p_a, std::string p_b) { return p_a + p_b; })};
+    std::string _expected_digits;
+    for (int _i = 0; _i < 1000; ++_i)
+    {
+      _expected_digits += std::to_string(_i % 10);
+    }
+
+    const std::uint64_t _empty{async::bus::parallel_reduce<log::cerr>(
+        std::uint64_t{10}, std::uint64_t{10}, 0, std::uint64_t{42}, _square,
+        _sum)};
+
+    return (_digits == _expected_digits) && (_empty == 42);
+  }
+
+private:
+  static constexpr std::uint64_t m_amount{1000000};
+};
+
+struct parallel_002
+{
+  static std::string desc()
+  {
+    return "parallel_for called from every task of a pool of 2 workers does "
+           "not wait forever, and an exception raised by the function is "
+           "rethrown to the caller";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                                 _logger;
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 2);
+
+    std::atomic_size_t _inner{0};
+    async::bus::parallel_for(_pool, 0, 8, 1,
+                             [&](int)
+                             {
+                               async::bus::parallel_for(
+                                   _pool, 0, 100, 1, [&](int) { ++_inner; });
+                             });
+    if (_inner != 800)
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt("inner calls = ", _inner.load()));
+      return false;
+    }
+
+    try
+    {
+      async::bus::parallel_for(_pool, 0, 1000, 10,
+                               [](int p_idx)
+                               {
+                                 if (p_idx == 500)
+                                 {
+                                   throw std::runtime_error("index 500");
+                                 }
+                               });
+    }
+    catch (std::runtime_error &_ex)
+    {
+      TNCT_LOG_TST(_logger, format::bus::fmt("caught '", _ex.what(), '\''));
+      return std::string{_ex.what()} == "index 500";
+    }
+    TNCT_LOG_ERR(_logger, "exception not rethrown");
+    return false;
+  }
+};
+
+} // namespace tnct::async::tst
+
+#endif
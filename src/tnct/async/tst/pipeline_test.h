@@ -0,0 +1,294 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_PIPELINE_TEST_H
+#define TNCT_ASYNC_TST_PIPELINE_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/pipeline.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/dat/stage_config.h"
+#include "tnct/async/dat/stage_metrics.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct line
+{
+  friend std::ostream &operator<<(std::ostream &p_out, const line &p_line)
+  {
+    p_out << "line '" << p_line.text << '\'';
+    return p_out;
+  }
+
+  std::string text;
+};
+
+struct number
+{
+  friend std::ostream &operator<<(std::ostream &p_out, const number &p_number)
+  {
+    p_out << "number " << p_number.value;
+    return p_out;
+  }
+
+  std::uint64_t value{0};
+};
+
+struct square
+{
+  friend std::ostream &operator<<(std::ostream &p_out, const square &p_square)
+  {
+    p_out << "square " << p_square.value;
+    return p_out;
+  }
+
+  std::uint64_t value{0};
+};
+
+struct pipeline_000
+{
+  static std::string desc()
+  {
+    return "A line is parsed to a number by a fused stage, squared by a stage "
+           "with 2 threads, and summed by the sink, and each stage reports "
+           "how many values it handled";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::atomic_uint64_t _sum{0};
+    std::atomic_size_t   _sunk{0};
+
+    std::optional<async::bus::pipeline<log::cerr, line>> _pipeline{
+        async::bus::pipeline_builder<log::cerr, line>(_logger)
+            .stage(
+                "parse",
+                [](line &&p_line) { return number{std::stoull(p_line.text)}; },
+                async::dat::fused)
+            .stage("square",
+                   [](number &&p_number)
+                   { return square{p_number.value * p_number.value}; },
+                   {.handlers = 2, .capacity = 64})
+            .sink("sum",
+                  [&](square &&p_square)
+                  {
+                    _sum += p_square.value;
+                    ++_sunk;
+                  })};
+    if (!_pipeline)
+    {
+      TNCT_LOG_ERR(_logger, "error creating pipeline");
+      return false;
+    }
+
+    std::uint64_t _expected{0};
+    for (std::uint64_t _i = 1; _i <= m_amount; ++_i)
+    {
+      if (_pipeline->publish(line{std::to_string(_i)})
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+      _expected += _i * _i;
+    }
+
+    for (int _i = 0; (_i < 200) && (_sunk < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::vector<async::dat::stage_metrics> _metrics{
+        _pipeline->get_metrics()};
+    for (const async::dat::stage_metrics &_stage : _metrics)
+    {
+      TNCT_LOG_TST(_logger, format::bus::fmt(_stage));
+    }
+
+    return (_sum == _expected) && (_metrics.size() == 3)
+           && (_metrics[0].name == "parse") && _metrics[0].fused
+           && (_metrics[0].threads == 1) && (_metrics[1].name == "square")
+           && !_metrics[1].fused && (_metrics[1].threads == 2)
+           && (_metrics[2].name == "sum") && (_metrics[0].handled == m_amount)
+           && (_metrics[1].handled == m_amount)
+           && (_metrics[2].handled == m_amount);
+  }
+
+private:
+  static constexpr std::uint64_t m_amount{2000};
+};
+
+struct pipeline_001
+{
+  static std::string desc()
+  {
+    return "Stages fused to a stage with its own thread run in that thread, "
+           "and a stage that returns 'std::nullopt' drops the value";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::mutex                 _mutex;
+    std::set<std::thread::id>  _threads;
+    std::atomic_size_t         _sunk{0};
+    const std::thread::id      _publisher{std::this_thread::get_id()};
+    auto                       _record{[&]()
+                 {
+                   std::lock_guard<std::mutex> _lock(_mutex);
+                   _threads.insert(std::this_thread::get_id());
+                 }};
+
+    std::optional<async::bus::pipeline<log::cerr, number>> _pipeline{
+        async::bus::pipeline_builder<log::cerr, number>(_logger)
+            .stage("hop",
+                   [&](number &&p_number)
+                   {
+                     _record();
+                     return p_number;
+                   })
+            .stage(
+                "odd",
+                [&](number &&p_number) -> std::optional<number>
+                {
+                  _record();
+                  if ((p_number.value % 2) == 0)
+                  {
+                    return std::nullopt;
+                  }
+                  return p_number;
+                },
+                async::dat::fused)
+            .sink(
+                "count",
+                [&](number &&)
+                {
+                  _record();
+                  ++_sunk;
+                },
+                async::dat::fused)};
+    if (!_pipeline)
+    {
+      TNCT_LOG_ERR(_logger, "error creating pipeline");
+      return false;
+    }
+
+    for (std::uint64_t _i = 0; _i < m_amount; ++_i)
+    {
+      _pipeline->publish(number{_i});
+    }
+    for (int _i = 0; (_i < 200) && (_sunk < (m_amount / 2)); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::vector<async::dat::stage_metrics> _metrics{
+        _pipeline->get_metrics()};
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("sunk = ", _sunk.load(),
+                                           ", threads = ", _threads.size()));
+
+    return (_sunk == (m_amount / 2)) && (_threads.size() == 1)
+           && (*_threads.begin() != _publisher)
+           && (_metrics[1].handled == m_amount)
+           && (_metrics[2].handled == (m_amount / 2));
+  }
+
+private:
+  static constexpr std::uint64_t m_amount{1000};
+};
+
+struct pipeline_002
+{
+  static std::string desc()
+  {
+    return "A slow stage is reported as the bottleneck, and its bounded queue "
+           "never holds more values than its capacity, as the publisher waits";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::atomic_size_t _sunk{0};
+    std::atomic_size_t _max_queued{0};
+
+    std::optional<async::bus::pipeline<log::cerr, number>> _pipeline{
+        async::bus::pipeline_builder<log::cerr, number>(_logger)
+            .stage("fast", [](number &&p_number) { return p_number; },
+                   {.handlers = 1, .capacity = 8})
+            .stage("slow",
+                   [](number &&p_number)
+                   {
+                     std::this_thread::sleep_for(200us);
+                     return p_number;
+                   },
+                   {.handlers = 1, .capacity = 8})
+            .sink("count", [&](number &&) { ++_sunk; }, async::dat::fused)};
+    if (!_pipeline)
+    {
+      TNCT_LOG_ERR(_logger, "error creating pipeline");
+      return false;
+    }
+
+    for (std::uint64_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_pipeline->publish(number{_i}) != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+      for (const async::dat::stage_metrics &_stage :
+           _pipeline->get_metrics())
+      {
+        if (_stage.queued > _max_queued)
+        {
+          _max_queued = _stage.queued;
+        }
+      }
+    }
+    for (int _i = 0; (_i < 300) && (_sunk < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    const std::optional<async::dat::stage_metrics> _bottleneck{
+        _pipeline->get_bottleneck()};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("sunk = ", _sunk.load(), ", max queued = ",
+                                  _max_queued.load(), ", bottleneck = ",
+                                  (_bottleneck ? _bottleneck->name : "none")));
+
+    return (_sunk == m_amount) && (_max_queued <= 8) && _bottleneck
+           && (_bottleneck->name == "slow");
+  }
+
+private:
+  static constexpr std::uint64_t m_amount{500};
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -0,0 +1,533 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_RECORD_TEST_H
+#define TNCT_ASYNC_TST_RECORD_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/recorder.h"
+#include "tnct/async/bus/replayer.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct trade
+{
+  friend std::ostream &operator<<(std::ostream &p_out, const trade &p_trade)
+  {
+    p_out << "trade " << p_trade.id << ' ' << p_trade.symbol;
+    return p_out;
+  }
+
+  bool operator==(const trade &) const = default;
+
+  std::uint32_t id{0};
+  std::string   symbol;
+};
+
+struct quote
+{
+  friend std::ostream &operator<<(std::ostream &p_out, const quote &p_quote)
+  {
+    p_out << "quote " << p_quote.price;
+    return p_out;
+  }
+
+  bool operator==(const quote &) const = default;
+
+  double price{0.0};
+};
+
+// A trade is its id followed by the chars of its symbol, and a quote is its
+// price
+struct market_serializer
+{
+  void serialize(const trade &p_trade, std::vector<std::byte> &p_buffer)
+  {
+    append(&p_trade.id, sizeof(p_trade.id), p_buffer);
+    append(p_trade.symbol.data(), p_trade.symbol.size(), p_buffer);
+  }
+
+  void serialize(const quote &p_quote, std::vector<std::byte> &p_buffer)
+  {
+    append(&p_quote.price, sizeof(p_quote.price), p_buffer);
+  }
+
+  std::optional<trade> deserialize(std::span<const std::byte> p_bytes,
+                                   std::type_identity<trade>)
+  {
+    if (p_bytes.size() < sizeof(std::uint32_t))
+    {
+      return std::nullopt;
+    }
+    trade _trade;
+    std::memcpy(&_trade.id, p_bytes.data(), sizeof(_trade.id));
+    _trade.symbol.assign(
+        reinterpret_cast<const char *>(p_bytes.data()) + sizeof(_trade.id),
+        p_bytes.size() - sizeof(_trade.id));
+    return _trade;
+  }
+
+  std::optional<quote> deserialize(std::span<const std::byte> p_bytes,
+                                   std::type_identity<quote>)
+  {
+    if (p_bytes.size() != sizeof(double))
+    {
+      return std::nullopt;
+    }
+    quote _quote;
+    std::memcpy(&_quote.price, p_bytes.data(), sizeof(_quote.price));
+    return _quote;
+  }
+
+private:
+  static void append(const void *p_data, std::size_t p_size,
+                     std::vector<std::byte> &p_buffer)
+  {
+    const std::byte *_data{static_cast<const std::byte *>(p_data)};
+    p_buffer.insert(p_buffer.end(), _data, _data + p_size);
+  }
+};
+
+using market_dispatcher = async::bus::dispatcher<log::cerr, trade, quote>;
+
+using market_recorder =
+    async::bus::recorder<log::cerr, market_serializer, trade, quote>;
+
+using market_replayer =
+    async::bus::replayer<log::cerr, market_serializer, trade, quote>;
+
+using market_queue_trade = container::dat::circular_queue<log::cerr, trade>;
+
+using market_queue_quote = container::dat::circular_queue<log::cerr, quote>;
+
+// Collects, in the order they are handled, the events published to a
+// dispatcher, with one handler for each type
+struct market_collector
+{
+  bool attach(log::cerr &p_logger, market_dispatcher &p_dispatcher)
+  {
+    auto _trades{market_queue_trade::create(p_logger, 64)};
+    auto _quotes{market_queue_quote::create(p_logger, 64)};
+    return _trades && _quotes
+           && (p_dispatcher.add_handling<trade>(
+                   "trades", std::move(*_trades),
+                   [this](trade &&p_trade) { add(std::move(p_trade)); })
+               == async::dat::result::OK)
+           && (p_dispatcher.add_handling<quote>(
+                   "quotes", std::move(*_quotes),
+                   [this](quote &&p_quote) { add(std::move(p_quote)); })
+               == async::dat::result::OK);
+  }
+
+  template <typename t_event> void add(t_event &&p_event)
+  {
+    std::lock_guard<std::mutex> _lock(mutex);
+    events.emplace_back(std::forward<t_event>(p_event));
+  }
+
+  std::size_t size()
+  {
+    std::lock_guard<std::mutex> _lock(mutex);
+    return events.size();
+  }
+
+  std::mutex mutex;
+
+  std::vector<std::variant<trade, quote>> events;
+};
+
+inline std::filesystem::path recording_path(const std::string &p_name)
+{
+  return std::filesystem::temp_directory_path() / (p_name + ".tnctrec");
+}
+
+struct record_000
+{
+  static std::string desc()
+  {
+    return "Trades and quotes published to a dispatcher are recorded, and "
+           "replayed as fast as possible to another dispatcher, which "
+           "receives the same events, in the same order, and stopping the "
+           "recorder removes its handlings";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const std::filesystem::path _path{recording_path("record_000")};
+
+    std::vector<std::variant<trade, quote>> _published;
+    {
+      market_dispatcher _dispatcher(_logger);
+      std::optional<market_recorder> _recorder{
+          market_recorder::create(_logger, _path)};
+      if (!_recorder
+          || (_recorder->attach(_dispatcher) != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error creating recorder");
+        return false;
+      }
+
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        if ((_i % 3) == 0)
+        {
+          const quote _quote{10.0 + _i};
+          _published.emplace_back(_quote);
+          static_cast<void>(_dispatcher.publish(_quote));
+        }
+        else
+        {
+          const trade _trade{_i, "SYM" + std::to_string(_i)};
+          _published.emplace_back(_trade);
+          static_cast<void>(_dispatcher.publish(_trade));
+        }
+      }
+      _recorder->stop();
+
+      if (_recorder->get_amount_recorded() != m_amount)
+      {
+        TNCT_LOG_ERR(_logger,
+                     format::bus::fmt("recorded ",
+                                      _recorder->get_amount_recorded()));
+        return false;
+      }
+
+      if ((_dispatcher.get_amount_handlings<trade>() != 0)
+          || (_dispatcher.get_amount_handlings<quote>() != 0))
+      {
+        TNCT_LOG_ERR(_logger, "the recorder handlings were not removed");
+        return false;
+      }
+    }
+
+    market_dispatcher _dispatcher(_logger);
+    market_collector  _collector;
+    if (!_collector.attach(_logger, _dispatcher))
+    {
+      TNCT_LOG_ERR(_logger, "error adding handlings");
+      return false;
+    }
+
+    std::optional<market_replayer> _replayer{
+        market_replayer::create(_logger, _path)};
+    if (!_replayer)
+    {
+      TNCT_LOG_ERR(_logger, "error creating replayer");
+      return false;
+    }
+
+    if (_replayer->replay(_dispatcher, 0) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error replaying");
+      return false;
+    }
+
+    for (int _i = 0; (_i < 200) && (_collector.size() < m_amount); ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    std::filesystem::remove(_path);
+
+    // each type has its own handling, so only the order of each type is kept
+    std::vector<trade> _published_trades;
+    std::vector<quote> _published_quotes;
+    std::vector<trade> _replayed_trades;
+    std::vector<quote> _replayed_quotes;
+    auto _split{[](const std::vector<std::variant<trade, quote>> &p_events,
+                   std::vector<trade> &p_trades, std::vector<quote> &p_quotes)
+                {
+                  for (const std::variant<trade, quote> &_event : p_events)
+                  {
+                    if (std::holds_alternative<trade>(_event))
+                    {
+                      p_trades.push_back(std::get<trade>(_event));
+                    }
+                    else
+                    {
+                      p_quotes.push_back(std::get<quote>(_event));
+                    }
+                  }
+                }};
+    _split(_published, _published_trades, _published_quotes);
+    _split(_collector.events, _replayed_trades, _replayed_quotes);
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("replayed ", _replayer->get_amount_replayed(),
+                                  ", trades ", _replayed_trades.size(),
+                                  ", quotes ", _replayed_quotes.size()));
+
+    return (_replayer->get_amount_replayed() == m_amount)
+           && (_published_trades == _replayed_trades)
+           && (_published_quotes == _replayed_quotes);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{300};
+};
+
+struct record_001
+{
+  static std::string desc()
+  {
+    return "Events recorded 30ms apart are replayed in about the same time "
+           "at the original speed, in a tenth of it at 10 times the speed, "
+           "and with no wait as fast as possible";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const std::filesystem::path _path{recording_path("record_001")};
+    {
+      market_dispatcher              _dispatcher(_logger);
+      std::optional<market_recorder> _recorder{
+          market_recorder::create(_logger, _path)};
+      if (!_recorder
+          || (_recorder->attach(_dispatcher) != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error creating recorder");
+        return false;
+      }
+      for (std::size_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_i != 0)
+        {
+          std::this_thread::sleep_for(30ms);
+        }
+        static_cast<void>(_dispatcher.publish(quote{1.0 * _i}));
+      }
+    }
+
+    std::optional<market_replayer> _replayer{
+        market_replayer::create(_logger, _path)};
+    if (!_replayer)
+    {
+      TNCT_LOG_ERR(_logger, "error creating replayer");
+      return false;
+    }
+
+    market_dispatcher _dispatcher(_logger);
+    auto _replay{[&](double p_speed)
+                 {
+                   const auto _start{std::chrono::steady_clock::now()};
+                   if (_replayer->replay(_dispatcher, p_speed)
+                       != async::dat::result::OK)
+                   {
+                     return std::chrono::milliseconds::max();
+                   }
+                   return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - _start);
+                 }};
+
+    const std::chrono::milliseconds _original{_replay(1)};
+    const std::chrono::milliseconds _ten_times{_replay(10)};
+    const std::chrono::milliseconds _fastest{_replay(0)};
+
+    std::filesystem::remove(_path);
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("original = ", _original.count(),
+                                  "ms, 10x = ", _ten_times.count(),
+                                  "ms, fastest = ", _fastest.count(), "ms"));
+
+    // the first event is published right away
+    return (_original >= 115ms) && (_original < 400ms) && (_ten_times >= 11ms)
+           && (_ten_times < 100ms) && (_fastest < 11ms);
+  }
+
+private:
+  static constexpr std::size_t m_amount{5};
+};
+
+struct record_002
+{
+  static std::string desc()
+  {
+    return "A replayer is not created for a file that does not exist, or that "
+           "is not a recording, and replaying a truncated recording publishes "
+           "the complete events, and fails";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const std::filesystem::path _path{recording_path("record_002")};
+
+    std::filesystem::remove(_path);
+    if (market_replayer::create(_logger, _path))
+    {
+      TNCT_LOG_ERR(_logger, "replayer created for a file that does not exist");
+      return false;
+    }
+
+    {
+      std::ofstream _file{_path, std::ios::binary};
+      _file << "this is not a recording";
+    }
+    if (market_replayer::create(_logger, _path))
+    {
+      TNCT_LOG_ERR(_logger, "replayer created for a file that is not a "
+                            "recording");
+      return false;
+    }
+
+    {
+      market_dispatcher              _dispatcher(_logger);
+      std::optional<market_recorder> _recorder{
+          market_recorder::create(_logger, _path)};
+      if (!_recorder
+          || (_recorder->attach(_dispatcher) != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error creating recorder");
+        return false;
+      }
+      for (std::uint32_t _i = 0; _i < 3; ++_i)
+      {
+        static_cast<void>(_dispatcher.publish(trade{_i, "ABC"}));
+      }
+    }
+
+    // cuts the last byte of the symbol of the last trade
+    std::filesystem::resize_file(_path, std::filesystem::file_size(_path) - 1);
+
+    std::optional<market_replayer> _replayer{
+        market_replayer::create(_logger, _path)};
+    if (!_replayer)
+    {
+      TNCT_LOG_ERR(_logger, "error creating replayer");
+      return false;
+    }
+
+    market_dispatcher _dispatcher(_logger);
+    const async::dat::result _result{_replayer->replay(_dispatcher, 0)};
+
+    std::filesystem::remove(_path);
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("result = ", _result, ", replayed ",
+                                           _replayer->get_amount_replayed()));
+
+    return (_result == async::dat::result::ERROR_REPLAYING)
+           && (_replayer->get_amount_replayed() == 2);
+  }
+};
+
+struct record_003
+{
+  static std::string desc()
+  {
+    return "Replaying 5 trades to a handling that holds 1 in its handler, "
+           "and rejects events beyond 1 in its queue, publishes all of them, "
+           "and counts the ones not accepted";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const std::filesystem::path _path{recording_path("record_003")};
+    {
+      market_dispatcher              _dispatcher(_logger);
+      std::optional<market_recorder> _recorder{
+          market_recorder::create(_logger, _path)};
+      if (!_recorder
+          || (_recorder->attach(_dispatcher) != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error creating recorder");
+        return false;
+      }
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        static_cast<void>(_dispatcher.publish(trade{_i, "ABC"}));
+      }
+    }
+
+    std::optional<market_replayer> _replayer{
+        market_replayer::create(_logger, _path)};
+    auto _queue{market_queue_trade::create(_logger, 64)};
+    if (!_replayer || !_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating replayer");
+      return false;
+    }
+
+    std::atomic_bool   _release{false};
+    async::dat::result _result{async::dat::result::OK};
+    {
+      market_dispatcher _dispatcher(_logger);
+      if ((_dispatcher.add_handling<trade>("trades", std::move(*_queue),
+                                           [&](trade &&)
+                                           {
+                                             while (!_release)
+                                             {
+                                               std::this_thread::sleep_for(
+                                                   1ms);
+                                             }
+                                           })
+           != async::dat::result::OK)
+          || (_dispatcher.set_overflow_policy<trade>(
+                  "trades", async::dat::overflow_policy::reject, 1)
+              != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error adding handling");
+        return false;
+      }
+
+      _result  = _replayer->replay(_dispatcher, 0);
+      _release = true;
+    }
+
+    std::filesystem::remove(_path);
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("result = ", _result, ", replayed ",
+                                  _replayer->get_amount_replayed(),
+                                  ", not replayed ",
+                                  _replayer->get_amount_not_replayed()));
+
+    // the handler holds at most 1 event, and the queue 1 more
+    return (_result == async::dat::result::OK)
+           && (_replayer->get_amount_replayed() >= 1)
+           && (_replayer->get_amount_not_replayed() >= (m_amount - 2))
+           && ((_replayer->get_amount_replayed()
+                + _replayer->get_amount_not_replayed())
+               == m_amount);
+  }
+
+private:
+  static constexpr std::size_t m_amount{5};
+};
+
+} // namespace tnct::async::tst
+
+#endif
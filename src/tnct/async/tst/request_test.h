@@ -0,0 +1,264 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_REQUEST_TEST_H
+#define TNCT_ASYNC_TST_REQUEST_TEST_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/dat/reply.h"
+#include "tnct/async/dat/request.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_square
+{
+  event_square(std::int32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream       &p_out,
+                                  const event_square &p_event)
+  {
+    p_out << p_event.value;
+    return p_out;
+  }
+
+  std::int32_t value;
+};
+
+using request_square = async::dat::request<event_square, std::int64_t>;
+
+using request_dispatcher = async::bus::dispatcher<log::cerr, request_square>;
+
+using request_queue = container::dat::circular_queue<log::cerr, request_square>;
+
+struct request_000
+{
+  static std::string desc()
+  {
+    return "100 requests, each replied by one of 4 handlers with the square of "
+           "the value of the event";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr          _logger;
+    request_dispatcher _dispatcher(_logger);
+
+    auto _queue{request_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<request_square>(
+            "square", std::move(*_queue),
+            [](request_square &&p_request)
+            {
+              const std::int64_t _value{p_request.get_event().value};
+              p_request.reply(_value * _value);
+            },
+            async::dat::handling_priority::medium, 4)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    std::vector<async::dat::reply<std::int64_t>> _replies;
+    for (std::int32_t _i = 0; _i < 100; ++_i)
+    {
+      _replies.push_back(
+          _dispatcher.request<std::int64_t>(event_square{_i}));
+    }
+
+    for (std::int32_t _i = 0; _i < 100; ++_i)
+    {
+      const std::optional<std::int64_t> _reply{_replies[_i].get()};
+      if (!_reply || (*_reply != (_i * _i)))
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("wrong reply for ", _i));
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+struct request_001
+{
+  static std::string desc()
+  {
+    return "A request that is not replied by the handler, or that has no "
+           "handling, gives an empty reply, without waiting for a timeout";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr          _logger;
+    request_dispatcher _dispatcher(_logger);
+
+    async::dat::reply<std::int64_t> _no_handling{
+        _dispatcher.request<std::int64_t>(event_square{3})};
+    if (!_no_handling.is_ready() || _no_handling.get())
+    {
+      TNCT_LOG_ERR(_logger, "reply with no handling should be empty");
+      return false;
+    }
+
+    auto _queue{request_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<request_square>(
+            "ignore", std::move(*_queue), [](request_square &&) {})
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    const auto _start{std::chrono::steady_clock::now()};
+    const std::optional<std::int64_t> _reply{
+        _dispatcher.request<std::int64_t>(event_square{3}).get(5s)};
+    const auto _elapsed{std::chrono::steady_clock::now() - _start};
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("waited ",
+                                  std::chrono::duration_cast<
+                                      std::chrono::microseconds>(_elapsed)
+                                      .count(),
+                                  "us"));
+
+    return !_reply && (_elapsed < 1s);
+  }
+};
+
+struct request_002
+{
+  static std::string desc()
+  {
+    return "A request whose handler takes 300ms is not replied in a 50ms "
+           "timeout";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr          _logger;
+    request_dispatcher _dispatcher(_logger);
+
+    auto _queue{request_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<request_square>(
+            "slow", std::move(*_queue),
+            [](request_square &&p_request)
+            {
+              std::this_thread::sleep_for(300ms);
+              p_request.reply(p_request.get_event().value);
+            })
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding handling");
+      return false;
+    }
+
+    const std::optional<std::int64_t> _reply{
+        _dispatcher.request<std::int64_t>(event_square{7}).get(50ms)};
+    if (_reply)
+    {
+      TNCT_LOG_ERR(_logger, "there should be no reply");
+      return false;
+    }
+
+    // the handler can still reply, but no one is waiting
+    std::this_thread::sleep_for(400ms);
+    return true;
+  }
+};
+
+struct request_003
+{
+  static std::string desc()
+  {
+    return "A request published to an inline handling and to a handling with a "
+           "queue keeps only the first reply, the one of the inline handling, "
+           "ready when 'request' returns";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr          _logger;
+    request_dispatcher _dispatcher(_logger);
+
+    auto _queue{request_queue::create(_logger, 16)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    if (_dispatcher.add_handling<request_square>(
+            "queued", std::move(*_queue),
+            [](request_square &&p_request) { p_request.reply(-1); },
+            async::dat::handling_priority::low)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding queued handling");
+      return false;
+    }
+
+    if (_dispatcher.add_inline_handling<request_square>(
+            "inline",
+            [](request_square &&p_request)
+            { p_request.reply(p_request.get_event().value * 2); },
+            async::dat::handling_priority::highest)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error adding inline handling");
+      return false;
+    }
+
+    async::dat::reply<std::int64_t> _reply{
+        _dispatcher.request<std::int64_t>(event_square{21})};
+    if (!_reply.is_ready())
+    {
+      TNCT_LOG_ERR(_logger, "reply of inline handling should be ready");
+      return false;
+    }
+
+    const std::optional<std::int64_t> _value{_reply.get()};
+    TNCT_LOG_TST(_logger, format::bus::fmt("reply = ", _value.value_or(0)));
+    return _value && (*_value == 42);
+  }
+};
+
+} // namespace tnct::async::tst
+
+#endif
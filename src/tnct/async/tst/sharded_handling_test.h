@@ -0,0 +1,273 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_SHARDED_HANDLING_TEST_H
+#define TNCT_ASYNC_TST_SHARDED_HANDLING_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/cpt/is_key_extractor.h"
+#include "tnct/async/dat/handling_metrics.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_reading
+{
+  event_reading(std::uint16_t p_sensor = 0, std::uint32_t p_sequence = 0)
+      : sensor(p_sensor), sequence(p_sequence)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream        &p_out,
+                                  const event_reading &p_event)
+  {
+    p_out << '(' << p_event.sensor << ',' << p_event.sequence << ')';
+    return p_out;
+  }
+
+  std::uint16_t sensor;
+  std::uint32_t sequence;
+};
+
+// Publishes 'm_amount' readings of each of 'num_sensors' sensors to a sharded
+// handling, and checks that the readings of each sensor were handled in the
+// order they were published, and by only one thread
+struct sharded_reading_checker
+{
+  using dispatcher = async::bus::dispatcher<log::cerr, event_reading>;
+
+  using queue = container::dat::circular_queue<log::cerr, event_reading>;
+
+  sharded_reading_checker(log::cerr &p_logger) : m_logger(p_logger)
+  {
+  }
+
+  bool operator()(dispatcher &p_dispatcher, std::size_t p_num_shards)
+  {
+    auto _queue{queue::create(m_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(m_logger, "error creating queue");
+      return false;
+    }
+
+    auto _handler = [this](event_reading &&p_event)
+    {
+      // some work, so readings of the same sensor pile up in the queue
+      std::this_thread::sleep_for(10us);
+
+      std::lock_guard<std::mutex> _lock(m_mutex);
+      m_sequences[p_event.sensor].push_back(p_event.sequence);
+      m_threads[p_event.sensor].insert(std::this_thread::get_id());
+      ++m_handled;
+    };
+
+    auto _sensor = [](const event_reading &p_event) { return p_event.sensor; };
+
+    static_assert(
+        async::cpt::is_key_extractor<decltype(_sensor), event_reading>);
+
+    if (p_dispatcher.add_sharded_handling<event_reading>(
+            "readings", std::move(*_queue), std::move(_handler),
+            std::move(_sensor), p_num_shards)
+        != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(m_logger, "error adding handling");
+      return false;
+    }
+
+    if (p_dispatcher.get_amount_handlers<event_reading>("readings")
+        != p_num_shards)
+    {
+      TNCT_LOG_ERR(m_logger, "wrong amount of handlers");
+      return false;
+    }
+
+    std::vector<std::thread> _publishers;
+    for (std::uint16_t _sensor = 0; _sensor < num_sensors; ++_sensor)
+    {
+      _publishers.emplace_back(
+          [&, _sensor]()
+          {
+            for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+            {
+              if (p_dispatcher.publish<event_reading>(_sensor, _i)
+                  != async::dat::result::OK)
+              {
+                TNCT_LOG_ERR(m_logger, "error publishing");
+              }
+            }
+          });
+    }
+    for (std::thread &_publisher : _publishers)
+    {
+      _publisher.join();
+    }
+
+    for (int _i = 0; (_i < 500) && (m_handled < (num_sensors * m_amount));
+         ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    TNCT_LOG_TST(m_logger, format::bus::fmt("handled ", m_handled.load()));
+
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    for (std::uint16_t _sensor = 0; _sensor < num_sensors; ++_sensor)
+    {
+      const std::vector<std::uint32_t> &_sequences{m_sequences[_sensor]};
+      if (_sequences.size() != m_amount)
+      {
+        TNCT_LOG_ERR(m_logger,
+                     format::bus::fmt("sensor ", _sensor, " has ",
+                                      _sequences.size(), " readings"));
+        return false;
+      }
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_sequences[_i] != _i)
+        {
+          TNCT_LOG_ERR(m_logger,
+                       format::bus::fmt("sensor ", _sensor, " reading ",
+                                        _sequences[_i], " at position ", _i));
+          return false;
+        }
+      }
+      if (m_check_threads && (m_threads[_sensor].size() != 1))
+      {
+        TNCT_LOG_ERR(m_logger,
+                     format::bus::fmt("sensor ", _sensor, " handled in ",
+                                      m_threads[_sensor].size(), " threads"));
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // In a pool, the tasks of a shard may run in different threads, one at a
+  // time
+  void do_not_check_threads()
+  {
+    m_check_threads = false;
+  }
+
+  static constexpr std::uint16_t num_sensors{8};
+
+private:
+  log::cerr &m_logger;
+
+  static constexpr std::uint32_t m_amount{500};
+
+  std::mutex m_mutex;
+
+  std::map<std::uint16_t, std::vector<std::uint32_t>> m_sequences;
+
+  std::map<std::uint16_t, std::set<std::thread::id>> m_threads;
+
+  std::atomic_size_t m_handled{0};
+
+  bool m_check_threads{true};
+};
+
+struct sharded_handling_000
+{
+  static std::string desc()
+  {
+    return "A sharded handling with 4 shards, keyed by sensor, handles the "
+           "readings of 8 sensors, published by 8 threads, in the order they "
+           "were published, and each sensor in only one thread";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                           _logger;
+    sharded_reading_checker::dispatcher _dispatcher(_logger);
+
+    return sharded_reading_checker{_logger}(_dispatcher, 4);
+  }
+};
+
+struct sharded_handling_001
+{
+  static std::string desc()
+  {
+    return "A sharded handling with 4 shards, keyed by sensor, in a dispatcher "
+           "that uses a 'work_stealing_pool', handles the readings of 8 "
+           "sensors in the order they were published";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                                 _logger;
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 4);
+    sharded_reading_checker::dispatcher       _dispatcher(_logger, _pool);
+
+    sharded_reading_checker _checker{_logger};
+    _checker.do_not_check_threads();
+    return _checker(_dispatcher, 4);
+  }
+};
+
+struct sharded_handling_002
+{
+  static std::string desc()
+  {
+    return "The metrics of a sharded handling with 3 shards add the ones of "
+           "the shards, with one handler per shard";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                           _logger;
+    sharded_reading_checker::dispatcher _dispatcher(_logger);
+
+    if (!sharded_reading_checker{_logger}(_dispatcher, 3))
+    {
+      return false;
+    }
+
+    const std::optional<async::dat::handling_metrics> _metrics{
+        _dispatcher.get_metrics<event_reading>("readings")};
+    if (!_metrics)
+    {
+      TNCT_LOG_ERR(_logger, "no metrics");
+      return false;
+    }
+
+    TNCT_LOG_TST(_logger, format::bus::fmt(*_metrics));
+
+    constexpr std::uint64_t _expected{sharded_reading_checker::num_sensors
+                                      * 500};
+
+    return (_metrics->name == "readings") && (_metrics->published == _expected)
+           && (_metrics->handled == _expected) && (_metrics->queued == 0)
+           && (_metrics->handlers.size() == 3)
+           && (_metrics->handler_time.get_count() == _expected);
+  }
+};
+
+} // namespace tnct::async::tst
+
+#endif
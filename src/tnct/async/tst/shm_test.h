@@ -0,0 +1,324 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_SHM_TEST_H
+#define TNCT_ASYNC_TST_SHM_TEST_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/shm_receiver.h"
+#include "tnct/async/bus/shm_sender.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/async/tst/record_test.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+using market_sender =
+    async::bus::shm_sender<log::cerr, market_serializer, trade, quote>;
+
+using market_receiver =
+    async::bus::shm_receiver<log::cerr, market_serializer, trade, quote>;
+
+// Collects the events published to a dispatcher in the thread that publishes
+// them, so, as a receiver publishes from one thread, in the order they were
+// sent
+struct shm_collector
+{
+  bool attach(market_dispatcher &p_dispatcher,
+              std::chrono::microseconds p_delay = 0us)
+  {
+    delay = p_delay;
+    return (p_dispatcher.add_inline_handling<trade>(
+                "trades", [this](trade &&p_trade) { add(std::move(p_trade)); })
+            == async::dat::result::OK)
+           && (p_dispatcher.add_inline_handling<quote>(
+                   "quotes",
+                   [this](quote &&p_quote) { add(std::move(p_quote)); })
+               == async::dat::result::OK);
+  }
+
+  template <typename t_event> void add(t_event &&p_event)
+  {
+    if (delay != 0us)
+    {
+      std::this_thread::sleep_for(delay);
+    }
+    std::lock_guard<std::mutex> _lock(mutex);
+    events.emplace_back(std::forward<t_event>(p_event));
+  }
+
+  bool wait_for(std::size_t p_amount)
+  {
+    for (int _i = 0; _i < 500; ++_i)
+    {
+      {
+        std::lock_guard<std::mutex> _lock(mutex);
+        if (events.size() >= p_amount)
+        {
+          return true;
+        }
+      }
+      std::this_thread::sleep_for(10ms);
+    }
+    return false;
+  }
+
+  std::chrono::microseconds delay{0};
+
+  std::mutex mutex;
+
+  std::vector<std::variant<trade, quote>> events;
+};
+
+// Sends 'p_amount' trades and quotes, where the symbol of a trade has up to
+// 'p_symbol_size' chars, through a ring of 'p_capacity' bytes, and checks
+// they are received in the order they were published
+inline bool shm_round_trip(log::cerr &p_logger, const std::string &p_name,
+                           std::size_t p_capacity, std::uint32_t p_amount,
+                           std::size_t               p_symbol_size,
+                           std::chrono::microseconds p_delay)
+{
+  std::optional<market_sender> _sender{
+      market_sender::create(p_logger, p_name, p_capacity)};
+  if (!_sender)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating sender");
+    return false;
+  }
+
+  std::optional<market_receiver> _receiver{
+      market_receiver::create(p_logger, p_name)};
+  if (!_receiver)
+  {
+    TNCT_LOG_ERR(p_logger, "error creating receiver");
+    return false;
+  }
+
+  market_dispatcher _receiving(p_logger);
+  shm_collector     _collector;
+  if (!_collector.attach(_receiving, p_delay)
+      || (_receiver->start(_receiving) != async::dat::result::OK))
+  {
+    TNCT_LOG_ERR(p_logger, "error starting receiver");
+    return false;
+  }
+
+  market_dispatcher _sending(p_logger);
+  if (_sender->attach(_sending) != async::dat::result::OK)
+  {
+    TNCT_LOG_ERR(p_logger, "error attaching sender");
+    return false;
+  }
+
+  std::vector<std::variant<trade, quote>> _published;
+  for (std::uint32_t _i = 0; _i < p_amount; ++_i)
+  {
+    if ((_i % 3) == 0)
+    {
+      const quote _quote{10.0 + _i};
+      _published.emplace_back(_quote);
+      static_cast<void>(_sending.publish(_quote));
+    }
+    else
+    {
+      const trade _trade{_i, std::string((_i * 7) % p_symbol_size, 'a')
+                                 + std::to_string(_i)};
+      _published.emplace_back(_trade);
+      static_cast<void>(_sending.publish(_trade));
+    }
+  }
+
+  const bool _received{_collector.wait_for(p_amount)};
+  _receiver->stop();
+
+  TNCT_LOG_TST(p_logger,
+               format::bus::fmt("sent ", _sender->get_amount_sent(),
+                                ", received ",
+                                _receiver->get_amount_received()));
+
+  return _received && (_sender->get_amount_sent() == p_amount)
+         && (_receiver->get_amount_received() == p_amount)
+         && (_collector.events == _published);
+}
+
+struct shm_000
+{
+  static std::string desc()
+  {
+    return "Trades and quotes published to a dispatcher are sent through "
+           "shared memory to another dispatcher, which receives the same "
+           "events, in the same order";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+    return shm_round_trip(_logger, "/tnct-shm_000", 1 << 16, 1000, 16, 0us);
+  }
+};
+
+struct shm_001
+{
+  static std::string desc()
+  {
+    return "Events of up to 1000 bytes sent through a ring of 4096 bytes, "
+           "to a slow receiver, wrap around the ring, and make the publisher "
+           "wait for space, and none is lost";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+    return shm_round_trip(_logger, "/tnct-shm_001", 4096, 600, 1000, 50us);
+  }
+};
+
+struct shm_002
+{
+  static std::string desc()
+  {
+    return "A receiver is not created for a segment that does not exist, or "
+           "that has other types of events, and an event larger than half of "
+           "the ring is not sent";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    const std::string _name{"/tnct-shm_002"};
+
+    if (market_receiver::create(_logger, _name))
+    {
+      TNCT_LOG_ERR(_logger, "receiver created for a segment that does not "
+                            "exist");
+      return false;
+    }
+
+    std::optional<market_sender> _sender{
+        market_sender::create(_logger, _name, 4096)};
+    if (!_sender)
+    {
+      TNCT_LOG_ERR(_logger, "error creating sender");
+      return false;
+    }
+
+    using quote_receiver =
+        async::bus::shm_receiver<log::cerr, market_serializer, quote>;
+    if (quote_receiver::create(_logger, _name))
+    {
+      TNCT_LOG_ERR(_logger, "receiver created for a segment with other "
+                            "types of events");
+      return false;
+    }
+
+    std::optional<market_receiver> _receiver{
+        market_receiver::create(_logger, _name)};
+    market_dispatcher _receiving(_logger);
+    shm_collector     _collector;
+    if (!_receiver || !_collector.attach(_receiving)
+        || (_receiver->start(_receiving) != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error starting receiver");
+      return false;
+    }
+
+    market_dispatcher _sending(_logger);
+    if (_sender->attach(_sending) != async::dat::result::OK)
+    {
+      TNCT_LOG_ERR(_logger, "error attaching sender");
+      return false;
+    }
+
+    static_cast<void>(_sending.publish(trade{1, std::string(4096, 'x')}));
+    static_cast<void>(_sending.publish(trade{2, "small"}));
+
+    const bool _received{_collector.wait_for(1)};
+    _receiver->stop();
+
+    return _received && (_sender->get_amount_sent() == 1)
+           && (_sender->get_amount_not_sent() == 1)
+           && (_collector.events.size() == 1)
+           && (std::get<trade>(_collector.events[0]) == trade{2, "small"});
+  }
+};
+
+struct shm_003
+{
+  static std::string desc()
+  {
+    return "With no receiver reading, a publisher waits for space only once, "
+           "the events that do not fit are dropped, and 'stop' removes the "
+           "handlings from the dispatcher";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr _logger;
+
+    std::optional<market_sender> _sender{
+        market_sender::create(_logger, "/tnct-shm_003", 4096, 20ms)};
+    market_dispatcher _sending(_logger);
+    if (!_sender || (_sender->attach(_sending) != async::dat::result::OK))
+    {
+      TNCT_LOG_ERR(_logger, "error attaching sender");
+      return false;
+    }
+
+    const auto _start{std::chrono::steady_clock::now()};
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (_sending.publish(trade{_i, std::string(100, 'x')})
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("error publishing ", _i));
+        return false;
+      }
+    }
+    const auto _elapsed{std::chrono::steady_clock::now() - _start};
+
+    _sender->stop();
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt(
+                     "sent = ", _sender->get_amount_sent(),
+                     ", not sent = ", _sender->get_amount_not_sent(),
+                     ", elapsed = ",
+                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                         _elapsed)
+                         .count(),
+                     " ms"));
+
+    return (_sender->get_amount_not_sent() > 0)
+           && ((_sender->get_amount_sent() + _sender->get_amount_not_sent())
+               == m_amount)
+           && (_elapsed < 500ms)
+           && (_sending.get_amount_handlings<trade>() == 0)
+           && (_sending.get_amount_handlings<quote>() == 0);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{200};
+};
+
+} // namespace tnct::async::tst
+
+#endif
@@ -6,6 +6,8 @@
 #ifndef TNCT_ASYNC_TST_SLEEPING_LOOP_TEST_H
 #define TNCT_ASYNC_TST_SLEEPING_LOOP_TEST_H
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
@@ -13,8 +15,10 @@
 #include <mutex>
 #include <sstream>
 #include <thread>
+#include <vector>
 
 #include "tnct/async/bus/sleeping_loop.h"
+#include "tnct/async/bus/timer_wheel.h"
 #include "tnct/format/bus/fmt.h"
 #include "tnct/log/bus/cerr.h"
 #include "tnct/log/cpt/macros.h"
@@ -165,5 +169,255 @@ struct sleeping_loop_002
     return true;
   }
 };
+struct sleeping_loop_003
+{
+  static std::string desc()
+  {
+    return "A loop with interval of 20ms, whose function takes 5ms, is called "
+           "about 50 times in 1s, as the interval is counted from the start "
+           "of the previous call, so the calls do not drift";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using loop = async::sleeping_loop<logger>;
+
+    logger _logger;
+
+    std::atomic_size_t _counter{0};
+
+    {
+      loop _loop{_logger,
+                 [&_counter]()
+                 {
+                   ++_counter;
+                   std::this_thread::sleep_for(5ms);
+                 },
+                 20ms, "loop-003"};
+
+      _loop.start();
+      std::this_thread::sleep_for(1s);
+    }
+
+    _logger.tst(format::bus::fmt("counter = ", _counter.load()));
+
+    // without drift, it would be about 40
+    return (_counter >= 48) && (_counter <= 51);
+  }
+};
+
+struct sleeping_loop_004
+{
+  static std::string desc()
+  {
+    return "1000 loops with interval of 10ms, in a 'timer_wheel' with 2 "
+           "worker threads, are all called about 20 times in 200ms";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using loop = async::sleeping_loop<logger>;
+
+    logger           _logger;
+    bus::timer_wheel _timer_wheel(2);
+
+    std::vector<std::atomic_size_t> _counters(m_amount);
+    {
+      std::vector<loop> _loops;
+      _loops.reserve(m_amount);
+      for (std::size_t _i = 0; _i < m_amount; ++_i)
+      {
+        _loops.emplace_back(
+            _logger, _timer_wheel, [&_counters, _i]() { ++_counters[_i]; },
+            10ms);
+      }
+      for (loop &_loop : _loops)
+      {
+        _loop.start();
+      }
+      std::this_thread::sleep_for(200ms);
+    }
+
+    const auto [_min, _max] =
+        std::minmax_element(_counters.begin(), _counters.end(),
+                            [](const std::atomic_size_t &p_a,
+                               const std::atomic_size_t &p_b)
+                            { return p_a.load() < p_b.load(); });
+
+    _logger.tst(format::bus::fmt("min = ", _min->load(),
+                                 ", max = ", _max->load()));
+
+    return (_min->load() >= 18) && (_max->load() <= 21);
+  }
+
+private:
+  static constexpr std::size_t m_amount{1000};
+};
+
+struct sleeping_loop_005
+{
+  static std::string desc()
+  {
+    return "In a 'timer_wheel' with a tick of 10us, a loop with interval of "
+           "700ms, kept in the higher levels of the wheel, is never called "
+           "before it is due, nor more than 20ms after";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using loop = async::sleeping_loop<logger>;
+
+    logger           _logger;
+    bus::timer_wheel _timer_wheel(1, 10us);
+
+    std::mutex                                       _mutex;
+    std::vector<bus::timer_wheel::clock::time_point> _calls;
+
+    {
+      loop _loop{_logger, _timer_wheel,
+                 [&]()
+                 {
+                   std::lock_guard<std::mutex> _lock(_mutex);
+                   _calls.push_back(bus::timer_wheel::clock::now());
+                 },
+                 700ms};
+      _loop.start();
+      std::this_thread::sleep_for(1500ms);
+    }
+
+    if (_calls.size() != 3)
+    {
+      _logger.err(format::bus::fmt("called ", _calls.size(), " times"));
+      return false;
+    }
+    for (std::size_t _i = 1; _i < _calls.size(); ++_i)
+    {
+      const auto _delay{(_calls[_i] - _calls[0])
+                        - (static_cast<int>(_i) * 700ms)};
+      _logger.tst(format::bus::fmt(
+          "call ", _i, " delay = ",
+          std::chrono::duration_cast<std::chrono::microseconds>(_delay).count(),
+          "us"));
+      if ((_delay < -1ms) || (_delay > 20ms))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+struct sleeping_loop_006
+{
+  static std::string desc()
+  {
+    return "A loop stopped inside its function is not called again, and the "
+           "destructor of a loop waits for the call that is running";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using loop = async::sleeping_loop<logger>;
+
+    logger _logger;
+
+    std::atomic_size_t _counter{0};
+    {
+      loop *_self{nullptr};
+      loop  _loop{_logger,
+                 [&]()
+                 {
+                   if (++_counter == 3)
+                   {
+                     _self->stop();
+                   }
+                 },
+                 5ms};
+      _self = &_loop;
+      _loop.start();
+      std::this_thread::sleep_for(100ms);
+      if (!_loop.is_stopped())
+      {
+        _logger.err("loop not stopped");
+        return false;
+      }
+    }
+    if (_counter != 3)
+    {
+      _logger.err(format::bus::fmt("counter = ", _counter.load()));
+      return false;
+    }
+
+    std::atomic_bool _finished{false};
+    {
+      loop _loop{_logger,
+                 [&]()
+                 {
+                   std::this_thread::sleep_for(100ms);
+                   _finished = true;
+                 },
+                 1s};
+      _loop.start();
+      std::this_thread::sleep_for(20ms);
+    }
+    return _finished;
+  }
+};
+
+struct sleeping_loop_007
+{
+  static std::string desc()
+  {
+    return "In a 'timer_wheel' where a timer with interval of 10s is pending, "
+           "timers of 5ms started later are called about 5ms after";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using clock = bus::timer_wheel::clock;
+
+    logger           _logger;
+    bus::timer_wheel _timer_wheel(1);
+
+    const bus::timer_wheel::timer_ptr _long{
+        _timer_wheel.start([]() {}, 10s)};
+    // the ticker sleeps until the 10s timer is due
+    std::this_thread::sleep_for(20ms);
+
+    bool _ok{true};
+    for (std::size_t _i = 0; _i < m_amount; ++_i)
+    {
+      std::mutex              _mutex;
+      std::condition_variable _cond;
+      bool                    _called{false};
+
+      const clock::time_point _start{clock::now()};
+      static_cast<void>(_timer_wheel.start_once(
+          [&]()
+          {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _called = true;
+            _cond.notify_one();
+          },
+          5ms));
+
+      std::unique_lock<std::mutex> _lock(_mutex);
+      _cond.wait_for(_lock, 1s, [&]() { return _called; });
+      const auto _delay{std::chrono::duration_cast<std::chrono::milliseconds>(
+          clock::now() - _start)};
+
+      _logger.tst(format::bus::fmt("call ", _i, " after ", _delay.count(),
+                                   "ms"));
+      _ok = _ok && _called && (_delay < 50ms);
+    }
+
+    bus::timer_wheel::cancel(_long);
+    return _ok;
+  }
+
+private:
+  static constexpr std::size_t m_amount{4};
+};
+
 } // namespace tnct::async::tst
 #endif
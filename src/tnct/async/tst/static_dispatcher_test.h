@@ -0,0 +1,330 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_STATIC_DISPATCHER_TEST_H
+#define TNCT_ASYNC_TST_STATIC_DISPATCHER_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/static_dispatcher.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/dat/handling_definition.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/overflow_policy.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_static_a
+{
+  event_static_a(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream         &p_out,
+                                  const event_static_a &p_event)
+  {
+    p_out << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+struct event_static_b
+{
+  event_static_b(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream         &p_out,
+                                  const event_static_b &p_event)
+  {
+    p_out << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+struct event_static_move_only
+{
+  event_static_move_only(std::uint32_t p_value = 0)
+      : value(std::make_unique<std::uint32_t>(p_value))
+  {
+  }
+
+  event_static_move_only(event_static_move_only &&)            = default;
+  event_static_move_only &operator=(event_static_move_only &&) = default;
+  event_static_move_only(const event_static_move_only &)       = delete;
+
+  friend std::ostream &operator<<(std::ostream                 &p_out,
+                                  const event_static_move_only &p_event)
+  {
+    p_out << (p_event.value ? *p_event.value : 0);
+    return p_out;
+  }
+
+  std::unique_ptr<std::uint32_t> value;
+};
+
+// Counts the events handled, and sums their values
+struct static_counter
+{
+  void handle(std::uint32_t p_value)
+  {
+    ++amount;
+    sum += p_value;
+  }
+
+  std::atomic_size_t   amount{0};
+  std::atomic_uint64_t sum{0};
+};
+
+inline bool wait_for_amount(const static_counter &p_counter,
+                            std::size_t           p_amount)
+{
+  for (int _i = 0; (_i < 200) && (p_counter.amount < p_amount); ++_i)
+  {
+    std::this_thread::sleep_for(10ms);
+  }
+  return p_counter.amount == p_amount;
+}
+
+struct static_dispatcher_000
+{
+  static std::string desc()
+  {
+    return "A 'static_dispatcher' with 2 handlings of 'event_static_a' and 1 "
+           "of 'event_static_b' delivers each event to the handlings of its "
+           "type";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue_a = container::dat::circular_queue<log::cerr, event_static_a>;
+    using queue_b = container::dat::circular_queue<log::cerr, event_static_b>;
+
+    log::cerr      _logger;
+    static_counter _counter_a_low;
+    static_counter _counter_a_high;
+    static_counter _counter_b;
+
+    auto _handler_a_low = [&](event_static_a &&p_event)
+    { _counter_a_low.handle(p_event.value); };
+    auto _handler_a_high = [&](event_static_a &&p_event)
+    { _counter_a_high.handle(p_event.value); };
+    auto _handler_b = [&](event_static_b &&p_event)
+    { _counter_b.handle(p_event.value); };
+
+    using definition_a_low =
+        dat::handling_definition<event_static_a, queue_a,
+                                 decltype(_handler_a_low),
+                                 dat::handling_priority::low>;
+    using definition_a_high =
+        dat::handling_definition<event_static_a, queue_a,
+                                 decltype(_handler_a_high),
+                                 dat::handling_priority::high>;
+    using definition_b =
+        dat::handling_definition<event_static_b, queue_b, decltype(_handler_b)>;
+
+    using dispatcher =
+        async::bus::static_dispatcher<log::cerr, definition_a_low,
+                                      definition_a_high, definition_b>;
+
+    static_assert(dispatcher::get_amount_handlings<event_static_a>() == 2);
+    static_assert(dispatcher::get_amount_handlings<event_static_b>() == 1);
+
+    auto _queue_a_low{queue_a::create(_logger, 64)};
+    auto _queue_a_high{queue_a::create(_logger, 64)};
+    auto _queue_b{queue_b::create(_logger, 64)};
+    if (!_queue_a_low || !_queue_a_high || !_queue_b)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    dispatcher _dispatcher(
+        _logger,
+        definition_a_low{"a-low", std::move(*_queue_a_low),
+                         std::move(_handler_a_low)},
+        definition_a_high{"a-high", std::move(*_queue_a_high),
+                          std::move(_handler_a_high), 2},
+        definition_b{"b", std::move(*_queue_b), std::move(_handler_b)});
+
+    std::uint64_t _sum{0};
+    for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+    {
+      const event_static_a _event{_i};
+      if ((_dispatcher.publish(_event) != dat::result::OK)
+          || (_dispatcher.publish<event_static_b>(_i) != dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+      _sum += _i;
+    }
+
+    if (!wait_for_amount(_counter_a_low, m_amount)
+        || !wait_for_amount(_counter_a_high, m_amount)
+        || !wait_for_amount(_counter_b, m_amount))
+    {
+      TNCT_LOG_ERR(_logger, format::bus::fmt(
+                                "handled ", _counter_a_low.amount.load(), ", ",
+                                _counter_a_high.amount.load(), ", ",
+                                _counter_b.amount.load()));
+      return false;
+    }
+
+    return (_counter_a_low.sum == _sum) && (_counter_a_high.sum == _sum)
+           && (_counter_b.sum == _sum)
+           && (_dispatcher.get_amount_handlers<1>() == 2)
+           && (_dispatcher.get_metrics<0>().handled == m_amount);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{1000};
+};
+
+struct static_dispatcher_001
+{
+  static std::string desc()
+  {
+    return "A move-only event is published to the only handling of its type "
+           "in a 'static_dispatcher'";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue =
+        container::dat::circular_queue<log::cerr, event_static_move_only>;
+
+    log::cerr      _logger;
+    static_counter _counter;
+
+    auto _handler = [&](event_static_move_only &&p_event)
+    { _counter.handle(*p_event.value); };
+
+    using definition = dat::handling_definition<event_static_move_only, queue,
+                                                decltype(_handler)>;
+    using dispatcher = async::bus::static_dispatcher<log::cerr, definition>;
+
+    auto _queue{queue::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    dispatcher _dispatcher(
+        _logger, definition{"move-only", std::move(*_queue), std::move(_handler)});
+
+    for (std::uint32_t _i = 1; _i <= m_amount; ++_i)
+    {
+      if (_dispatcher.publish(event_static_move_only{_i}) != dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+    }
+
+    return wait_for_amount(_counter, m_amount)
+           && (_counter.sum == (m_amount * (m_amount + 1)) / 2);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{100};
+};
+
+struct static_dispatcher_002
+{
+  static std::string desc()
+  {
+    return "A 'static_dispatcher' using a 'work_stealing_pool', with a batch "
+           "handler, handles all the events published with 'publish_batch', "
+           "and rejects events when the handling is full";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue = container::dat::circular_queue<log::cerr, event_static_a>;
+    using pool  = async::bus::work_stealing_pool<log::cerr>;
+
+    log::cerr      _logger;
+    pool           _pool(_logger, 2);
+    static_counter _counter;
+
+    auto _handler = [&](std::span<event_static_a> p_events)
+    {
+      for (const event_static_a &_event : p_events)
+      {
+        _counter.handle(_event.value);
+      }
+    };
+
+    using definition =
+        dat::handling_definition<event_static_a, queue, decltype(_handler)>;
+    using dispatcher = async::bus::static_dispatcher<log::cerr, definition>;
+
+    auto _queue{queue::create(_logger, 64)};
+    if (!_queue)
+    {
+      TNCT_LOG_ERR(_logger, "error creating queue");
+      return false;
+    }
+
+    {
+      dispatcher _dispatcher(_logger, _pool,
+                             definition{"batch", std::move(*_queue),
+                                        std::move(_handler), 1, 16});
+
+      std::vector<event_static_a> _events(m_amount, event_static_a{1});
+      if (_dispatcher.publish_batch<event_static_a>(_events)
+          != dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error publishing");
+        return false;
+      }
+
+      if (!wait_for_amount(_counter, m_amount))
+      {
+        TNCT_LOG_ERR(_logger,
+                     format::bus::fmt("handled ", _counter.amount.load()));
+        return false;
+      }
+
+      _dispatcher.set_overflow_policy<0>(dat::overflow_policy::reject, 0);
+      if (_dispatcher.publish<event_static_a>(1U) != dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "capacity 0 should mean no limit");
+        return false;
+      }
+    }
+
+    return _counter.sum >= m_amount;
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{1000};
+};
+
+} // namespace tnct::async::tst
+
+#endif
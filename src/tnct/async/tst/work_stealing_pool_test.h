@@ -0,0 +1,358 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_ASYNC_TST_WORK_STEALING_POOL_TEST_H
+#define TNCT_ASYNC_TST_WORK_STEALING_POOL_TEST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/async/bus/dispatcher.h"
+#include "tnct/async/bus/work_stealing_pool.h"
+#include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/result.h"
+#include "tnct/container/dat/circular_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/program/bus/options.h"
+
+using namespace std::chrono_literals;
+
+namespace tnct::async::tst
+{
+
+struct event_pool
+{
+  event_pool(std::uint32_t p_value = 0) : value(p_value)
+  {
+  }
+
+  friend std::ostream &operator<<(std::ostream &p_out, const event_pool &p_event)
+  {
+    p_out << p_event.value;
+    return p_out;
+  }
+
+  std::uint32_t value;
+};
+
+struct work_stealing_pool_000
+{
+  static std::string desc()
+  {
+    return "Submits 10000 tasks to a pool of 4 workers, and checks that all "
+           "of them were executed, and only in the threads of the pool";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                                 _logger;
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 4);
+
+    std::atomic_size_t         _executed{0};
+    std::mutex                 _mutex;
+    std::set<std::thread::id> _threads;
+
+    for (std::size_t _i = 0; _i < m_amount; ++_i)
+    {
+      if (!_pool.submit(
+              [&]()
+              {
+                ++_executed;
+                std::lock_guard<std::mutex> _lock(_mutex);
+                _threads.insert(std::this_thread::get_id());
+              }))
+      {
+        TNCT_LOG_ERR(_logger, "error submitting task");
+        return false;
+      }
+    }
+
+    _pool.stop();
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("executed ", _executed.load(), " tasks in ",
+                                  _threads.size(), " threads"));
+
+    return (_executed == m_amount) && (_threads.size() <= 4)
+           && (_threads.count(std::this_thread::get_id()) == 0)
+           && !_pool.submit([]() {});
+  }
+
+private:
+  static constexpr std::size_t m_amount{10000};
+};
+
+struct work_stealing_pool_001
+{
+  static std::string desc()
+  {
+    return "While the only worker of a pool is busy, submits a task with "
+           "'lowest' priority and a task with 'highest' priority, and checks "
+           "that the 'highest' one is executed first";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                                 _logger;
+    async::bus::work_stealing_pool<log::cerr> _pool(_logger, 1);
+
+    std::atomic_bool  _release{false};
+    std::vector<char> _order;
+
+    _pool.submit(
+        [&]()
+        {
+          while (!_release)
+          {
+            std::this_thread::sleep_for(1ms);
+          }
+        });
+
+    _pool.submit([&]() { _order.push_back('l'); },
+                 async::dat::handling_priority::lowest);
+    _pool.submit([&]() { _order.push_back('h'); },
+                 async::dat::handling_priority::highest);
+
+    _release = true;
+    _pool.stop();
+
+    return (_order.size() == 2) && (_order[0] == 'h') && (_order[1] == 'l');
+  }
+};
+
+struct work_stealing_pool_002
+{
+  static std::string desc()
+  {
+    return "A dispatcher with 3 handlings, each with 2 handlers, uses a pool "
+           "of 2 workers, and all the events are handled only in the threads "
+           "of the pool";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using pool       = async::bus::work_stealing_pool<log::cerr>;
+    using dispatcher = async::bus::dispatcher<log::cerr, event_pool>;
+    using queue      = container::dat::circular_queue<log::cerr, event_pool>;
+
+    log::cerr _logger;
+    pool      _pool(_logger, 2);
+
+    std::atomic_size_t         _handled{0};
+    std::mutex                 _mutex;
+    std::set<std::thread::id> _threads;
+
+    auto _handle = [&]()
+    {
+      ++_handled;
+      std::lock_guard<std::mutex> _lock(_mutex);
+      _threads.insert(std::this_thread::get_id());
+    };
+
+    {
+      dispatcher _dispatcher(_logger, _pool);
+
+      auto _handler_a = [&](event_pool &&) { _handle(); };
+      auto _handler_b = [&](event_pool &&) { _handle(); };
+      auto _handler_c = [&](event_pool &&) { _handle(); };
+
+      auto _queue_a{queue::create(_logger, 100)};
+      auto _queue_b{queue::create(_logger, 100)};
+      auto _queue_c{queue::create(_logger, 100)};
+      if (!_queue_a || !_queue_b || !_queue_c)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if ((_dispatcher.add_handling<event_pool>(
+               "handling-pool-a", std::move(*_queue_a), std::move(_handler_a),
+               async::dat::handling_priority::high, 2)
+           != async::dat::result::OK)
+          || (_dispatcher.add_handling<event_pool>(
+                  "handling-pool-b", std::move(*_queue_b),
+                  std::move(_handler_b), async::dat::handling_priority::medium,
+                  2)
+              != async::dat::result::OK)
+          || (_dispatcher.add_handling<event_pool>(
+                  "handling-pool-c", std::move(*_queue_c),
+                  std::move(_handler_c), async::dat::handling_priority::low, 2)
+              != async::dat::result::OK))
+      {
+        TNCT_LOG_ERR(_logger, "error adding handlings");
+        return false;
+      }
+
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_dispatcher.publish<event_pool>(_i) != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+      }
+
+      for (int _i = 0; (_i < 100) && (_handled < (3 * m_amount)); ++_i)
+      {
+        std::this_thread::sleep_for(20ms);
+      }
+    }
+
+    TNCT_LOG_TST(_logger,
+                 format::bus::fmt("handled ", _handled.load(), " events in ",
+                                  _threads.size(), " threads"));
+
+    return (_handled == (3 * m_amount)) && (_threads.size() <= 2)
+           && (_threads.count(std::this_thread::get_id()) == 0);
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{1000};
+};
+
+struct work_stealing_pool_003
+{
+  static std::string desc()
+  {
+    return "A handling with 1 handler in a pool of 4 workers handles the "
+           "events in the order they were published";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using pool       = async::bus::work_stealing_pool<log::cerr>;
+    using dispatcher = async::bus::dispatcher<log::cerr, event_pool>;
+    using queue      = container::dat::circular_queue<log::cerr, event_pool>;
+
+    log::cerr _logger;
+    pool      _pool(_logger, 4);
+
+    std::vector<std::uint32_t> _values;
+    std::atomic_size_t         _handled{0};
+
+    {
+      dispatcher _dispatcher(_logger, _pool);
+
+      auto _queue{queue::create(_logger, 100)};
+      if (!_queue)
+      {
+        TNCT_LOG_ERR(_logger, "error creating queue");
+        return false;
+      }
+
+      if (_dispatcher.add_handling<event_pool>(
+              "handling-pool-ordered", std::move(*_queue),
+              [&](event_pool &&p_event)
+              {
+                _values.push_back(p_event.value);
+                ++_handled;
+              })
+          != async::dat::result::OK)
+      {
+        TNCT_LOG_ERR(_logger, "error adding handling");
+        return false;
+      }
+
+      for (std::uint32_t _i = 0; _i < m_amount; ++_i)
+      {
+        if (_dispatcher.publish<event_pool>(_i) != async::dat::result::OK)
+        {
+          TNCT_LOG_ERR(_logger, "error publishing");
+          return false;
+        }
+      }
+
+      for (int _i = 0; (_i < 100) && (_handled < m_amount); ++_i)
+      {
+        std::this_thread::sleep_for(20ms);
+      }
+    }
+
+    for (std::uint32_t _i = 0; _i < _values.size(); ++_i)
+    {
+      if (_values[_i] != _i)
+      {
+        TNCT_LOG_ERR(_logger, format::bus::fmt("expected ", _i, ", but got ",
+                                               _values[_i]));
+        return false;
+      }
+    }
+
+    return _values.size() == m_amount;
+  }
+
+private:
+  static constexpr std::uint32_t m_amount{5000};
+};
+
+struct work_stealing_pool_004
+{
+  static std::string desc()
+  {
+    return "A task stops a pool of 4 workers, and checks that the pool does "
+           "not accept more tasks, that the tasks submitted before are "
+           "executed, and that the pool is destroyed after all of them";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using pool = async::bus::work_stealing_pool<log::cerr>;
+
+    log::cerr             _logger;
+    std::unique_ptr<pool> _pool{std::make_unique<pool>(_logger, 4)};
+
+    std::atomic_size_t _executed{0};
+    std::atomic_bool   _stopped{false};
+    std::atomic_bool   _rejected{false};
+
+    for (std::size_t _i = 0; _i < m_amount; ++_i)
+    {
+      _pool->submit(
+          [&]()
+          {
+            std::this_thread::sleep_for(100us);
+            ++_executed;
+          });
+    }
+
+    _pool->submit(
+        [&]()
+        {
+          _pool->stop();
+          _rejected = !_pool->submit([]() {});
+          _stopped  = true;
+        });
+
+    for (int _i = 0; (_i < 200) && !_stopped; ++_i)
+    {
+      std::this_thread::sleep_for(10ms);
+    }
+
+    _pool.reset();
+
+    TNCT_LOG_TST(_logger, format::bus::fmt("executed ", _executed.load(),
+                                           " tasks, stopped = ", _stopped.load(),
+                                           ", rejected = ", _rejected.load()));
+
+    return _stopped && _rejected && (_executed == m_amount);
+  }
+
+private:
+  static constexpr std::size_t m_amount{100};
+};
+
+} // namespace tnct::async::tst
+
+#endif
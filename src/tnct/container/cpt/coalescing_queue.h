@@ -0,0 +1,31 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_CPT_COALESCING_QUEUE_H
+#define TNCT_CONTAINER_CPT_COALESCING_QUEUE_H
+
+#include <concepts>
+
+#include "tnct/container/cpt/queue.h"
+
+namespace tnct::container::cpt
+{
+
+/// \brief A \p queue where a data may replace, in its place, an older one not
+/// popped yet, and that tells if that happened
+template <typename t, typename t_data>
+concept coalescing_queue =
+
+    queue<t, t_data> &&
+
+    requires(t p_t, t_data &&p_data) {
+      {
+        p_t.replace_or_push(std::move(p_data))
+      } -> std::same_as<bool>;
+    };
+
+} // namespace tnct::container::cpt
+
+#endif
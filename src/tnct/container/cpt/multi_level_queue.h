@@ -0,0 +1,33 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_CPT_MULTI_LEVEL_QUEUE_H
+#define TNCT_CONTAINER_CPT_MULTI_LEVEL_QUEUE_H
+
+#include <concepts>
+#include <optional>
+
+#include "tnct/container/cpt/queue.h"
+
+namespace tnct::container::cpt
+{
+
+/// \brief A \p queue that does not pop in the order data was pushed, but by
+/// levels of urgency, and that can pop the oldest data of the least urgent
+/// level, which is what is discarded when it has no space
+template <typename t, typename t_data>
+concept multi_level_queue =
+
+    queue<t, t_data> &&
+
+    requires(t p_t) {
+      {
+        p_t.pop_least_urgent()
+      } -> std::same_as<std::optional<t_data>>;
+    };
+
+} // namespace tnct::container::cpt
+
+#endif
@@ -20,11 +20,11 @@ concept queue =
 
     std::same_as<typename t::data, t_data> &&
 
-    std::copyable<t_data> &&
+    std::movable<t_data> &&
 
     ostream::cpt::has_output_operator<t_data> &&
 
-    std::copyable<t> &&
+    std::movable<t> &&
 
     std::same_as<typename t::data, t_data> &&
 
@@ -34,11 +34,12 @@ concept queue =
       } -> std::same_as<void>;
     } &&
 
-    requires(t p_t, const t_data &p_data) {
+    // pushing a copy is only required if the data can be copied
+    (!std::copy_constructible<t_data> || requires(t p_t, const t_data &p_data) {
       {
         p_t.push(p_data)
       } -> std::same_as<void>;
-    } &&
+    }) &&
 
     requires(t p_t) {
       {
@@ -0,0 +1,47 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_CPT_STAMPED_QUEUE_H
+#define TNCT_CONTAINER_CPT_STAMPED_QUEUE_H
+
+#include <concepts>
+#include <cstdint>
+#include <optional>
+
+#include "tnct/container/cpt/coalescing_queue.h"
+#include "tnct/container/cpt/queue.h"
+
+namespace tnct::container::cpt
+{
+
+/// \brief A queue that keeps a stamp, like the moment the data was pushed,
+/// with each data, and returns it when the data is popped
+template <typename t, typename t_data>
+concept stamped_queue =
+
+    queue<t, t_data> &&
+
+    requires(t p_t, t_data &&p_data, std::int64_t p_stamp,
+             std::int64_t &p_popped_stamp) {
+      {
+        p_t.push(std::move(p_data), p_stamp)
+      } -> std::same_as<void>;
+
+      {
+        p_t.pop(p_popped_stamp)
+      } -> std::same_as<std::optional<t_data>>;
+    } &&
+
+    // a coalescing queue also keeps the stamp of the data it replaces
+    (!coalescing_queue<t, t_data> || requires(t p_t, t_data &&p_data,
+                                              std::int64_t p_stamp) {
+      {
+        p_t.replace_or_push(std::move(p_data), p_stamp)
+      } -> std::same_as<bool>;
+    });
+
+} // namespace tnct::container::cpt
+
+#endif
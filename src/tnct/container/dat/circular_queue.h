@@ -7,6 +7,7 @@
 #define TNCT_CONTAINER_DAT_CIRCULAR_QUEUE_H
 
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <optional>
 #include <string_view>
@@ -25,9 +26,12 @@ namespace tnct::container::dat {
 /// The purpose is to avoid unnecessary memory allocations to create nodes in
 /// the queue by reusing nodes which data have been read
 ///
+/// A stamp, like the moment the data was pushed, can be pushed with a data,
+/// and it is returned when the data is popped
+///
 /// \tparam t_data defines the types of the data contained in the queue
 template <log::cpt::logger t_logger, typename t_data>
-  requires std::move_constructible<t_data> && std::copy_constructible<t_data> &&
+  requires std::move_constructible<t_data> &&
            ostream::cpt::has_output_operator<t_data>
 class circular_queue final {
 public:
@@ -71,7 +75,8 @@ public:
       : m_logger(p_queue.m_logger), m_desc(p_queue.m_desc),
         m_initial_size(p_queue.m_initial_size),
         m_incremental_size(p_queue.m_incremental_size),
-        m_vector(p_queue.m_vector), m_head(p_queue.m_head),
+        m_vector(p_queue.m_vector), m_stamps(p_queue.m_stamps),
+        m_head(p_queue.m_head),
         m_tail(p_queue.m_tail), m_occupied(p_queue.m_occupied) {}
 
   circular_queue(circular_queue &&p_queue)
@@ -79,6 +84,7 @@ public:
         m_initial_size(p_queue.m_initial_size),
         m_incremental_size(p_queue.m_incremental_size),
         m_vector(std::move(p_queue.m_vector)),
+        m_stamps(std::move(p_queue.m_stamps)),
         m_head(std::move(p_queue.m_head)), m_tail(std::move(p_queue.m_tail)),
         m_occupied(p_queue.m_occupied) {}
 
@@ -88,6 +94,7 @@ public:
       m_initial_size = p_queue.m_initial_size;
       m_incremental_size = p_queue.m_incremental_size;
       m_vector = p_queue.m_vector;
+      m_stamps = p_queue.m_stamps;
       m_head = p_queue.m_head;
       m_tail = p_queue.m_tail;
       m_occupied = p_queue.m_occupied;
@@ -102,6 +109,7 @@ public:
       m_initial_size = p_queue.m_initial_size;
       m_incremental_size = p_queue.m_incremental_size;
       m_vector = std::move(p_queue.m_vector);
+      m_stamps = std::move(p_queue.m_stamps);
       m_head = p_queue.m_head;
       m_tail = p_queue.m_tail;
       m_occupied = p_queue.m_occupied;
@@ -143,7 +151,10 @@ public:
     return _out.str();
   }
 
-  void push(t_data &&p_data) {
+  void push(t_data &&p_data) { push(std::move(p_data), 0); }
+
+  /// \brief Inserts \p p_data, and \p p_stamp, returned when it is popped
+  void push(t_data &&p_data, std::int64_t p_stamp) {
     std::lock_guard<std::mutex> _lock(m_mutex);
 
     TNCT_LOG_TRA(this->m_logger,
@@ -153,7 +164,8 @@ public:
       enlarge();
     }
 
-    m_vector[m_head] = std::optional<t_data>(p_data);
+    m_vector[m_head].emplace(std::move(p_data));
+    m_stamps[m_head] = p_stamp;
 
     if (m_head == (m_vector.size() - 1)) {
       m_head = 0;
@@ -166,7 +178,9 @@ public:
                  format::bus::fmt("push - leaving: ", brief_report()));
   }
 
-  void push(const t_data &p_data) {
+  void push(const t_data &p_data)
+    requires std::copy_constructible<t_data>
+  {
     std::lock_guard<std::mutex> _lock(m_mutex);
 
     TNCT_LOG_TRA(this->m_logger,
@@ -178,6 +192,7 @@ public:
     }
 
     m_vector[m_head] = std::optional<t_data>(p_data);
+    m_stamps[m_head] = 0;
 
     if (m_head == (m_vector.size() - 1)) {
       m_head = 0;
@@ -191,6 +206,12 @@ public:
   }
 
   std::optional<t_data> pop() {
+    std::int64_t _stamp{0};
+    return pop(_stamp);
+  }
+
+  /// \brief Pops a data, and writes to \p p_stamp the stamp pushed with it
+  std::optional<t_data> pop(std::int64_t &p_stamp) {
     std::lock_guard<std::mutex> _lock(m_mutex);
 
     TNCT_LOG_TRA(this->m_logger,
@@ -200,7 +221,9 @@ public:
       return std::nullopt;
     }
 
-    std::optional<t_data> _data(m_vector[m_tail]);
+    std::optional<t_data> _data(std::move(m_vector[m_tail]));
+    m_vector[m_tail].reset();
+    p_stamp = m_stamps[m_tail];
     ++m_tail;
 
     if (m_tail == m_vector.size()) {
@@ -238,13 +261,14 @@ public:
 
 private:
   using vector = std::vector<std::optional<t_data>>;
+  using stamps = std::vector<std::int64_t>;
 
 private:
   circular_queue(t_logger &p_logger, std::string_view p_desc,
                  std::size_t p_initial_size, std::size_t p_incremental_size)
       : m_logger(p_logger), m_desc(p_desc), m_initial_size(p_initial_size),
         m_incremental_size(p_incremental_size),
-        m_vector(m_initial_size, std::optional<t_data>()), m_head(0),
+        m_vector(m_initial_size), m_stamps(m_initial_size), m_head(0),
         m_tail(0) {
 
     TNCT_LOG_TRA(this->m_logger,
@@ -255,18 +279,11 @@ private:
     TNCT_LOG_TRA(this->m_logger,
                  format::bus::fmt("enlarging - entering ", full_report()));
 
-    vector _aux(m_vector.size() + m_incremental_size, std::optional<t_data>());
-
     auto _head(m_head);
     if (m_head == 0) {
       _head = m_vector.size();
     }
 
-    std::move(&m_vector[_head], &m_vector[m_vector.size()],
-              &_aux[_head + m_incremental_size]);
-
-    std::move(&m_vector[0], &m_vector[_head], &_aux[0]);
-
     // m_head = _head + 1;
 
     // m_tail += m_incremental_size;
@@ -279,7 +296,8 @@ private:
       m_tail += m_incremental_size;
     }
 
-    m_vector = std::move(_aux);
+    m_vector = enlarged(m_vector, _head);
+    m_stamps = enlarged(m_stamps, _head);
     TNCT_LOG_TRA(this->m_logger,
                  format::bus::fmt("enlarging - leaving ", full_report()));
 
@@ -287,6 +305,20 @@ private:
                  format::bus::fmt("enlarged - ", brief_report()));
   }
 
+  // Copy of \p p_vector with 'm_incremental_size' more positions before
+  // \p p_head
+  template <typename t_vector>
+  t_vector enlarged(t_vector &p_vector, std::size_t p_head) const {
+    t_vector _aux(p_vector.size() + m_incremental_size);
+
+    std::move(&p_vector[p_head], &p_vector[p_vector.size()],
+              &_aux[p_head + m_incremental_size]);
+
+    std::move(&p_vector[0], &p_vector[p_head], &_aux[0]);
+
+    return _aux;
+  }
+
 private:
   logger &m_logger;
   std::string m_desc;
@@ -294,6 +326,7 @@ private:
   size_t m_initial_size{0};
   size_t m_incremental_size{0};
   vector m_vector;
+  stamps m_stamps;
   size_t m_head{0};
   size_t m_tail{0};
   size_t m_occupied{0};
@@ -0,0 +1,296 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_DAT_COALESCING_QUEUE_H
+#define TNCT_CONTAINER_DAT_COALESCING_QUEUE_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/ostream/cpt/has_output_operator.h"
+
+namespace tnct::container::dat
+{
+
+/// \brief Implements a queue where a data replaces, in its place, the data with
+/// the same key that was not popped yet, instead of being added to the end
+///
+/// It is meant for data where only the latest value matters, like progress
+/// reports, so the amount of data in the queue is at most the amount of
+/// different keys.
+///
+/// \p t_key_of returns the key of a data, which must be hashable by
+/// \p std::hash.
+///
+/// As the queue grows as needed, \p full is always \p false, and \p capacity
+/// is the amount of data in the queue.
+///
+/// A stamp, like the moment the data was pushed, can be pushed with a data,
+/// and it is returned when the data is popped. A data that replaces another
+/// keeps its place, and its stamp.
+///
+/// \tparam t_data defines the types of the data contained in the queue
+template <log::cpt::logger t_logger, typename t_data, typename t_key_of>
+requires std::move_constructible<t_data>
+         && ostream::cpt::has_output_operator<t_data>
+         && std::copyable<t_key_of>
+         && requires(const t_key_of &p_key_of, const t_data &p_data) {
+              {
+                std::hash<std::remove_cvref_t<decltype(p_key_of(p_data))>>{}(
+                    p_key_of(p_data))
+              } -> std::convertible_to<std::size_t>;
+            }
+class coalescing_queue final
+{
+public:
+  using data   = t_data;
+  using logger = t_logger;
+  using key_of = t_key_of;
+
+public:
+  coalescing_queue() = delete;
+
+  static std::optional<coalescing_queue>
+  create(t_logger &p_logger, key_of p_key_of,
+         std::string_view p_desc = "NO DESC")
+  {
+    try
+    {
+      return coalescing_queue(p_logger, std::move(p_key_of), p_desc);
+    }
+    catch (...)
+    {
+      TNCT_LOG_ERR(p_logger,
+                   format::bus::fmt("Error creating 'coalescing_queue' named '",
+                                    p_desc, '\''));
+    }
+    return std::nullopt;
+  }
+
+  ~coalescing_queue() = default;
+
+  coalescing_queue(const coalescing_queue &p_queue)
+      : coalescing_queue(p_queue, std::lock_guard<std::mutex>(p_queue.m_mutex))
+  {
+  }
+
+  coalescing_queue(coalescing_queue &&p_queue)
+      : coalescing_queue(std::move(p_queue),
+                         std::lock_guard<std::mutex>(p_queue.m_mutex))
+  {
+  }
+
+  coalescing_queue &operator=(const coalescing_queue &p_queue)
+  {
+    if (this != &p_queue)
+    {
+      std::scoped_lock _lock(m_mutex, p_queue.m_mutex);
+      m_key_of    = p_queue.m_key_of;
+      m_desc      = p_queue.m_desc;
+      m_data      = p_queue.m_data;
+      m_positions = p_queue.m_positions;
+      m_first     = p_queue.m_first;
+    }
+    return *this;
+  }
+
+  coalescing_queue &operator=(coalescing_queue &&p_queue)
+  {
+    if (this != &p_queue)
+    {
+      std::scoped_lock _lock(m_mutex, p_queue.m_mutex);
+      m_key_of    = std::move(p_queue.m_key_of);
+      m_desc      = std::move(p_queue.m_desc);
+      m_data      = std::move(p_queue.m_data);
+      m_positions = std::move(p_queue.m_positions);
+      m_first     = p_queue.m_first;
+    }
+    return *this;
+  }
+
+  std::string brief_report() const
+  {
+    std::stringstream _out;
+    _out << "desc = '" << m_desc << "', first = " << m_first
+         << ", occupied = " << m_data.size();
+    return _out.str();
+  }
+
+  /// \brief Replaces the data with the same key of \p p_data, if it was not
+  /// popped yet, or inserts \p p_data at the end of the queue
+  void push(t_data &&p_data)
+  {
+    replace_or_push(std::move(p_data));
+  }
+
+  /// \brief Like \p replace_or_push
+  void push(t_data &&p_data, std::int64_t p_stamp)
+  {
+    replace_or_push(std::move(p_data), p_stamp);
+  }
+
+  /// \brief Replaces the data with the same key of \p p_data, if it was not
+  /// popped yet, or inserts \p p_data at the end of the queue
+  void push(const t_data &p_data)
+  requires std::copy_constructible<t_data>
+  {
+    replace_or_push(t_data{p_data});
+  }
+
+  /// \return \p true if \p p_data replaced the data with the same key, and
+  /// \p false if it was inserted at the end of the queue
+  bool replace_or_push(t_data &&p_data)
+  {
+    return replace_or_push(std::move(p_data), 0);
+  }
+
+  /// \brief Like \p replace_or_push, and \p p_stamp is returned when
+  /// \p p_data is popped, if it is inserted at the end of the queue
+  bool replace_or_push(t_data &&p_data, std::int64_t p_stamp)
+  {
+    key _key{m_key_of(p_data)};
+
+    std::lock_guard<std::mutex> _lock(m_mutex);
+
+    if (auto _ite{m_positions.find(_key)}; _ite != m_positions.end())
+    {
+      m_data[static_cast<std::size_t>(_ite->second - m_first)].data =
+          std::move(p_data);
+      return true;
+    }
+
+    m_positions.emplace(std::move(_key), m_first + m_data.size());
+    m_data.push_back({std::move(p_data), p_stamp});
+    return false;
+  }
+
+  std::optional<t_data> pop()
+  {
+    std::int64_t _stamp{0};
+    return pop(_stamp);
+  }
+
+  /// \brief Pops a data, and writes to \p p_stamp the stamp pushed with it
+  std::optional<t_data> pop(std::int64_t &p_stamp)
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+
+    if (m_data.empty())
+    {
+      return std::nullopt;
+    }
+
+    std::optional<t_data> _data{std::move(m_data.front().data)};
+    p_stamp = m_data.front().stamp;
+    m_data.pop_front();
+    ++m_first;
+
+    m_positions.erase(m_key_of(*_data));
+
+    return _data;
+  }
+
+  bool full() const
+  {
+    return false;
+  }
+
+  bool empty() const
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    return m_data.empty();
+  }
+
+  std::size_t capacity() const
+  {
+    return occupied();
+  }
+
+  std::size_t occupied() const
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    return m_data.size();
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> _lock(m_mutex);
+    m_first += m_data.size();
+    m_data.clear();
+    m_positions.clear();
+  }
+
+private:
+  using key = std::remove_cvref_t<
+      std::invoke_result_t<const key_of &, const t_data &>>;
+
+  struct entry
+  {
+    t_data       data;
+    std::int64_t stamp{0};
+  };
+
+  // Position of the data of a key, counted since the queue was created
+  using positions = std::unordered_map<key, std::uint64_t>;
+
+private:
+  // The copy and move constructors lock \p p_queue, and delegate to these
+  // ones, which copy, or move, it while the lock lives
+  coalescing_queue(const coalescing_queue &p_queue,
+                   const std::lock_guard<std::mutex> &)
+      : m_logger(p_queue.m_logger), m_key_of(p_queue.m_key_of),
+        m_desc(p_queue.m_desc), m_data(p_queue.m_data),
+        m_positions(p_queue.m_positions), m_first(p_queue.m_first)
+  {
+  }
+
+  coalescing_queue(coalescing_queue &&p_queue,
+                   const std::lock_guard<std::mutex> &)
+      : m_logger(p_queue.m_logger), m_key_of(std::move(p_queue.m_key_of)),
+        m_desc(std::move(p_queue.m_desc)), m_data(std::move(p_queue.m_data)),
+        m_positions(std::move(p_queue.m_positions)), m_first(p_queue.m_first)
+  {
+  }
+
+  coalescing_queue(t_logger &p_logger, key_of &&p_key_of,
+                   std::string_view p_desc)
+      : m_logger(p_logger), m_key_of(std::move(p_key_of)), m_desc(p_desc)
+  {
+    TNCT_LOG_TRA(m_logger, format::bus::fmt("creating - ", brief_report()));
+  }
+
+private:
+  logger &m_logger;
+
+  key_of m_key_of;
+
+  std::string m_desc;
+
+  std::deque<entry> m_data;
+
+  positions m_positions;
+
+  // Position of the data at the front of 'm_data'
+  std::uint64_t m_first{0};
+
+  mutable std::mutex m_mutex;
+};
+
+} // namespace tnct::container::dat
+
+#endif
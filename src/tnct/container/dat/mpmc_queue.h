@@ -0,0 +1,410 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_DAT_MPMC_QUEUE_H
+#define TNCT_CONTAINER_DAT_MPMC_QUEUE_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/ostream/cpt/has_output_operator.h"
+
+namespace tnct::container::dat
+{
+
+/// \brief Implements a lock-free bounded queue that supports multiple
+/// producers and multiple consumers
+///
+/// The queue is an array of slots, each one with a sequence number that tells
+/// producers and consumers if the slot is ready to be written or read, so no
+/// mutex is needed to \p push or \p pop. The capacity is always a power of two,
+/// and it is never increased.
+///
+/// \p push waits, yielding the thread, while the queue is full, so it can be
+/// used as the queue of a \p async::bus::dispatcher handling. \p try_push
+/// returns \p false instead of waiting.
+///
+/// A stamp, like the moment the data was pushed, can be pushed with a data,
+/// and it is returned when the data is popped.
+///
+/// If constructing the data in its slot throws, the exception is passed to
+/// the caller of \p push, and the slot is left empty, and skipped by \p pop.
+///
+/// Copying, moving and assigning are not thread safe, and should happen only
+/// while no other thread is using the queue. A queue moved from has no
+/// capacity, \p pop and \p try_push on it fail, and it should only be
+/// destroyed, or assigned.
+///
+/// \tparam t_data defines the types of the data contained in the queue
+template <log::cpt::logger t_logger, typename t_data>
+requires std::move_constructible<t_data>
+         && ostream::cpt::has_output_operator<t_data>
+class mpmc_queue final
+{
+public:
+  using data   = t_data;
+  using logger = t_logger;
+
+public:
+  mpmc_queue() = delete;
+
+  static constexpr std::size_t default_capacity{1024};
+
+  /// \brief Creates a queue
+  ///
+  /// \param p_capacity is rounded up to the next power of two
+  static std::optional<mpmc_queue>
+  create(t_logger &p_logger, std::size_t p_capacity = default_capacity,
+         std::string_view p_desc = "NO DESC")
+  {
+    try
+    {
+      if (p_capacity == 0)
+      {
+        return std::nullopt;
+      }
+
+      return mpmc_queue(p_logger, p_desc, std::bit_ceil(p_capacity));
+    }
+    catch (...)
+    {
+      TNCT_LOG_ERR(p_logger,
+                   format::bus::fmt("Error creating 'mpmc_queue' named '",
+                                    p_desc, "', with capacity = ", p_capacity));
+    }
+    return std::nullopt;
+  }
+
+  ~mpmc_queue() = default;
+
+  mpmc_queue(const mpmc_queue &p_queue)
+      : m_logger(p_queue.m_logger), m_desc(p_queue.m_desc),
+        m_mask(p_queue.m_mask), m_slots(p_queue.m_slots),
+        m_enqueue_pos(p_queue.m_enqueue_pos.load()),
+        m_dequeue_pos(p_queue.m_dequeue_pos.load())
+  {
+  }
+
+  mpmc_queue(mpmc_queue &&p_queue)
+      : m_logger(p_queue.m_logger), m_desc(std::move(p_queue.m_desc)),
+        m_mask(std::exchange(p_queue.m_mask, 0)),
+        m_slots(std::move(p_queue.m_slots)),
+        m_enqueue_pos(p_queue.m_enqueue_pos.exchange(0)),
+        m_dequeue_pos(p_queue.m_dequeue_pos.exchange(0))
+  {
+    p_queue.m_slots.clear();
+  }
+
+  mpmc_queue &operator=(const mpmc_queue &p_queue)
+  {
+    if (this != &p_queue)
+    {
+      m_desc  = p_queue.m_desc;
+      m_mask  = p_queue.m_mask;
+      m_slots = p_queue.m_slots;
+      m_enqueue_pos.store(p_queue.m_enqueue_pos.load());
+      m_dequeue_pos.store(p_queue.m_dequeue_pos.load());
+    }
+    return *this;
+  }
+
+  mpmc_queue &operator=(mpmc_queue &&p_queue)
+  {
+    if (this != &p_queue)
+    {
+      m_desc  = std::move(p_queue.m_desc);
+      m_mask  = std::exchange(p_queue.m_mask, 0);
+      m_slots = std::move(p_queue.m_slots);
+      p_queue.m_slots.clear();
+      m_enqueue_pos.store(p_queue.m_enqueue_pos.exchange(0));
+      m_dequeue_pos.store(p_queue.m_dequeue_pos.exchange(0));
+    }
+    return *this;
+  }
+
+  std::string brief_report() const
+  {
+    std::stringstream _out;
+    _out << "desc = '" << m_desc << "', enqueue pos = " << m_enqueue_pos
+         << ", dequeue pos = " << m_dequeue_pos
+         << ", occupied = " << occupied() << ", capacity = " << capacity();
+    return _out.str();
+  }
+
+  /// \brief Inserts data in the queue, waiting while it is full
+  void push(t_data &&p_data)
+  {
+    while (!try_push(std::move(p_data)))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  /// \brief Inserts data in the queue, and \p p_stamp, returned when it is
+  /// popped, waiting while it is full
+  void push(t_data &&p_data, std::int64_t p_stamp)
+  {
+    while (!emplace(std::move(p_data), p_stamp))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  /// \brief Inserts data in the queue, waiting while it is full
+  void push(const t_data &p_data)
+  requires std::copy_constructible<t_data>
+  {
+    while (!try_push(p_data))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  /// \brief Tries to insert data in the queue
+  ///
+  /// \return \p false if the queue is full, \p true otherwise
+  bool try_push(t_data &&p_data)
+  {
+    return emplace(std::move(p_data), 0);
+  }
+
+  /// \brief Tries to insert data in the queue
+  ///
+  /// \return \p false if the queue is full, \p true otherwise
+  bool try_push(const t_data &p_data)
+  requires std::copy_constructible<t_data>
+  {
+    return emplace(p_data, 0);
+  }
+
+  std::optional<t_data> pop()
+  {
+    std::int64_t _stamp{0};
+    return pop(_stamp);
+  }
+
+  /// \brief Pops a data, and writes to \p p_stamp the stamp pushed with it
+  std::optional<t_data> pop(std::int64_t &p_stamp)
+  {
+    if (m_slots.empty())
+    {
+      return std::nullopt;
+    }
+
+    while (true)
+    {
+      std::optional<t_data> _data;
+      if (!take(_data, p_stamp))
+      {
+        return std::nullopt;
+      }
+      if (_data.has_value())
+      {
+        return _data;
+      }
+      // the slot was left empty by a 'push' that threw
+    }
+  }
+
+  bool full() const
+  {
+    return occupied() == capacity();
+  }
+
+  bool empty() const
+  {
+    return occupied() == 0;
+  }
+
+  constexpr std::size_t capacity() const
+  {
+    return m_slots.size();
+  }
+
+  /// \return Amount of data in the queue, which may be outdated as soon as it
+  /// is returned, if other threads are using the queue
+  std::size_t occupied() const
+  {
+    const std::size_t _dequeue_pos{
+        m_dequeue_pos.load(std::memory_order_acquire)};
+    const std::size_t _enqueue_pos{
+        m_enqueue_pos.load(std::memory_order_acquire)};
+    if (_enqueue_pos <= _dequeue_pos)
+    {
+      return 0;
+    }
+    const std::size_t _occupied{_enqueue_pos - _dequeue_pos};
+    return (_occupied > capacity() ? capacity() : _occupied);
+  }
+
+  void clear()
+  {
+    while (pop().has_value())
+    {
+    }
+  }
+
+private:
+  struct slot
+  {
+    slot() = default;
+
+    slot(const slot &p_slot)
+        : sequence(p_slot.sequence.load()), data(p_slot.data),
+          stamp(p_slot.stamp)
+    {
+    }
+
+    slot &operator=(const slot &p_slot)
+    {
+      sequence.store(p_slot.sequence.load());
+      data  = p_slot.data;
+      stamp = p_slot.stamp;
+      return *this;
+    }
+
+    std::atomic_size_t    sequence{0};
+    std::optional<t_data> data;
+    std::int64_t          stamp{0};
+  };
+
+  using slots = std::vector<slot>;
+
+  // avoids 'm_enqueue_pos' and 'm_dequeue_pos' sharing a cache line
+  static constexpr std::size_t cache_line_size{64};
+
+private:
+  mpmc_queue(t_logger &p_logger, std::string_view p_desc,
+             std::size_t p_capacity)
+      : m_logger(p_logger), m_desc(p_desc), m_mask(p_capacity - 1),
+        m_slots(p_capacity)
+  {
+    for (std::size_t _i = 0; _i < p_capacity; ++_i)
+    {
+      m_slots[_i].sequence.store(_i, std::memory_order_relaxed);
+    }
+    TNCT_LOG_TRA(m_logger, format::bus::fmt("creating - ", brief_report()));
+  }
+
+  // Takes the data, and the stamp, of the next slot to \p p_data and
+  // \p p_stamp, and \p p_data is empty if the slot was left empty by a 'push'
+  // that threw
+  //
+  // \return \p false if the queue is empty
+  bool take(std::optional<t_data> &p_data, std::int64_t &p_stamp)
+  {
+    slot       *_slot{nullptr};
+    std::size_t _pos{m_dequeue_pos.load(std::memory_order_relaxed)};
+
+    while (true)
+    {
+      _slot = &m_slots[_pos & m_mask];
+      const std::size_t _sequence{
+          _slot->sequence.load(std::memory_order_acquire)};
+      const auto _diff{static_cast<std::intptr_t>(_sequence)
+                       - static_cast<std::intptr_t>(_pos + 1)};
+      if (_diff == 0)
+      {
+        if (m_dequeue_pos.compare_exchange_weak(_pos, _pos + 1,
+                                                std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (_diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        _pos = m_dequeue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    p_data  = std::move(_slot->data);
+    p_stamp = _slot->stamp;
+    _slot->data.reset();
+    _slot->sequence.store(_pos + m_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename t_value>
+  bool emplace(t_value &&p_value, std::int64_t p_stamp)
+  {
+    if (m_slots.empty())
+    {
+      return false;
+    }
+
+    slot       *_slot{nullptr};
+    std::size_t _pos{m_enqueue_pos.load(std::memory_order_relaxed)};
+
+    while (true)
+    {
+      _slot = &m_slots[_pos & m_mask];
+      const std::size_t _sequence{
+          _slot->sequence.load(std::memory_order_acquire)};
+      const auto _diff{static_cast<std::intptr_t>(_sequence)
+                       - static_cast<std::intptr_t>(_pos)};
+      if (_diff == 0)
+      {
+        if (m_enqueue_pos.compare_exchange_weak(_pos, _pos + 1,
+                                                std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (_diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        _pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    try
+    {
+      _slot->data.emplace(std::forward<t_value>(p_value));
+      _slot->stamp = p_stamp;
+    }
+    catch (...)
+    {
+      // the position was claimed, so the slot is published empty, otherwise
+      // 'pop' would stop at it forever
+      _slot->sequence.store(_pos + 1, std::memory_order_release);
+      throw;
+    }
+    _slot->sequence.store(_pos + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  logger     &m_logger;
+  std::string m_desc;
+
+  std::size_t m_mask{0};
+  slots       m_slots;
+
+  alignas(cache_line_size) std::atomic_size_t m_enqueue_pos{0};
+  alignas(cache_line_size) std::atomic_size_t m_dequeue_pos{0};
+};
+
+} // namespace tnct::container::dat
+
+#endif
@@ -0,0 +1,287 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_DAT_MULTI_LEVEL_QUEUE_H
+#define TNCT_CONTAINER_DAT_MULTI_LEVEL_QUEUE_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "tnct/container/dat/mpmc_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/cpt/logger.h"
+#include "tnct/log/cpt/macros.h"
+#include "tnct/ostream/cpt/has_output_operator.h"
+
+namespace tnct::container::dat
+{
+
+/// \brief Implements a bounded queue with many levels of priority, where data
+/// of a more urgent level is always popped before data of a less urgent one
+///
+/// \p t_level_of tells the level of a data, where 0 is the most urgent, and a
+/// level greater than the last is taken as the last. Each level is a
+/// \p mpmc_queue, so data of the same level is popped in the order it was
+/// pushed, and no mutex is needed to \p push or \p pop.
+///
+/// As the levels are strictly ordered, data of the less urgent levels waits
+/// while there is data in the more urgent ones, so the urgent levels should be
+/// used for few data, like a request to stop.
+///
+/// \p push waits, yielding the thread, while the level of the data is full, so
+/// it can be used as the queue of a \p async::bus::dispatcher handling.
+/// \p try_push returns \p false instead of waiting.
+///
+/// A stamp, like the moment the data was pushed, can be pushed with a data,
+/// and it is returned when the data is popped.
+///
+/// Copying, moving and assigning are not thread safe, and should happen only
+/// while no other thread is using the queue.
+///
+/// \tparam t_data defines the types of the data contained in the queue
+template <log::cpt::logger t_logger, typename t_data, typename t_level_of>
+requires std::move_constructible<t_data>
+         && ostream::cpt::has_output_operator<t_data>
+         && std::copyable<t_level_of>
+         && requires(const t_level_of &p_level_of, const t_data &p_data) {
+              {
+                p_level_of(p_data)
+              } -> std::convertible_to<std::size_t>;
+            }
+class multi_level_queue final
+{
+public:
+  using data     = t_data;
+  using logger   = t_logger;
+  using level_of = t_level_of;
+
+public:
+  multi_level_queue() = delete;
+
+  static constexpr std::size_t default_capacity_per_level{256};
+
+  /// \brief Creates a queue
+  ///
+  /// \param p_num_levels is the amount of levels, which must be at least 1
+  ///
+  /// \param p_capacity_per_level is rounded up to the next power of two
+  static std::optional<multi_level_queue>
+  create(t_logger &p_logger, level_of p_level_of, std::size_t p_num_levels,
+         std::size_t      p_capacity_per_level = default_capacity_per_level,
+         std::string_view p_desc               = "NO DESC")
+  {
+    try
+    {
+      if ((p_num_levels == 0) || (p_capacity_per_level == 0))
+      {
+        return std::nullopt;
+      }
+
+      levels _levels;
+      _levels.reserve(p_num_levels);
+      for (std::size_t _i = 0; _i < p_num_levels; ++_i)
+      {
+        std::optional<level> _level{
+            level::create(p_logger, p_capacity_per_level, p_desc)};
+        if (!_level)
+        {
+          return std::nullopt;
+        }
+        _levels.push_back(std::move(*_level));
+      }
+
+      return multi_level_queue(p_logger, std::move(p_level_of), p_desc,
+                               std::move(_levels));
+    }
+    catch (...)
+    {
+      TNCT_LOG_ERR(p_logger, format::bus::fmt(
+                                 "Error creating 'multi_level_queue' named '",
+                                 p_desc, "', with ", p_num_levels,
+                                 " levels of capacity ", p_capacity_per_level));
+    }
+    return std::nullopt;
+  }
+
+  ~multi_level_queue() = default;
+
+  multi_level_queue(const multi_level_queue &)            = default;
+  multi_level_queue(multi_level_queue &&)                 = default;
+  multi_level_queue &operator=(const multi_level_queue &) = default;
+  multi_level_queue &operator=(multi_level_queue &&)      = default;
+
+  std::string brief_report() const
+  {
+    std::stringstream _out;
+    _out << "desc = '" << m_desc << "', levels = " << m_levels.size()
+         << ", occupied = " << occupied() << ", capacity = " << capacity();
+    return _out.str();
+  }
+
+  /// \brief Inserts data in its level, waiting while the level is full
+  void push(t_data &&p_data)
+  {
+    get_level(p_data).push(std::move(p_data));
+  }
+
+  /// \brief Inserts data in its level, and \p p_stamp, returned when it is
+  /// popped, waiting while the level is full
+  void push(t_data &&p_data, std::int64_t p_stamp)
+  {
+    get_level(p_data).push(std::move(p_data), p_stamp);
+  }
+
+  /// \brief Inserts data in its level, waiting while the level is full
+  void push(const t_data &p_data)
+  requires std::copy_constructible<t_data>
+  {
+    get_level(p_data).push(p_data);
+  }
+
+  /// \brief Tries to insert data in its level
+  ///
+  /// \return \p false if the level is full, \p true otherwise
+  bool try_push(t_data &&p_data)
+  {
+    return get_level(p_data).try_push(std::move(p_data));
+  }
+
+  /// \brief Tries to insert data in its level
+  ///
+  /// \return \p false if the level is full, \p true otherwise
+  bool try_push(const t_data &p_data)
+  requires std::copy_constructible<t_data>
+  {
+    return get_level(p_data).try_push(p_data);
+  }
+
+  /// \brief Pops the oldest data of the most urgent level that has data
+  std::optional<t_data> pop()
+  {
+    std::int64_t _stamp{0};
+    return pop(_stamp);
+  }
+
+  /// \brief Like \p pop, and writes to \p p_stamp the stamp pushed with the
+  /// data
+  std::optional<t_data> pop(std::int64_t &p_stamp)
+  {
+    for (level &_level : m_levels)
+    {
+      if (std::optional<t_data> _data{_level.pop(p_stamp)})
+      {
+        return _data;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// \brief Pops the oldest data of the least urgent level that has data
+  ///
+  /// It is meant to make room for new data, discarding the less important
+  std::optional<t_data> pop_least_urgent()
+  {
+    for (auto _ite = m_levels.rbegin(); _ite != m_levels.rend(); ++_ite)
+    {
+      if (std::optional<t_data> _data{_ite->pop()})
+      {
+        return _data;
+      }
+    }
+    return std::nullopt;
+  }
+
+  bool full() const
+  {
+    return occupied() == capacity();
+  }
+
+  bool empty() const
+  {
+    return std::all_of(m_levels.begin(), m_levels.end(),
+                       [](const level &p_level) { return p_level.empty(); });
+  }
+
+  /// \return Sum of the capacities of the levels
+  std::size_t capacity() const
+  {
+    std::size_t _capacity{0};
+    for (const level &_level : m_levels)
+    {
+      _capacity += _level.capacity();
+    }
+    return _capacity;
+  }
+
+  /// \return Amount of data in all the levels, which may be outdated as soon
+  /// as it is returned, if other threads are using the queue
+  std::size_t occupied() const
+  {
+    std::size_t _occupied{0};
+    for (const level &_level : m_levels)
+    {
+      _occupied += _level.occupied();
+    }
+    return _occupied;
+  }
+
+  /// \return Amount of data in \p p_level
+  std::size_t occupied(std::size_t p_level) const
+  {
+    return m_levels[std::min(p_level, m_levels.size() - 1)].occupied();
+  }
+
+  std::size_t get_num_levels() const
+  {
+    return m_levels.size();
+  }
+
+  void clear()
+  {
+    for (level &_level : m_levels)
+    {
+      _level.clear();
+    }
+  }
+
+private:
+  using level = mpmc_queue<t_logger, t_data>;
+
+  using levels = std::vector<level>;
+
+private:
+  multi_level_queue(t_logger &p_logger, level_of &&p_level_of,
+                    std::string_view p_desc, levels &&p_levels)
+      : m_level_of(std::move(p_level_of)), m_desc(p_desc),
+        m_levels(std::move(p_levels))
+  {
+    TNCT_LOG_TRA(p_logger, format::bus::fmt("creating - ", brief_report()));
+  }
+
+  level &get_level(const t_data &p_data)
+  {
+    const std::size_t _level{static_cast<std::size_t>(m_level_of(p_data))};
+    return m_levels[std::min(_level, m_levels.size() - 1)];
+  }
+
+private:
+  level_of m_level_of;
+
+  std::string m_desc;
+
+  levels m_levels;
+};
+
+} // namespace tnct::container::dat
+
+#endif
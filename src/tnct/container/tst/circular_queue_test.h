@@ -11,6 +11,7 @@
 #include <string>
 #include <utility>
 
+#include "tnct/container/cpt/stamped_queue.h"
 #include "tnct/container/dat/circular_queue.h"
 #include "tnct/format/bus/fmt.h"
 #include "tnct/log/bus/cerr.h"
@@ -85,6 +86,50 @@ struct circular_queue_003 {
   }
 };
 
+struct circular_queue_004 {
+  static std::string desc() {
+    return "Each data is popped with the stamp pushed with it, also after the "
+           "queue is enlarged while its data wraps around";
+  }
+
+  bool operator()(const program::bus::options &) {
+    using queue = container::dat::circular_queue<log::cerr, int32_t>;
+    static_assert(container::cpt::stamped_queue<queue, int32_t>,
+                  "'queue' should be compliant to "
+                  "'container::cpt::stamped_queue'");
+
+    log::cerr _logger;
+    std::optional<queue> _queue(queue::create(_logger, 4, 2));
+    if (!_queue) {
+      return false;
+    }
+
+    // the data is 10 times its stamp
+    int32_t _next{1};
+    for (; _next <= 3; ++_next) {
+      _queue->push(_next * 10, _next);
+    }
+    std::int64_t _stamp{0};
+    if (_queue->pop(_stamp) != std::optional<int32_t>{10} || (_stamp != 1)) {
+      return false;
+    }
+    for (; _next <= 9; ++_next) {
+      _queue->push(_next * 10, _next);
+    }
+
+    for (int32_t _expected = 2; _expected <= 9; ++_expected) {
+      const std::optional<int32_t> _data{_queue->pop(_stamp)};
+      if (!_data || (*_data != _expected * 10) || (_stamp != _expected)) {
+        _logger.err(format::bus::fmt("expected ", _expected * 10, " with ",
+                                     _expected, ", but got ",
+                                     _data.value_or(-1), " with ", _stamp));
+        return false;
+      }
+    }
+    return _queue->empty();
+  }
+};
+
 // struct circular_queue_test
 // {
 
@@ -0,0 +1,272 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_TST_COALESCING_QUEUE_TEST_H
+#define TNCT_CONTAINER_TST_COALESCING_QUEUE_TEST_H
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tnct/container/cpt/coalescing_queue.h"
+#include "tnct/container/cpt/queue.h"
+#include "tnct/container/cpt/stamped_queue.h"
+#include "tnct/container/dat/coalescing_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/program/bus/options.h"
+
+namespace tnct::container::tst
+{
+
+// How far a task, identified by 'task', has progressed
+struct progress
+{
+  friend std::ostream &operator<<(std::ostream   &p_out,
+                                  const progress &p_progress)
+  {
+    p_out << '(' << p_progress.task << ',' << p_progress.done << ')';
+    return p_out;
+  }
+
+  std::uint32_t task{0};
+  std::uint64_t done{0};
+};
+
+struct task_of_progress
+{
+  std::uint32_t operator()(const progress &p_progress) const
+  {
+    return p_progress.task;
+  }
+};
+
+using progress_queue =
+    container::dat::coalescing_queue<log::cerr, progress, task_of_progress>;
+
+struct coalescing_queue_000
+{
+  static std::string desc()
+  {
+    return "Checking if 'container::dat::coalescing_queue' complies to "
+           "'container::cpt::coalescing_queue', and if a data replaces the one "
+           "with the same key that was not popped, keeping its place";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    static_assert(container::cpt::queue<progress_queue, progress>,
+                  "'coalescing_queue' should be compliant to "
+                  "'container::cpt::queue'");
+    static_assert(container::cpt::coalescing_queue<progress_queue, progress>,
+                  "'coalescing_queue' should be compliant to "
+                  "'container::cpt::coalescing_queue'");
+
+    log::cerr                     _logger;
+    std::optional<progress_queue> _queue{
+        progress_queue::create(_logger, task_of_progress{})};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    if (_queue->replace_or_push(progress{1, 10})
+        || _queue->replace_or_push(progress{2, 10}))
+    {
+      _logger.err("the first data of a task should not replace other");
+      return false;
+    }
+    if (!_queue->replace_or_push(progress{1, 20}))
+    {
+      _logger.err("the second data of task 1 should replace the first");
+      return false;
+    }
+    _queue->push(progress{1, 30});
+    _queue->push(progress{2, 20});
+
+    _logger.tst(_queue->brief_report());
+
+    if (_queue->occupied() != 2)
+    {
+      _logger.err(format::bus::fmt("occupied = ", _queue->occupied()));
+      return false;
+    }
+
+    // task 1 keeps the place of its first data
+    std::optional<progress> _first{_queue->pop()};
+    if (!_first || (_first->task != 1) || (_first->done != 30))
+    {
+      _logger.err("expected (1,30)");
+      return false;
+    }
+
+    // task 1 was popped, so a new data goes to the end
+    if (_queue->replace_or_push(progress{1, 40}))
+    {
+      _logger.err("(1,40) should not replace other data");
+      return false;
+    }
+
+    std::optional<progress> _second{_queue->pop()};
+    std::optional<progress> _third{_queue->pop()};
+    if (!_second || (_second->task != 2) || (_second->done != 20) || !_third
+        || (_third->task != 1) || (_third->done != 40))
+    {
+      _logger.err("expected (2,20) and (1,40)");
+      return false;
+    }
+
+    _queue->push(progress{3, 1});
+    _queue->clear();
+    if (!_queue->empty() || _queue->replace_or_push(progress{3, 2}))
+    {
+      _logger.err("after 'clear', (3,2) should not replace other data");
+      return false;
+    }
+
+    return _queue->occupied() == 1;
+  }
+};
+
+struct coalescing_queue_001
+{
+  static std::string desc()
+  {
+    return "4 producers, each reporting the progress of its own task, and a "
+           "consumer share a 'coalescing_queue', and the consumer sees the "
+           "progress of each task only increasing, until the last one";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                     _logger;
+    std::optional<progress_queue> _queue{
+        progress_queue::create(_logger, task_of_progress{})};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    std::vector<std::uint64_t> _last(m_producers, 0);
+    std::atomic_bool           _wrong{false};
+    std::atomic_size_t         _finished{0};
+    std::size_t                _popped{0};
+
+    std::thread _consumer(
+        [&]()
+        {
+          while (true)
+          {
+            const bool _all_finished{_finished == m_producers};
+            std::optional<progress> _maybe{_queue->pop()};
+            if (!_maybe)
+            {
+              if (_all_finished)
+              {
+                break;
+              }
+              std::this_thread::yield();
+              continue;
+            }
+            ++_popped;
+            if (_maybe->done <= _last[_maybe->task])
+            {
+              _wrong = true;
+            }
+            _last[_maybe->task] = _maybe->done;
+          }
+        });
+
+    std::vector<std::thread> _producers;
+    for (std::uint32_t _p = 0; _p < m_producers; ++_p)
+    {
+      _producers.emplace_back(
+          [&, _p]()
+          {
+            for (std::uint64_t _done = 1; _done <= m_amount; ++_done)
+            {
+              _queue->push(progress{_p, _done});
+            }
+            ++_finished;
+          });
+    }
+
+    for (std::thread &_producer : _producers)
+    {
+      _producer.join();
+    }
+    _consumer.join();
+
+    _logger.tst(format::bus::fmt("popped ", _popped, " of ",
+                                 m_producers * m_amount, " pushed"));
+
+    for (std::uint64_t _done : _last)
+    {
+      if (_done != m_amount)
+      {
+        _logger.err(format::bus::fmt("last progress = ", _done));
+        return false;
+      }
+    }
+
+    return !_wrong && _queue->empty();
+  }
+
+private:
+  static constexpr std::uint32_t m_producers{4};
+  static constexpr std::uint64_t m_amount{100000};
+};
+
+struct coalescing_queue_002
+{
+  static std::string desc()
+  {
+    return "Each data is popped with the stamp pushed with it, and a data "
+           "that replaces another keeps the stamp of the one replaced";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    static_assert(
+        container::cpt::stamped_queue<progress_queue, progress>,
+        "'progress_queue' should be compliant to "
+        "'container::cpt::stamped_queue'");
+
+    log::cerr                     _logger;
+    std::optional<progress_queue> _queue{
+        progress_queue::create(_logger, task_of_progress{})};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    const bool _replaced{!_queue->replace_or_push(progress{0, 1}, 100)
+                         && !_queue->replace_or_push(progress{1, 1}, 200)
+                         && _queue->replace_or_push(progress{0, 2}, 300)};
+
+    std::int64_t                  _first_stamp{0};
+    std::int64_t                  _second_stamp{0};
+    const std::optional<progress> _first{_queue->pop(_first_stamp)};
+    const std::optional<progress> _second{_queue->pop(_second_stamp)};
+
+    _logger.tst(format::bus::fmt("first stamp ", _first_stamp,
+                                 ", second stamp ", _second_stamp));
+
+    return _replaced && _first && (_first->task == 0) && (_first->done == 2)
+           && (_first_stamp == 100) && _second && (_second->task == 1)
+           && (_second_stamp == 200) && _queue->empty();
+  }
+};
+
+} // namespace tnct::container::tst
+
+#endif
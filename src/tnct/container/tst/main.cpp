@@ -7,8 +7,11 @@
 
 #include "tnct/container/tst/chunked_container_test.h"
 #include "tnct/container/tst/circular_queue_test.h"
+#include "tnct/container/tst/coalescing_queue_test.h"
 #include "tnct/container/tst/cpt_test.h"
 #include "tnct/container/tst/matrix_test.h"
+#include "tnct/container/tst/mpmc_queue_test.h"
+#include "tnct/container/tst/multi_level_queue_test.h"
 #include "tnct/container/tst/multi_index_test.h"
 #include "tnct/container/tst/multiply_matrix_row_test.h"
 #include "tnct/container/tst/multiply_matrix_test.h"
@@ -20,8 +23,24 @@ int main(int argc, char **argv) {
   tester::bus::test _tester(argc, argv);
   run_test(_tester, container::tst::circular_queue_001);
   run_test(_tester, container::tst::circular_queue_003);
+  run_test(_tester, container::tst::circular_queue_004);
   // run_test(_tester, container::tst::circular_queue_test);
 
+  run_test(_tester, container::tst::mpmc_queue_000);
+  run_test(_tester, container::tst::mpmc_queue_001);
+  run_test(_tester, container::tst::mpmc_queue_002);
+  run_test(_tester, container::tst::mpmc_queue_003);
+
+  run_test(_tester, container::tst::multi_level_queue_000);
+  run_test(_tester, container::tst::multi_level_queue_001);
+  run_test(_tester, container::tst::multi_level_queue_002);
+  run_test(_tester, container::tst::multi_level_queue_003);
+  run_test(_tester, container::tst::multi_level_queue_004);
+
+  run_test(_tester, container::tst::coalescing_queue_000);
+  run_test(_tester, container::tst::coalescing_queue_001);
+  run_test(_tester, container::tst::coalescing_queue_002);
+
   run_test(_tester, container::tst::matrix_000);
   run_test(_tester, container::tst::matrix_001);
   run_test(_tester, container::tst::matrix_002);
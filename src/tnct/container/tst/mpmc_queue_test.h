@@ -0,0 +1,278 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_TST_MPMC_QUEUE_TEST_H
+#define TNCT_CONTAINER_TST_MPMC_QUEUE_TEST_H
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <thread>
+#include <vector>
+
+#include "tnct/container/cpt/queue.h"
+#include "tnct/container/dat/mpmc_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/program/bus/options.h"
+
+namespace tnct::container::tst
+{
+
+struct mpmc_queue_000
+{
+  static std::string desc()
+  {
+    return "Checking if 'container::dat::mpmc_queue' complies to "
+           "'container::cpt::queue', and if its capacity is rounded up to a "
+           "power of two";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue = container::dat::mpmc_queue<log::cerr, std::uint16_t>;
+
+    static_assert(container::cpt::queue<queue, std::uint16_t>,
+                  "'mpmc_queue' should be compliant to 'container::cpt::queue'");
+
+    log::cerr            _logger;
+    std::optional<queue> _queue{queue::create(_logger, 100)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    _logger.tst(format::bus::fmt("capacity = ", _queue->capacity()));
+
+    return (_queue->capacity() == 128) && (!queue::create(_logger, 0));
+  }
+};
+
+struct mpmc_queue_001
+{
+  static std::string desc()
+  {
+    return "Fills a queue, checks that 'try_push' fails when it is full, and "
+           "that data is popped in the order it was pushed";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue = container::dat::mpmc_queue<log::cerr, std::uint32_t>;
+
+    log::cerr            _logger;
+    std::optional<queue> _queue{queue::create(_logger, 8)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < 8; ++_i)
+    {
+      _queue->push(_i);
+    }
+
+    if (!_queue->full() || _queue->try_push(8))
+    {
+      _logger.err(format::bus::fmt("queue should be full: ",
+                                   _queue->brief_report()));
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < 8; ++_i)
+    {
+      std::optional<std::uint32_t> _maybe{_queue->pop()};
+      if (!_maybe || (*_maybe != _i))
+      {
+        _logger.err(format::bus::fmt("expected ", _i, ", but got ",
+                                     (_maybe ? std::to_string(*_maybe)
+                                             : std::string{"nothing"})));
+        return false;
+      }
+    }
+
+    return _queue->empty() && !_queue->pop().has_value();
+  }
+};
+
+struct mpmc_queue_002
+{
+  static std::string desc()
+  {
+    return "4 producers and 4 consumers share a queue of 64 slots, and the sum "
+           "of all popped values must match the sum of all pushed values";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue = container::dat::mpmc_queue<log::cerr, std::uint64_t>;
+
+    log::cerr            _logger;
+    std::optional<queue> _queue{queue::create(_logger, 64)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    std::atomic_uint64_t _popped_sum{0};
+    std::atomic_uint64_t _popped_amount{0};
+
+    std::vector<std::thread> _threads;
+    for (std::size_t _c = 0; _c < m_consumers; ++_c)
+    {
+      _threads.emplace_back(
+          [&]()
+          {
+            while (_popped_amount < m_total)
+            {
+              std::optional<std::uint64_t> _maybe{_queue->pop()};
+              if (_maybe)
+              {
+                _popped_sum += *_maybe;
+                ++_popped_amount;
+              }
+              else
+              {
+                std::this_thread::yield();
+              }
+            }
+          });
+    }
+
+    for (std::size_t _p = 0; _p < m_producers; ++_p)
+    {
+      _threads.emplace_back(
+          [&, _p]()
+          {
+            for (std::uint64_t _i = 0; _i < m_per_producer; ++_i)
+            {
+              _queue->push((_p * m_per_producer) + _i + 1);
+            }
+          });
+    }
+
+    for (std::thread &_thread : _threads)
+    {
+      _thread.join();
+    }
+
+    const std::uint64_t _expected_sum{(m_total * (m_total + 1)) / 2};
+
+    _logger.tst(format::bus::fmt("popped ", _popped_amount.load(),
+                                 ", sum = ", _popped_sum.load(),
+                                 ", expected sum = ", _expected_sum));
+
+    return (_popped_sum == _expected_sum) && _queue->empty();
+  }
+
+private:
+  static constexpr std::size_t   m_producers{4};
+  static constexpr std::size_t   m_consumers{4};
+  static constexpr std::uint64_t m_per_producer{100000};
+  static constexpr std::uint64_t m_total{m_producers * m_per_producer};
+};
+
+// Throws when copied, if 'fail' is set
+struct mpmc_value
+{
+  mpmc_value(std::uint32_t p_id, bool p_fail = false) : id(p_id), fail(p_fail)
+  {
+  }
+
+  mpmc_value(const mpmc_value &p_value) : id(p_value.id), fail(p_value.fail)
+  {
+    if (fail)
+    {
+      throw std::runtime_error("copy failed");
+    }
+  }
+
+  mpmc_value(mpmc_value &&) = default;
+
+  mpmc_value &operator=(const mpmc_value &) = default;
+  mpmc_value &operator=(mpmc_value &&)      = default;
+
+  friend std::ostream &operator<<(std::ostream      &p_out,
+                                  const mpmc_value &p_value)
+  {
+    return p_out << p_value.id;
+  }
+
+  std::uint32_t id;
+  bool          fail;
+};
+
+struct mpmc_queue_003
+{
+  static std::string desc()
+  {
+    return "A value whose copy throws while pushed does not block the values "
+           "pushed after it, and a queue moved from has no capacity, and "
+           "fails to push and pop";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    using queue = container::dat::mpmc_queue<log::cerr, mpmc_value>;
+
+    log::cerr            _logger;
+    std::optional<queue> _queue{queue::create(_logger, 4)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    const mpmc_value _first{1};
+    const mpmc_value _failing{2, true};
+    const mpmc_value _last{3};
+
+    _queue->push(_first);
+    bool _thrown{false};
+    try
+    {
+      _queue->push(_failing);
+    }
+    catch (const std::runtime_error &)
+    {
+      _thrown = true;
+    }
+    _queue->push(_last);
+
+    std::optional<mpmc_value> _popped_first{_queue->pop()};
+    std::optional<mpmc_value> _popped_last{_queue->pop()};
+
+    _logger.tst(format::bus::fmt("thrown = ", _thrown, ", popped ",
+                                 (_popped_first ? _popped_first->id : 0),
+                                 " and ",
+                                 (_popped_last ? _popped_last->id : 0)));
+
+    if (!_thrown || !_popped_first || (_popped_first->id != 1) || !_popped_last
+        || (_popped_last->id != 3) || !_queue->empty())
+    {
+      return false;
+    }
+
+    _queue->push(mpmc_value{4});
+    queue _moved{std::move(*_queue)};
+
+    std::optional<mpmc_value> _popped_moved{_moved.pop()};
+
+    return (_queue->capacity() == 0) && !_queue->pop().has_value()
+           && !_queue->try_push(mpmc_value{5}) && _popped_moved
+           && (_popped_moved->id == 4);
+  }
+};
+
+} // namespace tnct::container::tst
+
+#endif
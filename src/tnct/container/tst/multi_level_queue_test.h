@@ -0,0 +1,328 @@
+/// \copyright This file is under GPL 3 license. Please read the \p LICENSE file
+/// at the root of \p tenacitas directory
+
+/// \author Rodrigo Canellas - rodrigo.canellas at gmail.com
+
+#ifndef TNCT_CONTAINER_TST_MULTI_LEVEL_QUEUE_TEST_H
+#define TNCT_CONTAINER_TST_MULTI_LEVEL_QUEUE_TEST_H
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tnct/container/cpt/queue.h"
+#include "tnct/container/cpt/stamped_queue.h"
+#include "tnct/container/dat/multi_level_queue.h"
+#include "tnct/format/bus/fmt.h"
+#include "tnct/log/bus/cerr.h"
+#include "tnct/program/bus/options.h"
+
+namespace tnct::container::tst
+{
+
+// The level of a value is its hundreds, so 5 is in level 0, and 205 in level 2
+struct level_by_hundreds
+{
+  std::size_t operator()(std::uint32_t p_value) const
+  {
+    return p_value / 100;
+  }
+};
+
+using multi_level_queue_u32 =
+    container::dat::multi_level_queue<log::cerr, std::uint32_t,
+                                      level_by_hundreds>;
+
+struct multi_level_queue_000
+{
+  static std::string desc()
+  {
+    return "Checking if 'container::dat::multi_level_queue' complies to "
+           "'container::cpt::queue', and if data of a more urgent level is "
+           "popped first, and data of the same level in the order it was "
+           "pushed";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    static_assert(
+        container::cpt::queue<multi_level_queue_u32, std::uint32_t>,
+        "'multi_level_queue' should be compliant to 'container::cpt::queue'");
+
+    log::cerr                            _logger;
+    std::optional<multi_level_queue_u32> _queue{
+        multi_level_queue_u32::create(_logger, level_by_hundreds{}, 3, 8)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    for (std::uint32_t _value : {200U, 201U, 100U, 0U, 202U, 101U, 1U})
+    {
+      _queue->push(_value);
+    }
+
+    _logger.tst(_queue->brief_report());
+
+    if ((_queue->occupied() != 7) || (_queue->occupied(0) != 2)
+        || (_queue->occupied(1) != 2) || (_queue->occupied(2) != 3))
+    {
+      _logger.err("wrong amount of data in the levels");
+      return false;
+    }
+
+    for (std::uint32_t _expected : {0U, 1U, 100U, 101U, 200U, 201U, 202U})
+    {
+      std::optional<std::uint32_t> _maybe{_queue->pop()};
+      if (!_maybe || (*_maybe != _expected))
+      {
+        _logger.err(format::bus::fmt("expected ", _expected, ", but got ",
+                                     (_maybe ? std::to_string(*_maybe)
+                                             : std::string{"nothing"})));
+        return false;
+      }
+    }
+
+    return _queue->empty() && !_queue->pop().has_value();
+  }
+};
+
+struct multi_level_queue_001
+{
+  static std::string desc()
+  {
+    return "Each level of a 'multi_level_queue' is bounded, a level beyond the "
+           "last is taken as the last, and a queue with no levels can not be "
+           "created";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                            _logger;
+    std::optional<multi_level_queue_u32> _queue{
+        multi_level_queue_u32::create(_logger, level_by_hundreds{}, 2, 4)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    if (_queue->capacity() != 8)
+    {
+      _logger.err(format::bus::fmt("capacity = ", _queue->capacity()));
+      return false;
+    }
+
+    for (std::uint32_t _i = 0; _i < 4; ++_i)
+    {
+      // level 9 is taken as level 1
+      if (!_queue->try_push(900 + _i))
+      {
+        _logger.err(format::bus::fmt("could not push ", 900 + _i));
+        return false;
+      }
+    }
+
+    if (_queue->try_push(950) || (_queue->occupied(1) != 4))
+    {
+      _logger.err("level 1 should be full");
+      return false;
+    }
+
+    // the urgent level still has space
+    if (!_queue->try_push(7)
+        || (_queue->pop() != std::optional<std::uint32_t>{7}))
+    {
+      _logger.err("urgent data should be pushed, and popped first");
+      return false;
+    }
+
+    return !multi_level_queue_u32::create(_logger, level_by_hundreds{}, 0, 4);
+  }
+};
+
+struct multi_level_queue_002
+{
+  static std::string desc()
+  {
+    return "4 producers, each pushing to one of 2 levels, and 4 consumers "
+           "share a 'multi_level_queue', and the sum of all popped values must "
+           "match the sum of all pushed values";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    struct level_by_parity
+    {
+      std::size_t operator()(std::uint64_t p_value) const
+      {
+        return p_value % 2;
+      }
+    };
+
+    using queue = container::dat::multi_level_queue<log::cerr, std::uint64_t,
+                                                    level_by_parity>;
+
+    log::cerr            _logger;
+    std::optional<queue> _queue{
+        queue::create(_logger, level_by_parity{}, 2, 64)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    std::atomic_uint64_t _popped_sum{0};
+    std::atomic_uint64_t _popped_amount{0};
+
+    std::vector<std::thread> _threads;
+    for (std::size_t _c = 0; _c < m_consumers; ++_c)
+    {
+      _threads.emplace_back(
+          [&]()
+          {
+            while (_popped_amount < m_total)
+            {
+              std::optional<std::uint64_t> _maybe{_queue->pop()};
+              if (_maybe)
+              {
+                _popped_sum += *_maybe;
+                ++_popped_amount;
+              }
+              else
+              {
+                std::this_thread::yield();
+              }
+            }
+          });
+    }
+
+    for (std::size_t _p = 0; _p < m_producers; ++_p)
+    {
+      _threads.emplace_back(
+          [&, _p]()
+          {
+            for (std::uint64_t _i = 0; _i < m_per_producer; ++_i)
+            {
+              _queue->push((_p * m_per_producer) + _i + 1);
+            }
+          });
+    }
+
+    for (std::thread &_thread : _threads)
+    {
+      _thread.join();
+    }
+
+    const std::uint64_t _expected_sum{(m_total * (m_total + 1)) / 2};
+
+    _logger.tst(format::bus::fmt("popped ", _popped_amount.load(),
+                                 ", sum = ", _popped_sum.load(),
+                                 ", expected sum = ", _expected_sum));
+
+    return (_popped_sum == _expected_sum) && _queue->empty();
+  }
+
+private:
+  static constexpr std::size_t   m_producers{4};
+  static constexpr std::size_t   m_consumers{4};
+  static constexpr std::uint64_t m_per_producer{50000};
+  static constexpr std::uint64_t m_total{m_producers * m_per_producer};
+};
+
+struct multi_level_queue_003
+{
+  static std::string desc()
+  {
+    return "'pop_least_urgent' pops the oldest data of the least urgent level "
+           "that has data, and 'pop' still pops the most urgent first";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    log::cerr                            _logger;
+    std::optional<multi_level_queue_u32> _queue{
+        multi_level_queue_u32::create(_logger, level_by_hundreds{}, 3, 8)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    for (std::uint32_t _value : {1U, 101U, 201U, 2U, 202U})
+    {
+      _queue->push(_value);
+    }
+
+    const std::vector<std::optional<std::uint32_t>> _expected{201, 202, 101,
+                                                              1};
+    std::vector<std::optional<std::uint32_t>>       _popped;
+    for (std::size_t _i = 0; _i < _expected.size(); ++_i)
+    {
+      _popped.push_back(_queue->pop_least_urgent());
+    }
+
+    _logger.tst(format::bus::fmt("popped ", _popped.size(), ", occupied ",
+                                 _queue->occupied()));
+
+    return (_popped == _expected)
+           && (_queue->pop() == std::optional<std::uint32_t>{2})
+           && !_queue->pop_least_urgent();
+  }
+};
+
+struct multi_level_queue_004
+{
+  static std::string desc()
+  {
+    return "Each data is popped with the stamp pushed with it, although the "
+           "data is not popped in the order it was pushed";
+  }
+
+  bool operator()(const program::bus::options &)
+  {
+    static_assert(
+        container::cpt::stamped_queue<multi_level_queue_u32, std::uint32_t>,
+        "'multi_level_queue_u32' should be compliant to "
+        "'container::cpt::stamped_queue'");
+
+    log::cerr                            _logger;
+    std::optional<multi_level_queue_u32> _queue{
+        multi_level_queue_u32::create(_logger, level_by_hundreds{}, 3, 8)};
+    if (!_queue)
+    {
+      _logger.err("error creating queue");
+      return false;
+    }
+
+    // the stamp is the order of the push
+    std::int64_t _order{0};
+    for (std::uint32_t _value : {201U, 1U, 101U, 2U})
+    {
+      _queue->push(std::uint32_t{_value}, _order++);
+    }
+
+    const std::vector<std::pair<std::uint32_t, std::int64_t>> _expected{
+        {1, 1}, {2, 3}, {101, 2}, {201, 0}};
+    std::vector<std::pair<std::uint32_t, std::int64_t>> _popped;
+
+    std::int64_t _stamp{0};
+    while (std::optional<std::uint32_t> _value{_queue->pop(_stamp)})
+    {
+      _popped.emplace_back(*_value, _stamp);
+    }
+
+    _logger.tst(format::bus::fmt("popped ", _popped.size()));
+
+    return _popped == _expected;
+  }
+};
+
+} // namespace tnct::container::tst
+
+#endif
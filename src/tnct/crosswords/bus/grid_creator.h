@@ -11,6 +11,7 @@
 
 #include "tnct/async/bus/dispatcher.h"
 #include "tnct/container/dat/circular_queue.h"
+#include "tnct/container/dat/coalescing_queue.h"
 #include "tnct/crosswords/bus/internal/assembler.h"
 #include "tnct/crosswords/dat/error.h"
 #include "tnct/crosswords/dat/grid.h"
@@ -104,10 +105,15 @@ struct grid_creator
   {
     using evt::internal::grid_attempt_configuration;
 
+    // only the latest configuration of a client matters
+    auto _client{[](const grid_attempt_configuration &p_event)
+                 { return p_event.client; }};
+
     using queue =
-        container::dat::circular_queue<t_logger, grid_attempt_configuration>;
+        container::dat::coalescing_queue<t_logger, grid_attempt_configuration,
+                                         decltype(_client)>;
 
-    auto _queue{queue::create(m_logger, 300)};
+    auto _queue{queue::create(m_logger, _client)};
     if (!_queue)
     {
       TNCT_LOG_ERR(m_logger,
@@ -132,9 +138,14 @@ struct grid_creator
   {
     using evt::internal::grid_permutations_tried;
 
+    // only the latest amount of permutations tried for a client matters
+    auto _client{[](const grid_permutations_tried &p_event)
+                 { return p_event.client; }};
+
     using queue =
-        container::dat::circular_queue<t_logger, grid_permutations_tried>;
-    auto _queue{queue::create(m_logger, 500)};
+        container::dat::coalescing_queue<t_logger, grid_permutations_tried,
+                                         decltype(_client)>;
+    auto _queue{queue::create(m_logger, _client)};
     if (!_queue)
     {
       TNCT_LOG_ERR(m_logger,
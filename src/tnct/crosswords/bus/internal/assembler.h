@@ -16,6 +16,7 @@
 #include "tnct/async/bus/dispatcher.h"
 #include "tnct/async/cpt/is_dispatcher.h"
 #include "tnct/async/dat/handling_priority.h"
+#include "tnct/async/dat/overflow_policy.h"
 #include "tnct/async/dat/result.h"
 #include "tnct/container/dat/circular_queue.h"
 #include "tnct/crosswords/bus/internal/organizer.h"
@@ -120,9 +121,6 @@ struct assembler {
         m_logger,
         format::bus::fmt("initial = ", _initial.time_since_epoch().count()));
 
-    std::size_t _slept{0};
-    const auto _amount_to_sleep{100ms};
-
     while (true) {
       if (should_break(_initial, _permutation_counter, p_max_permutations)) {
         break;
@@ -170,20 +168,6 @@ struct assembler {
         break;
       }
 
-      std::unique_lock<std::mutex> _lock_wait(m_mutex_wait);
-      m_cond_wait.wait_for(_lock_wait, _amount_to_sleep, [&]() {
-        if (!should_break(_initial, _permutation_counter, p_max_permutations) &&
-            should_wait(_max_memory_to_use)) {
-          ++_slept;
-          return false;
-        }
-        return true;
-      });
-
-      if (should_break(_initial, _permutation_counter, p_max_permutations)) {
-        break;
-      }
-
       std::next_permutation(_permutation.begin(), _permutation.end(),
                             [this](dat::entries::const_entry_ite p_e1,
                                    dat::entries::const_entry_ite p_e2) -> bool {
@@ -200,17 +184,12 @@ struct assembler {
                      "left the loop, solved = ", (m_solved ? "Y" : "N"),
                      ", timeout = ", (m_timeout ? "Y" : "N"),
                      ", stop = ", (m_stop ? "Y" : "N"), ", waiting more ",
-                     (m_wait_for +
-                      std::chrono::seconds(_slept * _amount_to_sleep.count())) -
-                         _elapsed,
-                     " secs"));
+                     m_wait_for - _elapsed, " secs"));
 
     std::unique_lock<std::mutex> _lock_finish(m_mutex_finish);
-    m_cond_finish.wait_for(
-        _lock_finish,
-        (m_wait_for + std::chrono::seconds(_slept * _amount_to_sleep.count())) -
-            _elapsed,
-        [&]() { return (m_solved || m_timeout || m_stop); });
+    m_cond_finish.wait_for(_lock_finish, m_wait_for - _elapsed, [&]() {
+      return (m_solved || m_timeout || m_stop);
+    });
 
     TNCT_LOG_DEB(m_logger, "left the condition");
 
@@ -249,71 +228,6 @@ private:
         .value();
   }
 
-  bool should_wait(std::size_t p_max_memory_to_use) {
-#ifdef TENACITAS_LOG
-    static size_t _counter{0};
-#endif
-    size_t _current_free_mem{free_mem()};
-
-    if (m_max_mem_occupied) {
-      const auto _maybe_num_events{
-          m_internal_dispatcher
-              .template get_num_events<evt::internal::grid_to_organize>(
-                  m_grid_to_organize)};
-
-      const auto _maybe_events_capacity{
-          m_internal_dispatcher
-              .template get_events_capacity<evt::internal::grid_to_organize>(
-                  m_grid_to_organize)};
-
-      if (!_maybe_num_events.has_value()) {
-        TNCT_LOG_ERR(
-            m_logger,
-            format::bus::fmt("Error retrieving the number of "
-                             "events for evt::internal::grid_to_organize"));
-        return false;
-      }
-
-      if (!_maybe_events_capacity.has_value()) {
-        TNCT_LOG_ERR(m_logger, format::bus::fmt(
-                                   "Error retrieving the events capacity for "
-                                   "evt::internal::grid_to_organize"));
-        return false;
-      }
-
-      const auto _num_events{_maybe_num_events.value()};
-      const auto _events_capacity{_maybe_events_capacity.value()};
-
-      if (_num_events < _events_capacity) {
-        TNCT_LOG_DEB(m_logger,
-                     format::bus::fmt(_num_events, "/", _events_capacity,
-                                      " - DONT WAIT"));
-        return false;
-      }
-      return true;
-    }
-
-    if (_current_free_mem <=
-        static_cast<decltype(_current_free_mem)>(p_max_memory_to_use)) {
-#ifdef TENACITAS_LOG
-      if (std::remainder(_counter++, 50000) == 0) {
-        TNCT_LOG_DEB(m_logger, format::bus::fmt("current free mem = ",
-                                                _current_free_mem));
-      }
-#endif
-      m_max_mem_occupied = true;
-
-      TNCT_LOG_DEB(m_logger,
-                   format::bus::fmt("allowed memory occupied at = ",
-                                    std::chrono::high_resolution_clock::now()
-                                        .time_since_epoch()
-                                        .count()));
-
-      return true;
-    }
-    return false;
-  }
-
   bool compare_entries(const dat::entry &p_e1, const dat::entry &p_e2) {
     if (p_e1.get_word().size() == p_e2.get_word().size()) {
       return p_e1.get_word() < p_e2.get_word();
@@ -367,6 +281,18 @@ private:
             },
             async::dat::handling_priority::highest, p_hw_num_threads);
 
+    // the permutations are generated much faster than they are organized, so
+    // the generation waits while there are 'm_max_grids_to_organize' grids
+    // waiting to be organized
+    if (m_internal_dispatcher
+            .template set_overflow_policy<evt::internal::grid_to_organize>(
+                m_grid_to_organize, async::dat::overflow_policy::block,
+                m_max_grids_to_organize) != async::dat::result::OK) {
+      TNCT_LOG_ERR(m_logger,
+                   format::bus::fmt("Error setting overflow policy for ",
+                                    m_grid_to_organize));
+    }
+
     TNCT_LOG_DEB(
         m_logger,
         "configuring queue for event evt::internal::grid_create_solved");
@@ -417,7 +343,6 @@ private:
       return;
     }
     if (m_solved) {
-      m_cond_wait.notify_all();
       return;
     }
     //    internal::organizer _organizer{m_dispatcher};
@@ -434,16 +359,7 @@ private:
 
       // m_dispatcher. template clear<evt::internal::grid_to_organize>();
       m_solved = p_event.grid;
-      m_cond_wait.notify_all();
       m_cond_finish.notify_one();
-      return;
-    }
-
-    // if assembler is waiting for an available slot, in case memory is full, we
-    // notify that at one permutation was removed from the queues, but only if
-    // the grid was not solved by another organizer
-    if (!m_solved) {
-      m_cond_wait.notify_all();
     }
   }
 
@@ -472,14 +388,11 @@ private:
   std::mutex m_mutex_finish;
   std::condition_variable m_cond_finish;
 
-  std::mutex m_mutex_wait;
-  std::condition_variable m_cond_wait;
-
-  std::atomic_bool m_max_mem_occupied{false};
-
   internal_dispatcher m_internal_dispatcher{m_logger};
 
   static constexpr float m_perc_memory_to_be_used{0.1};
+
+  static constexpr std::size_t m_max_grids_to_organize{10000};
 };
 
 } // namespace tnct::crosswords::bus::internal